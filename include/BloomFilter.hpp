@@ -0,0 +1,330 @@
+// BloomFilter.hpp
+
+#ifndef _BLOOMFILTER_
+#define _BLOOMFILTER_
+
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+
+// Blocked Bloom filter over the hash values. Every hash value sets one bit
+// in each of the 8 words of a single block of the cache line size, so the
+// check of the hash value reads only one cache line. The block is chosen by
+// the high half of the mixed hash value and the bits by its low half, so the
+// filter is independent of the bucket index chosen by the low bits of the
+// hash value. The empty filter is disabled and reports every hash value as
+// possibly present
+class BlockedBloomFilter
+{
+public:
+    // Statistics of the filter
+    struct stats_t
+    {
+        size_t lookups;             // Count of checked hash values
+        size_t negatives;           // Count of rejected hash values
+        size_t false_positives;     // Count of passed absent keys
+
+        // Returns the fraction of the absent keys passed by the filter
+        double false_positive_rate() const noexcept
+        {
+            size_t count_absent = negatives + false_positives;
+
+            return count_absent == 0 ? 0.0 :
+                (double)false_positives / count_absent;
+        }
+    };
+
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+    static constexpr size_t BLOCK_SIZE = WORDS_PER_BLOCK * sizeof(uint64_t);
+    static constexpr float DEFAULT_BITS_PER_KEY = 10.0f;
+
+private:
+    std::vector<uint64_t> _m_words;     // Storage of the blocks
+    size_t _m_first;                    // Index of the first aligned word
+    size_t _m_count_blocks;             // Count of blocks
+    float _m_bits_per_key;              // Bits per key, 0 if disabled
+    bool _m_is_collect_stats;           // Statistics collection flag
+
+    // The counters are updated by the const lookups of the container, so
+    // they are relaxed atomics
+    mutable std::atomic<size_t> _m_lookups;
+    mutable std::atomic<size_t> _m_negatives;
+    mutable std::atomic<size_t> _m_false_positives;
+
+    // Mixes the hash value, since the hash values of integers are the
+    // integers themselves
+    static uint64_t _mix(size_t _hash) noexcept
+    { return static_cast<uint64_t>(_hash) * 0x9E3779B97F4A7C15ull; }
+
+    // Returns the index of the first word of the block of the mixed hash
+    // value
+    size_t _block_of(uint64_t _mixed) const noexcept
+    {
+        size_t i = ((_mixed >> 32) * _m_count_blocks) >> 32;
+
+        return _m_first + i * WORDS_PER_BLOCK;
+    }
+
+    // Returns the mask of the bit in the specified word of the block
+    static uint64_t _bit_of(uint64_t _mixed, size_t _word) noexcept
+    {
+        static const uint32_t SALTS[WORDS_PER_BLOCK] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+
+        uint32_t low = static_cast<uint32_t>(_mixed);
+
+        return uint64_t(1) << ((uint32_t)(low * SALTS[_word]) >> 26);
+    }
+
+    // Allocates the zeroed blocks aligned to the block size
+    void _allocate(size_t _count_blocks)
+    {
+        const size_t PADDING = WORDS_PER_BLOCK - 1;
+
+        _m_count_blocks = _count_blocks;
+        _m_words.assign(_count_blocks * WORDS_PER_BLOCK + PADDING, 0);
+
+        uintptr_t addr = reinterpret_cast<uintptr_t>(_m_words.data());
+        _m_first = ((BLOCK_SIZE - addr % BLOCK_SIZE) % BLOCK_SIZE) /
+            sizeof(uint64_t);
+    }
+
+    // Copies the parameters and the blocks of the other filter
+    void _copy(const BlockedBloomFilter& _other)
+    {
+        _m_bits_per_key = _other._m_bits_per_key;
+        _m_is_collect_stats = _other._m_is_collect_stats;
+        _m_lookups = _other._m_lookups.load(std::memory_order_relaxed);
+        _m_negatives = _other._m_negatives.load(std::memory_order_relaxed);
+        _m_false_positives
+            = _other._m_false_positives.load(std::memory_order_relaxed);
+
+        if (_other._m_count_blocks == 0)
+        {
+            _m_words.clear();
+            _m_first = 0;
+            _m_count_blocks = 0;
+
+            return;
+        }
+
+        // The copied words can have another alignment
+        _allocate(_other._m_count_blocks);
+        std::copy
+        (
+            _other._m_words.begin() + _other._m_first,
+            _other._m_words.begin() + _other._m_first +
+                _m_count_blocks * WORDS_PER_BLOCK,
+            _m_words.begin() + _m_first
+        );
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor of the disabled filter
+    BlockedBloomFilter():
+        _m_words{},
+        _m_first{0},
+        _m_count_blocks{0},
+        _m_bits_per_key{0.0f},
+        _m_is_collect_stats{false},
+        _m_lookups{0},
+        _m_negatives{0},
+        _m_false_positives{0}
+    {}
+
+    // Copy constructor
+    BlockedBloomFilter(const BlockedBloomFilter& _other):
+        BlockedBloomFilter()
+    {
+        _copy(_other);
+    }
+
+    // Move constructor. The moved vector keeps its data, so the alignment
+    // of the blocks is preserved
+    BlockedBloomFilter(BlockedBloomFilter&& _other) noexcept:
+        _m_words{std::move(_other._m_words)},
+        _m_first{_other._m_first},
+        _m_count_blocks{_other._m_count_blocks},
+        _m_bits_per_key{_other._m_bits_per_key},
+        _m_is_collect_stats{_other._m_is_collect_stats},
+        _m_lookups{_other._m_lookups.load(std::memory_order_relaxed)},
+        _m_negatives{_other._m_negatives.load(std::memory_order_relaxed)},
+        _m_false_positives
+        {
+            _other._m_false_positives.load(std::memory_order_relaxed)
+        }
+    {
+        _other._m_count_blocks = 0;
+        _other._m_bits_per_key = 0.0f;
+    }
+
+    // Destructor
+    ~BlockedBloomFilter() {}
+
+    // Assignment by copying
+    BlockedBloomFilter& operator=(const BlockedBloomFilter& _other)
+    {
+        if (this != &_other)
+            _copy(_other);
+
+        return *this;
+    }
+
+    // Assignment by moving
+    BlockedBloomFilter& operator=(BlockedBloomFilter&& _other) noexcept
+    {
+        _m_words = std::move(_other._m_words);
+        _m_first = _other._m_first;
+        _m_count_blocks = _other._m_count_blocks;
+        _m_bits_per_key = _other._m_bits_per_key;
+        _m_is_collect_stats = _other._m_is_collect_stats;
+        _m_lookups = _other._m_lookups.load(std::memory_order_relaxed);
+        _m_negatives = _other._m_negatives.load(std::memory_order_relaxed);
+        _m_false_positives
+            = _other._m_false_positives.load(std::memory_order_relaxed);
+
+        _other._m_count_blocks = 0;
+        _other._m_bits_per_key = 0.0f;
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Operations
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Enables the filter with the specified count of bits per key, the
+    // statistics are collected only if it is requested, since the atomic
+    // counters are shared by the concurrent lookups
+    void enable(float _bits_per_key = DEFAULT_BITS_PER_KEY,
+        bool _is_collect_stats = false)
+    {
+        _m_bits_per_key = _bits_per_key > 1.0f ? _bits_per_key : 1.0f;
+        _m_is_collect_stats = _is_collect_stats;
+        reset(0);
+    }
+
+    // Disables the filter and releases its memory
+    void disable()
+    {
+        _m_words = std::vector<uint64_t>();
+        _m_first = 0;
+        _m_count_blocks = 0;
+        _m_bits_per_key = 0.0f;
+    }
+
+    // Clears the enabled filter and resizes it for the specified count of
+    // keys
+    void reset(size_t _count_keys)
+    {
+        if (!enabled())
+            return;
+
+        double bits = std::ceil(_count_keys * (double)_m_bits_per_key);
+        size_t count_blocks = static_cast<size_t>(std::ceil(bits /
+            (BLOCK_SIZE * 8)));
+
+        _allocate(count_blocks > 0 ? count_blocks : 1);
+    }
+
+    // Adds the hash value to the enabled filter
+    void add(size_t _hash) noexcept
+    {
+        if (_m_count_blocks == 0)
+            return;
+
+        uint64_t mixed = _mix(_hash);
+        uint64_t* block = _m_words.data() + _block_of(mixed);
+
+        for (size_t i = 0; i < WORDS_PER_BLOCK; i++)
+            block[i] |= _bit_of(mixed, i);
+    }
+
+    // Checks that the hash value can be in the filter, the disabled filter
+    // passes all hash values
+    bool may_contain(size_t _hash) const noexcept
+    {
+        if (_m_count_blocks == 0)
+            return true;
+
+        uint64_t mixed = _mix(_hash);
+        const uint64_t* block = _m_words.data() + _block_of(mixed);
+        bool result = true;
+
+        for (size_t i = 0; i < WORDS_PER_BLOCK; i++)
+            if ((block[i] & _bit_of(mixed, i)) == 0)
+            {
+                result = false;
+                break;
+            }
+
+        if (_m_is_collect_stats)
+        {
+            _m_lookups.fetch_add(1, std::memory_order_relaxed);
+            if (!result)
+                _m_negatives.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    // Notes the absent key passed by the filter
+    void note_false_positive() const noexcept
+    {
+        if (_m_is_collect_stats && _m_count_blocks > 0)
+            _m_false_positives.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Checks that the filter is enabled
+    bool enabled() const noexcept { return _m_bits_per_key > 0.0f; }
+    // Returns count of bits per key
+    float bits_per_key() const noexcept { return _m_bits_per_key; }
+    // Returns count of blocks
+    size_t count_blocks() const noexcept { return _m_count_blocks; }
+    // Returns the memory in bytes used by the blocks
+    size_t memory_usage() const noexcept
+    { return _m_words.capacity() * sizeof(uint64_t); }
+
+    // Returns the statistics of the filter
+    stats_t stats() const noexcept
+    {
+        return stats_t
+        {
+            _m_lookups.load(std::memory_order_relaxed),
+            _m_negatives.load(std::memory_order_relaxed),
+            _m_false_positives.load(std::memory_order_relaxed)
+        };
+    }
+
+    // Resets the statistics of the filter
+    void reset_stats() noexcept
+    {
+        _m_lookups = 0;
+        _m_negatives = 0;
+        _m_false_positives = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // BlockedBloomFilter
+
+
+#endif  // _BLOOMFILTER_
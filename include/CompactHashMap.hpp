@@ -0,0 +1,1772 @@
+// CompactHashMap.hpp
+
+#ifndef _COMPACTHASHMAP_
+#define _COMPACTHASHMAP_
+
+
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+
+// Iterator over the elements of the compact table. It keeps the number of
+// the bucket and the number of the node in the chain of the bucket. The
+// table must provide "_next_of(n)", "_value_at(n)" and "_first_from(i)"
+template <class _Table, class _Value>
+class __compact_iterator:
+    public std::iterator<std::forward_iterator_tag, _Value>
+{
+private:
+    template <class, class> friend class __compact_iterator;
+
+    _Table* _m_table_ptr;   // Table of the iterator
+    size_t _m_bucket;       // Number of the bucket, count of buckets at end
+    uint32_t _m_node;       // Number of the node
+
+public:
+    // Default constructor
+    __compact_iterator(): _m_table_ptr{nullptr}, _m_bucket{0}, _m_node{0} {}
+
+    // Constructor with the table and the numbers of the bucket and the node
+    __compact_iterator(_Table& _table, size_t _bucket, uint32_t _node)
+        noexcept:
+        _m_table_ptr{&_table},
+        _m_bucket{_bucket},
+        _m_node{_node}
+    {}
+
+    // Constructor with the table and the number of the bucket, the iterator
+    // is set to the first element of the first non-empty bucket starting
+    // from the specified one
+    __compact_iterator(_Table& _table, size_t _bucket) noexcept:
+        _m_table_ptr{&_table},
+        _m_bucket{0},
+        _m_node{0}
+    {
+        _m_node = _table._first_from(_bucket, _m_bucket);
+    }
+
+    // Converting constructor from the iterator over mutable elements
+    template <class _OtherTable, class _OtherValue>
+    __compact_iterator
+    (
+        const __compact_iterator<_OtherTable, _OtherValue>& _other
+    ) noexcept:
+        _m_table_ptr{_other._m_table_ptr},
+        _m_bucket{_other._m_bucket},
+        _m_node{_other._m_node}
+    {}
+
+    // Returns the number of the bucket
+    size_t bucket() const noexcept { return _m_bucket; }
+    // Returns the number of the node
+    uint32_t node() const noexcept { return _m_node; }
+
+    // Equality operator
+    template <class _OtherTable, class _OtherValue>
+    bool operator==
+    (
+        const __compact_iterator<_OtherTable, _OtherValue>& _other
+    ) const noexcept
+    {
+        return _m_table_ptr == _other._m_table_ptr &&
+            _m_bucket == _other._m_bucket && _m_node == _other._m_node;
+    }
+
+    // Inequality operator
+    template <class _OtherTable, class _OtherValue>
+    bool operator!=
+    (
+        const __compact_iterator<_OtherTable, _OtherValue>& _other
+    ) const noexcept
+    { return !(*this == _other); }
+
+    // Dereference operators
+    _Value& operator*() const noexcept
+    { return _m_table_ptr->_value_at(_m_node); }
+    _Value* operator->() const noexcept
+    { return &_m_table_ptr->_value_at(_m_node); }
+
+    // Prefix increment operator
+    __compact_iterator& operator++() noexcept
+    {
+        _m_node = _m_table_ptr->_next_of(_m_node);
+
+        if (_m_node == _Table::NIL)
+            *this = __compact_iterator(*_m_table_ptr, _m_bucket + 1);
+
+        return *this;
+    }
+
+    // Postfix increment operator
+    __compact_iterator operator++(int) noexcept
+    {
+        __compact_iterator temp = *this;
+        ++(*this);
+
+        return temp;
+    }
+};
+
+
+// Iterator over the elements of a single bucket of the compact table
+template <class _Table, class _Value>
+class __compact_bucket_iterator:
+    public std::iterator<std::forward_iterator_tag, _Value>
+{
+private:
+    template <class, class> friend class __compact_bucket_iterator;
+
+    _Table* _m_table_ptr;   // Table of the iterator
+    uint32_t _m_node;       // Number of the node, NIL at the end
+
+public:
+    // Default constructor
+    __compact_bucket_iterator(): _m_table_ptr{nullptr}, _m_node{0} {}
+
+    // Constructor with the table and the number of the node
+    __compact_bucket_iterator(_Table& _table, uint32_t _node) noexcept:
+        _m_table_ptr{&_table},
+        _m_node{_node}
+    {}
+
+    // Converting constructor from the iterator over mutable elements
+    template <class _OtherTable, class _OtherValue>
+    __compact_bucket_iterator
+    (
+        const __compact_bucket_iterator<_OtherTable, _OtherValue>& _other
+    ) noexcept:
+        _m_table_ptr{_other._m_table_ptr},
+        _m_node{_other._m_node}
+    {}
+
+    // Equality operator
+    bool operator==(const __compact_bucket_iterator& _other) const noexcept
+    { return _m_node == _other._m_node; }
+
+    // Inequality operator
+    bool operator!=(const __compact_bucket_iterator& _other) const noexcept
+    { return _m_node != _other._m_node; }
+
+    // Dereference operators
+    _Value& operator*() const noexcept
+    { return _m_table_ptr->_value_at(_m_node); }
+    _Value* operator->() const noexcept
+    { return &_m_table_ptr->_value_at(_m_node); }
+
+    // Prefix increment operator
+    __compact_bucket_iterator& operator++() noexcept
+    {
+        _m_node = _m_table_ptr->_next_of(_m_node);
+        return *this;
+    }
+
+    // Postfix increment operator
+    __compact_bucket_iterator operator++(int) noexcept
+    {
+        __compact_bucket_iterator temp = *this;
+        ++(*this);
+
+        return temp;
+    }
+};
+
+
+// Hash map with collision chains linked by 32-bit numbers of the nodes. It
+// has the interface of HashMap, but the nodes are not allocated one by
+// one: they are kept in the chunks of the node pool, the buckets are the
+// 32-bit numbers of the first nodes of the chains and every node has the
+// 32-bit number of the next node and the low 32 bits of the hash value.
+// So every element costs 8 bytes besides itself and 4 bytes per bucket,
+// while the node of HashMap costs 16 bytes, the overhead of the allocator
+// and 8 bytes per bucket. The map holds less than 2^32 elements.
+//
+// The chunks of the pool grow twice from 16 nodes up to 65536 nodes, the
+// rest of the chunks have 65536 nodes, so the small maps stay small and the
+// large maps do not reserve much unused memory. The chunks are never moved,
+// so the references to the elements remain valid until their removal, as in
+// HashMap. The erased nodes are reused by the following insertions.
+//
+// The nodes can not be shared between different pools, so the node handles
+// and the merging move the elements instead of relinking the nodes
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<std::pair<const _Key, _Data>>
+>
+class CompactHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<const _Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+    using _allocator_t   = _Allocator;
+
+    using iterator = __compact_iterator<CompactHashMap, _value_t>;
+    using const_iterator
+        = __compact_iterator<const CompactHashMap, const _value_t>;
+    using bucket_iterator
+        = __compact_bucket_iterator<CompactHashMap, _value_t>;
+    using const_bucket_iterator
+        = __compact_bucket_iterator<const CompactHashMap, const _value_t>;
+    class node_type;
+    struct insert_return_type;
+
+    // Key together with its hash value without the seed, see
+    // HashMap::hashed_key
+    class hashed_key
+    {
+    private:
+        const _key_t* _m_key_ptr;   // Pointer to the key
+        size_t _m_hash;             // Hash value of the key
+
+    public:
+        // Constructor with the key and its hash value
+        hashed_key(const _key_t& _key, size_t _hash) noexcept:
+            _m_key_ptr{&_key},
+            _m_hash{_hash}
+        {}
+
+        // Returns the key
+        const _key_t& key() const noexcept { return *_m_key_ptr; }
+        // Returns the hash value of the key without the seed
+        size_t hash() const noexcept { return _m_hash; }
+    };
+
+    // Number marking the end of the chain
+    static constexpr uint32_t NIL = UINT32_MAX;
+    // Max count of elements
+    static constexpr size_t MAX_COUNT = UINT32_MAX;
+
+protected:
+    template <class, class> friend class __compact_iterator;
+    template <class, class> friend class __compact_bucket_iterator;
+
+    static constexpr size_t MIN_COUNT_BUCKETS  = 16;
+    // Only the first 2^32 buckets are reachable by the 32-bit hash values
+    static constexpr size_t MAX_COUNT_BUCKETS = sizeof(size_t) > 4 ?
+        static_cast<size_t>(uint64_t(UINT32_MAX) + 1) : SIZE_MAX;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+    static constexpr float DEFAULT_MIN_LOAD_FACTOR = 0.0f;
+    static constexpr size_t MAX_CHAIN_LENGTH = 32;
+    // Sizes of the chunks of the pool
+    static constexpr unsigned FIRST_CHUNK_BITS = 4;
+    static constexpr unsigned MAX_CHUNK_BITS = 16;
+    // Count of the growing chunks and count of nodes in them
+    static constexpr size_t COUNT_GROWING_CHUNKS
+        = MAX_CHUNK_BITS - FIRST_CHUNK_BITS;
+    static constexpr size_t COUNT_GROWING_NODES
+        = (size_t(1) << MAX_CHUNK_BITS) - (size_t(1) << FIRST_CHUNK_BITS);
+
+    // Node of the pool, the element is constructed only in the node of the
+    // container, the free nodes are linked to the list of free nodes
+    struct _node_t
+    {
+        uint32_t _m_next;   // Number of the next node of the chain
+        uint32_t _m_hash;   // Low 32 bits of the hash value
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_storage;    // Storage of element
+
+        // Returns the stored element
+        _value_t& value() noexcept
+        { return *reinterpret_cast<_value_t*>(&_m_storage); }
+        const _value_t& value() const noexcept
+        { return *reinterpret_cast<const _value_t*>(&_m_storage); }
+    };
+
+    using _alloc_traits = std::allocator_traits<_allocator_t>;
+    using _node_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_node_t>;
+    using _node_traits = std::allocator_traits<_node_allocator_t>;
+    using _bucket_allocator_t
+        = typename _alloc_traits::template rebind_alloc<uint32_t>;
+    using _chunk_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_node_t*>;
+    using _table_t = std::vector<uint32_t, _bucket_allocator_t>;
+
+    _table_t _m_buckets;                // First nodes of the chains
+    std::vector<_node_t*, _chunk_allocator_t> _m_chunks;  // Node pool
+    size_t _m_used;                     // Count of nodes taken from pool
+    uint32_t _m_free;                   // First free node
+    size_t _m_count;                    // Count of items in map
+    float _m_max_load_factor;           // Max load factor
+    float _m_min_load_factor;           // Min load factor
+    _hasher_t _m_hasher;                // Hasher functor
+    _key_equal_t _m_key_equal;          // Key equal functor
+    _node_allocator_t _m_allocator;     // Allocator of the chunks
+    BlockedBloomFilter _m_filter;       // Filter of the absent keys
+    size_t _m_seed;                     // Seed of the hash values
+    size_t _m_reseed_count;             // Count of items allowing reseeding
+    __bucket_bitmap _m_occupied;        // Bitmap of the non-empty buckets
+    size_t _m_first_bucket;             // First non-empty bucket
+
+    // Returns the key of the element
+    static const _key_t& _key_of(const _value_t& _val) noexcept
+    { return _val.first; }
+
+    // Returns the hash value stored in the nodes
+    static uint32_t _short_hash(size_t _hash) noexcept
+    { return static_cast<uint32_t>(_hash); }
+
+    // Returns the hash value of the key with the seed of the container
+    size_t _hash(const _key_t& _key) const
+    { return __hash_with_seed(_m_hasher, _key, _m_seed); }
+
+    // Returns the hash value of the key of the handle with the seed of the
+    // container
+    size_t _hash(const hashed_key& _hkey) const
+    { return __seed_hash(_m_hasher, _hkey.key(), _hkey.hash(), _m_seed); }
+
+    // Returns the hash value of the node of the container with the
+    // specified seed. The stored hash value is reused if the seeds are
+    // equal, otherwise the key is hashed again
+    size_t _hash_from(size_t _seed, const _node_t& _node) const
+    {
+        return _seed == _m_seed ? _node._m_hash :
+            _hash(_key_of(_node.value()));
+    }
+
+    // Returns the count of nodes in the chunk of the pool
+    static size_t _chunk_size(size_t _k) noexcept
+    {
+        return _k < COUNT_GROWING_CHUNKS ?
+            size_t(1) << (FIRST_CHUNK_BITS + _k) :
+            size_t(1) << MAX_CHUNK_BITS;
+    }
+
+    // Returns the node of the pool by its number
+    _node_t& _node(uint32_t _n) noexcept
+    {
+        return const_cast<_node_t&>(
+            static_cast<const CompactHashMap&>(*this)._node(_n));
+    }
+
+    const _node_t& _node(uint32_t _n) const noexcept
+    {
+        if (_n < COUNT_GROWING_NODES)
+        {
+            // The chunk of the node is found by the highest bit of its
+            // number counted from the beginning of the first chunk
+            size_t i = _n + (size_t(1) << FIRST_CHUNK_BITS);
+            size_t k = 63 - __builtin_clzll(i) - FIRST_CHUNK_BITS;
+
+            return _m_chunks[k][i - (size_t(1) << (FIRST_CHUNK_BITS + k))];
+        }
+
+        size_t i = _n - COUNT_GROWING_NODES;
+
+        return _m_chunks[COUNT_GROWING_CHUNKS + (i >> MAX_CHUNK_BITS)]
+            [i & ((size_t(1) << MAX_CHUNK_BITS) - 1)];
+    }
+
+    // Interface of the iterators
+
+    uint32_t _next_of(uint32_t _n) const noexcept
+    { return _node(_n)._m_next; }
+
+    _value_t& _value_at(uint32_t _n) noexcept
+    { return _node(_n).value(); }
+
+    const _value_t& _value_at(uint32_t _n) const noexcept
+    { return _node(_n).value(); }
+
+    // Returns the first node of the first non-empty bucket starting from the
+    // specified one and sets the number of that bucket, the count of
+    // buckets and NIL are returned if there is no such bucket
+    uint32_t _first_from(size_t _i, size_t& _bucket) const noexcept
+    {
+        _bucket = _next_occupied(_i);
+
+        return _bucket < _m_buckets.size() ? _m_buckets[_bucket] : NIL;
+    }
+
+    // Takes a node from the list of free nodes or from the pool, the chunk
+    // is allocated if the pool is exhausted
+    uint32_t _take_node()
+    {
+        if (_m_free != NIL)
+        {
+            uint32_t n = _m_free;
+
+            _m_free = _node(n)._m_next;
+            return n;
+        }
+
+        if (_m_used == MAX_COUNT)
+            throw std::length_error("the count of elements exceeds the max "
+                "count");
+
+        size_t k = _m_chunks.size();
+        size_t capacity = k < COUNT_GROWING_CHUNKS ?
+            (size_t(1) << (FIRST_CHUNK_BITS + k)) -
+            (size_t(1) << FIRST_CHUNK_BITS) :
+            COUNT_GROWING_NODES + ((k - COUNT_GROWING_CHUNKS) <<
+            MAX_CHUNK_BITS);
+
+        if (_m_used == capacity)
+        {
+            _m_chunks.reserve(k + 1);
+            _m_chunks.push_back(_node_traits::allocate(_m_allocator,
+                _chunk_size(k)));
+        }
+
+        return static_cast<uint32_t>(_m_used++);
+    }
+
+    // Returns the node to the list of free nodes, its element must be
+    // destroyed
+    void _give_node(uint32_t _n) noexcept
+    {
+        _node(_n)._m_next = _m_free;
+        _m_free = _n;
+    }
+
+    // Destroys the elements and releases the chunks of the pool
+    void _deallocate() noexcept
+    {
+        for (uint32_t head : _m_buckets)
+            for (uint32_t n = head; n != NIL; n = _node(n)._m_next)
+                _node(n).value().~_value_t();
+
+        for (size_t k = 0; k < _m_chunks.size(); k++)
+            _node_traits::deallocate(_m_allocator, _m_chunks[k],
+                _chunk_size(k));
+
+        _m_chunks.clear();
+        _m_used = 0;
+        _m_free = NIL;
+        _m_count = 0;
+    }
+
+    // Copies the nodes of the other container with the same numbers, so
+    // the chains and the list of free nodes are copied as they are
+    void _copy_nodes(const CompactHashMap& _other)
+    {
+        _m_chunks.reserve(_other._m_chunks.size());
+        for (size_t k = 0; k < _other._m_chunks.size(); k++)
+            _m_chunks.push_back(_node_traits::allocate(_m_allocator,
+                _chunk_size(k)));
+
+        for (size_t n = 0; n < _other._m_used; n++)
+        {
+            _node(n)._m_next = _other._node(n)._m_next;
+            _node(n)._m_hash = _other._node(n)._m_hash;
+        }
+
+        _m_used = _other._m_used;
+        _m_free = _other._m_free;
+
+        // The chains are copied one by one, so the destructor releases
+        // only the elements already copied if the copying throws
+        _m_buckets.assign(_other._m_buckets.size(), uint32_t(NIL));
+
+        for (size_t i = 0; i < _m_buckets.size(); i++)
+        {
+            uint32_t* link = &_m_buckets[i];
+
+            for (uint32_t n = _other._m_buckets[i]; n != NIL;
+                n = _other._node(n)._m_next)
+            {
+                new (&_node(n)._m_storage) _value_t(_other._node(n).value());
+                *link = n;
+                link = &_node(n)._m_next;
+                *link = NIL;
+            }
+        }
+
+        _m_count = _other._m_count;
+    }
+
+    // Takes the nodes of the other container, which is left empty with the
+    // minimum buckets as the default constructed one
+    void _take(CompactHashMap& _other)
+    {
+        _m_buckets = std::move(_other._m_buckets);
+        _m_chunks = std::move(_other._m_chunks);
+        _m_used = _other._m_used;
+        _m_free = _other._m_free;
+        _m_count = _other._m_count;
+        _m_occupied = std::move(_other._m_occupied);
+        _m_first_bucket = _other._m_first_bucket;
+
+        _other._m_buckets.clear();
+        _other._m_chunks.clear();
+        _other.clear();
+    }
+
+    // Returns the load factor of the container
+    // if it had specified count elements
+    float _load_factor(size_t _count) const noexcept
+    { return (float)_count / _m_buckets.size(); }
+
+    // Returns number of bucket by specified hash value
+    size_t _bucket_index(size_t _hash) const noexcept
+    { return mod_hash(_short_hash(_hash), _m_buckets.size()); }
+
+    // Marks the bucket as non-empty in the occupancy bitmap
+    void _set_occupied(size_t _n) noexcept
+    {
+        _m_occupied.set(_n);
+
+        if (_n < _m_first_bucket)
+            _m_first_bucket = _n;
+    }
+
+    // Marks the bucket as empty in the occupancy bitmap if it has no nodes
+    void _update_occupied(size_t _n) noexcept
+    {
+        if (_m_buckets[_n] != NIL)
+            return;
+
+        _m_occupied.reset(_n);
+
+        if (_n == _m_first_bucket)
+            _m_first_bucket = _next_occupied(_n + 1);
+    }
+
+    // Returns number of the first non-empty bucket starting from the
+    // specified one, or the count of buckets if there is no such bucket
+    size_t _next_occupied(size_t _n) const noexcept
+    { return _m_occupied.next(_n); }
+
+    // Checks that the load factor of the container has fallen below the
+    // minimum load factor, see HashMap
+    bool _is_sparse() const noexcept
+    {
+        float min_load_factor = _m_min_load_factor;
+
+        if (min_load_factor > _m_max_load_factor / 4)
+            min_load_factor = _m_max_load_factor / 4;
+
+        return _m_buckets.size() > MIN_COUNT_BUCKETS &&
+            _load_factor(_m_count) < min_load_factor;
+    }
+
+    // Clears the filter and adds the stored hash values of all elements to
+    // it. The filter is sized for the elements the buckets can accommodate
+    // without exceeding maximum load factor
+    void _rebuild_filter()
+    {
+        if (!_m_filter.enabled())
+            return;
+
+        _m_filter.reset(_m_buckets.size() * _m_max_load_factor);
+        for (uint32_t head : _m_buckets)
+            for (uint32_t n = head; n != NIL; n = _node(n)._m_next)
+                _m_filter.add(_node(n)._m_hash);
+    }
+
+    // Rehashes the container before the addition of the element if it
+    // overflows after the addition or if it has become sparse. In both
+    // cases the load factor becomes half of the maximum load factor
+    void _rehash_before_insert()
+    {
+        if (_load_factor(_m_count + 1) > _m_max_load_factor || _is_sparse())
+            reverse(_m_count * 2);
+    }
+
+    // Adds a new element with the specified hash value of the key to the
+    // container without checking for its presence
+    template <class... _Args>
+    iterator _insert_new(size_t _hash, _Args&&... _args)
+    {
+        _rehash_before_insert();
+
+        uint32_t n = _take_node();
+        _node_t& node = _node(n);
+
+        try
+        {
+            new (&node._m_storage) _value_t(std::forward<_Args>(_args)...);
+        }
+        catch (...)
+        {
+            _give_node(n);
+            throw;
+        }
+
+        size_t i = _bucket_index(_hash);
+
+        node._m_hash = _short_hash(_hash);
+        node._m_next = _m_buckets[i];
+        _m_buckets[i] = n;
+        _m_count++;
+        _m_filter.add(node._m_hash);
+        _set_occupied(i);
+
+        return _check_chain(i);
+    }
+
+    // Returns the iterator to the node just added to the front of the
+    // chain. If the chain has grown abnormally long, the container is
+    // reseeded, see HashMap
+    iterator _check_chain(size_t _i)
+    {
+        uint32_t n = _m_buckets[_i];
+
+        if (_m_count < _m_reseed_count || !_is_long_chain(_i))
+            return iterator(*this, _i, n);
+
+        reseed(_Random_seed());
+        _m_reseed_count = 2 * _m_count;
+
+        // The nodes keep their numbers, but the bucket has changed
+        return iterator(*this, _bucket_index(_node(n)._m_hash), n);
+    }
+
+    // Checks that the chain is longer than the length expected for the
+    // maximum load factor by far
+    bool _is_long_chain(size_t _i) const noexcept
+    {
+        size_t max_length = MAX_CHAIN_LENGTH;
+
+        if (_m_max_load_factor > 1)
+            max_length *= std::ceil(_m_max_load_factor);
+
+        size_t length = 0;
+
+        for (uint32_t n = _m_buckets[_i]; n != NIL; n = _node(n)._m_next)
+            if (++length > max_length)
+                return true;
+
+        return false;
+    }
+
+    // Relinks the nodes to the specified count of new buckets by their
+    // stored hash values
+    void _relink_nodes(size_t _count_buckets)
+    {
+        _table_t new_buckets(_count_buckets, uint32_t(NIL),
+            _m_buckets.get_allocator());
+
+        _m_occupied = __bucket_bitmap(_count_buckets);
+
+        for (uint32_t head : _m_buckets)
+        {
+            uint32_t n = head;
+
+            while (n != NIL)
+            {
+                _node_t& node = _node(n);
+                uint32_t next = node._m_next;
+                size_t i = mod_hash(node._m_hash, _count_buckets);
+
+                node._m_next = new_buckets[i];
+                new_buckets[i] = n;
+                _m_occupied.set(i);
+                n = next;
+            }
+        }
+
+        _m_buckets = std::move(new_buckets);
+        _m_first_bucket = _next_occupied(0);
+        _rebuild_filter();
+    }
+
+    // Returns the node of the chain with the specified key and its hash
+    // value with the seed or NIL
+    uint32_t _find_node(size_t _i, const _key_t& _key, size_t _hash) const
+    {
+        uint32_t hash = _short_hash(_hash);
+
+        for (uint32_t n = _m_buckets[_i]; n != NIL; n = _node(n)._m_next)
+        {
+            const _node_t& node = _node(n);
+
+            if
+            (
+                node._m_hash == hash &&
+                _m_key_equal(_key, _key_of(node.value()))
+            )
+                return n;
+        }
+
+        return NIL;
+    }
+
+    // Returns the iterator to the element with the specified key and its
+    // hash value with the seed, or end if there is no such element
+    iterator _find(const _key_t& _key, size_t _hash)
+    {
+        // The filter rejects most of the absent keys reading a single
+        // cache line instead of the collision chain
+        if (!_m_filter.may_contain(_short_hash(_hash)))
+            return end();
+
+        size_t i = _bucket_index(_hash);
+        uint32_t n = _find_node(i, _key, _hash);
+
+        if (n != NIL)
+            return iterator(*this, i, n);
+
+        _m_filter.note_false_positive();
+
+        return end();
+    }
+
+    const_iterator _find(const _key_t& _key, size_t _hash) const
+    {
+        // The filter rejects most of the absent keys reading a single
+        // cache line instead of the collision chain
+        if (!_m_filter.may_contain(_short_hash(_hash)))
+            return cend();
+
+        size_t i = _bucket_index(_hash);
+        uint32_t n = _find_node(i, _key, _hash);
+
+        if (n != NIL)
+            return const_iterator(*this, i, n);
+
+        _m_filter.note_false_positive();
+
+        return cend();
+    }
+
+    // Returns the mapped value of the found element, if the element was not
+    // found, an out_of_range exception is thrown
+    _mapped_t& _found(iterator _iter)
+    {
+        if (_iter == end())
+            throw std::out_of_range("the element with this key was not found");
+
+        return (*_iter).second;
+    }
+
+    const _mapped_t& _found(const_iterator _iter) const
+    {
+        if (_iter == cend())
+            throw std::out_of_range("the element with this key was not found");
+
+        return (*_iter).second;
+    }
+
+    // Returns the link of the chain referring to the specified node
+    uint32_t& _link_of(size_t _i, uint32_t _n) noexcept
+    {
+        uint32_t* link = &_m_buckets[_i];
+
+        while (*link != _n)
+            link = &_node(*link)._m_next;
+
+        return *link;
+    }
+
+    // Unlinks the node from the chain, its element remains constructed
+    void _unlink(size_t _i, uint32_t _n) noexcept
+    {
+        _link_of(_i, _n) = _node(_n)._m_next;
+        _m_count--;
+        _update_occupied(_i);
+    }
+
+    // Unlinks the node from the chain, destroys its element and returns the
+    // node to the list of free nodes
+    void _erase_node(size_t _i, uint32_t _n) noexcept
+    {
+        _unlink(_i, _n);
+        _node(_n).value().~_value_t();
+        _give_node(_n);
+    }
+
+    // Unlinks the node from the chain and returns the node handle owning
+    // its element
+    node_type _extract(size_t _i, uint32_t _n)
+    {
+        _node_t& node = _node(_n);
+        node_type handle(_allocator_t(_m_allocator), node._m_hash, _m_seed,
+            std::move(node.value()));
+
+        _erase_node(_i, _n);
+
+        return handle;
+    }
+
+    // Erases the element with the specified key and its hash value with the
+    // seed, returns the count of removed elements
+    size_t _erase_key(const _key_t& _key, size_t _hash)
+    {
+        size_t i = _bucket_index(_hash);
+        uint32_t n = _find_node(i, _key, _hash);
+
+        if (n == NIL)
+            return 0;
+
+        _erase_node(i, n);
+
+        return 1;
+    }
+
+    // Extracts the element with the specified key and its hash value with
+    // the seed, returns empty handle if there is no such element
+    node_type _extract_key(const _key_t& _key, size_t _hash)
+    {
+        size_t i = _bucket_index(_hash);
+        uint32_t n = _find_node(i, _key, _hash);
+
+        if (n == NIL)
+            return node_type();
+
+        return _extract(i, n);
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor with optional parameters
+    explicit CompactHashMap
+    (
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        _m_buckets(std::max(_count_buckets, size_t(MIN_COUNT_BUCKETS)),
+            uint32_t(NIL), _bucket_allocator_t(_allocator)),
+        _m_chunks(_chunk_allocator_t(_allocator)),
+        _m_used{0},
+        _m_free{NIL},
+        _m_count{0},
+        _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_min_load_factor{DEFAULT_MIN_LOAD_FACTOR},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal},
+        _m_allocator{_allocator},
+        _m_filter{},
+        _m_seed{_Random_seed()},
+        _m_reseed_count{0},
+        _m_occupied{_m_buckets.size()},
+        _m_first_bucket{_m_buckets.size()}
+    {}
+
+    // Constructor with the allocator parameter
+    explicit CompactHashMap(const _allocator_t& _alloc):
+        CompactHashMap(MIN_COUNT_BUCKETS, _hasher_t(), _key_equal_t(), _alloc)
+    {}
+
+    // Range-based constructor
+    template <class InputIterator>
+    explicit CompactHashMap
+    (
+        const InputIterator& begin, const InputIterator& end,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        CompactHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(begin, end);
+    }
+
+    // Copy constructor
+    CompactHashMap(const CompactHashMap& _other):
+        CompactHashMap(_other, _allocator_t(
+            _node_traits::select_on_container_copy_construction(
+            _other._m_allocator)))
+    {}
+
+    // Copy constuctor with allocator parameter
+    CompactHashMap(const CompactHashMap& _other, const _allocator_t& _alloc):
+        _m_buckets(_bucket_allocator_t(_alloc)),
+        _m_chunks(_chunk_allocator_t(_alloc)),
+        _m_used{0},
+        _m_free{NIL},
+        _m_count{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
+        _m_hasher{_other._m_hasher},
+        _m_key_equal{_other._m_key_equal},
+        _m_allocator{_alloc},
+        _m_filter{_other._m_filter},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{_other._m_occupied},
+        _m_first_bucket{_other._m_first_bucket}
+    {
+        try
+        {
+            _copy_nodes(_other);
+        }
+        catch (...)
+        {
+            _deallocate();
+            throw;
+        }
+    }
+
+    // Move constructor
+    CompactHashMap(CompactHashMap&& _other):
+        _m_buckets(_other._m_buckets.get_allocator()),
+        _m_chunks(_other._m_chunks.get_allocator()),
+        _m_used{0},
+        _m_free{NIL},
+        _m_count{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
+        _m_hasher{std::move(_other._m_hasher)},
+        _m_key_equal{std::move(_other._m_key_equal)},
+        _m_allocator{std::move(_other._m_allocator)},
+        _m_filter{std::move(_other._m_filter)},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{},
+        _m_first_bucket{0}
+    {
+        _take(_other);
+    }
+
+    // Move constuctor with allocator parameter
+    CompactHashMap(CompactHashMap&& _other, const _allocator_t& _alloc):
+        CompactHashMap(_other.buckets_count(), _other._m_hasher,
+            _other._m_key_equal, _alloc)
+    {
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_min_load_factor = _other._m_min_load_factor;
+        _m_filter = std::move(_other._m_filter);
+        _m_seed = _other._m_seed;
+        _m_reseed_count = _other._m_reseed_count;
+
+        // The nodes can be taken only if they can be released by the
+        // specified allocator, otherwise they are copied
+        if (_m_allocator == _other._m_allocator)
+        {
+            _deallocate();
+            _take(_other);
+        }
+        else
+        {
+            _deallocate();
+            _copy_nodes(_other);
+            _m_occupied = _other._m_occupied;
+            _m_first_bucket = _other._m_first_bucket;
+        }
+    }
+
+    // Constructor based on the initialization list
+    CompactHashMap
+    (
+        std::initializer_list<_value_t> _il,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        CompactHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(_il);
+    }
+
+    // Destructor
+    ~CompactHashMap()
+    { _deallocate(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Assigment operator
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assignment by copying
+    CompactHashMap& operator=(const CompactHashMap& _other)
+    {
+        if (this == &_other)
+            return *this;
+
+        CompactHashMap copy(_other, _allocator_t(_m_allocator));
+
+        return *this = std::move(copy);
+    }
+
+    // Assignment by moving
+    CompactHashMap& operator=(CompactHashMap&& _other) noexcept
+    {
+        if (this == &_other)
+            return *this;
+
+        _deallocate();
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_min_load_factor = _other._m_min_load_factor;
+        _m_hasher = std::move(_other._m_hasher);
+        _m_key_equal = std::move(_other._m_key_equal);
+        _m_allocator = std::move(_other._m_allocator);
+        _m_filter = std::move(_other._m_filter);
+        _m_seed = _other._m_seed;
+        _m_reseed_count = _other._m_reseed_count;
+        _take(_other);
+
+        return *this;
+    }
+
+    // Assignment based on the initialization list
+    CompactHashMap& operator=(std::initializer_list<_value_t> _il)
+    {
+        clear();
+        insert(_il);
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the container
+    iterator begin() noexcept
+    { return iterator(*this, _m_first_bucket); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator begin() const noexcept
+    { return const_iterator(*this, _m_first_bucket); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept
+    { return const_iterator(*this, _m_first_bucket); }
+    // Returns the iterator set to the end of the container
+    iterator end() noexcept
+    { return iterator(*this, _m_buckets.size(), NIL); }
+    // Returns the const iterator set to the end of the container
+    const_iterator end() const noexcept
+    { return const_iterator(*this, _m_buckets.size(), NIL); }
+    // Returns the const iterator set to the end of the container
+    const_iterator cend() const noexcept
+    { return const_iterator(*this, _m_buckets.size(), NIL); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_count; }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_count == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the handle of the specified key with its hash value without
+    // the seed
+    hashed_key hash_key(const _key_t& _key) const
+    { return hashed_key(_key, __hash_without_seed(_m_hasher, _key)); }
+
+    // Accessing an element by key and returning an iterator
+
+    iterator find(const _key_t& _key)
+    { return _find(_key, _hash(_key)); }
+
+    const_iterator find(const _key_t& _key) const
+    { return _find(_key, _hash(_key)); }
+
+    iterator find(const hashed_key& _hkey)
+    { return _find(_hkey.key(), _hash(_hkey)); }
+
+    const_iterator find(const hashed_key& _hkey) const
+    { return _find(_hkey.key(), _hash(_hkey)); }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const
+    { return find(_key) != cend(); }
+
+    size_t count(const hashed_key& _hkey) const
+    { return find(_hkey) != cend(); }
+
+    // Indexing operator
+
+    _mapped_t& operator[](const _key_t& _key)
+    {
+        size_t hash = _hash(_key);
+        iterator iter = _find(_key, hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+
+        // Otherwise, add it to containter
+        iter = _insert_new(hash, _key, _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    _mapped_t& operator[](_key_t&& _key)
+    {
+        size_t hash = _hash(_key);
+        iterator iter = _find(_key, hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+
+        // Otherwise, add it to containter
+        iter = _insert_new(hash, std::move(_key), _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    _mapped_t& operator[](const hashed_key& _hkey)
+    {
+        size_t hash = _hash(_hkey);
+        iterator iter = _find(_hkey.key(), hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+
+        // Otherwise, add it to containter
+        iter = _insert_new(hash, _hkey.key(), _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+
+    _mapped_t& at(const _key_t& _key)
+    { return _found(find(_key)); }
+
+    const _mapped_t& at(const _key_t& _key) const
+    { return _found(find(_key)); }
+
+    _mapped_t& at(const hashed_key& _hkey)
+    { return _found(find(_hkey)); }
+
+    const _mapped_t& at(const hashed_key& _hkey) const
+    { return _found(find(_hkey)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Insert operations
+
+    // Inserting a single element by copying
+    std::pair<iterator, bool> insert(const _value_t& _val)
+    {
+        size_t hash = _hash(_key_of(_val));
+        iterator iter = _find(_key_of(_val), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(_insert_new(hash, _val), true);
+    }
+
+    // Inserting a single element by moving
+    std::pair<iterator, bool> insert(_value_t&& _val)
+    {
+        size_t hash = _hash(_key_of(_val));
+        iterator iter = _find(_key_of(_val), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(_insert_new(hash, std::move(_val)), true);
+    }
+
+    // Inserting a single element with the prehashed key by copying
+    // the mapped value
+    std::pair<iterator, bool>
+    insert(const hashed_key& _hkey, const _mapped_t& _data)
+    {
+        size_t hash = _hash(_hkey);
+        iterator iter = _find(_hkey.key(), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(_insert_new(hash, _hkey.key(), _data), true);
+    }
+
+    // Inserting a single element with the prehashed key by moving
+    // the mapped value
+    std::pair<iterator, bool> insert(const hashed_key& _hkey, _mapped_t&& _data)
+    {
+        size_t hash = _hash(_hkey);
+        iterator iter = _find(_hkey.key(), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair
+        (
+            _insert_new(hash, _hkey.key(), std::move(_data)),
+            true
+        );
+    }
+
+    // Inserting a range of values
+    template <class InputIterator>
+    size_t insert(InputIterator _first, InputIterator _last)
+    {
+        size_t count = std::distance(_first, _last);
+
+        if (_load_factor(_m_count + count) > _m_max_load_factor)
+            reverse(_m_count + count);
+
+        size_t result = 0;
+        for (InputIterator iter = _first; iter != _last; iter++)
+            if (insert(*iter).second)
+                result++;
+
+        return result;
+    }
+
+    // Inserting an initialization list
+    size_t insert(std::initializer_list<_value_t> _il)
+    { return insert(_il.begin(), _il.end()); }
+
+    // Erase operations
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    { return _erase_key(_key, _hash(_key)); }
+
+    // Erase item from container by specified prehashed key
+    size_t erase(const hashed_key& _hkey)
+    { return _erase_key(_hkey.key(), _hash(_hkey)); }
+
+    // Erase item set by the iterator from container without the lookup
+    // of its key, returns the iterator following the removed item
+    iterator erase(const_iterator _pos)
+    {
+        size_t i = _pos.bucket();
+        uint32_t next = _next_of(_pos.node());
+
+        _erase_node(i, _pos.node());
+
+        if (next != NIL)
+            return iterator(*this, i, next);
+        else
+            return iterator(*this, i + 1);
+    }
+
+    iterator erase(iterator _pos)
+    { return erase(const_iterator(_pos)); }
+
+    // Erase items in the range [first, last) from container, returns the
+    // iterator following the last removed item
+    iterator erase(const_iterator _first, const_iterator _last)
+    {
+        while (_first != _last)
+            _first = erase(_first);
+
+        return iterator(*this, _last.bucket(), _last.node());
+    }
+
+    // Erase all items satisfying the predicate from container in a single
+    // pass over buckets, returns count of removed items
+    template <class _Predicate>
+    size_t erase_if(_Predicate _pred)
+    {
+        size_t count_removed = 0;
+
+        for (size_t i = 0; i < _m_buckets.size(); i++)
+        {
+            uint32_t* link = &_m_buckets[i];
+
+            while (*link != NIL)
+            {
+                uint32_t n = *link;
+                _node_t& node = _node(n);
+
+                if (!_pred(static_cast<const _value_t&>(node.value())))
+                {
+                    link = &node._m_next;
+                    continue;
+                }
+
+                *link = node._m_next;
+                node.value().~_value_t();
+                _give_node(n);
+                count_removed++;
+            }
+
+            _update_occupied(i);
+        }
+
+        _m_count -= count_removed;
+
+        // The filter is rebuilt by rehashing, otherwise it is compacted here
+        // to drop the bits of the removed keys
+        size_t count_buckets = _m_buckets.size();
+
+        if (_is_sparse())
+            reverse(_m_count * 2);
+
+        if (count_removed > 0 && count_buckets == _m_buckets.size())
+            _rebuild_filter();
+
+        return count_removed;
+    }
+
+    // Node operations
+
+    // Extracts the element by the specified key from the container and
+    // returns the node handle owning it, or empty handle if there is no
+    // such element
+    node_type extract(const _key_t& _key)
+    { return _extract_key(_key, _hash(_key)); }
+
+    // Extracts the element by the specified prehashed key from the container
+    node_type extract(const hashed_key& _hkey)
+    { return _extract_key(_hkey.key(), _hash(_hkey)); }
+
+    // Extracts the element set by the iterator from the container
+    node_type extract(const_iterator _pos)
+    { return _extract(_pos.bucket(), _pos.node()); }
+
+    node_type extract(iterator _pos)
+    { return extract(const_iterator(_pos)); }
+
+    // Inserts the element owned by the node handle. If the container already
+    // has the element with such key, the node handle is returned back. The
+    // element is moved to a node of the pool, the key is hashed again only
+    // if the node was extracted from the container with other seed
+    insert_return_type insert(node_type&& _node)
+    {
+        if (_node.empty())
+            return insert_return_type{end(), false, node_type()};
+
+        size_t hash = _node._m_seed == _m_seed ? _node._m_hash :
+            _hash(_node.key());
+        iterator iter = _find(_node.key(), hash);
+
+        if (iter != end())
+            return insert_return_type{iter, false, std::move(_node)};
+
+        iter = _insert_new(hash, std::move(_node.value()));
+        _node._reset();
+
+        return insert_return_type{iter, true, node_type()};
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified container, other elements remain in the source. The keys
+    // are hashed again only if the seeds of the containers differ
+    void merge(CompactHashMap& _source)
+    {
+        if (&_source == this)
+            return;
+
+        for (size_t i = 0; i < _source._m_buckets.size(); i++)
+        {
+            uint32_t* link = &_source._m_buckets[i];
+
+            while (*link != NIL)
+            {
+                uint32_t n = *link;
+                _node_t& node = _source._node(n);
+                size_t hash = _hash_from(_source._m_seed, node);
+
+                if (_find(_key_of(node.value()), hash) != end())
+                {
+                    link = &node._m_next;
+                    continue;
+                }
+
+                _insert_new(hash, std::move(node.value()));
+                _source._erase_node(i, n);
+            }
+        }
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified temporary container
+    void merge(CompactHashMap&& _source)
+    { merge(_source); }
+
+    // Moves all elements from the specified container. The mapped value of
+    // the element, whose key is already in the container, is combined with
+    // the source one as "value = _combine(value, source_value)". The keys
+    // are hashed again only if the seeds of the containers differ
+    template <class _Combine>
+    void merge(CompactHashMap& _source, _Combine _combine)
+    {
+        if (&_source == this)
+            return;
+
+        size_t count = _m_count + _source._m_count;
+
+        if (_load_factor(count) > _m_max_load_factor)
+            reverse(count);
+
+        for (size_t i = 0; i < _source._m_buckets.size(); i++)
+        {
+            while (_source._m_buckets[i] != NIL)
+            {
+                uint32_t n = _source._m_buckets[i];
+                _node_t& node = _source._node(n);
+                size_t hash = _hash_from(_source._m_seed, node);
+                iterator iter = _find(_key_of(node.value()), hash);
+
+                if (iter != end())
+                    (*iter).second = _combine((*iter).second,
+                        std::move(node.value().second));
+                else
+                    _insert_new(hash, std::move(node.value()));
+
+                _source._erase_node(i, n);
+            }
+        }
+    }
+
+    // Moves all elements from the specified temporary container combining
+    // the mapped values of the equal keys
+    template <class _Combine>
+    void merge(CompactHashMap&& _source, _Combine _combine)
+    { merge(_source, std::move(_combine)); }
+
+    // Clear the container
+    void clear()
+    {
+        _deallocate();
+
+        // The bucket array is replaced to release its capacity
+        _m_buckets = _table_t(MIN_COUNT_BUCKETS, uint32_t(NIL),
+            _m_buckets.get_allocator());
+        _m_occupied = __bucket_bitmap(MIN_COUNT_BUCKETS);
+        _m_first_bucket = MIN_COUNT_BUCKETS;
+        _rebuild_filter();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Bucket interface
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the begining of the specified bucket
+    bucket_iterator begin(size_t _n) noexcept
+    { return bucket_iterator(*this, _m_buckets[_n]); }
+    // Returns the const iterator set to the begining of the specified bucket
+    const_bucket_iterator begin(size_t _n) const noexcept
+    { return const_bucket_iterator(*this, _m_buckets[_n]); }
+    // Returns the const iterator set to the begining of the specified bucket
+    const_bucket_iterator cbegin(size_t _n) const noexcept
+    { return const_bucket_iterator(*this, _m_buckets[_n]); }
+    // Returns the iterator set to the end of the specified bucket
+    bucket_iterator end(size_t) noexcept
+    { return bucket_iterator(*this, NIL); }
+    // Returns the const iterator set to the end of the specified bucket
+    const_bucket_iterator end(size_t) const noexcept
+    { return const_bucket_iterator(*this, NIL); }
+    // Returns the const iterator set to the end of the specified bucket
+    const_bucket_iterator cend(size_t) const noexcept
+    { return const_bucket_iterator(*this, NIL); }
+
+    // Returns count of buckets in container
+    size_t buckets_count() const noexcept { return _m_buckets.size(); }
+    // Returns size of specified bucket
+    size_t bucket_size(size_t _n) const noexcept
+    { return std::distance(cbegin(_n), cend(_n)); }
+    // Returns number of bucket by specified key
+    size_t bucket(const _key_t& _key) const
+    { return _bucket_index(_hash(_key)); }
+    // Returns number of bucket by specified prehashed key
+    size_t bucket(const hashed_key& _hkey) const
+    { return _bucket_index(_hash(_hkey)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Hash policy
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the average number of elements per bucket
+    float load_factor() const noexcept
+    { return _load_factor(_m_count); }
+
+    // Returns current maximum load factor
+    float max_load_factor() const noexcept
+    { return _m_max_load_factor; }
+
+    // Set the maximum load factor to specified value
+    void max_load_factor(float _ml) noexcept
+    { _m_max_load_factor = _ml; }
+
+    // Returns current minimum load factor
+    float min_load_factor() const noexcept
+    { return _m_min_load_factor; }
+
+    // Set the minimum load factor to specified value, see HashMap
+    void min_load_factor(float _ml) noexcept
+    { _m_min_load_factor = _ml; }
+
+    // Sets the number of buckets to count and rehashes the container, the
+    // count is limited by the range of the 32-bit hash values
+    void rehash(size_t _count_buckets)
+    {
+        if (_count_buckets < MIN_COUNT_BUCKETS)
+            _count_buckets = MIN_COUNT_BUCKETS;
+
+        // If the new number of buckets makes load factor more than maximum
+        // load factor, then the new number of buckets is increased
+        if (_m_max_load_factor < ((float)_m_count / _count_buckets))
+            _count_buckets = _m_count / _m_max_load_factor;
+
+        if (_count_buckets > MAX_COUNT_BUCKETS)
+            _count_buckets = MAX_COUNT_BUCKETS;
+
+        if (_count_buckets == _m_buckets.size())
+            return;
+
+        _relink_nodes(_count_buckets);
+    }
+
+    // Sets the number of buckets to the number needed to accomodate at
+    // least count elements without exceeding maximum load factor and
+    // rehashes the container
+    void reverse(size_t _count)
+    { rehash(std::ceil((float)_count / _m_max_load_factor)); }
+
+    // Returns the seed of the hash values of the keys, see HashMap
+    size_t seed() const noexcept { return _m_seed; }
+
+    // Sets the seed of the hash values, hashes all the keys again and
+    // relinks the nodes to their new buckets
+    void reseed(size_t _seed)
+    {
+        _m_seed = _seed;
+
+        for (uint32_t head : _m_buckets)
+            for (uint32_t n = head; n != NIL; n = _node(n)._m_next)
+                _node(n)._m_hash = _short_hash(_hash(_key_of(
+                    _node(n).value())));
+
+        _relink_nodes(_m_buckets.size());
+    }
+
+    // Shrinks the bucket array to the minimum size for the current count
+    // of elements without exceeding maximum load factor and returns the
+    // cached unused memory of the allocator resource to its source. The
+    // chunks of the pool are kept for the following insertions
+    void shrink_to_fit()
+    {
+        reverse(_m_count);
+        __trim_allocator(_m_allocator, 0);
+    }
+
+    // Returns the estimate of the memory in bytes used by the container:
+    // the container object, the bucket array, the chunks of the pool, the
+    // occupancy bitmap and the filter. The memory owned by the elements
+    // themselves is not counted
+    size_t memory_usage() const noexcept
+    {
+        size_t count_nodes = 0;
+
+        for (size_t k = 0; k < _m_chunks.size(); k++)
+            count_nodes += _chunk_size(k);
+
+        return sizeof(*this) + _m_buckets.capacity() * sizeof(uint32_t) +
+            _m_chunks.capacity() * sizeof(_node_t*) +
+            count_nodes * sizeof(_node_t) +
+            _m_occupied.memory_usage() +
+            _m_filter.memory_usage();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Filter of the absent keys
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Enables the blocked Bloom filter built over the stored hash values,
+    // see HashMap
+    void enable_filter
+    (
+        float _bits_per_key = BlockedBloomFilter::DEFAULT_BITS_PER_KEY,
+        bool _is_collect_stats = false
+    )
+    {
+        _m_filter.enable(_bits_per_key, _is_collect_stats);
+        _rebuild_filter();
+    }
+
+    // Disables the filter and releases its memory
+    void disable_filter() { _m_filter.disable(); }
+
+    // Rebuilds the filter dropping the erased keys
+    void rebuild_filter() { _rebuild_filter(); }
+
+    // Checks that the filter is enabled
+    bool filter_enabled() const noexcept { return _m_filter.enabled(); }
+
+    // Returns the statistics of the filter
+    BlockedBloomFilter::stats_t filter_stats() const noexcept
+    { return _m_filter.stats(); }
+
+    // Resets the statistics of the filter
+    void reset_filter_stats() noexcept { _m_filter.reset_stats(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    // Returns the using allocator
+    _allocator_t get_allocator() const noexcept
+    { return _allocator_t(_m_allocator); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Node handle. It owns the element moved out of the pool
+    class node_type
+    {
+    private:
+        friend class CompactHashMap;
+
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_storage;    // Storage of element
+        bool _m_is_engaged;         // Whether the element is constructed
+        uint32_t _m_hash;           // Low 32 bits of the hash value
+        size_t _m_seed;             // Seed of the hash value
+        _allocator_t _m_allocator;  // Allocator of the container
+
+        // Constructor with the allocator, the hash value, the seed and the
+        // moved element
+        node_type
+        (
+            const _allocator_t& _alloc,
+            uint32_t _hash,
+            size_t _seed,
+            _value_t&& _value
+        ):
+            _m_is_engaged{false},
+            _m_hash{_hash},
+            _m_seed{_seed},
+            _m_allocator{_alloc}
+        {
+            new (&_m_storage) _value_t(std::move(_value));
+            _m_is_engaged = true;
+        }
+
+        // Destroys the owned element
+        void _reset() noexcept
+        {
+            if (_m_is_engaged)
+                value().~_value_t();
+
+            _m_is_engaged = false;
+        }
+
+    public:
+        // Default constructor
+        node_type(): _m_is_engaged{false}, _m_hash{0}, _m_seed{0} {}
+
+        // Move constructor
+        node_type(node_type&& _other):
+            _m_is_engaged{false},
+            _m_hash{_other._m_hash},
+            _m_seed{_other._m_seed},
+            _m_allocator{_other._m_allocator}
+        {
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+        }
+
+        // Destructor
+        ~node_type() { _reset(); }
+
+        // Assigment by moving
+        node_type& operator=(node_type&& _other)
+        {
+            if (this == &_other)
+                return *this;
+
+            _reset();
+            _m_hash = _other._m_hash;
+            _m_seed = _other._m_seed;
+            _m_allocator = _other._m_allocator;
+
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+
+            return *this;
+        }
+
+        // Checking the node handle for emptiness
+        bool empty() const noexcept { return !_m_is_engaged; }
+        explicit operator bool() const noexcept { return _m_is_engaged; }
+
+        // Returns the key of the owned element
+        const _key_t& key() const
+        { return _key_of(value()); }
+
+        // Returns the owned element
+        _value_t& value()
+        { return *reinterpret_cast<_value_t*>(&_m_storage); }
+        const _value_t& value() const
+        { return *reinterpret_cast<const _value_t*>(&_m_storage); }
+
+        // Returns the mapped value of the owned key-value pair
+        _mapped_t& mapped() { return value().second; }
+        const _mapped_t& mapped() const { return value().second; }
+
+        // Returns the allocator of the container
+        _allocator_t get_allocator() const
+        { return _m_allocator; }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Result of the node handle insertion
+    struct insert_return_type
+    {
+        iterator position;  // Inserted element or element with the same key
+        bool inserted;      // Whether the node has been inserted
+        node_type node;     // Node handle if it has not been inserted
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // CompactHashMap
+
+
+#endif  // _COMPACTHASHMAP_
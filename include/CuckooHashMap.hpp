@@ -0,0 +1,1244 @@
+// CuckooHashMap.hpp
+
+#ifndef _CUCKOOHASHMAP_
+#define _CUCKOOHASHMAP_
+
+
+#include <vector>
+#include <initializer_list>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <hash/hash.hpp>
+#include <hash/hash_functions.hpp>
+#include <SlotIterator.hpp>
+
+
+// Bucketized cuckoo hash table. Every key can be stored only in one of two
+// buckets of "_Ways" slots, so the lookup reads at most two buckets and the
+// stash if it is not empty. The buckets are aligned to the cache line. The
+// first bucket is chosen by the tag of the key and the second one by double
+// probing with the second hash value mixed from the tag. The keys with
+// equal tags have the same pair of buckets, so the hasher must not collide
+// too often.
+//
+// If both buckets of the new key are full, the shortest path of relocations
+// to a free slot is found by the breadth-first search over the alternative
+// buckets of the stored elements. If there is no such path, the loaded table
+// is grown once, otherwise the element is put to the small stash after the
+// buckets, since the growth does not separate the keys with equal tags. The
+// full stash throws std::length_error. The 32-bit tags folded from the hash
+// values are stored in the slots and the buckets are chosen by the tags, so
+// the relocations and the rehashing do not call the hasher. A bucket takes
+// a single cache line if "_Ways * (sizeof(_value_t) + 4)" does not exceed
+// 64 bytes
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<std::pair<const _Key, _Data>>,
+    size_t _Ways = 4
+>
+class CuckooHashMap
+{
+    static_assert(_Ways > 0 && _Ways <= 8, "the count of slots in a bucket "
+        "must be from 1 to 8");
+
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<const _Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+    using _allocator_t   = _Allocator;
+
+    using iterator = __slot_iterator<CuckooHashMap, _value_t>;
+    using const_iterator
+        = __slot_iterator<const CuckooHashMap, const _value_t>;
+    class node_type;
+    struct insert_return_type;
+
+    // Key together with its hash value, see HashMap::hashed_key
+    class hashed_key
+    {
+    private:
+        const _key_t* _m_key_ptr;   // Pointer to the key
+        size_t _m_hash;             // Hash value of the key
+
+    public:
+        // Constructor with the key and its hash value
+        hashed_key(const _key_t& _key, size_t _hash) noexcept:
+            _m_key_ptr{&_key},
+            _m_hash{_hash}
+        {}
+
+        // Returns the key
+        const _key_t& key() const noexcept { return *_m_key_ptr; }
+        // Returns the hash value of the key
+        size_t hash() const noexcept { return _m_hash; }
+    };
+
+protected:
+    template <class, class> friend class __slot_iterator;
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t MIN_COUNT_BUCKETS = 2;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.9f;
+    // Max count of buckets visited by the search of the relocation path
+    static constexpr size_t MAX_SEARCH_BUCKETS = 128;
+    // The table without the relocation path is grown only if its load factor
+    // exceeds this part of the max load factor
+    static constexpr float GROW_LOAD_PART = 0.5f;
+    // Count of the slots of the stash for the keys without the relocation
+    // path, the stash takes the whole buckets after the table ones
+    static constexpr size_t STASH_SLOTS = 8;
+    static constexpr size_t STASH_BUCKETS = (STASH_SLOTS + _Ways - 1) / _Ways;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    // Bucket aligned to the cache line. The slots are marked by the tags
+    // folded from the hash values of their keys, the high bit of the tag is
+    // set in the occupied slots. The tags are placed before the elements,
+    // so the lookup compares the elements only for the matching tags
+    struct alignas(CACHE_LINE_SIZE) _bucket_t
+    {
+        uint32_t _m_tags[_Ways];    // Tags of the slots, 0 if slot is free
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_values[_Ways];  // Elements
+
+        // Returns the element stored in the slot
+        _value_t& value(size_t _j) noexcept
+        { return *reinterpret_cast<_value_t*>(&_m_values[_j]); }
+        const _value_t& value(size_t _j) const noexcept
+        { return *reinterpret_cast<const _value_t*>(&_m_values[_j]); }
+    };
+
+    static constexpr uint32_t OCCUPIED_BIT = 0x80000000u;
+
+    // Node of the search of the relocation path
+    struct _path_node_t
+    {
+        size_t _m_bucket;   // Index of the bucket
+        size_t _m_parent;   // Index of the previous node of the path
+        size_t _m_slot;     // Slot of the previous bucket, whose element is
+                            // moved to this bucket
+    };
+
+    using _alloc_traits = std::allocator_traits<_allocator_t>;
+    using _byte_allocator_t
+        = typename _alloc_traits::template rebind_alloc<char>;
+    using _byte_traits = std::allocator_traits<_byte_allocator_t>;
+
+    char* _m_memory;                    // Memory of the buckets
+    _bucket_t* _m_buckets;              // Aligned buckets
+    size_t _m_count_buckets;            // Count of buckets
+    size_t _m_count;                    // Count of items in map
+    size_t _m_count_stashed;            // Count of items in the stash
+    float _m_max_load_factor;           // Max load factor of the slots
+    _hasher_t _m_hasher;                // Hasher functor
+    _key_equal_t _m_key_equal;          // Key equal functor
+    _byte_allocator_t _m_allocator;     // Allocator of the buckets
+
+    // Interface of the slot iterator
+
+    size_t _slot_count() const noexcept
+    {
+        return _m_memory == nullptr ? 0 :
+            (_m_count_buckets + STASH_BUCKETS) * _Ways;
+    }
+
+    bool _is_occupied(size_t _i) const noexcept
+    { return _m_buckets[_i / _Ways]._m_tags[_i % _Ways] != 0; }
+
+    _value_t& _value_at(size_t _i) noexcept
+    { return _m_buckets[_i / _Ways].value(_i % _Ways); }
+
+    const _value_t& _value_at(size_t _i) const noexcept
+    { return _m_buckets[_i / _Ways].value(_i % _Ways); }
+
+    // Returns the size of the memory of the specified count of buckets
+    // including the stash and the space for their alignment
+    static size_t _memory_size(size_t _count_buckets) noexcept
+    {
+        return (_count_buckets + STASH_BUCKETS) * sizeof(_bucket_t) +
+            CACHE_LINE_SIZE - 1;
+    }
+
+    // Allocates the specified count of empty buckets and the empty stash
+    void _allocate(size_t _count_buckets)
+    {
+        _m_memory = _byte_traits::allocate(_m_allocator,
+            _memory_size(_count_buckets));
+
+        uintptr_t addr = reinterpret_cast<uintptr_t>(_m_memory);
+        addr = (addr + CACHE_LINE_SIZE - 1) &
+            ~static_cast<uintptr_t>(CACHE_LINE_SIZE - 1);
+
+        _m_buckets = reinterpret_cast<_bucket_t*>(addr);
+        _m_count_buckets = _count_buckets;
+        _m_count_stashed = 0;
+
+        for (size_t i = 0; i < _count_buckets + STASH_BUCKETS; i++)
+            for (size_t j = 0; j < _Ways; j++)
+                _m_buckets[i]._m_tags[j] = 0;
+    }
+
+    // Destroys the elements and releases the buckets
+    void _deallocate() noexcept
+    {
+        if (_m_memory == nullptr)
+            return;
+
+        for (size_t i = 0; i < _slot_count(); i++)
+            if (_is_occupied(i))
+                _value_at(i).~_value_t();
+
+        _byte_traits::deallocate(_m_allocator, _m_memory,
+            _memory_size(_m_count_buckets));
+
+        _m_memory = nullptr;
+        _m_buckets = nullptr;
+        _m_count_buckets = 0;
+        _m_count = 0;
+        _m_count_stashed = 0;
+    }
+
+    // Copies the elements of the other container to the same slots
+    void _copy_slots(const CuckooHashMap& _other)
+    {
+        _allocate(_other._m_count_buckets);
+        _m_count_stashed = _other._m_count_stashed;
+
+        for (size_t i = 0; i < _m_count_buckets + STASH_BUCKETS; i++)
+            for (size_t j = 0; j < _Ways; j++)
+                if (_other._m_buckets[i]._m_tags[j] != 0)
+                {
+                    new (&_m_buckets[i]._m_values[j])
+                        _value_t(_other._m_buckets[i].value(j));
+                    _m_buckets[i]._m_tags[j] = _other._m_buckets[i]._m_tags[j];
+                    _m_count++;
+                }
+    }
+
+    // Takes the buckets of the other container
+    void _take(CuckooHashMap& _other) noexcept
+    {
+        _m_memory = _other._m_memory;
+        _m_buckets = _other._m_buckets;
+        _m_count_buckets = _other._m_count_buckets;
+        _m_count = _other._m_count;
+        _m_count_stashed = _other._m_count_stashed;
+
+        _other._m_memory = nullptr;
+        _other._m_buckets = nullptr;
+        _other._m_count_buckets = 0;
+        _other._m_count = 0;
+        _other._m_count_stashed = 0;
+    }
+
+    // Returns the tag of the hash value. The hash value is mixed, since the
+    // hash values of integers are the integers themselves and the buckets
+    // of the regular keys would collide
+    static uint32_t _tag_of(size_t _hash) noexcept
+    {
+        uint64_t mixed = static_cast<uint64_t>(_hash);
+
+        mixed ^= mixed >> 33;
+        mixed *= 0xFF51AFD7ED558CCDull;
+        mixed ^= mixed >> 33;
+        mixed *= 0xC4CEB9FE1A85EC53ull;
+        mixed ^= mixed >> 33;
+
+        return static_cast<uint32_t>(mixed) | OCCUPIED_BIT;
+    }
+
+    // Returns the first bucket of the tag
+    size_t _first_bucket(uint32_t _tag) const noexcept
+    { return mod_hash(_tag, _m_count_buckets); }
+
+    // Returns the second bucket of the tag
+    size_t _second_bucket(uint32_t _tag) const noexcept
+    {
+        // The second hash value is taken from the high bits of the tag
+        // multiplied by the golden ratio, since they depend on all bits of
+        // the tag, while the first bucket depends on its low bits
+        size_t other_hash = static_cast<size_t>((static_cast<uint64_t>(_tag)
+            * 0x9E3779B97F4A7C15ull) >> 32) | 1;
+        size_t first = _first_bucket(_tag);
+        size_t bucket = double_probing(first, other_hash, 1, _m_count_buckets);
+
+        if (bucket == first)
+            bucket = (bucket + 1) % _m_count_buckets;
+
+        return bucket;
+    }
+
+    // Returns the other bucket of the element stored in the specified one
+    size_t _alternative_bucket(size_t _bucket, uint32_t _tag) const noexcept
+    {
+        size_t first = _first_bucket(_tag);
+
+        return _bucket == first ? _second_bucket(_tag) : first;
+    }
+
+    // Returns the index of the slot with the key in the bucket or NPOS
+    size_t _find_in_bucket(size_t _bucket, uint32_t _tag,
+        const _key_t& _key) const
+    {
+        const _bucket_t& bucket = _m_buckets[_bucket];
+
+        for (size_t j = 0; j < _Ways; j++)
+            if
+            (
+                bucket._m_tags[j] == _tag &&
+                _m_key_equal(_key, bucket.value(j).first)
+            )
+                return _bucket * _Ways + j;
+
+        return NPOS;
+    }
+
+    // Returns the index of the slot with the key or NPOS, the stash is
+    // searched only if it is not empty
+    size_t _find_slot(const hashed_key& _hkey) const
+    {
+        uint32_t tag = _tag_of(_hkey.hash());
+        size_t i = _find_in_bucket(_first_bucket(tag), tag, _hkey.key());
+
+        if (i == NPOS)
+            i = _find_in_bucket(_second_bucket(tag), tag, _hkey.key());
+
+        for (size_t k = 0; i == NPOS && _m_count_stashed > 0 &&
+            k < STASH_BUCKETS; k++)
+            i = _find_in_bucket(_m_count_buckets + k, tag, _hkey.key());
+
+        return i;
+    }
+
+    // Returns the stash bucket with a free slot or NPOS if it is full
+    size_t _stash_room() const noexcept
+    {
+        for (size_t k = 0; k < STASH_BUCKETS; k++)
+            if (_free_slot(_m_count_buckets + k) != NPOS)
+                return _m_count_buckets + k;
+
+        return NPOS;
+    }
+
+    // Returns the index of the first free slot of the bucket or NPOS
+    size_t _free_slot(size_t _bucket) const noexcept
+    {
+        for (size_t j = 0; j < _Ways; j++)
+            if (_m_buckets[_bucket]._m_tags[j] == 0)
+                return j;
+
+        return NPOS;
+    }
+
+    // Moves the element from the slot to the free slot of other bucket
+    void _relocate(size_t _from_bucket, size_t _from_slot, size_t _to_bucket)
+    {
+        size_t to_slot = _free_slot(_to_bucket);
+        _bucket_t& from = _m_buckets[_from_bucket];
+        _bucket_t& to = _m_buckets[_to_bucket];
+
+        new (&to._m_values[to_slot])
+            _value_t(std::move(from.value(_from_slot)));
+        to._m_tags[to_slot] = from._m_tags[_from_slot];
+
+        from.value(_from_slot).~_value_t();
+        from._m_tags[_from_slot] = 0;
+    }
+
+    // Finds the shortest path of relocations from one of the buckets of the
+    // tag to a free slot and moves the elements along it. Returns the bucket
+    // with the freed slot or NPOS if there is no such path
+    size_t _make_room(uint32_t _tag)
+    {
+        std::vector<_path_node_t> queue;
+
+        queue.reserve(MAX_SEARCH_BUCKETS + _Ways);
+        queue.push_back(_path_node_t{_first_bucket(_tag), NPOS, 0});
+        queue.push_back(_path_node_t{_second_bucket(_tag), NPOS, 0});
+
+        for (size_t i = 0; i < queue.size(); i++)
+        {
+            size_t bucket = queue[i]._m_bucket;
+
+            if (_free_slot(bucket) != NPOS)
+            {
+                // The elements are moved from the end of the path, so every
+                // element is moved to the just freed slot
+                size_t node = i;
+
+                while (queue[node]._m_parent != NPOS)
+                {
+                    const _path_node_t& path_node = queue[node];
+
+                    _relocate(queue[path_node._m_parent]._m_bucket,
+                        path_node._m_slot, path_node._m_bucket);
+                    node = path_node._m_parent;
+                }
+
+                return queue[node]._m_bucket;
+            }
+
+            if (queue.size() >= MAX_SEARCH_BUCKETS)
+                continue;
+
+            for (size_t j = 0; j < _Ways; j++)
+            {
+                size_t next = _alternative_bucket(bucket,
+                    _m_buckets[bucket]._m_tags[j]);
+
+                // The bucket can appear only once in the path, otherwise
+                // the slots of the path would be changed by its own moves
+                bool is_in_path = false;
+                for (size_t k = i; k != NPOS; k = queue[k]._m_parent)
+                    if (queue[k]._m_bucket == next)
+                    {
+                        is_in_path = true;
+                        break;
+                    }
+
+                if (!is_in_path)
+                    queue.push_back(_path_node_t{next, i, j});
+            }
+        }
+
+        return NPOS;
+    }
+
+    // Adds a new element with the specified tag to the container without
+    // checking for its presence, returns the index of its slot
+    template <class... _Args>
+    size_t _insert_tagged(uint32_t _tag, _Args&&... _args)
+    {
+        if (_m_count + 1 > _m_count_buckets * _Ways * _m_max_load_factor)
+            rehash(_m_count_buckets * 2);
+
+        size_t bucket = _make_room(_tag);
+
+        // There is no relocation path. It is looked for again in the grown
+        // table only if the table is loaded, otherwise the keys collide and
+        // the growth does not separate them
+        if (bucket == NPOS && _m_count + 1 >
+            _m_count_buckets * _Ways * _m_max_load_factor * GROW_LOAD_PART)
+        {
+            rehash(_m_count_buckets * 2);
+            bucket = _make_room(_tag);
+        }
+
+        bool is_stashed = bucket == NPOS;
+
+        if (is_stashed)
+            bucket = _stash_room();
+
+        if (bucket == NPOS)
+            throw std::length_error("too many keys of the cuckoo hash map "
+                "have colliding hash values");
+
+        size_t j = _free_slot(bucket);
+
+        new (&_m_buckets[bucket]._m_values[j])
+            _value_t(std::forward<_Args>(_args)...);
+        _m_buckets[bucket]._m_tags[j] = _tag;
+        _m_count++;
+        _m_count_stashed += is_stashed;
+
+        return bucket * _Ways + j;
+    }
+
+    // Adds a new element with the specified hash value of the key to the
+    // container without checking for its presence, returns the index of its
+    // slot
+    template <class... _Args>
+    size_t _insert_new(size_t _hash, _Args&&... _args)
+    { return _insert_tagged(_tag_of(_hash), std::forward<_Args>(_args)...); }
+
+    // Removes the element from the slot
+    void _erase_slot(size_t _i) noexcept
+    {
+        _bucket_t& bucket = _m_buckets[_i / _Ways];
+
+        bucket.value(_i % _Ways).~_value_t();
+        bucket._m_tags[_i % _Ways] = 0;
+        _m_count--;
+        _m_count_stashed -= _i >= _m_count_buckets * _Ways;
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor with optional parameters
+    explicit CuckooHashMap
+    (
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        _m_memory{nullptr},
+        _m_buckets{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_count_stashed{0},
+        _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal},
+        _m_allocator{_allocator}
+    {
+        _allocate(_count_buckets > MIN_COUNT_BUCKETS ?
+            _count_buckets : MIN_COUNT_BUCKETS);
+    }
+
+    // Constructor with the allocator parameter
+    explicit CuckooHashMap(const _allocator_t& _alloc):
+        CuckooHashMap(MIN_COUNT_BUCKETS, _hasher_t(), _key_equal_t(), _alloc)
+    {}
+
+    // Range-based constructor
+    template <class InputIterator>
+    explicit CuckooHashMap
+    (
+        const InputIterator& begin, const InputIterator& end,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        CuckooHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(begin, end);
+    }
+
+    // Copy constructor
+    CuckooHashMap(const CuckooHashMap& _other):
+        _m_memory{nullptr},
+        _m_buckets{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_count_stashed{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_hasher{_other._m_hasher},
+        _m_key_equal{_other._m_key_equal},
+        _m_allocator{_byte_traits::select_on_container_copy_construction(
+            _other._m_allocator)}
+    {
+        _copy_slots(_other);
+    }
+
+    // Move constructor
+    CuckooHashMap(CuckooHashMap&& _other):
+        _m_memory{nullptr},
+        _m_buckets{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_count_stashed{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_hasher{std::move(_other._m_hasher)},
+        _m_key_equal{std::move(_other._m_key_equal)},
+        _m_allocator{std::move(_other._m_allocator)}
+    {
+        // The source is left empty with the minimum buckets
+        _take(_other);
+        _other._allocate(MIN_COUNT_BUCKETS);
+    }
+
+    // Constructor based on the initialization list
+    CuckooHashMap
+    (
+        std::initializer_list<_value_t> _il,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        CuckooHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(_il);
+    }
+
+    // Destructor
+    ~CuckooHashMap()
+    { _deallocate(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Assigment operator
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assignment by copying
+    CuckooHashMap& operator=(const CuckooHashMap& _other)
+    {
+        if (this == &_other)
+            return *this;
+
+        _deallocate();
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_hasher = _other._m_hasher;
+        _m_key_equal = _other._m_key_equal;
+        _copy_slots(_other);
+
+        return *this;
+    }
+
+    // Assignment by moving
+    CuckooHashMap& operator=(CuckooHashMap&& _other) noexcept
+    {
+        if (this == &_other)
+            return *this;
+
+        _deallocate();
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_hasher = std::move(_other._m_hasher);
+        _m_key_equal = std::move(_other._m_key_equal);
+        _m_allocator = std::move(_other._m_allocator);
+        _take(_other);
+        _other._allocate(MIN_COUNT_BUCKETS);
+
+        return *this;
+    }
+
+    // Assignment based on the initialization list
+    CuckooHashMap& operator=(std::initializer_list<_value_t> _il)
+    {
+        clear();
+        insert(_il);
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the container
+    iterator begin() noexcept { return iterator(*this, 0); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator begin() const noexcept { return const_iterator(*this, 0); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept { return const_iterator(*this, 0); }
+    // Returns the iterator set to the end of the container
+    iterator end() noexcept { return iterator(*this, _slot_count()); }
+    // Returns the const iterator set to the end of the container
+    const_iterator end() const noexcept
+    { return const_iterator(*this, _slot_count()); }
+    // Returns the const iterator set to the end of the container
+    const_iterator cend() const noexcept
+    { return const_iterator(*this, _slot_count()); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_count; }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_count == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the handle of the specified key with its computed hash value
+    hashed_key hash_key(const _key_t& _key) const
+    { return hashed_key(_key, _m_hasher(_key)); }
+
+    // Accessing an element by key and returning an iterator
+
+    iterator find(const _key_t& _key) noexcept
+    { return find(hash_key(_key)); }
+
+    const_iterator find(const _key_t& _key) const noexcept
+    { return find(hash_key(_key)); }
+
+    iterator find(const hashed_key& _hkey) noexcept
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? iterator(*this, i) : end();
+    }
+
+    const_iterator find(const hashed_key& _hkey) const noexcept
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? const_iterator(*this, i) : cend();
+    }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const noexcept
+    { return _find_slot(hash_key(_key)) != NPOS; }
+
+    size_t count(const hashed_key& _hkey) const noexcept
+    { return _find_slot(_hkey) != NPOS; }
+
+    // Indexing operator
+
+    _mapped_t& operator[](const _key_t& _key)
+    { return (*this)[hash_key(_key)]; }
+
+    _mapped_t& operator[](_key_t&& _key)
+    {
+        size_t hash = _m_hasher(_key);
+        size_t i = _find_slot(hashed_key(_key, hash));
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            i = _insert_new(hash, std::move(_key), _mapped_t{});
+
+        return _value_at(i).second;
+    }
+
+    _mapped_t& operator[](const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            i = _insert_new(_hkey.hash(), _hkey.key(), _mapped_t{});
+
+        return _value_at(i).second;
+    }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+
+    _mapped_t& at(const _key_t& _key)
+    { return at(hash_key(_key)); }
+
+    const _mapped_t& at(const _key_t& _key) const
+    { return at(hash_key(_key)); }
+
+    _mapped_t& at(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _value_at(i).second;
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    const _mapped_t& at(const hashed_key& _hkey) const
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _value_at(i).second;
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Insert operations
+
+    // Inserting a single element by copying
+    std::pair<iterator, bool> insert(const _value_t& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(iterator(*this, _insert_new(hash, _val)), true);
+    }
+
+    // Inserting a single element by moving
+    std::pair<iterator, bool> insert(_value_t&& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(hash, std::move(_val));
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a single element with the prehashed key by copying
+    // the mapped value
+    std::pair<iterator, bool>
+    insert(const hashed_key& _hkey, const _mapped_t& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(_hkey.hash(), _hkey.key(), _data);
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a single element with the prehashed key by moving
+    // the mapped value
+    std::pair<iterator, bool> insert(const hashed_key& _hkey, _mapped_t&& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(_hkey.hash(), _hkey.key(), std::move(_data));
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a range of values
+    template <class InputIterator>
+    size_t insert(InputIterator _first, InputIterator _last)
+    {
+        reverse(_m_count + std::distance(_first, _last));
+
+        size_t result = 0;
+        for (InputIterator iter = _first; iter != _last; iter++)
+            if (insert(*iter).second)
+                result++;
+
+        return result;
+    }
+
+    // Inserting an initialization list
+    size_t insert(std::initializer_list<_value_t> _il)
+    { return insert(_il.begin(), _il.end()); }
+
+    // Erase operations
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    { return erase(hash_key(_key)); }
+
+    // Erase item from container by specified prehashed key
+    size_t erase(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i == NPOS)
+            return 0;
+
+        _erase_slot(i);
+
+        return 1;
+    }
+
+    // Erase item set by the iterator from container without the lookup
+    // of its key, returns the iterator following the removed item
+    iterator erase(const_iterator _pos)
+    {
+        _erase_slot(_pos.index());
+
+        return iterator(*this, _pos.index() + 1);
+    }
+
+    iterator erase(iterator _pos)
+    { return erase(const_iterator(_pos)); }
+
+    // Erase items in the range [first, last) from container, returns the
+    // iterator following the last removed item. The elements are never
+    // moved by the erasure, so the range is a range of the slots
+    iterator erase(const_iterator _first, const_iterator _last)
+    {
+        for (size_t i = _first.index(); i < _last.index(); i++)
+            if (_is_occupied(i))
+                _erase_slot(i);
+
+        return iterator(*this, _last.index());
+    }
+
+    // Erase all items satisfying the predicate from container in a single
+    // pass over the slots, returns count of removed items
+    template <class _Predicate>
+    size_t erase_if(_Predicate _pred)
+    {
+        size_t count_removed = 0;
+
+        for (size_t i = 0; i < _slot_count(); i++)
+            if
+            (
+                _is_occupied(i) &&
+                _pred(static_cast<const _value_t&>(_value_at(i)))
+            )
+            {
+                _erase_slot(i);
+                count_removed++;
+            }
+
+        return count_removed;
+    }
+
+    // Node operations
+
+    // Extracts the element by the specified key from the container and
+    // returns the node handle owning it, or empty handle if there is no
+    // such element
+    node_type extract(const _key_t& _key)
+    { return extract(hash_key(_key)); }
+
+    // Extracts the element by the specified prehashed key from the container
+    node_type extract(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i == NPOS)
+            return node_type();
+
+        return extract(const_iterator(*this, i));
+    }
+
+    // Extracts the element set by the iterator from the container
+    node_type extract(const_iterator _pos)
+    {
+        node_type handle(_allocator_t(_m_allocator),
+            std::move(_value_at(_pos.index())));
+
+        _erase_slot(_pos.index());
+
+        return handle;
+    }
+
+    node_type extract(iterator _pos)
+    { return extract(const_iterator(_pos)); }
+
+    // Inserts the element owned by the node handle. If the container already
+    // has the element with such key, the node handle is returned back
+    insert_return_type insert(node_type&& _node)
+    {
+        if (_node.empty())
+            return insert_return_type{end(), false, node_type()};
+
+        size_t hash = _m_hasher(_node.key());
+        size_t i = _find_slot(hashed_key(_node.key(), hash));
+
+        if (i != NPOS)
+            return insert_return_type{iterator(*this, i), false,
+                std::move(_node)};
+
+        i = _insert_new(hash, std::move(_node.value()));
+        _node._reset();
+
+        return insert_return_type{iterator(*this, i), true, node_type()};
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified container, other elements remain in the source
+    void merge(CuckooHashMap& _source)
+    {
+        if (&_source == this)
+            return;
+
+        for (size_t i = 0; i < _source._slot_count(); i++)
+        {
+            if (!_source._is_occupied(i))
+                continue;
+
+            _value_t& val = _source._value_at(i);
+            size_t hash = _m_hasher(val.first);
+
+            if (_find_slot(hashed_key(val.first, hash)) != NPOS)
+                continue;
+
+            _insert_new(hash, std::move(val));
+            _source._erase_slot(i);
+        }
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified temporary container
+    void merge(CuckooHashMap&& _source)
+    { merge(_source); }
+
+    // Moves all elements from the specified container. The mapped value of
+    // the element, whose key is already in the container, is combined with
+    // the source one as "value = _combine(value, source_value)"
+    template <class _Combine>
+    void merge(CuckooHashMap& _source, _Combine _combine)
+    {
+        if (&_source == this)
+            return;
+
+        reverse(_m_count + _source._m_count);
+
+        for (size_t i = 0; i < _source._slot_count(); i++)
+        {
+            if (!_source._is_occupied(i))
+                continue;
+
+            _value_t& val = _source._value_at(i);
+            size_t hash = _m_hasher(val.first);
+            size_t j = _find_slot(hashed_key(val.first, hash));
+
+            if (j != NPOS)
+                _value_at(j).second = _combine(_value_at(j).second,
+                    std::move(val.second));
+            else
+                _insert_new(hash, std::move(val));
+
+            _source._erase_slot(i);
+        }
+    }
+
+    // Moves all elements from the specified temporary container combining
+    // the mapped values of the equal keys
+    template <class _Combine>
+    void merge(CuckooHashMap&& _source, _Combine _combine)
+    { merge(_source, std::move(_combine)); }
+
+    // Clear the container
+    void clear()
+    {
+        _deallocate();
+        _allocate(MIN_COUNT_BUCKETS);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Bucket interface
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns count of buckets
+    size_t buckets_count() const noexcept { return _m_count_buckets; }
+    // Returns count of slots in a bucket
+    static constexpr size_t bucket_ways() noexcept { return _Ways; }
+
+    // Returns count of items in the specified bucket
+    size_t bucket_size(size_t _n) const noexcept
+    {
+        size_t count = 0;
+
+        for (size_t j = 0; j < _Ways; j++)
+            count += _m_buckets[_n]._m_tags[j] != 0;
+
+        return count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Hash policy
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the ratio of the count of items to the count of slots
+    float load_factor() const noexcept
+    { return (float)_m_count / (_m_count_buckets * _Ways); }
+
+    // Returns max load factor
+    float max_load_factor() const noexcept
+    { return _m_max_load_factor; }
+
+    // Sets max load factor, which can not exceed 1
+    void max_load_factor(float _ml) noexcept
+    { _m_max_load_factor = _ml < 1.0f ? _ml : 1.0f; }
+
+    // Sets the number of buckets to the specified one, if it does not
+    // makes load factor more than maximum load factor, and moves the
+    // elements to the new buckets using their stored hash values
+    void rehash(size_t _count_buckets)
+    {
+        size_t min_count_buckets = std::ceil((float)_m_count /
+            (_m_max_load_factor * _Ways));
+
+        if (_count_buckets < min_count_buckets)
+            _count_buckets = min_count_buckets;
+
+        if (_count_buckets < MIN_COUNT_BUCKETS)
+            _count_buckets = MIN_COUNT_BUCKETS;
+
+        if (_count_buckets == _m_count_buckets)
+            return;
+
+        CuckooHashMap old(0, _m_hasher, _m_key_equal, _m_allocator);
+
+        old._deallocate();
+        old._take(*this);
+        _allocate(_count_buckets);
+
+        // The insertion can grow the new table again, the remaining
+        // elements are kept in the old one
+        for (size_t i = 0; i < old._slot_count(); i++)
+            if (old._is_occupied(i))
+            {
+                _bucket_t& bucket = old._m_buckets[i / _Ways];
+
+                _insert_tagged(bucket._m_tags[i % _Ways],
+                    std::move(bucket.value(i % _Ways)));
+                old._erase_slot(i);
+            }
+    }
+
+    // Sets the number of buckets to the number needed to accomodate at
+    // least count elements without exceeding maximum load factor and
+    // rehashes the container
+    void reverse(size_t _count)
+    {
+        size_t count_buckets = std::ceil((float)_count /
+            (_m_max_load_factor * _Ways));
+
+        if (count_buckets > _m_count_buckets)
+            rehash(count_buckets);
+    }
+
+    // Returns the estimate of the memory in bytes used by the container
+    size_t memory_usage() const noexcept
+    { return sizeof(*this) + _memory_size(_m_count_buckets); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare the keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    // Returns the allocator associated with the container
+    _allocator_t get_allocator() const noexcept
+    { return _allocator_t(_m_allocator); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Node handle. It owns the element moved out of the slot
+    class node_type
+    {
+    private:
+        friend class CuckooHashMap;
+
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_storage;    // Storage of element
+        bool _m_is_engaged;         // Whether the element is constructed
+        _allocator_t _m_allocator;  // Allocator of the container
+
+        // Constructor with the allocator and the moved element
+        node_type(const _allocator_t& _alloc, _value_t&& _value):
+            _m_is_engaged{false},
+            _m_allocator{_alloc}
+        {
+            new (&_m_storage) _value_t(std::move(_value));
+            _m_is_engaged = true;
+        }
+
+        // Destroys the owned element
+        void _reset() noexcept
+        {
+            if (_m_is_engaged)
+                value().~_value_t();
+
+            _m_is_engaged = false;
+        }
+
+    public:
+        // Default constructor
+        node_type(): _m_is_engaged{false} {}
+
+        // Move constructor
+        node_type(node_type&& _other):
+            _m_is_engaged{false},
+            _m_allocator{_other._m_allocator}
+        {
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+        }
+
+        // Destructor
+        ~node_type() { _reset(); }
+
+        // Assigment by moving
+        node_type& operator=(node_type&& _other)
+        {
+            if (this == &_other)
+                return *this;
+
+            _reset();
+            _m_allocator = _other._m_allocator;
+
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+
+            return *this;
+        }
+
+        // Checking the node handle for emptiness
+        bool empty() const noexcept { return !_m_is_engaged; }
+        explicit operator bool() const noexcept { return _m_is_engaged; }
+
+        // Returns the key of the owned element
+        const _key_t& key() const
+        { return value().first; }
+
+        // Returns the owned element
+        _value_t& value()
+        { return *reinterpret_cast<_value_t*>(&_m_storage); }
+        const _value_t& value() const
+        { return *reinterpret_cast<const _value_t*>(&_m_storage); }
+
+        // Returns the mapped value of the owned key-value pair
+        _mapped_t& mapped() { return value().second; }
+        const _mapped_t& mapped() const { return value().second; }
+
+        // Returns the allocator of the container
+        _allocator_t get_allocator() const
+        { return _m_allocator; }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Result of the node handle insertion
+    struct insert_return_type
+    {
+        iterator position;  // Inserted element or element with the same key
+        bool inserted;      // Whether the node has been inserted
+        node_type node;     // Node handle if it has not been inserted
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // CuckooHashMap
+
+
+#endif  // _CUCKOOHASHMAP_
@@ -0,0 +1,1153 @@
+// DenseHashMap.hpp
+
+#ifndef _DENSEHASHMAP_
+#define _DENSEHASHMAP_
+
+
+#include <initializer_list>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include <hash/hash.hpp>
+
+
+// Iterator over the elements of the split layout, it refers to the key and
+// the mapped value stored in the parallel arrays. The dereferenced element
+// is the pair of references, so it is returned by value
+template <class _Key, class _Data>
+class __split_iterator:
+    public std::iterator<std::forward_iterator_tag,
+        std::pair<const _Key&, _Data&>, ptrdiff_t, void,
+        std::pair<const _Key&, _Data&>>
+{
+private:
+    template <class, class> friend class __split_iterator;
+
+    const _Key* _m_key_ptr;     // Pointer to the key
+    _Data* _m_data_ptr;         // Pointer to the mapped value
+
+public:
+    // Default constructor
+    __split_iterator(): _m_key_ptr{nullptr}, _m_data_ptr{nullptr} {}
+
+    // Constructor with the pointers to the key and the mapped value
+    __split_iterator(const _Key* _key_ptr, _Data* _data_ptr) noexcept:
+        _m_key_ptr{_key_ptr},
+        _m_data_ptr{_data_ptr}
+    {}
+
+    // Conversion of the iterator to the const iterator
+    template <class _OtherData>
+    __split_iterator(const __split_iterator<_Key, _OtherData>& _other)
+        noexcept:
+        _m_key_ptr{_other._m_key_ptr},
+        _m_data_ptr{_other._m_data_ptr}
+    {}
+
+    std::pair<const _Key&, _Data&> operator*() const noexcept
+    { return std::pair<const _Key&, _Data&>(*_m_key_ptr, *_m_data_ptr); }
+
+    __split_iterator& operator++() noexcept
+    {
+        ++_m_key_ptr;
+        ++_m_data_ptr;
+
+        return *this;
+    }
+
+    __split_iterator operator++(int) noexcept
+    {
+        __split_iterator old(*this);
+
+        ++(*this);
+
+        return old;
+    }
+
+    // Returns the iterator moved forward by the count of elements
+    __split_iterator operator+(ptrdiff_t _count) const noexcept
+    { return __split_iterator(_m_key_ptr + _count, _m_data_ptr + _count); }
+
+    // Returns the count of elements between the iterators
+    template <class _OtherData>
+    ptrdiff_t operator-(const __split_iterator<_Key, _OtherData>& _other)
+        const noexcept
+    { return _m_key_ptr - _other._m_key_ptr; }
+
+    template <class _OtherData>
+    bool operator==(const __split_iterator<_Key, _OtherData>& _other)
+        const noexcept
+    { return _m_key_ptr == _other._m_key_ptr; }
+
+    template <class _OtherData>
+    bool operator!=(const __split_iterator<_Key, _OtherData>& _other)
+        const noexcept
+    { return _m_key_ptr != _other._m_key_ptr; }
+};
+
+
+// Layouts of the elements of DenseHashMap. The storage of the layout keeps
+// the elements by their numbers and moves the last element to the place of
+// the removed one
+
+// The elements are stored as pairs in a single array, so the key and the
+// mapped value of the small elements share the cache line
+struct dense_layout
+{
+    template <class _Key, class _Data, class _Allocator>
+    class storage
+    {
+    public:
+        using _value_t = std::pair<_Key, _Data>;
+
+    private:
+        using _alloc_traits = std::allocator_traits<_Allocator>;
+        using _value_allocator_t
+            = typename _alloc_traits::template rebind_alloc<_value_t>;
+
+        std::vector<_value_t, _value_allocator_t> _m_values;    // Elements
+
+    public:
+        using iterator = typename std::vector<_value_t,
+            _value_allocator_t>::iterator;
+        using const_iterator = typename std::vector<_value_t,
+            _value_allocator_t>::const_iterator;
+
+        // Size of the serialized element
+        static constexpr size_t ELEMENT_SIZE = sizeof(_value_t);
+
+        // Constructor with the allocator and the count of default
+        // constructed elements
+        explicit storage(const _Allocator& _alloc, size_t _count = 0):
+            _m_values(_count, _value_allocator_t(_alloc))
+        {}
+
+        iterator begin() noexcept { return _m_values.begin(); }
+        const_iterator begin() const noexcept { return _m_values.begin(); }
+        iterator end() noexcept { return _m_values.end(); }
+        const_iterator end() const noexcept { return _m_values.end(); }
+
+        // Returns the pointer to the elements
+        const _value_t* data() const noexcept { return _m_values.data(); }
+
+        size_t size() const noexcept { return _m_values.size(); }
+        bool empty() const noexcept { return _m_values.empty(); }
+
+        const _Key& key(size_t _n) const noexcept
+        { return _m_values[_n].first; }
+
+        _Data& mapped(size_t _n) noexcept { return _m_values[_n].second; }
+        const _Data& mapped(size_t _n) const noexcept
+        { return _m_values[_n].second; }
+
+        // Adds the element constructed by the arguments to the end
+        template <class... _Args>
+        void emplace_back(_Args&&... _args)
+        { _m_values.emplace_back(std::forward<_Args>(_args)...); }
+
+        // Removes the element replacing it by the last one
+        void erase(size_t _n)
+        {
+            if (_n != _m_values.size() - 1)
+                _m_values[_n] = std::move(_m_values.back());
+
+            _m_values.pop_back();
+        }
+
+        void reserve(size_t _count) { _m_values.reserve(_count); }
+        void clear() noexcept { _m_values.clear(); }
+        void swap(storage& _other) noexcept
+        { _m_values.swap(_other._m_values); }
+
+        // Writes the elements of trivially copyable types to the buffer
+        void write(char* _buffer) const noexcept
+        {
+            std::memcpy(_buffer, _m_values.data(),
+                _m_values.size() * sizeof(_value_t));
+        }
+
+        // Reads the elements of trivially copyable types from the buffer
+        void read(const char* _buffer) noexcept
+        {
+            std::memcpy(static_cast<void*>(_m_values.data()), _buffer,
+                _m_values.size() * sizeof(_value_t));
+        }
+
+        // Returns the memory in bytes used by the elements
+        size_t memory_usage() const noexcept
+        { return _m_values.capacity() * sizeof(_value_t); }
+
+        _Allocator get_allocator() const noexcept
+        { return _Allocator(_m_values.get_allocator()); }
+    };
+};
+
+// The keys and the mapped values are stored in two parallel arrays. The
+// lookups compare the keys within the compact array of keys and touch the
+// mapped value only on a hit, which suits the large mapped values. The
+// iterators return the pairs of references to the key and the value
+struct split_layout
+{
+    template <class _Key, class _Data, class _Allocator>
+    class storage
+    {
+    public:
+        using _value_t = std::pair<_Key, _Data>;
+
+    private:
+        // The elements must be addressable, so vector<bool> is excluded
+        static_assert(!std::is_same<_Key, bool>::value &&
+            !std::is_same<_Data, bool>::value, "the split layout does not "
+            "support bool keys and values");
+
+        using _alloc_traits = std::allocator_traits<_Allocator>;
+        using _key_allocator_t
+            = typename _alloc_traits::template rebind_alloc<_Key>;
+        using _data_allocator_t
+            = typename _alloc_traits::template rebind_alloc<_Data>;
+
+        std::vector<_Key, _key_allocator_t> _m_keys;    // Keys
+        std::vector<_Data, _data_allocator_t> _m_data;  // Mapped values
+
+        // Adds the key and the mapped value to the end
+        template <class _KeyArg, class _DataArg>
+        void _emplace(_KeyArg&& _key, _DataArg&& _data)
+        {
+            _m_keys.emplace_back(std::forward<_KeyArg>(_key));
+
+            try
+            {
+                _m_data.emplace_back(std::forward<_DataArg>(_data));
+            }
+            catch (...)
+            {
+                _m_keys.pop_back();
+                throw;
+            }
+        }
+
+    public:
+        using iterator = __split_iterator<_Key, _Data>;
+        using const_iterator = __split_iterator<_Key, const _Data>;
+
+        // Size of the serialized element
+        static constexpr size_t ELEMENT_SIZE = sizeof(_Key) + sizeof(_Data);
+
+        // Constructor with the allocator and the count of default
+        // constructed elements
+        explicit storage(const _Allocator& _alloc, size_t _count = 0):
+            _m_keys(_count, _key_allocator_t(_alloc)),
+            _m_data(_count, _data_allocator_t(_alloc))
+        {}
+
+        iterator begin() noexcept
+        { return iterator(_m_keys.data(), _m_data.data()); }
+        const_iterator begin() const noexcept
+        { return const_iterator(_m_keys.data(), _m_data.data()); }
+        iterator end() noexcept { return begin() + _m_keys.size(); }
+        const_iterator end() const noexcept
+        { return begin() + _m_keys.size(); }
+
+        size_t size() const noexcept { return _m_keys.size(); }
+        bool empty() const noexcept { return _m_keys.empty(); }
+
+        const _Key& key(size_t _n) const noexcept { return _m_keys[_n]; }
+
+        _Data& mapped(size_t _n) noexcept { return _m_data[_n]; }
+        const _Data& mapped(size_t _n) const noexcept { return _m_data[_n]; }
+
+        // Adds the element with the key and the mapped value to the end
+        template <class _KeyArg, class _DataArg>
+        void emplace_back(_KeyArg&& _key, _DataArg&& _data)
+        {
+            _emplace(std::forward<_KeyArg>(_key),
+                std::forward<_DataArg>(_data));
+        }
+
+        // Adds the element copied or moved from the pair to the end
+        template <class _Pair>
+        void emplace_back(_Pair&& _pair)
+        {
+            _emplace(std::forward<_Pair>(_pair).first,
+                std::forward<_Pair>(_pair).second);
+        }
+
+        // Removes the element replacing it by the last one
+        void erase(size_t _n)
+        {
+            if (_n != _m_keys.size() - 1)
+            {
+                _m_keys[_n] = std::move(_m_keys.back());
+                _m_data[_n] = std::move(_m_data.back());
+            }
+
+            _m_keys.pop_back();
+            _m_data.pop_back();
+        }
+
+        void reserve(size_t _count)
+        {
+            _m_keys.reserve(_count);
+            _m_data.reserve(_count);
+        }
+
+        void clear() noexcept
+        {
+            _m_keys.clear();
+            _m_data.clear();
+        }
+
+        void swap(storage& _other) noexcept
+        {
+            _m_keys.swap(_other._m_keys);
+            _m_data.swap(_other._m_data);
+        }
+
+        // Writes the keys and then the mapped values of trivially copyable
+        // types to the buffer
+        void write(char* _buffer) const noexcept
+        {
+            std::memcpy(_buffer, _m_keys.data(),
+                _m_keys.size() * sizeof(_Key));
+            std::memcpy(_buffer + _m_keys.size() * sizeof(_Key),
+                _m_data.data(), _m_data.size() * sizeof(_Data));
+        }
+
+        // Reads the keys and then the mapped values of trivially copyable
+        // types from the buffer
+        void read(const char* _buffer) noexcept
+        {
+            std::memcpy(static_cast<void*>(_m_keys.data()), _buffer,
+                _m_keys.size() * sizeof(_Key));
+            std::memcpy(static_cast<void*>(_m_data.data()),
+                _buffer + _m_keys.size() * sizeof(_Key),
+                _m_data.size() * sizeof(_Data));
+        }
+
+        // Returns the memory in bytes used by the elements
+        size_t memory_usage() const noexcept
+        {
+            return _m_keys.capacity() * sizeof(_Key) +
+                _m_data.capacity() * sizeof(_Data);
+        }
+
+        _Allocator get_allocator() const noexcept
+        { return _Allocator(_m_keys.get_allocator()); }
+    };
+};
+
+
+// Hash table with the elements stored contiguously in the insertion order.
+// The elements are kept in a single vector and the separate index table of
+// linear probing maps the hash values to their positions. Every slot of the
+// index takes 8 bytes: the 32-bit number of the element and the 32-bit tag
+// folded from its hash value, so the lookup compares the keys only when the
+// tags are equal and the index of the medium-size map stays in cache.
+//
+// The iteration is a linear scan of the vector. The removed element is
+// replaced by the last one, so the erasure keeps the elements contiguous,
+// but it changes their order. The key must not be changed through the
+// iterators, since the elements are stored as pairs of non-const key and
+// value to be movable within the vector.
+//
+// The home slots are chosen by the tags and the tags of the elements are
+// kept in a parallel vector, so the rehashing and the erasure do not call
+// the hasher.
+//
+// The layout of the elements is chosen by "_Layout": the default
+// "dense_layout" stores the pairs in one vector and "split_layout" stores
+// the keys and the mapped values in separate vectors for the large values
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<std::pair<const _Key, _Data>>,
+    class _Layout = dense_layout
+>
+class DenseHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<_Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+    using _allocator_t   = _Allocator;
+
+protected:
+    using _storage_t
+        = typename _Layout::template storage<_Key, _Data, _Allocator>;
+
+public:
+    using iterator          = typename _storage_t::iterator;
+    using const_iterator    = typename _storage_t::const_iterator;
+
+    // Key together with its hash value, see HashMap::hashed_key
+    class hashed_key
+    {
+    private:
+        const _key_t* _m_key_ptr;   // Pointer to the key
+        size_t _m_hash;             // Hash value of the key
+
+    public:
+        // Constructor with the key and its hash value
+        hashed_key(const _key_t& _key, size_t _hash) noexcept:
+            _m_key_ptr{&_key},
+            _m_hash{_hash}
+        {}
+
+        // Returns the key
+        const _key_t& key() const noexcept { return *_m_key_ptr; }
+        // Returns the hash value of the key
+        size_t hash() const noexcept { return _m_hash; }
+    };
+
+    // Max count of elements, the last 32-bit number marks the free slots
+    static constexpr size_t MAX_COUNT = UINT32_MAX - 1;
+
+protected:
+    static constexpr size_t MIN_COUNT_BUCKETS = 8;
+    // The index is a power of two not exceeding the range of the tags
+    static constexpr size_t MAX_COUNT_BUCKETS = sizeof(size_t) > 4 ?
+        static_cast<size_t>(uint64_t(UINT32_MAX) + 1) : SIZE_MAX / 2 + 1;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.75f;
+    // The probe sequences of the linear probing grow fast after it
+    static constexpr float MAX_MAX_LOAD_FACTOR = 0.9f;
+    static constexpr uint32_t FREE_SLOT = UINT32_MAX;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    // Slot of the index table
+    struct _slot_t
+    {
+        uint32_t _m_number;     // Number of the element or FREE_SLOT
+        uint32_t _m_tag;        // Tag of the element
+    };
+
+    using _alloc_traits = std::allocator_traits<_allocator_t>;
+    using _slot_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_slot_t>;
+    using _tag_allocator_t
+        = typename _alloc_traits::template rebind_alloc<uint32_t>;
+
+    _storage_t _m_values;                               // Elements
+    std::vector<uint32_t, _tag_allocator_t> _m_tags;    // Tags of elements
+    std::vector<_slot_t, _slot_allocator_t> _m_slots;   // Index table
+    float _m_max_load_factor;                           // Max load factor
+    _hasher_t _m_hasher;                                // Hasher functor
+    _key_equal_t _m_key_equal;                          // Key equal functor
+
+    // Returns the tag of the hash value. The hash value is mixed, since the
+    // hash values of integers are the integers themselves and the home
+    // slots of the regular keys would collide
+    static uint32_t _tag_of(size_t _hash) noexcept
+    {
+        uint64_t mixed = static_cast<uint64_t>(_hash);
+
+        mixed ^= mixed >> 33;
+        mixed *= 0xFF51AFD7ED558CCDull;
+        mixed ^= mixed >> 33;
+        mixed *= 0xC4CEB9FE1A85EC53ull;
+        mixed ^= mixed >> 33;
+
+        return static_cast<uint32_t>(mixed);
+    }
+
+    // Returns the mask of the index of slots
+    size_t _mask() const noexcept { return _m_slots.size() - 1; }
+
+    // Returns the home slot of the tag
+    size_t _home_of(uint32_t _tag) const noexcept { return _tag & _mask(); }
+
+    // Returns the slot following the specified one
+    size_t _next_slot(size_t _i) const noexcept { return (_i + 1) & _mask(); }
+
+    // Returns the count of slots of the power of two accommodating the
+    // specified count of elements
+    size_t _count_slots(size_t _count) const
+    {
+        size_t count_slots = MIN_COUNT_BUCKETS;
+
+        while (count_slots < _count / _m_max_load_factor)
+        {
+            if (count_slots == MAX_COUNT_BUCKETS)
+                throw std::length_error("the count of elements exceeds the "
+                    "max count");
+
+            count_slots *= 2;
+        }
+
+        return count_slots;
+    }
+
+    // Resizes the index to the specified count of slots and fills it by the
+    // stored tags of the elements
+    void _build_index(size_t _count_slots)
+    {
+        _m_slots.assign(_count_slots, _slot_t{FREE_SLOT, 0});
+
+        for (size_t n = 0; n < _m_values.size(); n++)
+        {
+            size_t i = _home_of(_m_tags[n]);
+
+            while (_m_slots[i]._m_number != FREE_SLOT)
+                i = _next_slot(i);
+
+            _m_slots[i] = _slot_t{static_cast<uint32_t>(n), _m_tags[n]};
+        }
+    }
+
+    // Returns the index of the slot with the key or NPOS
+    size_t _find_slot(const hashed_key& _hkey) const
+    {
+        uint32_t tag = _tag_of(_hkey.hash());
+
+        // The index always has a free slot, which ends the probe sequence
+        for (size_t i = _home_of(tag); _m_slots[i]._m_number != FREE_SLOT;
+            i = _next_slot(i))
+            if
+            (
+                _m_slots[i]._m_tag == tag &&
+                _m_key_equal(_hkey.key(),
+                    _m_values.key(_m_slots[i]._m_number))
+            )
+                return i;
+
+        return NPOS;
+    }
+
+    // Returns the index of the slot referring to the element with the
+    // specified number
+    size_t _slot_of(size_t _n) const noexcept
+    {
+        size_t i = _home_of(_m_tags[_n]);
+
+        while (_m_slots[i]._m_number != _n)
+            i = _next_slot(i);
+
+        return i;
+    }
+
+    // Adds a new element with the specified hash value of the key to the
+    // container without checking for its presence, returns its number
+    template <class... _Args>
+    size_t _insert_new(size_t _hash, _Args&&... _args)
+    {
+        if (_m_values.size() == MAX_COUNT)
+            throw std::length_error("the count of elements exceeds the max "
+                "count");
+
+        if (_m_values.size() + 1 > _m_slots.size() * _m_max_load_factor)
+            _build_index(_count_slots(_m_values.size() + 1));
+
+        uint32_t tag = _tag_of(_hash);
+        size_t n = _m_values.size();
+
+        _m_tags.push_back(tag);
+
+        try
+        {
+            _m_values.emplace_back(std::forward<_Args>(_args)...);
+        }
+        catch (...)
+        {
+            _m_tags.pop_back();
+            throw;
+        }
+
+        size_t i = _home_of(tag);
+
+        while (_m_slots[i]._m_number != FREE_SLOT)
+            i = _next_slot(i);
+
+        _m_slots[i] = _slot_t{static_cast<uint32_t>(n), tag};
+
+        return n;
+    }
+
+    // Frees the slot of the index shifting back the following slots of the
+    // probe sequence, so the lookups need no deleted marks
+    void _free_slot(size_t _i) noexcept
+    {
+        size_t hole = _i;
+
+        for (size_t i = _next_slot(_i); _m_slots[i]._m_number != FREE_SLOT;
+            i = _next_slot(i))
+        {
+            size_t home = _home_of(_m_slots[i]._m_tag);
+
+            // The slot can fill the hole only if its home slot is not
+            // between the hole and the slot
+            if (((i - home) & _mask()) >= ((i - hole) & _mask()))
+            {
+                _m_slots[hole] = _m_slots[i];
+                hole = i;
+            }
+        }
+
+        _m_slots[hole]._m_number = FREE_SLOT;
+    }
+
+    // Removes the element referred by the slot of the index, the last
+    // element is moved to its place
+    void _erase_slot(size_t _i)
+    {
+        size_t n = _m_slots[_i]._m_number;
+        size_t last = _m_values.size() - 1;
+
+        _free_slot(_i);
+
+        if (n != last)
+        {
+            _m_slots[_slot_of(last)]._m_number = static_cast<uint32_t>(n);
+            _m_tags[n] = _m_tags[last];
+        }
+
+        _m_values.erase(n);
+        _m_tags.pop_back();
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor with optional parameters
+    explicit DenseHashMap
+    (
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        _m_values(_allocator),
+        _m_tags(_tag_allocator_t(_allocator)),
+        _m_slots(_slot_allocator_t(_allocator)),
+        _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal}
+    {
+        _build_index(MIN_COUNT_BUCKETS);
+        rehash(_count_buckets);
+    }
+
+    // Constructor with the allocator parameter
+    explicit DenseHashMap(const _allocator_t& _alloc):
+        DenseHashMap(MIN_COUNT_BUCKETS, _hasher_t(), _key_equal_t(), _alloc)
+    {}
+
+    // Range-based constructor
+    template <class InputIterator>
+    explicit DenseHashMap
+    (
+        const InputIterator& begin, const InputIterator& end,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        DenseHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(begin, end);
+    }
+
+    // Copy constructor
+    DenseHashMap(const DenseHashMap& _other) = default;
+
+    // Move constructor, the other container is left empty with the minimum
+    // index, so its mask describes the slots it has
+    DenseHashMap(DenseHashMap&& _other):
+        _m_values(std::move(_other._m_values)),
+        _m_tags(std::move(_other._m_tags)),
+        _m_slots(std::move(_other._m_slots)),
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_hasher{std::move(_other._m_hasher)},
+        _m_key_equal{std::move(_other._m_key_equal)}
+    {
+        _other.clear();
+    }
+
+    // Constructor based on the initialization list
+    DenseHashMap
+    (
+        std::initializer_list<_value_t> _il,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        DenseHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(_il);
+    }
+
+    // Destructor
+    ~DenseHashMap() {}
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Assigment operator
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assignment by copying
+    DenseHashMap& operator=(const DenseHashMap& _other) = default;
+
+    // Assignment by moving, the other container is left empty
+    DenseHashMap& operator=(DenseHashMap&& _other)
+    {
+        if (this == &_other)
+            return *this;
+
+        _m_values = std::move(_other._m_values);
+        _m_tags = std::move(_other._m_tags);
+        _m_slots = std::move(_other._m_slots);
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_hasher = std::move(_other._m_hasher);
+        _m_key_equal = std::move(_other._m_key_equal);
+        _other.clear();
+
+        return *this;
+    }
+
+    // Assignment based on the initialization list
+    DenseHashMap& operator=(std::initializer_list<_value_t> _il)
+    {
+        clear();
+        insert(_il);
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the container
+    iterator begin() noexcept { return _m_values.begin(); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator begin() const noexcept { return _m_values.begin(); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept { return _m_values.begin(); }
+    // Returns the iterator set to the end of the container
+    iterator end() noexcept { return _m_values.end(); }
+    // Returns the const iterator set to the end of the container
+    const_iterator end() const noexcept { return _m_values.end(); }
+    // Returns the const iterator set to the end of the container
+    const_iterator cend() const noexcept { return _m_values.end(); }
+
+    // Returns the pointer to the contiguous elements in the insertion order
+    // changed only by the erasures, it is available for the dense layout
+    const _value_t* data() const noexcept { return _m_values.data(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_values.size(); }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_values.empty(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the handle of the specified key with its computed hash value
+    hashed_key hash_key(const _key_t& _key) const
+    { return hashed_key(_key, _m_hasher(_key)); }
+
+    // Accessing an element by key and returning an iterator
+
+    iterator find(const _key_t& _key)
+    { return find(hash_key(_key)); }
+
+    const_iterator find(const _key_t& _key) const
+    { return find(hash_key(_key)); }
+
+    iterator find(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? begin() + _m_slots[i]._m_number : end();
+    }
+
+    const_iterator find(const hashed_key& _hkey) const
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? cbegin() + _m_slots[i]._m_number : cend();
+    }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const
+    { return _find_slot(hash_key(_key)) != NPOS; }
+
+    size_t count(const hashed_key& _hkey) const
+    { return _find_slot(_hkey) != NPOS; }
+
+    // Indexing operator
+
+    _mapped_t& operator[](const _key_t& _key)
+    { return (*this)[hash_key(_key)]; }
+
+    _mapped_t& operator[](_key_t&& _key)
+    {
+        size_t hash = _m_hasher(_key);
+        size_t i = _find_slot(hashed_key(_key, hash));
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            return _m_values.mapped(_insert_new(hash, std::move(_key),
+                _mapped_t{}));
+
+        return _m_values.mapped(_m_slots[i]._m_number);
+    }
+
+    _mapped_t& operator[](const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            return _m_values.mapped(_insert_new(_hkey.hash(), _hkey.key(),
+                _mapped_t{}));
+
+        return _m_values.mapped(_m_slots[i]._m_number);
+    }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+
+    _mapped_t& at(const _key_t& _key)
+    { return at(hash_key(_key)); }
+
+    const _mapped_t& at(const _key_t& _key) const
+    { return at(hash_key(_key)); }
+
+    _mapped_t& at(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _m_values.mapped(_m_slots[i]._m_number);
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    const _mapped_t& at(const hashed_key& _hkey) const
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _m_values.mapped(_m_slots[i]._m_number);
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Insert operations
+
+    // Inserting a single element by copying
+    std::pair<iterator, bool> insert(const _value_t& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(begin() + _m_slots[i]._m_number, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(begin() + _insert_new(hash, _val), true);
+    }
+
+    // Inserting a single element by moving
+    std::pair<iterator, bool> insert(_value_t&& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(begin() + _m_slots[i]._m_number, false);
+
+        // Otherwise, add it to containter
+        size_t n = _insert_new(hash, std::move(_val));
+
+        return std::make_pair(begin() + n, true);
+    }
+
+    // Inserting a single element with the prehashed key by copying
+    // the mapped value
+    std::pair<iterator, bool>
+    insert(const hashed_key& _hkey, const _mapped_t& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(begin() + _m_slots[i]._m_number, false);
+
+        // Otherwise, add it to containter
+        size_t n = _insert_new(_hkey.hash(), _hkey.key(), _data);
+
+        return std::make_pair(begin() + n, true);
+    }
+
+    // Inserting a single element with the prehashed key by moving
+    // the mapped value
+    std::pair<iterator, bool> insert(const hashed_key& _hkey, _mapped_t&& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(begin() + _m_slots[i]._m_number, false);
+
+        // Otherwise, add it to containter
+        size_t n = _insert_new(_hkey.hash(), _hkey.key(), std::move(_data));
+
+        return std::make_pair(begin() + n, true);
+    }
+
+    // Inserting a range of values
+    template <class InputIterator>
+    size_t insert(InputIterator _first, InputIterator _last)
+    {
+        reverse(size() + std::distance(_first, _last));
+
+        size_t result = 0;
+        for (InputIterator iter = _first; iter != _last; iter++)
+            if (insert(*iter).second)
+                result++;
+
+        return result;
+    }
+
+    // Inserting an initialization list
+    size_t insert(std::initializer_list<_value_t> _il)
+    { return insert(_il.begin(), _il.end()); }
+
+    // Erase operations
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    { return erase(hash_key(_key)); }
+
+    // Erase item from container by specified prehashed key
+    size_t erase(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i == NPOS)
+            return 0;
+
+        _erase_slot(i);
+
+        return 1;
+    }
+
+    // Erase item set by the iterator from container without the lookup
+    // of its key. The last item takes the place of the removed one, so the
+    // returned iterator is set to the same position
+    iterator erase(const_iterator _pos)
+    {
+        size_t n = _pos - cbegin();
+
+        _erase_slot(_slot_of(n));
+
+        return begin() + n;
+    }
+
+    // Clear the container
+    void clear()
+    {
+        _m_values.clear();
+        _m_tags.clear();
+        _build_index(MIN_COUNT_BUCKETS);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Serialization
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The elements of the trivially copyable keys and values are written
+    // and read as a single block of bytes preceded by their count. The
+    // index is not written, it is rebuilt by hashing of the read keys
+
+    // Returns the size in bytes of the serialized container
+    size_t serialized_size() const noexcept
+    {
+        return sizeof(uint64_t) + _m_values.size() *
+            _storage_t::ELEMENT_SIZE;
+    }
+
+    // Writes the container to the buffer of serialized_size() bytes
+    void serialize(void* _buffer) const
+    {
+        static_assert(std::is_trivially_copyable<_key_t>::value &&
+            std::is_trivially_copyable<_mapped_t>::value, "the keys and "
+            "values must be trivially copyable");
+
+        uint64_t count = _m_values.size();
+        char* buffer = static_cast<char*>(_buffer);
+
+        std::memcpy(buffer, &count, sizeof(count));
+        _m_values.write(buffer + sizeof(count));
+    }
+
+    // Replaces the elements of the container by the ones read from the
+    // buffer of the specified size, an invalid_argument exception is thrown
+    // if the size does not match the count of elements. The keys of the
+    // buffer must be unique
+    void deserialize(const void* _buffer, size_t _size)
+    {
+        static_assert(std::is_trivially_copyable<_key_t>::value &&
+            std::is_trivially_copyable<_mapped_t>::value, "the keys and "
+            "values must be trivially copyable");
+
+        uint64_t count;
+        const char* buffer = static_cast<const char*>(_buffer);
+
+        if (_size < sizeof(count))
+            throw std::invalid_argument("the buffer is too small");
+
+        std::memcpy(&count, buffer, sizeof(count));
+
+        if (count > MAX_COUNT ||
+            count != (_size - sizeof(count)) / _storage_t::ELEMENT_SIZE ||
+            (_size - sizeof(count)) % _storage_t::ELEMENT_SIZE != 0)
+            throw std::invalid_argument("the size of the buffer does not "
+                "match the count of elements");
+
+        // The container is not changed if the allocation fails
+        _storage_t values(_m_values.get_allocator(), count);
+        std::vector<uint32_t, _tag_allocator_t> tags(count,
+            _m_tags.get_allocator());
+
+        values.read(buffer + sizeof(count));
+
+        for (size_t n = 0; n < count; n++)
+            tags[n] = _tag_of(_m_hasher(values.key(n)));
+
+        size_t count_slots = _count_slots(count);
+
+        _m_slots.reserve(count_slots);
+        _m_values.swap(values);
+        _m_tags.swap(tags);
+        _build_index(count_slots);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Bucket interface
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns count of slots of the index
+    size_t buckets_count() const noexcept { return _m_slots.size(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Hash policy
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the ratio of the count of items to the count of slots
+    float load_factor() const noexcept
+    { return (float)size() / _m_slots.size(); }
+
+    // Returns max load factor
+    float max_load_factor() const noexcept
+    { return _m_max_load_factor; }
+
+    // Sets max load factor, which can not exceed 0.9
+    void max_load_factor(float _ml) noexcept
+    {
+        _m_max_load_factor = _ml < MAX_MAX_LOAD_FACTOR ? _ml :
+            MAX_MAX_LOAD_FACTOR;
+    }
+
+    // Sets the number of slots of the index to the power of two not less
+    // than the specified one, if it does not makes load factor more than
+    // maximum load factor, and rebuilds the index using the stored tags
+    void rehash(size_t _count_buckets)
+    {
+        size_t count_slots = _count_slots(size());
+
+        while (count_slots < _count_buckets && count_slots < MAX_COUNT_BUCKETS)
+            count_slots *= 2;
+
+        if (count_slots != _m_slots.size())
+            _build_index(count_slots);
+    }
+
+    // Reserves the space for at least count elements without exceeding
+    // maximum load factor and rebuilds the index
+    void reverse(size_t _count)
+    {
+        size_t count_slots = _count_slots(_count);
+
+        _m_values.reserve(_count);
+        _m_tags.reserve(_count);
+
+        if (count_slots > _m_slots.size())
+            _build_index(count_slots);
+    }
+
+    // Returns the estimate of the memory in bytes used by the container
+    size_t memory_usage() const noexcept
+    {
+        return sizeof(*this) +
+            _m_values.memory_usage() +
+            _m_tags.capacity() * sizeof(uint32_t) +
+            _m_slots.capacity() * sizeof(_slot_t);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare the keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    // Returns the allocator associated with the container
+    _allocator_t get_allocator() const noexcept
+    { return _m_values.get_allocator(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // DenseHashMap
+
+
+#endif  // _DENSEHASHMAP_
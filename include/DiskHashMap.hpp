@@ -0,0 +1,813 @@
+// DiskHashMap.hpp
+
+#ifndef _DISKHASHMAP_
+#define _DISKHASHMAP_
+
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <LruCache.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+
+// Hash map stored in the file for the datasets larger than the memory. The
+// elements are placed in the fixed-size pages of the file by the extendible
+// hashing: the directory of 2^depth page numbers is indexed by the low bits
+// of the hash value, and the full page is split in two by the next bit, the
+// directory is doubled only if the page is referred by a single entry. The
+// directory is kept in the memory, so the lookup reads at most one page.
+//
+// The pages are read by "pread" to the bounded LRU cache and the modified
+// pages are written by "pwrite" only when they are evicted or flushed. The
+// directory and the header are written to the file by "flush" and by the
+// destructor, so the map written to the file without them is not restored.
+//
+// The keys and the mapped values must be trivially copyable, they are stored
+// as their bytes. The hash values are seeded by the seed stored in the file,
+// so the hasher must be the same for all the processes using the file. The
+// elements are returned by value, because the page of the element can be
+// evicted by any following access
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>
+>
+class DiskHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<_Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+
+    static_assert(std::is_trivially_copyable<_Key>::value &&
+        std::is_trivially_copyable<_Data>::value,
+        "the keys and the mapped values must be trivially copyable");
+
+    class const_iterator;
+    using iterator = const_iterator;
+
+    // Statistics of the page cache
+    struct stats_t
+    {
+        size_t hits;        // Count of the pages found in the cache
+        size_t reads;       // Count of the pages read from the file
+        size_t writes;      // Count of the pages written to the file
+    };
+
+    static constexpr size_t DEFAULT_PAGE_SIZE = 4096;
+    static constexpr size_t DEFAULT_CACHE_PAGES = 1024;
+    // Max depth of the directory
+    static constexpr uint32_t MAX_DEPTH = 32;
+
+protected:
+    static constexpr uint64_t MAGIC = 0x50414d4853414844ull; // "DHASHMAP"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t ENTRY_SIZE = sizeof(_Key) + sizeof(_Data);
+
+    // Header of the file, it occupies the first page
+    struct _file_header_t
+    {
+        uint64_t _m_magic;          // Signature of the file
+        uint32_t _m_version;        // Version of the format
+        uint32_t _m_depth;          // Depth of the directory
+        uint64_t _m_page_size;      // Size of the page
+        uint64_t _m_key_size;       // Size of the key
+        uint64_t _m_mapped_size;    // Size of the mapped value
+        uint64_t _m_seed;           // Seed of the hash values
+        uint64_t _m_count;          // Count of elements
+        uint64_t _m_count_pages;    // Count of pages with the header page
+    };
+
+    // Header of the page, the entries of the keys and the mapped values
+    // follow it
+    struct _page_header_t
+    {
+        uint32_t _m_count;          // Count of entries in the page
+        uint32_t _m_depth;          // Local depth of the page
+    };
+
+    // Page in the cache
+    struct _frame_t
+    {
+        std::vector<char> _m_data;  // Bytes of the page
+        bool _m_is_dirty;           // Whether the page has been modified
+    };
+
+    using _cache_t = LruCache<uint64_t, _frame_t>;
+
+    int _m_fd;                              // Descriptor of the file
+    size_t _m_page_size;                    // Size of the page
+    size_t _m_page_capacity;                // Max count of entries in page
+    uint32_t _m_depth;                      // Depth of the directory
+    std::vector<uint64_t> _m_directory;     // Pages by low bits of hashes
+    uint64_t _m_count_pages;                // Count of pages
+    size_t _m_count;                        // Count of elements
+    size_t _m_seed;                         // Seed of the hash values
+    _hasher_t _m_hasher;                    // Hasher functor
+    _key_equal_t _m_key_equal;              // Key equal functor
+    mutable _cache_t _m_cache;              // Cache of the pages
+    mutable stats_t _m_stats;               // Statistics of the cache
+    mutable std::vector<char> _m_spare;     // Buffer of the evicted page
+
+    // Returns the hash value of the key
+    size_t _hash(const _key_t& _key) const
+    { return __hash_with_seed(_m_hasher, _key, _m_seed); }
+
+    // Returns the page referred by the directory for the hash value
+    uint64_t _page_of(size_t _hash) const noexcept
+    { return _m_directory[_hash & ((size_t(1) << _m_depth) - 1)]; }
+
+    // Reads or writes the whole block at the offset of the file
+    void _read(void* _buf, size_t _size, uint64_t _offset) const
+    {
+        char* buf = static_cast<char*>(_buf);
+
+        while (_size > 0)
+        {
+            ssize_t res = ::pread(_m_fd, buf, _size, _offset);
+
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res < 0)
+                throw std::system_error(errno, std::generic_category(),
+                    "failed to read the file");
+            if (res == 0)
+                throw std::runtime_error("the file is truncated");
+
+            buf += res;
+            _size -= res;
+            _offset += res;
+        }
+    }
+
+    void _write(const void* _buf, size_t _size, uint64_t _offset) const
+    {
+        const char* buf = static_cast<const char*>(_buf);
+
+        while (_size > 0)
+        {
+            ssize_t res = ::pwrite(_m_fd, buf, _size, _offset);
+
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res < 0)
+                throw std::system_error(errno, std::generic_category(),
+                    "failed to write the file");
+
+            buf += res;
+            _size -= res;
+            _offset += res;
+        }
+    }
+
+    // Writes the page of the cache to the file
+    void _write_page(uint64_t _page, _frame_t& _frame) const
+    {
+        _write(_frame._m_data.data(), _m_page_size, _page * _m_page_size);
+        _frame._m_is_dirty = false;
+        _m_stats.writes++;
+    }
+
+    // Returns the page from the cache, it is read from the file on a miss.
+    // The reference is valid until the next page is loaded, the recently
+    // loaded page is never evicted by the next one
+    _frame_t& _load(uint64_t _page) const
+    {
+        _frame_t* frame = _m_cache.get(_page);
+
+        if (frame != nullptr)
+        {
+            _m_stats.hits++;
+            return *frame;
+        }
+
+        // The buffer of the last evicted page is reused
+        _frame_t loaded{std::move(_m_spare), false};
+
+        loaded._m_data.resize(_m_page_size);
+
+        _read(loaded._m_data.data(), _m_page_size, _page * _m_page_size);
+        _m_stats.reads++;
+        _m_cache.put(_page, std::move(loaded));
+
+        return *_m_cache.get(_page);
+    }
+
+    // Creates the empty page with the specified local depth in the cache,
+    // it is written to the file on eviction
+    _frame_t& _create(uint64_t _page, uint32_t _depth)
+    {
+        _frame_t created{std::vector<char>(_m_page_size, 0), true};
+
+        _set_header(created, _page_header_t{0, _depth});
+        _m_cache.put(_page, std::move(created));
+
+        return *_m_cache.get(_page);
+    }
+
+    // Access to the header and the entries of the page
+
+    static _page_header_t _header(const _frame_t& _frame) noexcept
+    {
+        _page_header_t header;
+
+        std::memcpy(&header, _frame._m_data.data(), sizeof(header));
+        return header;
+    }
+
+    static void _set_header(_frame_t& _frame, const _page_header_t& _header)
+        noexcept
+    { std::memcpy(_frame._m_data.data(), &_header, sizeof(_header)); }
+
+    static char* _entry(_frame_t& _frame, size_t _n) noexcept
+    { return _frame._m_data.data() + sizeof(_page_header_t) + _n * ENTRY_SIZE; }
+
+    static const char* _entry(const _frame_t& _frame, size_t _n) noexcept
+    { return _frame._m_data.data() + sizeof(_page_header_t) + _n * ENTRY_SIZE; }
+
+    static _key_t _key_at(const _frame_t& _frame, size_t _n) noexcept
+    {
+        _key_t key;
+
+        std::memcpy(&key, _entry(_frame, _n), sizeof(_key_t));
+        return key;
+    }
+
+    static _mapped_t _mapped_at(const _frame_t& _frame, size_t _n) noexcept
+    {
+        _mapped_t data;
+
+        std::memcpy(&data, _entry(_frame, _n) + sizeof(_key_t),
+            sizeof(_mapped_t));
+        return data;
+    }
+
+    static void _set_entry(_frame_t& _frame, size_t _n, const _key_t& _key,
+        const _mapped_t& _data) noexcept
+    {
+        std::memcpy(_entry(_frame, _n), &_key, sizeof(_key_t));
+        std::memcpy(_entry(_frame, _n) + sizeof(_key_t), &_data,
+            sizeof(_mapped_t));
+    }
+
+    // Returns the number of the entry with the key in the page or the
+    // count of entries if there is no such entry
+    size_t _find_entry(const _frame_t& _frame, const _key_t& _key) const
+    {
+        size_t count = _header(_frame)._m_count;
+
+        for (size_t n = 0; n < count; n++)
+            if (_m_key_equal(_key, _key_at(_frame, n)))
+                return n;
+
+        return count;
+    }
+
+    // Checks that the hash values of the entries of the page and the key
+    // differ in the bits of the directory, otherwise no split separates them
+    bool _is_separable(const _frame_t& _frame, size_t _key_hash) const
+    {
+        const uint64_t MASK = (uint64_t(1) << MAX_DEPTH) - 1;
+        size_t count = _header(_frame)._m_count;
+
+        for (size_t n = 0; n < count; n++)
+            if ((uint64_t(_hash(_key_at(_frame, n)) ^ _key_hash) & MASK) != 0)
+                return true;
+
+        return false;
+    }
+
+    // Splits the full page referred by the directory for the hash value.
+    // The entries with the next bit of the hash value set are moved to the
+    // new page, the directory is doubled if the local depth of the page is
+    // equal to its depth. The directory is not doubled for the keys with
+    // the colliding hash values, which can not be separated
+    void _split(size_t _key_hash)
+    {
+        uint64_t page = _page_of(_key_hash);
+        _page_header_t header = _header(_load(page));
+        uint32_t depth = header._m_depth;
+
+        if (depth == _m_depth)
+        {
+            if (!_is_separable(_load(page), _key_hash))
+                throw std::length_error("too many keys of the disk hash map "
+                    "have colliding hash values");
+
+            if (_m_depth == MAX_DEPTH)
+                throw std::length_error("the depth of the directory exceeds "
+                    "the max depth");
+
+            size_t size = _m_directory.size();
+
+            _m_directory.resize(size * 2);
+            std::copy(_m_directory.begin(), _m_directory.begin() + size,
+                _m_directory.begin() + size);
+            _m_depth++;
+        }
+
+        uint64_t new_page = _m_count_pages++;
+        _frame_t& created = _create(new_page, depth + 1);
+        _frame_t& frame = _load(page);
+        size_t bit = size_t(1) << depth;
+        size_t count = 0;
+        size_t count_moved = 0;
+
+        for (size_t n = 0; n < header._m_count; n++)
+        {
+            _key_t key = _key_at(frame, n);
+            _mapped_t data = _mapped_at(frame, n);
+
+            if (_hash(key) & bit)
+                _set_entry(created, count_moved++, key, data);
+            else
+                _set_entry(frame, count++, key, data);
+        }
+
+        _set_header(frame, _page_header_t{uint32_t(count), depth + 1});
+        _set_header(created, _page_header_t{uint32_t(count_moved),
+            depth + 1});
+        frame._m_is_dirty = true;
+
+        // The entries referring the page with the bit set refer the new one
+        for (size_t i = (_key_hash & (bit - 1)) | bit; i < _m_directory.size();
+            i += bit << 1)
+            _m_directory[i] = new_page;
+    }
+
+    // Inserts the element or optionally replaces the mapped value, the full
+    // page is split until the page of the key has a free entry
+    std::pair<const_iterator, bool>
+    _insert(const _key_t& _key, const _mapped_t& _data, bool _is_assign)
+    {
+        size_t hash = _hash(_key);
+
+        while (true)
+        {
+            uint64_t page = _page_of(hash);
+            _frame_t& frame = _load(page);
+            _page_header_t header = _header(frame);
+            size_t n = _find_entry(frame, _key);
+
+            if (n < header._m_count)
+            {
+                if (_is_assign)
+                {
+                    _set_entry(frame, n, _key, _data);
+                    frame._m_is_dirty = true;
+                }
+
+                return std::make_pair(const_iterator(*this, page, n), false);
+            }
+
+            if (header._m_count < _m_page_capacity)
+            {
+                _set_entry(frame, n, _key, _data);
+                header._m_count++;
+                _set_header(frame, header);
+                frame._m_is_dirty = true;
+                _m_count++;
+
+                return std::make_pair(const_iterator(*this, page, n), true);
+            }
+
+            _split(hash);
+        }
+    }
+
+    // Removes the entry of the page moving the last entry to its place
+    void _erase_entry(_frame_t& _frame, size_t _n)
+    {
+        _page_header_t header = _header(_frame);
+
+        header._m_count--;
+        if (_n != header._m_count)
+            std::memcpy(_entry(_frame, _n), _entry(_frame, header._m_count),
+                ENTRY_SIZE);
+
+        _set_header(_frame, header);
+        _frame._m_is_dirty = true;
+        _m_count--;
+    }
+
+    // Writes the dirty pages, the directory and the header to the file
+    void _write_all()
+    {
+        _m_cache.for_each([this](const uint64_t& _page, _frame_t& _frame)
+        {
+            if (_frame._m_is_dirty)
+                _write_page(_page, _frame);
+        });
+
+        // The directory follows the last page
+        _write(_m_directory.data(), _m_directory.size() * sizeof(uint64_t),
+            _m_count_pages * _m_page_size);
+
+        _file_header_t header{MAGIC, VERSION, _m_depth, _m_page_size,
+            sizeof(_key_t), sizeof(_mapped_t), _m_seed, _m_count,
+            _m_count_pages};
+
+        _write(&header, sizeof(header), 0);
+    }
+
+    // Initializes the empty map in the file
+    void _create_file()
+    {
+        if (::ftruncate(_m_fd, 0) < 0)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to truncate the file");
+
+        _m_cache.clear();
+        _m_depth = 0;
+        _m_directory.assign(1, 1);
+        _m_count_pages = 2;
+        _m_count = 0;
+        _create(1, 0);
+        _write_all();
+    }
+
+    // Reads the header and the directory of the existing file
+    void _open_file()
+    {
+        _file_header_t header;
+
+        _read(&header, sizeof(header), 0);
+
+        if (header._m_magic != MAGIC || header._m_version != VERSION)
+            throw std::runtime_error("the file is not a disk hash map");
+
+        if
+        (
+            header._m_key_size != sizeof(_key_t) ||
+            header._m_mapped_size != sizeof(_mapped_t)
+        )
+            throw std::runtime_error("the sizes of the keys and the mapped "
+                "values of the file differ");
+
+        if (header._m_depth > MAX_DEPTH)
+            throw std::runtime_error("the directory of the file is damaged");
+
+        _m_page_size = header._m_page_size;
+        _m_page_capacity = (_m_page_size - sizeof(_page_header_t)) /
+            ENTRY_SIZE;
+        _m_depth = header._m_depth;
+        _m_seed = header._m_seed;
+        _m_count = header._m_count;
+        _m_count_pages = header._m_count_pages;
+        _m_directory.resize(size_t(1) << _m_depth);
+        _read(_m_directory.data(), _m_directory.size() * sizeof(uint64_t),
+            _m_count_pages * _m_page_size);
+    }
+
+public:
+    // Iterator over the elements of the map. It keeps the copy of the
+    // current element, so the element is not changed through the iterator
+    class const_iterator:
+        public std::iterator<std::forward_iterator_tag, _value_t>
+    {
+    private:
+        friend class DiskHashMap;
+
+        const DiskHashMap* _m_map_ptr;  // Map of the iterator
+        uint64_t _m_page;               // Number of the page
+        size_t _m_slot;                 // Number of the entry in the page
+        _value_t _m_value;              // Copy of the current element
+
+        // Constructor with the map and the position, the iterator is moved
+        // to the first element starting from the position
+        const_iterator(const DiskHashMap& _map, uint64_t _page, size_t _slot):
+            _m_map_ptr{&_map},
+            _m_page{_page},
+            _m_slot{_slot},
+            _m_value{}
+        { _settle(); }
+
+        // Moves the iterator to the first element starting from its
+        // position and copies it
+        void _settle()
+        {
+            for (; _m_page < _m_map_ptr->_m_count_pages; _m_page++, _m_slot = 0)
+            {
+                const _frame_t& frame = _m_map_ptr->_load(_m_page);
+
+                if (_m_slot < _header(frame)._m_count)
+                {
+                    _m_value = _value_t(_key_at(frame, _m_slot),
+                        _mapped_at(frame, _m_slot));
+                    return;
+                }
+            }
+
+            _m_slot = 0;
+        }
+
+    public:
+        // Default constructor
+        const_iterator(): _m_map_ptr{nullptr}, _m_page{0}, _m_slot{0},
+            _m_value{} {}
+
+        // Equality operator
+        bool operator==(const const_iterator& _other) const noexcept
+        {
+            return _m_map_ptr == _other._m_map_ptr &&
+                _m_page == _other._m_page && _m_slot == _other._m_slot;
+        }
+
+        // Inequality operator
+        bool operator!=(const const_iterator& _other) const noexcept
+        { return !(*this == _other); }
+
+        // Dereference operators
+        const _value_t& operator*() const noexcept { return _m_value; }
+        const _value_t* operator->() const noexcept { return &_m_value; }
+
+        // Prefix increment operator
+        const_iterator& operator++()
+        {
+            _m_slot++;
+            _settle();
+
+            return *this;
+        }
+
+        // Postfix increment operator
+        const_iterator operator++(int)
+        {
+            const_iterator temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructor with the path of the file, the count of pages in the
+    // cache and the size of the page. The existing file is opened with its
+    // own page size, otherwise the empty map is created
+    explicit DiskHashMap
+    (
+        const std::string& _path,
+        size_t _cache_pages = DEFAULT_CACHE_PAGES,
+        size_t _page_size = DEFAULT_PAGE_SIZE,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        _m_fd{-1},
+        _m_page_size{_page_size},
+        _m_page_capacity{0},
+        _m_depth{0},
+        _m_directory{},
+        _m_count_pages{0},
+        _m_count{0},
+        _m_seed{_Random_seed()},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal},
+        _m_cache{_cache_pages > 2 ? _cache_pages : 2},
+        _m_stats{0, 0, 0},
+        _m_spare{}
+    {
+        if
+        (
+            _page_size < sizeof(_file_header_t) ||
+            (_page_size - sizeof(_page_header_t)) / ENTRY_SIZE < 2
+        )
+            throw std::invalid_argument("the page must hold the header and "
+                "at least two elements");
+
+        _m_page_capacity = (_page_size - sizeof(_page_header_t)) / ENTRY_SIZE;
+        _m_fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+
+        if (_m_fd < 0)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to open the file " + _path);
+
+        try
+        {
+            off_t size = ::lseek(_m_fd, 0, SEEK_END);
+
+            if (size > 0)
+                _open_file();
+            else
+                _create_file();
+        }
+        catch (...)
+        {
+            ::close(_m_fd);
+            throw;
+        }
+
+        _m_cache.on_evict([this](const uint64_t& _page, _frame_t& _frame)
+        {
+            if (_frame._m_is_dirty)
+                _write_page(_page, _frame);
+
+            _m_spare = std::move(_frame._m_data);
+        });
+    }
+
+    // The map owns the descriptor of the file, so it is not copyable
+    DiskHashMap(const DiskHashMap&) = delete;
+    DiskHashMap& operator=(const DiskHashMap&) = delete;
+
+    // Destructor, the map is flushed to the file
+    ~DiskHashMap()
+    {
+        try
+        {
+            _write_all();
+        }
+        catch (...)
+        {
+        }
+
+        ::close(_m_fd);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the map
+    const_iterator begin() const { return const_iterator(*this, 1, 0); }
+    // Returns the iterator set to the beginning of the map
+    const_iterator cbegin() const { return const_iterator(*this, 1, 0); }
+    // Returns the iterator set to the end of the map
+    const_iterator end() const
+    { return const_iterator(*this, _m_count_pages, 0); }
+    // Returns the iterator set to the end of the map
+    const_iterator cend() const
+    { return const_iterator(*this, _m_count_pages, 0); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_count; }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_count == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator to the element with the key or the end iterator
+    const_iterator find(const _key_t& _key) const
+    {
+        uint64_t page = _page_of(_hash(_key));
+        const _frame_t& frame = _load(page);
+        size_t n = _find_entry(frame, _key);
+
+        if (n == _header(frame)._m_count)
+            return end();
+
+        return const_iterator(*this, page, n);
+    }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const
+    {
+        const _frame_t& frame = _load(_page_of(_hash(_key)));
+
+        return _find_entry(frame, _key) < _header(frame)._m_count;
+    }
+
+    // Returns the mapped value by the key, if the element is not found,
+    // an out_of_range exception is thrown
+    _mapped_t at(const _key_t& _key) const
+    {
+        const _frame_t& frame = _load(_page_of(_hash(_key)));
+        size_t n = _find_entry(frame, _key);
+
+        if (n == _header(frame)._m_count)
+            throw std::out_of_range("the element with this key was not found");
+
+        return _mapped_at(frame, n);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts the element if there is no element with its key, returns the
+    // iterator to the element with the key and whether it was inserted
+    std::pair<const_iterator, bool> insert(const _value_t& _val)
+    { return _insert(_val.first, _val.second, false); }
+
+    // Inserts the element or replaces the mapped value of the element with
+    // the same key, returns whether the element was inserted
+    bool insert_or_assign(const _key_t& _key, const _mapped_t& _data)
+    { return _insert(_key, _data, true).second; }
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    {
+        uint64_t page = _page_of(_hash(_key));
+        _frame_t& frame = _load(page);
+        size_t n = _find_entry(frame, _key);
+
+        if (n == _header(frame)._m_count)
+            return 0;
+
+        _erase_entry(frame, n);
+
+        return 1;
+    }
+
+    // Erase item set by the iterator, the last entry of its page takes its
+    // place, so the returned iterator refers the same position
+    const_iterator erase(const_iterator _pos)
+    {
+        _erase_entry(_load(_pos._m_page), _pos._m_slot);
+
+        return const_iterator(*this, _pos._m_page, _pos._m_slot);
+    }
+
+    // Clear the container, the file is truncated
+    void clear() { _create_file(); }
+
+    // Writes the modified pages, the directory and the header to the file
+    // and waits for them to reach the storage
+    void flush()
+    {
+        _write_all();
+
+        if (::fsync(_m_fd) < 0)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to sync the file");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Pages and cache
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the size of the page
+    size_t page_size() const noexcept { return _m_page_size; }
+    // Returns the max count of elements in the page
+    size_t page_capacity() const noexcept { return _m_page_capacity; }
+    // Returns the count of pages in the file with the header page
+    size_t count_pages() const noexcept { return _m_count_pages; }
+    // Returns the depth of the directory
+    size_t depth() const noexcept { return _m_depth; }
+    // Returns the max count of pages in the cache
+    size_t cache_pages() const noexcept { return _m_cache.max_entries(); }
+
+    // Returns the statistics of the cache
+    stats_t stats() const noexcept { return _m_stats; }
+    // Resets the statistics of the cache
+    void reset_stats() noexcept { _m_stats = stats_t{0, 0, 0}; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // DiskHashMap
+
+
+#endif  // _DISKHASHMAP_
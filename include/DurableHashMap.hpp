@@ -0,0 +1,824 @@
+// DurableHashMap.hpp
+
+#ifndef _DURABLEHASHMAP_
+#define _DURABLEHASHMAP_
+
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <functional>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <hash/hash_bytes.hpp>
+#include <hash/hash_impl.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+// Hash map, which mutations are appended to the write-ahead log. Every
+// assignment and erasure is applied to the map in the memory and encoded to
+// the record of the log with its checksum. The records are written and
+// synced to the file by the background thread in batches (group commit): the
+// batch is collected until the latency bound expires or it grows past the
+// max size, so a single "fdatasync" makes many mutations durable. The
+// mutation is durable at most the latency bound after it, "sync" waits for
+// all the previous mutations to become durable.
+//
+// On construction the map is restored from the snapshot, if there is one,
+// and the log is replayed on top of it. The table is sized for the elements
+// of the snapshot, or for the records of the log without it. The torn
+// record at the end of the log left by a crash is detected by its checksum
+// and truncated. The "snapshot" writes the map to the snapshot file and
+// truncates the log, the records are assignments and erasures, so replaying
+// of the log already included to the snapshot gives the same map.
+//
+// The keys and the mapped values must be trivially copyable, they are stored
+// as their bytes. The map itself is not thread-safe, as HashMap
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>
+>
+class DurableHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _map_t         = HashMap<_Key, _Data, _Hasher, _KeyEqual>;
+    using _value_t       = typename _map_t::_value_t;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+    using const_iterator = typename _map_t::const_iterator;
+    using iterator       = const_iterator;
+    using _duration_t    = std::chrono::microseconds;
+
+    static_assert(std::is_trivially_copyable<_Key>::value &&
+        std::is_trivially_copyable<_Data>::value,
+        "the keys and the mapped values must be trivially copyable");
+
+    class mapped_proxy;
+
+    // Statistics of the log
+    struct stats_t
+    {
+        size_t records;     // Count of the appended records
+        size_t batches;     // Count of the synced batches
+        size_t bytes;       // Count of the written bytes
+    };
+
+    static constexpr size_t DEFAULT_MAX_BATCH_SIZE = size_t(1) << 20;
+
+protected:
+    static constexpr uint64_t MAGIC = 0x50414e5344484d44ull; // "DMHDSNAP"
+    static constexpr uint32_t VERSION = 1;
+    // Operations of the records
+    static constexpr uint8_t OP_ASSIGN = 1;
+    static constexpr uint8_t OP_ERASE = 2;
+    // Layout of the record: checksum, operation, key and mapped value
+    static constexpr size_t CHECKSUM_SIZE = sizeof(uint32_t);
+    static constexpr size_t BODY_SIZE = 1 + sizeof(_Key) + sizeof(_Data);
+    static constexpr size_t RECORD_SIZE = CHECKSUM_SIZE + BODY_SIZE;
+    // Size of the blocks of the snapshot and the log read at once
+    static constexpr size_t BLOCK_SIZE = 1024 * RECORD_SIZE;
+
+    // Header of the snapshot, the pairs of the keys and the mapped values
+    // and the checksum of them follow it
+    struct _snapshot_header_t
+    {
+        uint64_t _m_magic;          // Signature of the file
+        uint32_t _m_version;        // Version of the format
+        uint32_t _m_entry_size;     // Size of the key and the mapped value
+        uint64_t _m_count;          // Count of elements
+    };
+
+    _map_t _m_map;                          // Elements
+    std::string _m_path;                    // Path of the log
+    int _m_fd;                              // Descriptor of the log
+    _duration_t _m_max_delay;               // Latency bound of the batch
+    size_t _m_max_batch_size;               // Max size of the batch
+
+    mutable std::mutex _m_mutex;            // Lock of the state below
+    std::condition_variable _m_flush_cv;    // Wakes up the flusher
+    std::condition_variable _m_durable_cv;  // Wakes up the waiting sync
+    std::vector<char> _m_batch;             // Records to be written
+    std::vector<char> _m_spare;             // Buffer of the written batch
+    std::chrono::steady_clock::time_point _m_batch_start;   // First record
+    uint64_t _m_appended;                   // Count of appended records
+    uint64_t _m_durable;                    // Count of durable records
+    bool _m_is_sync_requested;              // Whether sync waits
+    bool _m_is_stopped;                     // Whether the flusher stops
+    std::exception_ptr _m_error;            // Error of the flusher
+    stats_t _m_stats;                       // Statistics
+    std::thread _m_flusher;                 // Thread writing the batches
+
+    // Returns the checksum of the bytes. FNV-1a starts from its offset
+    // basis, with the zero seed the zeroed bytes have the zero checksum
+    static uint32_t _checksum(const void* _ptr, size_t _size) noexcept
+    {
+        return static_cast<uint32_t>(_Fnv_hash_bytes(_ptr, _size,
+            __hash_impl::FNV::INITIAL_SEED));
+    }
+
+    // Throws the exception with the error code of the failed call
+    static void _throw_errno(const std::string& _what)
+    { throw std::system_error(errno, std::generic_category(), _what); }
+
+    // Writes the whole block to the end of the file
+    static void _write(int _fd, const char* _buf, size_t _size)
+    {
+        while (_size > 0)
+        {
+            ssize_t res = ::write(_fd, _buf, _size);
+
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res < 0)
+                _throw_errno("failed to write the file");
+
+            _buf += res;
+            _size -= res;
+        }
+    }
+
+    // Reads up to the specified count of bytes, returns the count of read
+    // bytes, which is less only at the end of the file
+    static size_t _read(int _fd, char* _buf, size_t _size)
+    {
+        size_t count = 0;
+
+        while (count < _size)
+        {
+            ssize_t res = ::read(_fd, _buf + count, _size - count);
+
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res < 0)
+                _throw_errno("failed to read the file");
+            if (res == 0)
+                break;
+
+            count += res;
+        }
+
+        return count;
+    }
+
+    // Syncs the directory of the file, so the renaming of the file is
+    // durable
+    void _sync_directory() const
+    {
+        size_t slash = _m_path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." :
+            _m_path.substr(0, slash + 1);
+        int fd = ::open(dir.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            _throw_errno("failed to open the directory " + dir);
+
+        int res = ::fsync(fd);
+
+        ::close(fd);
+        if (res < 0)
+            _throw_errno("failed to sync the directory " + dir);
+    }
+
+    // Returns the path of the snapshot
+    std::string _snapshot_path() const { return _m_path + ".snap"; }
+
+    // Encodes the record to the batch and wakes up the flusher, when the
+    // batch has been started or it is full
+    void _append(uint8_t _op, const _key_t& _key, const _mapped_t& _data)
+    {
+        std::lock_guard<std::mutex> lock(_m_mutex);
+
+        if (_m_error)
+            std::rethrow_exception(_m_error);
+
+        size_t offset = _m_batch.size();
+
+        _m_batch.resize(offset + RECORD_SIZE);
+
+        char* body = _m_batch.data() + offset + CHECKSUM_SIZE;
+        uint32_t checksum;
+
+        body[0] = static_cast<char>(_op);
+        std::memcpy(body + 1, &_key, sizeof(_key_t));
+        std::memcpy(body + 1 + sizeof(_key_t), &_data, sizeof(_mapped_t));
+        checksum = _checksum(body, BODY_SIZE);
+        std::memcpy(body - CHECKSUM_SIZE, &checksum, CHECKSUM_SIZE);
+
+        _m_appended++;
+        _m_stats.records++;
+
+        if (offset == 0)
+        {
+            _m_batch_start = std::chrono::steady_clock::now();
+            _m_flush_cv.notify_one();
+        }
+        else if (offset < _m_max_batch_size &&
+            _m_batch.size() >= _m_max_batch_size)
+            _m_flush_cv.notify_one();
+    }
+
+    // Appends the assignment of the element
+    void _log_assign(const _key_t& _key, const _mapped_t& _data)
+    { _append(OP_ASSIGN, _key, _data); }
+
+    // Inserts the element or replaces the mapped value of the element with
+    // the same key and logs the assignment
+    std::pair<typename _map_t::iterator, bool> _assign(const _key_t& _key,
+        const _mapped_t& _data)
+    {
+        std::pair<typename _map_t::iterator, bool> res
+            = _m_map.insert(_value_t(_key, _data));
+
+        if (!res.second)
+            (*res.first).second = _data;
+
+        _log_assign(_key, _data);
+
+        return res;
+    }
+
+    // Returns the mapped value of the key, the absent element is inserted
+    // with the default mapped value and the insertion is logged
+    _mapped_t& _find_or_insert(const _key_t& _key)
+    {
+        typename _map_t::iterator iter = _m_map.find(_key);
+
+        if (iter == _m_map.end())
+        {
+            iter = _m_map.insert(_value_t(_key, _mapped_t{})).first;
+            _log_assign(_key, (*iter).second);
+        }
+
+        return (*iter).second;
+    }
+
+    // Appends the erasure of the element, its mapped value is zeroed
+    void _log_erase(const _key_t& _key)
+    {
+        _mapped_t data;
+
+        std::memset(static_cast<void*>(&data), 0, sizeof(data));
+        _append(OP_ERASE, _key, data);
+    }
+
+    // Loop of the flusher thread. It waits for the first record of the
+    // batch, then for the latency bound, the max size of the batch or the
+    // sync request, and writes and syncs the whole batch without the lock
+    void _flush_loop()
+    {
+        std::unique_lock<std::mutex> lock(_m_mutex);
+
+        while (true)
+        {
+            _m_flush_cv.wait(lock, [this]()
+            { return _m_is_stopped || !_m_batch.empty(); });
+
+            if (_m_batch.empty())
+                return;
+
+            _m_flush_cv.wait_until(lock, _m_batch_start + _m_max_delay,
+                [this]()
+                {
+                    return _m_is_stopped || _m_is_sync_requested ||
+                        _m_batch.size() >= _m_max_batch_size;
+                });
+
+            std::vector<char> batch;
+            uint64_t appended = _m_appended;
+
+            batch.swap(_m_batch);
+            _m_batch.swap(_m_spare);
+            _m_is_sync_requested = false;
+            lock.unlock();
+
+            try
+            {
+                _write(_m_fd, batch.data(), batch.size());
+
+                if (::fdatasync(_m_fd) < 0)
+                    _throw_errno("failed to sync the log");
+            }
+            catch (...)
+            {
+                lock.lock();
+                _m_error = std::current_exception();
+                _m_durable_cv.notify_all();
+
+                return;
+            }
+
+            lock.lock();
+            _m_durable = appended;
+            _m_stats.batches++;
+            _m_stats.bytes += batch.size();
+            batch.clear();
+            _m_spare.swap(batch);
+            _m_durable_cv.notify_all();
+        }
+    }
+
+    // Stops the flusher after writing of the last batch
+    void _stop_flusher() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(_m_mutex);
+            _m_is_stopped = true;
+        }
+
+        _m_flush_cv.notify_one();
+
+        if (_m_flusher.joinable())
+            _m_flusher.join();
+    }
+
+    // Applies the record to the map, returns false if the record is damaged
+    bool _apply(const char* _record)
+    {
+        uint32_t checksum;
+
+        std::memcpy(&checksum, _record, CHECKSUM_SIZE);
+
+        const char* body = _record + CHECKSUM_SIZE;
+
+        if (checksum != _checksum(body, BODY_SIZE))
+            return false;
+
+        _key_t key;
+        _mapped_t data;
+
+        std::memcpy(&key, body + 1, sizeof(_key_t));
+        std::memcpy(&data, body + 1 + sizeof(_key_t), sizeof(_mapped_t));
+
+        if (body[0] == OP_ASSIGN)
+            _m_map[key] = data;
+        else if (body[0] == OP_ERASE)
+            _m_map.erase(key);
+        else
+            return false;
+
+        return true;
+    }
+
+    // Reads the snapshot to the map, the table is sized for its elements or
+    // for the specified count of records of the log without the snapshot.
+    // The log after the snapshot is mostly the assignments of its elements,
+    // so the table grows by itself for the new ones
+    void _load_snapshot(size_t _count_records)
+    {
+        int fd = ::open(_snapshot_path().c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            if (errno != ENOENT)
+                _throw_errno("failed to open the snapshot");
+
+            _m_map.reverse(_count_records);
+            return;
+        }
+
+        try
+        {
+            _snapshot_header_t header;
+
+            if
+            (
+                _read(fd, reinterpret_cast<char*>(&header), sizeof(header))
+                    != sizeof(header) ||
+                header._m_magic != MAGIC ||
+                header._m_version != VERSION ||
+                header._m_entry_size != sizeof(_key_t) + sizeof(_mapped_t)
+            )
+                throw std::runtime_error("the snapshot is damaged");
+
+            _m_map.reverse(header._m_count);
+
+            const size_t ENTRY_SIZE = sizeof(_key_t) + sizeof(_mapped_t);
+            std::vector<char> block(BLOCK_SIZE / ENTRY_SIZE * ENTRY_SIZE);
+            size_t hash = __hash_impl::FNV::INITIAL_SEED;
+
+            for (uint64_t n = 0; n < header._m_count;)
+            {
+                size_t count = std::min<uint64_t>(header._m_count - n,
+                    block.size() / ENTRY_SIZE);
+
+                if (_read(fd, block.data(), count * ENTRY_SIZE) !=
+                    count * ENTRY_SIZE)
+                    throw std::runtime_error("the snapshot is truncated");
+
+                hash = _Fnv_hash_bytes(block.data(), count * ENTRY_SIZE,
+                    hash);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    _key_t key;
+                    _mapped_t data;
+                    const char* entry = block.data() + i * ENTRY_SIZE;
+
+                    std::memcpy(&key, entry, sizeof(_key_t));
+                    std::memcpy(&data, entry + sizeof(_key_t),
+                        sizeof(_mapped_t));
+                    _m_map.insert(_value_t(key, data));
+                }
+
+                n += count;
+            }
+
+            uint64_t checksum;
+
+            if
+            (
+                _read(fd, reinterpret_cast<char*>(&checksum),
+                    sizeof(checksum)) != sizeof(checksum) ||
+                checksum != hash
+            )
+                throw std::runtime_error("the snapshot is damaged");
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+
+        ::close(fd);
+    }
+
+    // Restores the map from the snapshot and the log, the damaged tail of
+    // the log is truncated
+    void _recover()
+    {
+        struct stat st;
+
+        if (::fstat(_m_fd, &st) < 0)
+            _throw_errno("failed to read the size of the log");
+
+        _load_snapshot(st.st_size / RECORD_SIZE);
+
+        std::vector<char> block(BLOCK_SIZE);
+        off_t valid = 0;
+        size_t size;
+
+        while ((size = _read(_m_fd, block.data(), block.size())) > 0)
+        {
+            size_t n = 0;
+
+            for (; n + RECORD_SIZE <= size; n += RECORD_SIZE)
+                if (!_apply(block.data() + n))
+                    break;
+
+            valid += n;
+
+            if (n < block.size())
+                break;
+        }
+
+        if (valid < st.st_size)
+        {
+            if (::ftruncate(_m_fd, valid) < 0 || ::fdatasync(_m_fd) < 0)
+                _throw_errno("failed to truncate the log");
+        }
+    }
+
+public:
+    // Proxy of the mapped value returned by the indexing operator, the
+    // assignment to it is logged. The absent element is inserted only by
+    // the proxy, so the assignment to it appends the single record, and the
+    // reading of it inserts and logs the default mapped value
+    class mapped_proxy
+    {
+    private:
+        friend class DurableHashMap;
+
+        DurableHashMap* _m_owner;       // Map of the element
+        _key_t _m_key;                  // Key of the element
+        mutable _mapped_t* _m_data_ptr; // Mapped value or null if absent
+
+        // Constructor with the map and the element
+        mapped_proxy(DurableHashMap& _owner, const _key_t& _key,
+            _mapped_t* _data_ptr) noexcept:
+            _m_owner{&_owner},
+            _m_key(_key),
+            _m_data_ptr{_data_ptr}
+        {}
+
+    public:
+        // Assigns and logs the mapped value
+        mapped_proxy& operator=(const _mapped_t& _data)
+        {
+            if (_m_data_ptr != nullptr)
+            {
+                *_m_data_ptr = _data;
+                _m_owner->_log_assign(_m_key, _data);
+            }
+            else
+            {
+                typename _map_t::iterator iter
+                    = _m_owner->_assign(_m_key, _data).first;
+                _m_data_ptr = &(*iter).second;
+            }
+
+            return *this;
+        }
+
+        // Assigns the mapped value of the other proxy
+        mapped_proxy& operator=(const mapped_proxy& _other)
+        { return *this = static_cast<const _mapped_t&>(_other); }
+
+        // Returns the mapped value
+        operator const _mapped_t&() const
+        {
+            if (_m_data_ptr == nullptr)
+                _m_data_ptr = &_m_owner->_find_or_insert(_m_key);
+
+            return *_m_data_ptr;
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructor with the path of the log, the latency bound and the max
+    // size in bytes of the batch. The map is restored from the snapshot
+    // and the log if they exist
+    explicit DurableHashMap
+    (
+        const std::string& _path,
+        _duration_t _max_delay = std::chrono::milliseconds(2),
+        size_t _max_batch_size = DEFAULT_MAX_BATCH_SIZE,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        _m_map(0, _hasher, _key_equal),
+        _m_path{_path},
+        _m_fd{-1},
+        _m_max_delay{_max_delay},
+        _m_max_batch_size{_max_batch_size > 0 ? _max_batch_size : 1},
+        _m_batch{},
+        _m_spare{},
+        _m_batch_start{},
+        _m_appended{0},
+        _m_durable{0},
+        _m_is_sync_requested{false},
+        _m_is_stopped{false},
+        _m_error{},
+        _m_stats{0, 0, 0},
+        _m_flusher{}
+    {
+        _m_fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+
+        if (_m_fd < 0)
+            _throw_errno("failed to open the log " + _path);
+
+        try
+        {
+            _recover();
+            _m_flusher = std::thread(&DurableHashMap::_flush_loop, this);
+        }
+        catch (...)
+        {
+            ::close(_m_fd);
+            throw;
+        }
+    }
+
+    // The map owns the log and its flusher, so it is not copyable
+    DurableHashMap(const DurableHashMap&) = delete;
+    DurableHashMap& operator=(const DurableHashMap&) = delete;
+
+    // Destructor, the appended records are written to the log
+    ~DurableHashMap()
+    {
+        _stop_flusher();
+        ::close(_m_fd);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the const iterator set to the beginning of the container
+    const_iterator begin() const noexcept { return _m_map.begin(); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept { return _m_map.cbegin(); }
+    // Returns the const iterator set to the end of the container
+    const_iterator end() const noexcept { return _m_map.end(); }
+    // Returns the const iterator set to the end of the container
+    const_iterator cend() const noexcept { return _m_map.cend(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_map.size(); }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_map.empty(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Accessing an element by key and returning an iterator
+    const_iterator find(const _key_t& _key) const
+    { return _m_map.find(_key); }
+
+    // Returns count of items with specified key in container
+    size_t count(const _key_t& _key) const
+    { return _m_map.count(_key); }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+    const _mapped_t& at(const _key_t& _key) const
+    { return _m_map.at(_key); }
+
+    // Indexing operator. The absent element is inserted by the assignment
+    // to the proxy with the assigned mapped value or by the reading of it
+    // with the default one, the insertion is logged
+    mapped_proxy operator[](const _key_t& _key)
+    {
+        typename _map_t::iterator iter = _m_map.find(_key);
+
+        return mapped_proxy(*this, _key,
+            iter != _m_map.end() ? &(*iter).second : nullptr);
+    }
+
+    // Returns the map of the elements
+    const _map_t& map() const noexcept { return _m_map; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts the element if there is no element with its key
+    std::pair<const_iterator, bool> insert(const _value_t& _val)
+    {
+        std::pair<typename _map_t::iterator, bool> res = _m_map.insert(_val);
+
+        if (res.second)
+            _log_assign(_val.first, _val.second);
+
+        return std::pair<const_iterator, bool>(res.first, res.second);
+    }
+
+    // Inserts the element or replaces the mapped value of the element with
+    // the same key, returns whether the element was inserted
+    bool insert_or_assign(const _key_t& _key, const _mapped_t& _data)
+    { return _assign(_key, _data).second; }
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    {
+        if (_m_map.erase(_key) == 0)
+            return 0;
+
+        _log_erase(_key);
+
+        return 1;
+    }
+
+    // Clears the container, the empty snapshot replaces the log
+    void clear()
+    {
+        _m_map.clear();
+        snapshot();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Durability
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Waits for all the previous mutations to become durable
+    void sync()
+    {
+        std::unique_lock<std::mutex> lock(_m_mutex);
+        uint64_t target = _m_appended;
+
+        if (_m_durable < target && !_m_error)
+        {
+            _m_is_sync_requested = true;
+            _m_flush_cv.notify_one();
+            _m_durable_cv.wait(lock, [this, target]()
+            { return _m_durable >= target || _m_error; });
+        }
+
+        if (_m_error)
+            std::rethrow_exception(_m_error);
+    }
+
+    // Writes the map to the snapshot and truncates the log. The snapshot is
+    // written to the temporary file and renamed, so the previous snapshot
+    // remains valid until the new one is durable
+    void snapshot()
+    {
+        sync();
+
+        std::string path = _snapshot_path();
+        std::string temp = path + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd < 0)
+            _throw_errno("failed to create the snapshot " + temp);
+
+        try
+        {
+            const size_t ENTRY_SIZE = sizeof(_key_t) + sizeof(_mapped_t);
+            _snapshot_header_t header{MAGIC, VERSION, uint32_t(ENTRY_SIZE),
+                _m_map.size()};
+            std::vector<char> block;
+            uint64_t hash = __hash_impl::FNV::INITIAL_SEED;
+
+            block.reserve(BLOCK_SIZE + ENTRY_SIZE);
+            _write(fd, reinterpret_cast<const char*>(&header),
+                sizeof(header));
+
+            for (const _value_t& val : _m_map)
+            {
+                size_t offset = block.size();
+
+                block.resize(offset + ENTRY_SIZE);
+                std::memcpy(&block[offset], &val.first, sizeof(_key_t));
+                std::memcpy(&block[offset + sizeof(_key_t)], &val.second,
+                    sizeof(_mapped_t));
+
+                if (block.size() >= BLOCK_SIZE)
+                {
+                    hash = _Fnv_hash_bytes(block.data(), block.size(), hash);
+                    _write(fd, block.data(), block.size());
+                    block.clear();
+                }
+            }
+
+            hash = _Fnv_hash_bytes(block.data(), block.size(), hash);
+            _write(fd, block.data(), block.size());
+            _write(fd, reinterpret_cast<const char*>(&hash), sizeof(hash));
+
+            if (::fsync(fd) < 0)
+                _throw_errno("failed to sync the snapshot");
+        }
+        catch (...)
+        {
+            ::close(fd);
+            ::unlink(temp.c_str());
+            throw;
+        }
+
+        ::close(fd);
+
+        if (std::rename(temp.c_str(), path.c_str()) < 0)
+            _throw_errno("failed to rename the snapshot");
+
+        _sync_directory();
+
+        // The flusher is idle, because there are no records after the sync
+        std::lock_guard<std::mutex> lock(_m_mutex);
+
+        if (::ftruncate(_m_fd, 0) < 0 || ::fdatasync(_m_fd) < 0)
+            _throw_errno("failed to truncate the log");
+    }
+
+    // Returns the statistics of the log
+    stats_t stats() const
+    {
+        std::lock_guard<std::mutex> lock(_m_mutex);
+        return _m_stats;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // DurableHashMap
+
+
+#endif  // _DURABLEHASHMAP_
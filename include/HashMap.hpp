@@ -9,95 +9,902 @@
 #include <initializer_list>
 #include <functional>
 #include <utility>
+#include <type_traits>
 #include <stdexcept>
 #include <memory>
 #include <cmath>
+#include <limits>
+#include <cstdint>
 #include <cstddef>
 
 #include <hash/hash.hpp>
 #include <hash/hash_functions.hpp>
+#include <BloomFilter.hpp>
+#include <RehashPolicy.hpp>
 
 
-// Hash map container
+// Iterator over the elements of a single bucket. It adapts the iterator
+// over the nodes of the collision chain to the elements stored in them
+template <class _NodeIter, class _Value>
+class __bucket_iterator:
+    public std::iterator<std::forward_iterator_tag, _Value>
+{
+private:
+    template <class, class> friend class __bucket_iterator;
+
+    _NodeIter _m_iter;  // Iterator over the chain nodes
+
+public:
+    // Default constructor
+    __bucket_iterator() = default;
+
+    // Constructor with the node iterator parameter
+    explicit __bucket_iterator(const _NodeIter& _iter): _m_iter{_iter} {}
+
+    // Converting constructor from the iterator over mutable elements
+    template <class _OtherIter, class _OtherValue>
+    __bucket_iterator
+    (
+        const __bucket_iterator<_OtherIter, _OtherValue>& _other
+    ):
+        _m_iter{_other._m_iter}
+    {}
+
+    // Equality operator
+    bool operator==(const __bucket_iterator& _other) const noexcept
+    { return _m_iter == _other._m_iter; }
+
+    // Inequality operator
+    bool operator!=(const __bucket_iterator& _other) const noexcept
+    { return _m_iter != _other._m_iter; }
+
+    // Dereference operators
+    _Value& operator*() const noexcept { return _m_iter->_m_value; }
+    _Value* operator->() const noexcept { return &_m_iter->_m_value; }
+
+    // Prefix increment operator
+    __bucket_iterator& operator++() noexcept
+    {
+        ++_m_iter;
+        return *this;
+    }
+
+    // Postfix increment operator
+    __bucket_iterator operator++(int) noexcept
+    {
+        __bucket_iterator temp = *this;
+        ++_m_iter;
+
+        return temp;
+    }
+};
+
+
+// Two-level bitmap of the non-empty buckets. The lower level has a bit for
+// every bucket and the upper level has a bit for every nonzero word of the
+// lower one, so the search of the next non-empty bucket skips 64 empty
+// buckets by a bit and 4096 empty buckets by a word of the upper level
+class __bucket_bitmap
+{
+private:
+    static constexpr size_t BITS_PER_WORD = 64;
+
+    std::vector<uint64_t> _m_bits;      // Bits of the buckets
+    std::vector<uint64_t> _m_words;     // Bits of the nonzero words
+    size_t _m_size;                     // Count of the buckets
+
+    static size_t _count_words(size_t _count) noexcept
+    { return (_count + BITS_PER_WORD - 1) / BITS_PER_WORD; }
+
+    // Returns the index of the lowest set bit of the nonzero word
+    static size_t _lowest_bit(uint64_t _bits) noexcept
+    { return __builtin_ctzll(_bits); }
+
+public:
+    // Constructor with the count of buckets, all of them are empty
+    explicit __bucket_bitmap(size_t _size = 0):
+        _m_bits(_count_words(_size), 0),
+        _m_words(_count_words(_count_words(_size)), 0),
+        _m_size{_size}
+    {}
+
+    // Marks the bucket as non-empty
+    void set(size_t _n) noexcept
+    {
+        size_t word = _n / BITS_PER_WORD;
+
+        _m_bits[word] |= uint64_t(1) << (_n % BITS_PER_WORD);
+        _m_words[word / BITS_PER_WORD] |=
+            uint64_t(1) << (word % BITS_PER_WORD);
+    }
+
+    // Marks the bucket as empty
+    void reset(size_t _n) noexcept
+    {
+        size_t word = _n / BITS_PER_WORD;
+
+        _m_bits[word] &= ~(uint64_t(1) << (_n % BITS_PER_WORD));
+
+        if (_m_bits[word] == 0)
+            _m_words[word / BITS_PER_WORD] &=
+                ~(uint64_t(1) << (word % BITS_PER_WORD));
+    }
+
+    // Returns number of the first non-empty bucket starting from the
+    // specified one, or the count of buckets if there is no such bucket
+    size_t next(size_t _n) const noexcept
+    {
+        if (_n >= _m_size)
+            return _m_size;
+
+        size_t word = _n / BITS_PER_WORD;
+        uint64_t bits = _m_bits[word] &
+            (~uint64_t(0) << (_n % BITS_PER_WORD));
+
+        if (bits != 0)
+            return word * BITS_PER_WORD + _lowest_bit(bits);
+
+        // The next nonzero word of the lower level is found by the upper one
+        size_t upper = ++word / BITS_PER_WORD;
+
+        if (upper >= _m_words.size())
+            return _m_size;
+
+        bits = _m_words[upper] & (~uint64_t(0) << (word % BITS_PER_WORD));
+
+        while (bits == 0)
+        {
+            if (++upper == _m_words.size())
+                return _m_size;
+
+            bits = _m_words[upper];
+        }
+
+        word = upper * BITS_PER_WORD + _lowest_bit(bits);
+
+        return word * BITS_PER_WORD + _lowest_bit(_m_bits[word]);
+    }
+
+    // Returns the memory in bytes used by the bitmap
+    size_t memory_usage() const noexcept
+    {
+        return (_m_bits.capacity() + _m_words.capacity()) *
+            sizeof(uint64_t);
+    }
+}; // __bucket_bitmap
+
+
+// Returns the cached unused memory of the allocator to its source if the
+// allocator takes the memory from the memory resource
+template <class _Alloc>
+auto __trim_allocator(const _Alloc& _alloc, int)
+    -> decltype(_alloc.resource()->trim(), void())
+{ _alloc.resource()->trim(); }
+
+template <class _Alloc>
+void __trim_allocator(const _Alloc&, long) {}
+
+
+// Functor returning the key of the key-value pair
+struct __select_first
+{
+    template <class _Pair>
+    const typename _Pair::first_type& operator()(const _Pair& _pair)
+        const noexcept
+    { return _pair.first; }
+};
+
+// Functor returning the value itself as the key
+struct __identity
+{
+    template <class _Type>
+    const _Type& operator()(const _Type& _value) const noexcept
+    { return _value; }
+};
+
+// Hook of the merge leaving the element with the key already in the target
+// container in the source one
+struct __keep_source
+{
+    template <class _Type>
+    bool operator()(_Type&, _Type&&) const noexcept { return false; }
+};
+
+
+// Hash table with collision chains. It is the engine of the hash containers,
+// which store the elements of "_Value" type with the keys obtained from the
+// elements by "_ExtractKey" functor. The growth and the shrinking of the
+// bucket array are decided by "_RehashPolicy"
 template
 <
-    class _Key, class _Data,
-    class _Hasher = hash<_Key>,
-    class _KeyEqual = std::equal_to<_Key>,
-    class _Allocator = std::allocator<std::pair<const _Key, _Data>>
+    class _Key, class _Value, class _ExtractKey,
+    class _Hasher, class _KeyEqual, class _Allocator,
+    class _RehashPolicy = DefaultRehashPolicy
 >
-class HashMap
+class __HashTable
 {
 public:
     using _key_t         = _Key;
-    using _mapped_t      = _Data;
-    using _value_t       = std::pair<const _key_t, _mapped_t>;
+    using _value_t       = _Value;
     using _hasher_t      = _Hasher;
     using _key_equal_t   = _KeyEqual;
     using _allocator_t   = _Allocator;
+    using _rehash_policy_t = _RehashPolicy;
+
+protected:
+    // Node of the collision chain, which stores the element together with
+    // the hash value of its key. The hash value precedes the element, so it
+    // shares the cache line with the link of the node and the walk along
+    // the chain does not touch the large mapped values of the other keys
+    struct _node_t
+    {
+        size_t _m_hash;     // Hash value of the element key
+        _value_t _m_value;  // Stored element
+
+        // Constructor with the hash value and the element parameters
+        template <class... _Args>
+        _node_t(size_t _hash, _Args&&... _args):
+            _m_hash{_hash},
+            _m_value(std::forward<_Args>(_args)...)
+        {}
+    };
 
-private:
-    using _bucket_t = std::forward_list<_value_t, _allocator_t>;
+    using _alloc_traits = std::allocator_traits<_allocator_t>;
+    using _node_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_node_t>;
+    using _bucket_t = std::forward_list<_node_t, _node_allocator_t>;
+    using _node_iterator = typename _bucket_t::iterator;
+    using _const_node_iterator = typename _bucket_t::const_iterator;
+    using _bucket_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_bucket_t>;
+    using _table_t = std::vector<_bucket_t, _bucket_allocator_t>;
     using _table_iterator        
-        = typename std::vector<_bucket_t>::iterator;
+        = typename _table_t::iterator;
     using _const_table_iterator  
-        = typename std::vector<_bucket_t>::const_iterator;
+        = typename _table_t::const_iterator;
 
 public:
     class iterator;
     class const_iterator;
-    using bucket_iterator       = typename _bucket_t::iterator;
-    using const_bucket_iterator = typename _bucket_t::const_iterator;
+    using bucket_iterator
+        = __bucket_iterator<_node_iterator, _value_t>;
+    using const_bucket_iterator
+        = __bucket_iterator<_const_node_iterator, const _value_t>;
+    class node_type;
+    struct insert_return_type;
+
+    // Key together with its hash value. It allows to hash the key once and
+    // then reuse the hash in several operations on the same key, or to pass
+    // the hash value already computed by the caller. The hash value is the
+    // value of the hasher of the container without the seed, as returned
+    // by "hash_key", the container mixes it with its current seed, so the
+    // handle remains valid after reseeding. The hashers taking the seed
+    // hash the key again with the seed of the container. The key must
+    // outlive the handle
+    class hashed_key
+    {
+    private:
+        const _key_t* _m_key_ptr;   // Pointer to the key
+        size_t _m_hash;             // Hash value of the key
 
-private:
-    static constexpr size_t MIN_COUNT_BUCKETS  = 16;
-    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+    public:
+        // Constructor with the key and its hash value
+        hashed_key(const _key_t& _key, size_t _hash) noexcept:
+            _m_key_ptr{&_key},
+            _m_hash{_hash}
+        {}
+
+        // Returns the key
+        const _key_t& key() const noexcept { return *_m_key_ptr; }
+        // Returns the hash value of the key without the seed
+        size_t hash() const noexcept { return _m_hash; }
+    };
+
+protected:
+    static constexpr size_t MIN_COUNT_BUCKETS
+        = _RehashPolicy::MIN_COUNT_BUCKETS;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR
+        = _RehashPolicy::DEFAULT_MAX_LOAD_FACTOR;
+    static constexpr float DEFAULT_MIN_LOAD_FACTOR
+        = _RehashPolicy::DEFAULT_MIN_LOAD_FACTOR;
+    static constexpr size_t ERASE_BATCH_SIZE = 256;
+    static constexpr size_t MAX_CHAIN_LENGTH = 32;
     
-    std::vector<_bucket_t> _m_buckets;  // Collision chains
+    _table_t _m_buckets;                // Collision chains
     size_t _m_count;                    // Count of items in map
     float _m_max_load_factor;           // Max load factor
+    float _m_min_load_factor;           // Min load factor
     _hasher_t _m_hasher;                // Hasher functor
     _key_equal_t _m_key_equal;          // Key equal functor
     _allocator_t _m_allocator;          // Allocator for _value_t
+    BlockedBloomFilter _m_filter;       // Filter of the absent keys
+    size_t _m_seed;                     // Seed of the hash values
+    size_t _m_reseed_count;             // Count of items allowing reseeding
+    __bucket_bitmap _m_occupied;        // Bitmap of the non-empty buckets
+    size_t _m_first_bucket;             // First non-empty bucket
+    bool _m_is_shrinkable;              // Whether erased since resizing
+
+    // Returns the key of the element
+    static const _key_t& _key_of(const _value_t& _val) noexcept
+    { return _ExtractKey()(_val); }
+
+    // Returns the hash value of the key with the seed of the container
+    size_t _hash(const _key_t& _key) const
+    { return __hash_with_seed(_m_hasher, _key, _m_seed); }
+
+    // Returns the hash value of the key of the handle with the seed of the
+    // container
+    size_t _hash(const hashed_key& _hkey) const
+    { return __seed_hash(_m_hasher, _hkey.key(), _hkey.hash(), _m_seed); }
+
+    // Returns the hash value of the node of the container with the
+    // specified seed. The stored hash value is reused if the seeds are
+    // equal, otherwise the key is hashed again
+    size_t _hash_from(size_t _seed, const _node_t& _node) const
+    {
+        return _seed == _m_seed ? _node._m_hash :
+            _hash(_key_of(_node._m_value));
+    }
+
+    // Returns the least count of buckets, which accomodates the specified
+    // count of elements without exceeding maximum load factor
+    size_t _count_for(size_t _count) const noexcept
+    { return std::ceil((double)_count / _m_max_load_factor); }
 
     // Returns the load factor of the container
-    // if it had specified count elements
+    // if it had specified count elements. The container without buckets
+    // is overflowed by any element
     float _load_factor(size_t _count) const noexcept
-    { return (float)_count / _m_buckets.size(); }
+    {
+        if (_m_buckets.empty())
+            return _count == 0 ? 0.0f : std::numeric_limits<float>::infinity();
+
+        return (float)_count / _m_buckets.size();
+    }
+
+    // Leaves the moved-from container empty without buckets. Nothing is
+    // allocated, the buckets are allocated by the next insertion
+    void _release_buckets() noexcept
+    {
+        _m_buckets.clear();
+        _m_count = 0;
+        _m_occupied = __bucket_bitmap();
+        _m_first_bucket = 0;
+        _m_is_shrinkable = false;
+    }
+
+    // Returns the array of the specified count of empty buckets, which
+    // takes the memory for itself and for the nodes from the allocator
+    static _table_t _make_buckets(size_t _count, const _allocator_t& _alloc)
+    {
+        _table_t buckets{_bucket_allocator_t(_alloc)};
+
+        buckets.reserve(_count);
+        for (size_t i = 0; i < _count; i++)
+            buckets.emplace_back(_node_allocator_t(_alloc));
+
+        return buckets;
+    }
+
+    // Returns the copy of the specified buckets, which takes the memory
+    // from the allocator
+    static _table_t
+    _copy_buckets(const _table_t& _buckets, const _allocator_t& _alloc)
+    {
+        _table_t buckets{_bucket_allocator_t(_alloc)};
+
+        buckets.reserve(_buckets.size());
+        for (const _bucket_t& bucket : _buckets)
+            buckets.emplace_back(bucket, _node_allocator_t(_alloc));
+
+        return buckets;
+    }
+
+    // Returns the buckets with the elements moved from the specified ones
+    // to the nodes from the allocator
+    static _table_t
+    _move_buckets(_table_t& _buckets, const _allocator_t& _alloc)
+    {
+        _table_t buckets{_bucket_allocator_t(_alloc)};
+
+        buckets.reserve(_buckets.size());
+        for (_bucket_t& bucket : _buckets)
+            buckets.emplace_back(std::move(bucket), _node_allocator_t(_alloc));
+
+        return buckets;
+    }
+
+    // Returns the count of buckets of the policy sequence, which is not
+    // less than the specified one and the minimum count
+    static size_t _fit_count_buckets(size_t _count) noexcept
+    {
+        if (_count < MIN_COUNT_BUCKETS)
+            _count = MIN_COUNT_BUCKETS;
+
+        return _RehashPolicy::count_buckets(_count);
+    }
+
+    // Returns number of bucket by specified hash value
+    size_t _bucket_index(size_t _hash) const noexcept
+    { return _RehashPolicy::index(_hash, _m_buckets.size()); }
+
+    // Returns number of the bucket of the container
+    size_t _index_of(const _bucket_t& _chain) const noexcept
+    { return &_chain - _m_buckets.data(); }
+
+    // Marks the bucket as non-empty in the occupancy bitmap
+    void _set_occupied(size_t _n) noexcept
+    {
+        _m_occupied.set(_n);
+
+        if (_n < _m_first_bucket)
+            _m_first_bucket = _n;
+    }
+
+    // Marks the bucket as empty in the occupancy bitmap if it has no nodes
+    void _update_occupied(size_t _n) noexcept
+    {
+        if (!_m_buckets[_n].empty())
+            return;
+
+        _m_occupied.reset(_n);
+
+        if (_n == _m_first_bucket)
+            _m_first_bucket = _next_occupied(_n + 1);
+    }
+
+    // Returns number of the first non-empty bucket starting from the
+    // specified one, or the count of buckets if there is no such bucket
+    size_t _next_occupied(size_t _n) const noexcept
+    { return _m_occupied.next(_n); }
+
+    // Checks that the load factor of the container has fallen below the
+    // minimum load factor. The minimum is limited by the maximum load factor
+    // divided by the shrink divisor of the policy, so the container which
+    // has just been expanded or shrunk is far from both limits. Only the
+    // erasures make the container sparse, so the buckets reserved for the
+    // elements, which have not been inserted yet, are kept
+    bool _is_sparse() const noexcept
+    {
+        if (!_m_is_shrinkable)
+            return false;
+
+        float min_load_factor = _m_min_load_factor;
+        float max_min_load_factor
+            = _m_max_load_factor / _RehashPolicy::SHRINK_DIVISOR;
+
+        if (min_load_factor > max_min_load_factor)
+            min_load_factor = max_min_load_factor;
+
+        return _m_buckets.size() > MIN_COUNT_BUCKETS &&
+            _load_factor(_m_count) < min_load_factor;
+    }
+
+    // Clears the filter and adds the stored hash values of all elements to
+    // it. The filter is sized for the elements the buckets can accommodate
+    // without exceeding maximum load factor
+    void _rebuild_filter()
+    {
+        if (!_m_filter.enabled())
+            return;
+
+        _m_filter.reset(_m_buckets.size() * _m_max_load_factor);
+        for (const _bucket_t& bucket : _m_buckets)
+            for (const _node_t& node : bucket)
+                _m_filter.add(node._m_hash);
+    }
+
+    // Rehashes the container before the addition of the element if it
+    // overflows after the addition or if it has become sparse. In both
+    // cases the container is sized for the count of elements grown by the
+    // policy
+    void _rehash_before_insert()
+    {
+        if (_load_factor(_m_count + 1) > _m_max_load_factor || _is_sparse())
+            reverse(_RehashPolicy::grow(_m_count));
+    }
+
+    // Adds a new element with the specified hash value of the key to the
+    // container without checking for its presence
+    template <class... _Args>
+    iterator _insert_new(size_t _hash, _Args&&... _args)
+    {
+        _rehash_before_insert();
+
+        _table_iterator table_iter = _m_buckets.begin() + _bucket_index(_hash);
+
+        (*table_iter).emplace_front(_hash, std::forward<_Args>(_args)...);
+        _m_count++;
+        _m_filter.add(_hash);
+        _set_occupied(table_iter - _m_buckets.begin());
+
+        return _check_chain(table_iter);
+    }
+
+    // Moves the node following the specified one from the specified chain
+    // to the container without checking for its presence. The node is
+    // relinked without reallocation using its stored hash value, so the
+    // chain must use the allocator equal to the container allocator
+    iterator _link_node(_bucket_t& _chain, _node_iterator _before)
+    {
+        _rehash_before_insert();
+
+        size_t hash = std::next(_before)->_m_hash;
+        _table_iterator table_iter = _m_buckets.begin() + _bucket_index(hash);
+
+        (*table_iter).splice_after((*table_iter).before_begin(), _chain,
+            _before);
+        _m_count++;
+        _m_filter.add(hash);
+        _set_occupied(table_iter - _m_buckets.begin());
+
+        return _check_chain(table_iter);
+    }
+
+    // Returns the iterator to the node just added to the front of the
+    // chain. If the chain has grown abnormally long, the container is
+    // reseeded to break up the keys colliding for the current seed. If the
+    // chains remain long after that, the keys collide for every seed, so
+    // the next reseeding is allowed only after the count of elements has
+    // doubled, which keeps the cost of reseeding amortized
+    iterator _check_chain(_table_iterator _table_iter)
+    {
+        _node_iterator node_iter = (*_table_iter).begin();
+
+        if (_m_count < _m_reseed_count || !_is_long_chain(*_table_iter))
+            return iterator(*this, _table_iter, node_iter);
+
+        reseed(_Random_seed());
+        _m_reseed_count = 2 * _m_count;
+
+        // The nodes are relinked by reseeding, so the iterator to the node
+        // remains valid, but its bucket has changed
+        _table_iter = _m_buckets.begin() + _bucket_index(node_iter->_m_hash);
+
+        return iterator(*this, _table_iter, node_iter);
+    }
+
+    // Checks that the chain is longer than the length expected for the
+    // maximum load factor by far
+    bool _is_long_chain(const _bucket_t& _chain) const noexcept
+    {
+        size_t max_length = MAX_CHAIN_LENGTH;
+
+        if (_m_max_load_factor > 1)
+            max_length *= std::ceil(_m_max_load_factor);
+
+        size_t length = 0;
+
+        for (auto iter = _chain.begin(); iter != _chain.end(); iter++)
+            if (++length > max_length)
+                return true;
+
+        return false;
+    }
+
+    // Relinks the nodes to the specified count of new buckets by their
+    // stored hash values without reallocation
+    void _relink_nodes(size_t _count_buckets)
+    {
+        _table_t new_buckets = _make_buckets(_count_buckets, _m_allocator);
+
+        _m_occupied = __bucket_bitmap(_count_buckets);
+
+        for (_bucket_t& bucket : _m_buckets)
+        {
+            while (!bucket.empty())
+            {
+                size_t i = _RehashPolicy::index(bucket.front()._m_hash,
+                    _count_buckets);
+                new_buckets[i].splice_after(new_buckets[i].before_begin(),
+                    bucket, bucket.before_begin());
+                _m_occupied.set(i);
+            }
+        }
+
+        _m_buckets = std::move(new_buckets);
+        _m_first_bucket = _next_occupied(0);
+        _m_is_shrinkable = false;
+        _rebuild_filter();
+    }
+
+    // Returns the iterator to the node preceding the node with the
+    // specified key and its hash value with the seed in the chain, or end of
+    // the chain if there is no such node
+    _node_iterator
+    _find_before(_bucket_t& _chain, const _key_t& _key, size_t _hash)
+    {
+        _node_iterator before = _chain.before_begin();
+
+        for (_node_iterator iter = _chain.begin(); iter != _chain.end();
+            before = iter++)
+        {
+            if
+            (
+                iter->_m_hash == _hash &&
+                _m_key_equal(_key, _key_of(iter->_m_value))
+            )
+                return before;
+        }
+
+        return _chain.end();
+    }
+
+    // Returns the iterator to the element with the specified key and its
+    // hash value with the seed, or end if there is no such element
+    iterator _find(const _key_t& _key, size_t _hash) noexcept
+    {
+        // The filter rejects most of the absent keys reading a single
+        // cache line instead of the collision chain
+        if (_m_buckets.empty() || !_m_filter.may_contain(_hash))
+            return iterator(*this);
+
+        size_t i = _bucket_index(_hash);
+        _table_iterator table_iter = _m_buckets.begin() + i;
+        _node_iterator buck_iter = _m_buckets[i].begin();
+
+        for (; buck_iter != _m_buckets[i].end(); buck_iter++)
+            if
+            (
+                buck_iter->_m_hash == _hash &&
+                _m_key_equal(_key, _key_of(buck_iter->_m_value))
+            )
+                return iterator(*this, table_iter, buck_iter);
+
+        _m_filter.note_false_positive();
+
+        return iterator(*this);
+    }
+
+    const_iterator _find(const _key_t& _key, size_t _hash) const noexcept
+    {
+        if (_m_buckets.empty() || !_m_filter.may_contain(_hash))
+            return const_iterator(*this);
+
+        size_t i = _bucket_index(_hash);
+        _const_table_iterator table_iter = _m_buckets.cbegin() + i;
+        _const_node_iterator buck_iter = _m_buckets[i].cbegin();
+
+        for (; buck_iter != _m_buckets[i].cend(); buck_iter++)
+            if
+            (
+                buck_iter->_m_hash == _hash &&
+                _m_key_equal(_key, _key_of(buck_iter->_m_value))
+            )
+                return const_iterator(*this, table_iter, buck_iter);
+
+        _m_filter.note_false_positive();
+
+        return const_iterator(*this);
+    }
+
+    // Erases the element with the specified key and its hash value with the
+    // seed, returns the count of removed elements
+    size_t _erase_key(const _key_t& _key, size_t _hash)
+    {
+        if (_m_buckets.empty())
+            return 0;
+
+        _bucket_t& bucket = _m_buckets[_bucket_index(_hash)];
+        _node_iterator before = _find_before(bucket, _key, _hash);
+
+        if (before == bucket.end())
+            return 0;
+
+        bucket.erase_after(before);
+        _m_count--;
+        _m_is_shrinkable = true;
+        _update_occupied(_index_of(bucket));
+
+        return 1;
+    }
+
+    // Extracts the element with the specified key and its hash value with
+    // the seed, returns empty handle if there is no such element
+    node_type _extract_key(const _key_t& _key, size_t _hash)
+    {
+        if (_m_buckets.empty())
+            return node_type();
+
+        _bucket_t& bucket = _m_buckets[_bucket_index(_hash)];
+        _node_iterator before = _find_before(bucket, _key, _hash);
+
+        if (before == bucket.end())
+            return node_type();
+
+        return _extract(bucket, before);
+    }
+
+    // Unlinks the node following the specified one from the chain and
+    // returns the node handle owning it
+    node_type _extract(_bucket_t& _chain, _node_iterator _before)
+    {
+        node_type node(_chain.get_allocator(), _m_seed);
+
+        node._m_chain.splice_after(node._m_chain.before_begin(), _chain,
+            _before);
+        _m_count--;
+        _m_is_shrinkable = true;
+        _update_occupied(_index_of(_chain));
+
+        return node;
+    }
+
+    // Erases all nodes satisfying the predicate in a single pass over
+    // buckets, returns count of removed nodes. The removed nodes are
+    // collected and released in batches
+    template <class _Predicate>
+    size_t _erase_nodes_if(_Predicate _pred)
+    {
+        _bucket_t removed{_node_allocator_t(_m_allocator)};
+        size_t count_removed = 0;
+        size_t count_batch = 0;
+
+        for (_bucket_t& bucket : _m_buckets)
+        {
+            _node_iterator before = bucket.before_begin();
+            size_t count_before = count_removed;
+
+            while (std::next(before) != bucket.end())
+            {
+                if (!_pred(static_cast<const _node_t&>(*std::next(before))))
+                {
+                    before++;
+                    continue;
+                }
+
+                removed.splice_after(removed.before_begin(), bucket, before);
+                count_removed++;
+
+                if (++count_batch == ERASE_BATCH_SIZE)
+                {
+                    removed.clear();
+                    count_batch = 0;
+                }
+            }
+
+            if (count_removed != count_before)
+                _update_occupied(_index_of(bucket));
+        }
+
+        _m_count -= count_removed;
+        _m_is_shrinkable |= count_removed > 0;
+
+        // The filter is rebuilt by rehashing, otherwise it is compacted here
+        // to drop the bits of the removed keys
+        size_t count_buckets = _m_buckets.size();
+
+        if (_is_sparse())
+            reverse(_RehashPolicy::grow(_m_count));
+
+        if (count_removed > 0 && count_buckets == _m_buckets.size())
+            _rebuild_filter();
+
+        return count_removed;
+    }
+
+    // Moves the elements from the specified container. The element, whose
+    // key is already in the container, is passed to the hook as
+    // "_combine(value, source_value)", which returns true if it has taken
+    // the source element, then the element is erased from the source,
+    // otherwise it remains there. The nodes are relinked without
+    // reallocation, the keys are hashed again only if the seeds of the
+    // containers differ
+    template <class _Combine>
+    void _merge(__HashTable& _source, _Combine _combine)
+    {
+        if (&_source == this)
+            return;
+
+        size_t count = _m_count + _source._m_count;
+
+        if (_load_factor(count) > _m_max_load_factor)
+            reverse(count);
+
+        // The nodes can be relinked only if they can be released by the
+        // allocator of the container, otherwise the elements are moved
+        bool is_relink = _m_allocator == _source._m_allocator;
+
+        for (_bucket_t& bucket : _source._m_buckets)
+        {
+            _node_iterator before = bucket.before_begin();
+
+            while (std::next(before) != bucket.end())
+            {
+                _node_t& node = *std::next(before);
+                size_t hash = _hash_from(_source._m_seed, node);
+                iterator iter = _find(_key_of(node._m_value), hash);
+
+                if (iter != end())
+                {
+                    if (!_combine(*iter, std::move(node._m_value)))
+                    {
+                        before++;
+                        continue;
+                    }
+
+                    bucket.erase_after(before);
+                }
+                else if (is_relink)
+                {
+                    node._m_hash = hash;
+                    _link_node(bucket, before);
+                }
+                else
+                {
+                    _insert_new(hash, std::move(node._m_value));
+                    bucket.erase_after(before);
+                }
+
+                _source._m_count--;
+                _source._m_is_shrinkable = true;
+            }
+
+            _source._update_occupied(_source._index_of(bucket));
+        }
+    }
+
+    // Returns the iterator to the node preceding the specified one in its
+    // chain
+    _node_iterator _before_node(_bucket_t& _chain, _const_node_iterator _node)
+    {
+        _node_iterator before = _chain.before_begin();
+
+        while (std::next(before) != _node)
+            before++;
+
+        return before;
+    }
 
 public:
     // Constructors and destructor
     ///////////////////////////////////////////////////////////////////////////
 
     // Default constructor with optional parameters
-    explicit HashMap
+    explicit __HashTable
     (
         size_t _count_buckets = MIN_COUNT_BUCKETS,
         const _hasher_t& _hasher = _hasher_t(),
         const _key_equal_t& _key_equal = _key_equal_t(),
         const _allocator_t& _allocator = _allocator_t()
     ):
-        _m_buckets{_count_buckets},
+        _m_buckets{_make_buckets(_fit_count_buckets(_count_buckets),
+            _allocator)},
         _m_count{0},
         _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_min_load_factor{DEFAULT_MIN_LOAD_FACTOR},
         _m_hasher{_hasher},
         _m_key_equal{_key_equal},
-        _m_allocator{_allocator}
+        _m_allocator{_allocator},
+        _m_filter{},
+        _m_seed{_Random_seed()},
+        _m_reseed_count{0},
+        _m_occupied{_m_buckets.size()},
+        _m_first_bucket{_m_buckets.size()},
+        _m_is_shrinkable{false}
     {}
 
     // Constructor with the allocator parameter
-    explicit HashMap(const _allocator_t& _alloc):
-        _m_buckets{MIN_COUNT_BUCKETS},
+    explicit __HashTable(const _allocator_t& _alloc):
+        _m_buckets{_make_buckets(_fit_count_buckets(MIN_COUNT_BUCKETS),
+            _alloc)},
         _m_count{0},
         _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_min_load_factor{DEFAULT_MIN_LOAD_FACTOR},
         _m_hasher{_hasher_t()},
         _m_key_equal{_key_equal_t()},
-        _m_allocator{_allocator_t()}
+        _m_allocator{_alloc},
+        _m_filter{},
+        _m_seed{_Random_seed()},
+        _m_reseed_count{0},
+        _m_occupied{_m_buckets.size()},
+        _m_first_bucket{_m_buckets.size()},
+        _m_is_shrinkable{false}
     {}
 
     // Range-based constructor
     template <class InputIterator>
-    explicit HashMap
+    explicit __HashTable
     (
         const InputIterator& begin, const InputIterator& end,
         size_t _count_buckets = MIN_COUNT_BUCKETS,
@@ -105,58 +912,111 @@ public:
         const _key_equal_t& _key_equal = _key_equal_t(),
         const _allocator_t& _allocator = _allocator_t()
     ):
-        _m_buckets{_count_buckets},
+        _m_buckets{_make_buckets(_fit_count_buckets(_count_buckets),
+            _allocator)},
         _m_count{0},
         _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_min_load_factor{DEFAULT_MIN_LOAD_FACTOR},
         _m_hasher{_hasher},
         _m_key_equal{_key_equal},
-        _m_allocator{_allocator}
+        _m_allocator{_allocator},
+        _m_filter{},
+        _m_seed{_Random_seed()},
+        _m_reseed_count{0},
+        _m_occupied{_m_buckets.size()},
+        _m_first_bucket{_m_buckets.size()},
+        _m_is_shrinkable{false}
     {
         insert(begin, end);
     }
 
     // Copy constructor
-    HashMap(const HashMap& _other):
+    __HashTable(const __HashTable& _other):
         _m_buckets{_other._m_buckets},
         _m_count{_other._m_count},
         _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
         _m_hasher{_other._m_hasher},
         _m_key_equal{_other._m_key_equal},
-        _m_allocator{_other._m_allocator}
+        _m_allocator{_other._m_allocator},
+        _m_filter{_other._m_filter},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{_other._m_occupied},
+        _m_first_bucket{_other._m_first_bucket},
+        _m_is_shrinkable{_other._m_is_shrinkable}
     {}
 
     // Copy constuctor with allocator parameter
-    HashMap(const HashMap& _other, const _allocator_t& _alloc):
-        _m_buckets{_other._m_buckets},
+    __HashTable(const __HashTable& _other, const _allocator_t& _alloc):
+        _m_buckets{_copy_buckets(_other._m_buckets, _alloc)},
         _m_count{_other._m_count},
         _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
         _m_hasher{_other._m_hasher},
         _m_key_equal{_other._m_key_equal},
-        _m_allocator{_alloc}
+        _m_allocator{_alloc},
+        _m_filter{_other._m_filter},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{_other._m_occupied},
+        _m_first_bucket{_other._m_first_bucket},
+        _m_is_shrinkable{_other._m_is_shrinkable}
     {}
 
-    // Move constructor
-    HashMap(HashMap&& _other):
+    // Move constructor. The source is left without buckets, so nothing is
+    // allocated
+    __HashTable(__HashTable&& _other)
+        noexcept
+        (
+            std::is_nothrow_move_constructible<_hasher_t>::value &&
+            std::is_nothrow_move_constructible<_key_equal_t>::value
+        ):
         _m_buckets{std::move(_other._m_buckets)},
         _m_count{_other._m_count},
         _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
         _m_hasher{std::move(_other._m_hasher)},
         _m_key_equal{std::move(_other._m_key_equal)},
-        _m_allocator{std::move(_other._m_allocator)}
-    {}
+        _m_allocator{std::move(_other._m_allocator)},
+        _m_filter{std::move(_other._m_filter)},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{std::move(_other._m_occupied)},
+        _m_first_bucket{_other._m_first_bucket},
+        _m_is_shrinkable{_other._m_is_shrinkable}
+    {
+        _other._release_buckets();
+    }
 
     // Move constuctor with allocator parameter
-    HashMap(HashMap&& _other, const _allocator_t& _alloc):
-        _m_buckets{std::move(_other._m_buckets)},
+    __HashTable(__HashTable&& _other, const _allocator_t& _alloc):
+        _m_buckets{_bucket_allocator_t(_alloc)},
         _m_count{_other._m_count},
         _m_max_load_factor{_other._m_max_load_factor},
+        _m_min_load_factor{_other._m_min_load_factor},
         _m_hasher{std::move(_other._m_hasher)},
         _m_key_equal{std::move(_other._m_key_equal)},
-        _m_allocator{std::move(_alloc)}
-    {}
+        _m_allocator{_alloc},
+        _m_filter{std::move(_other._m_filter)},
+        _m_seed{_other._m_seed},
+        _m_reseed_count{_other._m_reseed_count},
+        _m_occupied{std::move(_other._m_occupied)},
+        _m_first_bucket{_other._m_first_bucket},
+        _m_is_shrinkable{_other._m_is_shrinkable}
+    {
+        // The nodes can be taken only if they can be released by the
+        // specified allocator, otherwise the elements are moved
+        if (_m_allocator == _other._m_allocator)
+            _m_buckets = std::move(_other._m_buckets);
+        else
+            _m_buckets = _move_buckets(_other._m_buckets, _alloc);
+
+        _other._release_buckets();
+    }
 
     // Constructor based on the initialization list
-    HashMap
+    __HashTable
     (
         std::initializer_list<_value_t> _il,
         size_t _count_buckets = MIN_COUNT_BUCKETS,
@@ -164,18 +1024,26 @@ public:
         const _key_equal_t& _key_equal = _key_equal_t(),
         const _allocator_t& _allocator = _allocator_t()
     ):
-        _m_buckets{_count_buckets},
+        _m_buckets{_make_buckets(_fit_count_buckets(_count_buckets),
+            _allocator)},
         _m_count{0},
         _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_min_load_factor{DEFAULT_MIN_LOAD_FACTOR},
         _m_hasher{_hasher},
         _m_key_equal{_key_equal},
-        _m_allocator{_allocator}
+        _m_allocator{_allocator},
+        _m_filter{},
+        _m_seed{_Random_seed()},
+        _m_reseed_count{0},
+        _m_occupied{_m_buckets.size()},
+        _m_first_bucket{_m_buckets.size()},
+        _m_is_shrinkable{false}
     {
         insert(_il);
     }
 
     // Destructor
-    ~HashMap()
+    ~__HashTable()
     {}
 
     ///////////////////////////////////////////////////////////////////////////
@@ -184,34 +1052,78 @@ public:
     // Assigment operator
     ///////////////////////////////////////////////////////////////////////////
 
-    // Assignment by copying
-    HashMap& operator=(const HashMap& _other)
+    // Assignment by copying. The allocator is replaced only if it propagates
+    // on the copy assignment, otherwise the elements are copied to the nodes
+    // from the allocator of the container
+    __HashTable& operator=(const __HashTable& _other)
     {
-        _m_buckets = _other._m_buckets;
+        if (this == &_other)
+            return *this;
+
+        if (_alloc_traits::propagate_on_container_copy_assignment::value)
+            _m_allocator = _other._m_allocator;
+
+        _m_buckets = _copy_buckets(_other._m_buckets, _m_allocator);
         _m_count = _other._m_count;
         _m_max_load_factor = _other._m_max_load_factor;
+        _m_min_load_factor = _other._m_min_load_factor;
         _m_hasher = _other._m_hasher;
         _m_key_equal = _other._m_key_equal;
-        _m_allocator = _other._m_allocator;
+        _m_filter = _other._m_filter;
+        _m_seed = _other._m_seed;
+        _m_reseed_count = _other._m_reseed_count;
+        _m_occupied = _other._m_occupied;
+        _m_first_bucket = _other._m_first_bucket;
+        _m_is_shrinkable = _other._m_is_shrinkable;
 
         return *this;
     }
 
-    // Assignment by moving
-    HashMap& operator=(HashMap&& _other) noexcept
+    // Assignment by moving. The nodes are taken if the allocator propagates
+    // on the move assignment or both allocators are equal, otherwise the
+    // elements are moved to the nodes from the allocator of the container.
+    // The source is left without buckets, so only moving of the elements
+    // allocates
+    __HashTable& operator=(__HashTable&& _other)
+        noexcept
+        (
+            _alloc_traits::propagate_on_container_move_assignment::value &&
+            std::is_nothrow_move_assignable<_hasher_t>::value &&
+            std::is_nothrow_move_assignable<_key_equal_t>::value
+        )
     {
-        _m_buckets = std::move(_other._m_buckets);
+        if (this == &_other)
+            return *this;
+
+        if (_alloc_traits::propagate_on_container_move_assignment::value)
+        {
+            _m_allocator = _other._m_allocator;
+            _m_buckets = std::move(_other._m_buckets);
+        }
+        else if (_m_allocator == _other._m_allocator)
+            _m_buckets = std::move(_other._m_buckets);
+        else
+            _m_buckets = _move_buckets(_other._m_buckets, _m_allocator);
+
         _m_count = _other._m_count;
         _m_max_load_factor = _other._m_max_load_factor;
+        _m_min_load_factor = _other._m_min_load_factor;
         _m_hasher = std::move(_other._m_hasher);
         _m_key_equal = std::move(_other._m_key_equal);
-        _m_allocator = std::move(_other._m_allocator);
+        _m_filter = std::move(_other._m_filter);
+        _m_seed = _other._m_seed;
+        _m_reseed_count = _other._m_reseed_count;
+        _m_occupied = std::move(_other._m_occupied);
+        _m_first_bucket = _other._m_first_bucket;
+        _m_is_shrinkable = _other._m_is_shrinkable;
+
+        _other._release_buckets();
 
         return *this;
     }
 
     // Assignment based on the initialization list
-    HashMap& operator=(std::initializer_list<_value_t> _il)
+    __HashTable& operator=(std::initializer_list<_value_t> _il)
     {
         clear();
         insert(_il);
@@ -227,13 +1139,13 @@ public:
 
     // Returns the iterator set to the beginning of the container
     iterator begin() noexcept
-    { return iterator(*this, _m_buckets.begin()); }
+    { return iterator(*this, _m_buckets.begin() + _m_first_bucket); }
     // Returns the const iterator set to the beginning of the container
     const_iterator begin() const noexcept
-    { return const_iterator(*this, _m_buckets.cbegin()); }
+    { return const_iterator(*this, _m_buckets.cbegin() + _m_first_bucket); }
     // Returns the const iterator set to the beginning of the container
     const_iterator cbegin() const noexcept
-    { return const_iterator(*this, _m_buckets.cbegin()); }
+    { return const_iterator(*this, _m_buckets.cbegin() + _m_first_bucket); }
     // Returns the iterator set to the end of the container
     iterator end() noexcept
     { return iterator(*this); }
@@ -261,118 +1173,33 @@ public:
     // Elements access
     ///////////////////////////////////////////////////////////////////////////
 
-    // Indexing operator
-
-    _mapped_t& operator[](const _key_t& _key)
-    {
-        iterator iter = find(_key);
-
-        // If an element with such a key was founded
-        if (iter != end())
-            return (*iter).second;
-        
-        // Otherwise, add it to containter
-
-        // If an overflow of the container occurs after the addition,
-        // then it must first be expanded
-        _bucket_t* buck_ptr = nullptr;
-        if (_load_factor(_m_count + 1) > _m_max_load_factor)
-        {
-            reverse(_m_count * 2);
-            buck_ptr = &_m_buckets[bucket(_key)];
-        }
-        else
-            buck_ptr = &iter._m_table_iter;
-
-        buck_ptr->push_front(std::make_pair(_key, _mapped_t{}));
-        _m_count++;
-        
-        return buck_ptr->front().second;
-    }
-
-    _mapped_t& operator[](_key_t&& _key)
-    {
-        iterator iter = find(_key);
-
-        // If an element with such a key was founded, then return it
-        if (iter != end())
-            return (*iter).second;
-        
-        // Otherwise, add it to containter
-
-        // If an overflow of the container occurs after the addition,
-        // then it must first be expanded
-        _bucket_t* buck_ptr = nullptr;
-        if (_load_factor(_m_count + 1) > _m_max_load_factor)
-        {
-            reverse(_m_count * 2);
-            buck_ptr = &_m_buckets[bucket(_key)];
-        }
-        else
-            buck_ptr = &iter._m_table_iter;
-
-        buck_ptr->push_front(std::make_pair(_key, _mapped_t{}));
-        _m_count++;
-        
-        return buck_ptr->front().second;
-    }
-
-    // Access to the element by key, if the element is not found,
-    // an out_of_range exception is thrown
-    
-    _mapped_t& at(const _key_t& _key)
-    {
-        iterator iter = find(_key);
-
-        if (iter != end())
-            return (*iter).second;
-        else
-            throw std::out_of_range("the element with this key was not found");
-    }
-
-    const _mapped_t& at(const _key_t& _key) const
-    {
-        const_iterator iter = find(_key);
-
-        if (iter != end())
-            return (*iter).second;
-        else
-            throw std::out_of_range("the element with this key was not found");
-    }
+    // Returns the handle of the specified key with its hash value without
+    // the seed
+    hashed_key hash_key(const _key_t& _key) const
+    { return hashed_key(_key, __hash_without_seed(_m_hasher, _key)); }
 
     // Accessing an element by key and returning an iterator
 
     iterator find(const _key_t& _key) noexcept
-    {
-        size_t i = bucket(_key);
-        _table_iterator table_iter = _m_buckets.begin() + i;
-        bucket_iterator buck_iter = _m_buckets[i].begin();
-
-        for (; buck_iter != _m_buckets[i].end(); buck_iter++)
-            if (_m_key_equal(_key, buck_iter->first))
-                return iterator(*this, table_iter, buck_iter);
-        
-        return iterator(*this);
-    }
+    { return _find(_key, _hash(_key)); }
 
     const_iterator find(const _key_t& _key) const noexcept
-    {
-        size_t i = bucket(_key);
-        _const_table_iterator table_iter = _m_buckets.cbegin() + i;
-        const_bucket_iterator buck_iter = _m_buckets[i].cbegin();
+    { return _find(_key, _hash(_key)); }
 
-        for (; buck_iter != _m_buckets[i].cend(); buck_iter++)
-            if (_m_key_equal(_key, buck_iter->first))
-                return const_iterator(*this, table_iter, buck_iter);
-        
-        return const_iterator(*this);
-    }
+    iterator find(const hashed_key& _hkey) noexcept
+    { return _find(_hkey.key(), _hash(_hkey)); }
+
+    const_iterator find(const hashed_key& _hkey) const noexcept
+    { return _find(_hkey.key(), _hash(_hkey)); }
 
     // Returns count of items with specified key in container
     // (1 if there is such an element, 0 otherwise)
     size_t count(const _key_t& _key) const noexcept
     { return find(_key) != cend(); }
 
+    size_t count(const hashed_key& _hkey) const noexcept
+    { return find(_hkey) != cend(); }
+
     ///////////////////////////////////////////////////////////////////////////
 
 
@@ -384,57 +1211,29 @@ public:
     // Inserting a single element by copying
     std::pair<iterator, bool> insert(const _value_t& _val)
     {
-        iterator iter = find(_val.first);
-
-        // If an element with such a key was founded
-        if (iter != end())
-            return std::make_pair(iter, false);
-
-        // Otherwise, add it to containter
-
-        // If an overflow of the container occurs after the addition,
-        // then it must first be expanded
-        if (_load_factor(_m_count + 1) > _m_max_load_factor)
-            reverse(_m_count * 2);
-        
-        _table_iterator table_iter = _m_buckets.begin() + bucket(_val.first);
+        size_t hash = _hash(_key_of(_val));
+        iterator iter = _find(_key_of(_val), hash);
 
-        (*table_iter).push_front(_val);
-        _m_count++;
-        
-        return std::make_pair
-        (
-            iterator(*this, table_iter, (*table_iter).begin()),
-            true
-        );
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(_insert_new(hash, _val), true);
     }
 
     // Inserting a single element by moving
     std::pair<iterator, bool> insert(_value_t&& _val)
     {
-        iterator iter = find(_val.first);
+        size_t hash = _hash(_key_of(_val));
+        iterator iter = _find(_key_of(_val), hash);
 
         // If an element with such a key was founded
         if (iter != end())
             return std::make_pair(iter, false);
 
         // Otherwise, add it to containter
-
-        // If an overflow of the container occurs after the addition,
-        // then it must first be expanded
-        if (_load_factor(_m_count + 1) > _m_max_load_factor)
-            reverse(_m_count * 2);
-        
-        _table_iterator table_iter = _m_buckets.begin() + bucket(_val.first);
-
-        (*table_iter).push_front(_val);
-        _m_count++;
-        
-        return std::make_pair
-        (
-            iterator(*this, table_iter, (*table_iter).begin()),
-            true
-        );
+        return std::make_pair(_insert_new(hash, std::move(_val)), true);
     }
 
     // Inserting a range of values
@@ -444,7 +1243,7 @@ public:
         size_t count = std::distance(_first, _last);
 
         if (_load_factor(_m_count + count) > _m_max_load_factor)
-            reverse(count);
+            reverse(_m_count + count);
         
         size_t result = 0;
         for (InputIterator iter = _first; iter < _last; iter++)
@@ -460,7 +1259,7 @@ public:
         size_t count = _il.size();
 
         if (_load_factor(_m_count + count) > _m_max_load_factor)
-            reverse(count);
+            reverse(_m_count + count);
 
         size_t result = 0;
         for (auto&& item : _il)
@@ -474,41 +1273,176 @@ public:
 
     // Erase item from container by specified key
     size_t erase(const _key_t& _key)
+    { return _erase_key(_key, _hash(_key)); }
+
+    // Erase item from container by specified prehashed key
+    size_t erase(const hashed_key& _hkey)
+    { return _erase_key(_hkey.key(), _hash(_hkey)); }
+
+    // Erase item set by the iterator from container without the lookup
+    // of its key, returns the iterator following the removed item
+    iterator erase(const_iterator _pos)
     {
-        iterator iter = find(_key);
-        _table_iterator table_iter = iter._m_table_iter;
+        _table_iterator table_iter
+            = _m_buckets.begin() + (_pos._m_table_iter - _m_buckets.cbegin());
+        _node_iterator next = (*table_iter).erase_after
+        (
+            _before_node(*table_iter, _pos._m_buck_iter)
+        );
+        _m_count--;
+        _m_is_shrinkable = true;
+        _update_occupied(table_iter - _m_buckets.begin());
 
-        size_t old_count = _m_count;
+        if (next != (*table_iter).end())
+            return iterator(*this, table_iter, next);
+        else
+            return iterator(*this, ++table_iter);
+    }
 
-        if (table_iter != _m_buckets.end())
+    iterator erase(iterator _pos)
+    { return erase(const_iterator(_pos)); }
+
+    // Erase items in the range [first, last) from container, returns the
+    // iterator following the last removed item
+    iterator erase(const_iterator _first, const_iterator _last)
+    {
+        while (_first != _last)
         {
-            (*table_iter).remove_if
+            _table_iterator table_iter = _m_buckets.begin()
+                + (_first._m_table_iter - _m_buckets.cbegin());
+            _bucket_t& bucket = *table_iter;
+            _node_iterator before = _before_node(bucket, _first._m_buck_iter);
+
+            // Items of the current bucket are removed up to the last
+            // iterator or to the end of the bucket
+            bool is_last_bucket = _first._m_table_iter == _last._m_table_iter;
+
+            while
             (
-                [this, &_key](const _value_t& val) -> bool
-                {
-                    if (_m_key_equal(val.first, _key))
-                    {
-                        _m_count--;
-                        return true;
-                    }
+                std::next(before) != bucket.end() &&
+                !(is_last_bucket && std::next(before) == _last._m_buck_iter)
+            )
+            {
+                bucket.erase_after(before);
+                _m_count--;
+                _m_is_shrinkable = true;
+            }
 
-                    return false;
-                }
-            );
+            _update_occupied(table_iter - _m_buckets.begin());
+
+            if (is_last_bucket)
+                return iterator(*this, table_iter, std::next(before));
+
+            _first = const_iterator(*this, _first._m_table_iter + 1);
+        }
+
+        if (_last._m_table_iter == _m_buckets.cend())
+            return end();
+
+        // Convert the last iterator to the iterator over mutable items
+        _table_iterator table_iter = _m_buckets.begin()
+            + (_last._m_table_iter - _m_buckets.cbegin());
+        _node_iterator before = _before_node(*table_iter, _last._m_buck_iter);
+
+        return iterator(*this, table_iter, std::next(before));
+    }
+
+    // Erase all items satisfying the predicate from container in a single
+    // pass over buckets, returns count of removed items. The removed nodes
+    // are collected and released in batches
+    template <class _Predicate>
+    size_t erase_if(_Predicate _pred)
+    {
+        return _erase_nodes_if
+        (
+            [&_pred](const _node_t& _node) -> bool
+            { return _pred(static_cast<const _value_t&>(_node._m_value)); }
+        );
+    }
+
+    // Node operations
+
+    // Extracts the element by the specified key from the container and
+    // returns the node handle owning it, or empty handle if there is no
+    // such element
+    node_type extract(const _key_t& _key)
+    { return _extract_key(_key, _hash(_key)); }
+
+    // Extracts the element by the specified prehashed key from the container
+    node_type extract(const hashed_key& _hkey)
+    { return _extract_key(_hkey.key(), _hash(_hkey)); }
+
+    // Extracts the element set by the iterator from the container
+    node_type extract(iterator _pos)
+    {
+        _bucket_t& bucket = *_pos._m_table_iter;
+        return _extract(bucket, _before_node(bucket, _pos._m_buck_iter));
+    }
+
+    // Extracts the element set by the const iterator from the container
+    node_type extract(const_iterator _pos)
+    {
+        _bucket_t& bucket
+            = _m_buckets[_pos._m_table_iter - _m_buckets.cbegin()];
+        return _extract(bucket, _before_node(bucket, _pos._m_buck_iter));
+    }
+
+    // Inserts the element owned by the node handle. If the container already
+    // has the element with such key, the node handle is returned back.
+    // The node is relinked without reallocation, the key is hashed again
+    // only if the node was extracted from the container with other seed
+    insert_return_type insert(node_type&& _node)
+    {
+        if (_node.empty())
+            return insert_return_type{end(), false, node_type()};
+
+        _node_t& node = _node._m_chain.front();
+        size_t hash = _hash_from(_node._m_seed, node);
+        iterator iter = _find(_key_of(node._m_value), hash);
+
+        if (iter != end())
+            return insert_return_type{iter, false, std::move(_node)};
+
+        node._m_hash = hash;
+        _node._m_seed = _m_seed;
+
+        // The node can be relinked only if it can be released by the
+        // allocator of the container, otherwise its element is moved
+        if (_node._m_chain.get_allocator() == _node_allocator_t(_m_allocator))
+            iter = _link_node(_node._m_chain, _node._m_chain.before_begin());
+        else
+        {
+            iter = _insert_new(node._m_hash, std::move(node._m_value));
+            _node._m_chain.clear();
         }
 
-        return old_count - _m_count;
+        return insert_return_type{iter, true, node_type()};
     }
 
+    // Moves the elements, whose keys are not in the container, from the
+    // specified container. The nodes are relinked without reallocation,
+    // other elements remain in the source. The keys are hashed again only
+    // if the seeds of the containers differ
+    void merge(__HashTable& _source)
+    { _merge(_source, __keep_source()); }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified temporary container
+    void merge(__HashTable&& _source)
+    { merge(_source); }
+
     // Clear the container
     void clear()
     {
-        _m_buckets.resize(MIN_COUNT_BUCKETS);
-
-        for (auto& bucket : _m_buckets)
-            bucket.clear();
+        // The bucket array is replaced to release its capacity
+        size_t count_buckets = _fit_count_buckets(MIN_COUNT_BUCKETS);
 
+        _m_buckets = _make_buckets(count_buckets, _m_allocator);
         _m_count = 0;
+        _m_occupied = __bucket_bitmap(count_buckets);
+        _m_first_bucket = count_buckets;
+        _m_is_shrinkable = false;
+        _rebuild_filter();
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -519,22 +1453,22 @@ public:
 
     // Returns the iterator set to the begining of the specified bucket
     bucket_iterator begin(size_t _n) noexcept
-    { return _m_buckets[_n].begin(); }
+    { return bucket_iterator(_m_buckets[_n].begin()); }
     // Returns the const iterator set to the begining of the specified bucket
     const_bucket_iterator begin(size_t _n) const noexcept
-    { return _m_buckets[_n].cbegin(); }
+    { return const_bucket_iterator(_m_buckets[_n].cbegin()); }
     // Returns the const iterator set to the begining of the specified bucket
     const_bucket_iterator cbegin(size_t _n) const noexcept
-    { return _m_buckets[_n].cbegin(); }
+    { return const_bucket_iterator(_m_buckets[_n].cbegin()); }
     // Returns the iterator set to the end of the specified bucket
     bucket_iterator end(size_t _n) noexcept
-    { return _m_buckets[_n].end(); }
+    { return bucket_iterator(_m_buckets[_n].end()); }
     // Returns the const iterator set to the end of the specified bucket
     const_bucket_iterator end(size_t _n) const noexcept
-    { return _m_buckets[_n].cend(); }
+    { return const_bucket_iterator(_m_buckets[_n].cend()); }
     // Returns the const iterator set to the end of the specified bucket
     const_bucket_iterator cend(size_t _n) const noexcept
-    { return _m_buckets[_n].cend(); }
+    { return const_bucket_iterator(_m_buckets[_n].cend()); }
 
     // Returns count of buckets in container
     size_t buckets_count() const noexcept { return _m_buckets.size(); }
@@ -543,7 +1477,10 @@ public:
     { return std::distance(_m_buckets[_n].cbegin(), _m_buckets[_n].cend()); }
     // Returns number of bucket by specified key
     size_t bucket(const _key_t& _key) const noexcept
-    { return mod_hash(_m_hasher(_key), _m_buckets.size()); }
+    { return _bucket_index(_hash(_key)); }
+    // Returns number of bucket by specified prehashed key
+    size_t bucket(const hashed_key& _hkey) const
+    { return _bucket_index(_hash(_hkey)); }
 
     ///////////////////////////////////////////////////////////////////////////
 
@@ -563,37 +1500,118 @@ public:
     void max_load_factor(float _ml) noexcept
     { _m_max_load_factor = _ml; }
 
-    // Sets the number of buckets to count and rehashes the container
+    // Returns current minimum load factor
+    float min_load_factor() const noexcept
+    { return _m_min_load_factor; }
+
+    // Set the minimum load factor to specified value. When the load factor
+    // falls below it, the container is shrunk by the next insertion or
+    // erase_if(). Erasing by key or by iterator never rehashes the container,
+    // so the iterators remain valid. Zero disables the shrinking
+    void min_load_factor(float _ml) noexcept
+    { _m_min_load_factor = _ml; }
+
+    // Sets the number of buckets to count and rehashes the container. The
+    // count is raised to accomodate the elements without exceeding maximum
+    // load factor and rounded up to the sequence of the rehash policy
     void rehash(size_t _count_buckets)
     {
-        if (_count_buckets < MIN_COUNT_BUCKETS)
-            _count_buckets = MIN_COUNT_BUCKETS;
-        
-        if (_count_buckets == _m_buckets.size())
-            return;
-        
-        // If the new number of buckets makes load factor more than maximum
-        // load factor... 
-        if (_m_max_load_factor < ((float)_m_count / _count_buckets))
-            // then the new number of buckets is at least:
-            _count_buckets = _m_count / _m_max_load_factor;
-        
-        std::vector<_bucket_t> new_buckets(_count_buckets);
+        size_t min_count_buckets = _count_for(_m_count);
 
-        for (_value_t& value : *this)
-        {
-            size_t i = mod_hash(_m_hasher(value.first), _count_buckets);
-            new_buckets[i].push_front(std::move(value));
-        }
+        if (_count_buckets < min_count_buckets)
+            _count_buckets = min_count_buckets;
 
-        _m_buckets = std::move(new_buckets);
+        _count_buckets = _fit_count_buckets(_count_buckets);
+
+        if (_count_buckets != _m_buckets.size())
+            _relink_nodes(_count_buckets);
     }
 
     // Sets the number of buckets to the number needed to accomodate at
     // least count elements without exceeding maximum load factor and
     // rehashes the container
     void reverse(size_t _count)
-    { rehash(std::ceil((float)_count / _m_max_load_factor)); }
+    { rehash(_count_for(_count)); }
+
+    // Returns the seed of the hash values of the keys. Every container takes
+    // its own seed from the entropy of the system when it is constructed,
+    // so the keys colliding in one container do not collide in others. The
+    // copies share the seed with the original. The seed must be saved
+    // together with the hash values computed by "hash_key"
+    size_t seed() const noexcept { return _m_seed; }
+
+    // Sets the seed of the hash values, hashes all the keys again and
+    // relinks the nodes to their new buckets without reallocation. The
+    // container is also reseeded by the insertion which makes some chain
+    // abnormally long
+    void reseed(size_t _seed)
+    {
+        _m_seed = _seed;
+
+        for (_bucket_t& bucket : _m_buckets)
+            for (_node_t& node : bucket)
+                node._m_hash = _hash(_key_of(node._m_value));
+
+        _relink_nodes(_m_buckets.size());
+    }
+
+    // Shrinks the bucket array to the minimum size for the current count
+    // of elements without exceeding maximum load factor and returns the
+    // cached unused memory of the allocator resource to its source
+    void shrink_to_fit()
+    {
+        reverse(_m_count);
+        __trim_allocator(_m_allocator, 0);
+    }
+
+    // Returns the estimate of the memory in bytes used by the container:
+    // the container object, the bucket array, the chain nodes, the occupancy
+    // bitmap and the filter. The memory owned by the elements themselves is
+    // not counted
+    size_t memory_usage() const noexcept
+    {
+        return sizeof(*this) + _m_buckets.capacity() * sizeof(_bucket_t) +
+            _m_count * (sizeof(_node_t) + sizeof(void*)) +
+            _m_occupied.memory_usage() +
+            _m_filter.memory_usage();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Filter of the absent keys
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Enables the blocked Bloom filter built over the stored hash values.
+    // The lookups of the absent keys are mostly rejected by the filter
+    // without walking the chains. The filter is updated by the insertions
+    // and rebuilt by rehashing and "erase_if", the keys erased in other ways
+    // remain in it until the next rebuilding
+    void enable_filter
+    (
+        float _bits_per_key = BlockedBloomFilter::DEFAULT_BITS_PER_KEY,
+        bool _is_collect_stats = false
+    )
+    {
+        _m_filter.enable(_bits_per_key, _is_collect_stats);
+        _rebuild_filter();
+    }
+
+    // Disables the filter and releases its memory
+    void disable_filter() { _m_filter.disable(); }
+
+    // Rebuilds the filter dropping the erased keys
+    void rebuild_filter() { _rebuild_filter(); }
+
+    // Checks that the filter is enabled
+    bool filter_enabled() const noexcept { return _m_filter.enabled(); }
+
+    // Returns the statistics of the filter
+    BlockedBloomFilter::stats_t filter_stats() const noexcept
+    { return _m_filter.stats(); }
+
+    // Resets the statistics of the filter
+    void reset_filter_stats() noexcept { _m_filter.reset_stats(); }
 
     ///////////////////////////////////////////////////////////////////////////
 
@@ -621,47 +1639,40 @@ public:
         public std::iterator<std::forward_iterator_tag, _value_t>
     {
     private:
-        friend class HashMap;
+        friend class __HashTable;
+        friend class const_iterator;
 
     private:
-        HashMap* _m_ht_ptr;
+        __HashTable* _m_ht_ptr;
         _table_iterator _m_table_iter;
-        bucket_iterator _m_buck_iter;
+        _node_iterator _m_buck_iter;
 
         // Default constructor
-        iterator(HashMap& _table):
+        iterator(__HashTable& _table):
             _m_ht_ptr{&_table},
             _m_table_iter{_table._m_buckets.end()},
             _m_buck_iter{}
         {}
 
-        // Constructor with table iterator parameter
-        iterator(HashMap& _table, const _table_iterator& _iter):
+        // Constructor with table iterator parameter. The iterator is set to
+        // the first non-empty bucket starting from the specified one, which
+        // is found by the occupancy bitmap
+        iterator(__HashTable& _table, const _table_iterator& _iter):
             _m_ht_ptr{&_table},
-            _m_table_iter{_iter}
+            _m_table_iter{_table._m_buckets.begin() + _table._next_occupied(
+                _iter - _table._m_buckets.begin())},
+            _m_buck_iter{}
         {
-            if (_m_table_iter == _m_ht_ptr->_m_buckets.end())
-                return;
-            
-            _m_buck_iter = (*_m_table_iter).begin();
-
-            while (_m_buck_iter == (*_m_table_iter).end())
-            {
-                _m_table_iter++;
-                
-                if (_m_table_iter != _m_ht_ptr->_m_buckets.end())
-                    _m_buck_iter = (*_m_table_iter).begin();
-                else
-                    break;
-            }
+            if (_m_table_iter != _m_ht_ptr->_m_buckets.end())
+                _m_buck_iter = (*_m_table_iter).begin();
         }
 
         // Constructor with table iterator and bucket iterator parameters
         iterator
         (
-            HashMap& _table,
+            __HashTable& _table,
             const _table_iterator& _table_iter,
-            const bucket_iterator& _buck_iter
+            const _node_iterator& _buck_iter
         ):
             _m_ht_ptr{&_table},
             _m_table_iter{_table_iter},
@@ -707,7 +1718,7 @@ public:
 
         // Dereference Operator
         _value_t& operator*() const noexcept
-        { return *_m_buck_iter; }
+        { return (*_m_buck_iter)._m_value; }
 
         // Prefix increment operator
         iterator& operator++() noexcept
@@ -715,17 +1726,8 @@ public:
             if (_m_table_iter == _m_ht_ptr->_m_buckets.end())
                 return *this;
 
-            _m_buck_iter++;
-
-            while (_m_buck_iter == (*_m_table_iter).end())
-            {
-                _m_table_iter++;
-                
-                if (_m_table_iter != _m_ht_ptr->_m_buckets.end())
-                    _m_buck_iter = (*_m_table_iter).begin();
-                else
-                    break;
-            }
+            if (++_m_buck_iter == (*_m_table_iter).end())
+                *this = iterator(*_m_ht_ptr, _m_table_iter + 1);
 
             return *this;
         }
@@ -747,51 +1749,43 @@ public:
         public std::iterator<std::forward_iterator_tag, _value_t>
     {
     private:
-        friend class HashMap;
+        friend class __HashTable;
 
     private:
-        const HashMap* _m_ht_ptr;
+        const __HashTable* _m_ht_ptr;
         _const_table_iterator _m_table_iter;
-        const_bucket_iterator _m_buck_iter;
+        _const_node_iterator _m_buck_iter;
 
         // Default constructor
-        const_iterator(const HashMap& _table):
+        const_iterator(const __HashTable& _table):
             _m_ht_ptr{&_table},
             _m_table_iter{_table._m_buckets.cend()},
             _m_buck_iter{}
         {}
 
-        // Constructor with table iterator parameter
+        // Constructor with table iterator parameter. The iterator is set to
+        // the first non-empty bucket starting from the specified one, which
+        // is found by the occupancy bitmap
         const_iterator
         (
-            const HashMap& _table,
+            const __HashTable& _table,
             const _const_table_iterator& _iter
         ):
             _m_ht_ptr{&_table},
-            _m_table_iter{_iter}
+            _m_table_iter{_table._m_buckets.cbegin() + _table._next_occupied(
+                _iter - _table._m_buckets.cbegin())},
+            _m_buck_iter{}
         {
-            if (_m_table_iter == _m_ht_ptr->_m_buckets.cend())
-                return;
-            
-            _m_buck_iter = (*_m_table_iter).cbegin();
-
-            while (_m_buck_iter == (*_m_table_iter).cend())
-            {
-                _m_table_iter++;
-                
-                if (_m_table_iter != (*_m_ht_ptr)._m_buckets.cend())
-                    _m_buck_iter = (*_m_table_iter).cbegin();
-                else
-                    break;
-            }
+            if (_m_table_iter != _m_ht_ptr->_m_buckets.cend())
+                _m_buck_iter = (*_m_table_iter).cbegin();
         }
 
         // Constructor with table iterator and bucket iterator parameters
         const_iterator
         (
-            const HashMap& _table,
+            const __HashTable& _table,
             const _const_table_iterator& _table_iter,
-            const const_bucket_iterator& _buck_iter
+            const _const_node_iterator& _buck_iter
         ):
             _m_ht_ptr{&_table},
             _m_table_iter{_table_iter},
@@ -799,6 +1793,12 @@ public:
         {}
     
     public:
+        // Converting constructor from the iterator
+        const_iterator(const iterator& _other) noexcept:
+            _m_ht_ptr{_other._m_ht_ptr},
+            _m_table_iter{_other._m_table_iter},
+            _m_buck_iter{_other._m_buck_iter}
+        {}
         // Copy constructor
         const_iterator(const const_iterator& _other) = default;
         // Move constructor
@@ -839,7 +1839,7 @@ public:
 
         // Dereference Operator
         const _value_t& operator*() const noexcept
-        { return *_m_buck_iter; }
+        { return (*_m_buck_iter)._m_value; }
 
         // Prefix increment operator
         const_iterator& operator++() noexcept
@@ -847,17 +1847,8 @@ public:
             if (_m_table_iter == (*_m_ht_ptr)._m_buckets.cend())
                 return *this;
 
-            _m_buck_iter++;
-
-            while (_m_buck_iter == (*_m_table_iter).cend())
-            {
-                _m_table_iter++;
-                
-                if (_m_table_iter != (*_m_ht_ptr)._m_buckets.cend())
-                    _m_buck_iter = (*_m_table_iter).cbegin();
-                else
-                    break;
-            }
+            if (++_m_buck_iter == (*_m_table_iter).cend())
+                *this = const_iterator(*_m_ht_ptr, _m_table_iter + 1);
 
             return *this;
         }
@@ -874,6 +1865,271 @@ public:
     };
     ///////////////////////////////////////////////////////////////////////////
 
+    // Node handle
+    class node_type
+    {
+    private:
+        friend class __HashTable;
+
+        _bucket_t _m_chain;     // Chain of the owned node or empty chain
+        size_t _m_seed;         // Seed of the hash value of the node
+
+        // Constructor with the allocator and the seed parameters
+        node_type(const _node_allocator_t& _alloc, size_t _seed):
+            _m_chain{_alloc},
+            _m_seed{_seed}
+        {}
+
+    public:
+        // Default constructor
+        node_type(): _m_seed{0} {}
+        // Move constructor
+        node_type(node_type&& _other) = default;
+        // Destructor
+        ~node_type() {}
+
+        // Assigment by moving
+        node_type& operator=(node_type&& _other) = default;
+
+        // Checking the node handle for emptiness
+        bool empty() const noexcept { return _m_chain.empty(); }
+        explicit operator bool() const noexcept { return !empty(); }
+
+        // Returns the key of the owned element
+        const _key_t& key() const
+        { return _key_of(_m_chain.front()._m_value); }
+
+        // Returns the owned element
+        _value_t& value()
+        { return _m_chain.front()._m_value; }
+        const _value_t& value() const
+        { return _m_chain.front()._m_value; }
+
+        // Returns the mapped value of the owned key-value pair
+        template <class _Pair = _value_t>
+        typename _Pair::second_type& mapped()
+        { return _m_chain.front()._m_value.second; }
+        template <class _Pair = _value_t>
+        const typename _Pair::second_type& mapped() const
+        { return _m_chain.front()._m_value.second; }
+
+        // Returns the allocator of the owned node
+        _allocator_t get_allocator() const
+        { return _allocator_t(_m_chain.get_allocator()); }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Result of the node handle insertion
+    struct insert_return_type
+    {
+        iterator position;  // Inserted element or element with the same key
+        bool inserted;      // Whether the node has been inserted
+        node_type node;     // Node handle if it has not been inserted
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // __HashTable
+
+
+// Hash map container
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<std::pair<const _Key, _Data>>,
+    class _RehashPolicy = DefaultRehashPolicy
+>
+class HashMap:
+    public __HashTable
+    <
+        _Key, std::pair<const _Key, _Data>, __select_first,
+        _Hasher, _KeyEqual, _Allocator, _RehashPolicy
+    >
+{
+private:
+    using _base_t = __HashTable
+    <
+        _Key, std::pair<const _Key, _Data>, __select_first,
+        _Hasher, _KeyEqual, _Allocator, _RehashPolicy
+    >;
+
+public:
+    using typename _base_t::_key_t;
+    using _mapped_t = _Data;
+    using typename _base_t::_value_t;
+    using typename _base_t::iterator;
+    using typename _base_t::const_iterator;
+    using typename _base_t::hashed_key;
+
+private:
+    // Returns the mapped value of the found element, if the element was not
+    // found, an out_of_range exception is thrown
+    _mapped_t& _found(iterator _iter)
+    {
+        if (_iter == end())
+            throw std::out_of_range("the element with this key was not found");
+
+        return (*_iter).second;
+    }
+
+    const _mapped_t& _found(const_iterator _iter) const
+    {
+        if (_iter == end())
+            throw std::out_of_range("the element with this key was not found");
+
+        return (*_iter).second;
+    }
+
+public:
+
+    // Constructors of the hash table
+    using _base_t::_base_t;
+    // Assignment based on the initialization list
+    using _base_t::operator=;
+
+    using _base_t::end;
+    using _base_t::find;
+    using _base_t::hash_key;
+    using _base_t::insert;
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Indexing operator
+
+    _mapped_t& operator[](const _key_t& _key)
+    {
+        size_t hash = this->_hash(_key);
+        iterator iter = this->_find(_key, hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+
+        // Otherwise, add it to containter
+        iter = this->_insert_new(hash, _key, _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    _mapped_t& operator[](_key_t&& _key)
+    {
+        size_t hash = this->_hash(_key);
+        iterator iter = this->_find(_key, hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+        
+        // Otherwise, add it to containter
+        iter = this->_insert_new(hash, std::move(_key), _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    _mapped_t& operator[](const hashed_key& _hkey)
+    {
+        size_t hash = this->_hash(_hkey);
+        iterator iter = this->_find(_hkey.key(), hash);
+
+        // If an element with such a key was founded, then return it
+        if (iter != end())
+            return (*iter).second;
+        
+        // Otherwise, add it to containter
+        iter = this->_insert_new(hash, _hkey.key(), _mapped_t{});
+
+        return (*iter).second;
+    }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+    
+    _mapped_t& at(const _key_t& _key)
+    { return _found(find(_key)); }
+
+    const _mapped_t& at(const _key_t& _key) const
+    { return _found(find(_key)); }
+
+    _mapped_t& at(const hashed_key& _hkey)
+    { return _found(find(_hkey)); }
+
+    const _mapped_t& at(const hashed_key& _hkey) const
+    { return _found(find(_hkey)); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserting a single element with the prehashed key by copying
+    // the mapped value
+    std::pair<iterator, bool>
+    insert(const hashed_key& _hkey, const _mapped_t& _data)
+    {
+        size_t hash = this->_hash(_hkey);
+        iterator iter = this->_find(_hkey.key(), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair
+        (
+            this->_insert_new(hash, _hkey.key(), _data),
+            true
+        );
+    }
+
+    // Inserting a single element with the prehashed key by moving
+    // the mapped value
+    std::pair<iterator, bool> insert(const hashed_key& _hkey, _mapped_t&& _data)
+    {
+        size_t hash = this->_hash(_hkey);
+        iterator iter = this->_find(_hkey.key(), hash);
+
+        // If an element with such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair
+        (
+            this->_insert_new(hash, _hkey.key(), std::move(_data)),
+            true
+        );
+    }
+
+    // Moves all elements from the specified container. The mapped value of
+    // the element, whose key is already in the container, is combined with
+    // the source one as "value = _combine(value, source_value)". The nodes
+    // are relinked without reallocation, the keys are hashed again only if
+    // the seeds of the containers differ
+    template <class _Combine>
+    void merge(HashMap& _source, _Combine _combine)
+    {
+        this->_merge(_source, [&_combine](_value_t& _value,
+            _value_t&& _other)
+        {
+            _value.second = _combine(_value.second, std::move(_other.second));
+            return true;
+        });
+    }
+
+    // Moves all elements from the specified temporary container combining
+    // the mapped values of the equal keys
+    template <class _Combine>
+    void merge(HashMap&& _source, _Combine _combine)
+    { merge(_source, std::move(_combine)); }
+
+    using _base_t::merge;
+
+    ///////////////////////////////////////////////////////////////////////////
+
 }; // HashMap
 
 
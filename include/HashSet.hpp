@@ -0,0 +1,215 @@
+// HashSet.hpp
+
+#ifndef _HASHSET_
+#define _HASHSET_
+
+
+#include <functional>
+#include <utility>
+#include <memory>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+
+// Hash set container. It shares the hash table engine with the hash map,
+// but its nodes store only the keys
+template
+<
+    class _Key,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<_Key>,
+    class _RehashPolicy = DefaultRehashPolicy
+>
+class HashSet:
+    public __HashTable
+    <
+        _Key, const _Key, __identity, _Hasher, _KeyEqual, _Allocator,
+        _RehashPolicy
+    >
+{
+private:
+    using _base_t = __HashTable
+    <
+        _Key, const _Key, __identity, _Hasher, _KeyEqual, _Allocator,
+        _RehashPolicy
+    >;
+    using typename _base_t::_node_t;
+    using typename _base_t::_bucket_t;
+
+public:
+    using typename _base_t::_key_t;
+    using typename _base_t::_value_t;
+    using typename _base_t::iterator;
+    using typename _base_t::const_iterator;
+    using typename _base_t::hashed_key;
+
+    // Constructors of the hash table
+    using _base_t::_base_t;
+    // Assignment based on the initialization list
+    using _base_t::operator=;
+
+    using _base_t::end;
+    using _base_t::find;
+    using _base_t::insert;
+
+
+    // Lookup
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Checking the key for belonging to the container
+    bool contains(const _key_t& _key) const
+    { return find(_key) != end(); }
+
+    bool contains(const hashed_key& _hkey) const
+    { return find(_hkey) != end(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserting a single key by moving
+    std::pair<iterator, bool> insert(_key_t&& _key)
+    {
+        size_t hash = this->_hash(_key);
+        iterator iter = this->_find(_key, hash);
+
+        // If such a key was founded
+        if (iter != end())
+            return std::make_pair(iter, false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(this->_insert_new(hash, std::move(_key)), true);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Set algebra
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The operations go over the other set bucket by bucket and use the
+    // stored hash values of its keys, so no key is hashed again if the sets
+    // have the same seed, as the copies of one set do
+
+    // Adds the keys of the other set to this set
+    HashSet& unite(const HashSet& _other)
+    {
+        if (&_other == this)
+            return *this;
+
+        size_t count = this->size() + _other.size();
+
+        if (this->_load_factor(count) > this->_m_max_load_factor)
+            this->reverse(count);
+
+        for (const _bucket_t& bucket : _other._m_buckets)
+            for (const _node_t& node : bucket)
+            {
+                size_t hash = this->_hash_from(_other._m_seed, node);
+
+                if (this->_find(node._m_value, hash) == end())
+                    this->_insert_new(hash, node._m_value);
+            }
+
+        return *this;
+    }
+
+    // Removes the keys which are not in the other set from this set
+    HashSet& intersect(const HashSet& _other)
+    {
+        if (&_other == this)
+            return *this;
+
+        this->_erase_nodes_if
+        (
+            [this, &_other](const _node_t& _node) -> bool
+            {
+                size_t hash = _other._hash_from(this->_m_seed, _node);
+                return _other._find(_node._m_value, hash) == _other.end();
+            }
+        );
+
+        return *this;
+    }
+
+    // Removes the keys of the other set from this set
+    HashSet& subtract(const HashSet& _other)
+    {
+        if (&_other == this)
+        {
+            this->clear();
+            return *this;
+        }
+
+        this->_erase_nodes_if
+        (
+            [this, &_other](const _node_t& _node) -> bool
+            {
+                size_t hash = _other._hash_from(this->_m_seed, _node);
+                return _other._find(_node._m_value, hash) != _other.end();
+            }
+        );
+
+        return *this;
+    }
+
+    // Union of the sets
+    HashSet& operator|=(const HashSet& _other) { return unite(_other); }
+    // Intersection of the sets
+    HashSet& operator&=(const HashSet& _other) { return intersect(_other); }
+    // Difference of the sets
+    HashSet& operator-=(const HashSet& _other) { return subtract(_other); }
+
+    // Returns the union of the sets
+    friend HashSet operator|(const HashSet& _a, const HashSet& _b)
+    {
+        // The smaller set is added to the copy of the larger one
+        if (_a.size() < _b.size())
+            return HashSet(_b) |= _a;
+        else
+            return HashSet(_a) |= _b;
+    }
+
+    // Returns the intersection of the sets
+    friend HashSet operator&(const HashSet& _a, const HashSet& _b)
+    {
+        // The keys of the smaller set are looked up in the larger one
+        const HashSet& small = _a.size() < _b.size() ? _a : _b;
+        const HashSet& large = _a.size() < _b.size() ? _b : _a;
+
+        HashSet result
+        (
+            small.buckets_count(), small.hash_function(), small.key_eq(),
+            small.get_allocator()
+        );
+
+        // The result takes the seed of the smaller set to reuse its hash
+        // values
+        result.reseed(small.seed());
+
+        for (const _bucket_t& bucket : small._m_buckets)
+            for (const _node_t& node : bucket)
+            {
+                size_t hash = large._hash_from(small._m_seed, node);
+
+                if (large._find(node._m_value, hash) != large.end())
+                    result._insert_new(node._m_hash, node._m_value);
+            }
+
+        return result;
+    }
+
+    // Returns the difference of the sets
+    friend HashSet operator-(const HashSet& _a, const HashSet& _b)
+    { return HashSet(_a) -= _b; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // HashSet
+
+
+#endif  // _HASHSET_
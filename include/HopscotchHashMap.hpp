@@ -0,0 +1,1154 @@
+// HopscotchHashMap.hpp
+
+#ifndef _HOPSCOTCHHASHMAP_
+#define _HOPSCOTCHHASHMAP_
+
+
+#include <initializer_list>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <hash/hash.hpp>
+#include <hash/hash_functions.hpp>
+#include <SlotIterator.hpp>
+
+
+// Hopscotch hash table. Every element is stored within the neighborhood of
+// "NEIGHBORHOOD_SIZE" slots starting from its home slot, the neighborhoods
+// of the last slots are wrapped around to the first ones. The home slot keeps
+// the bitmap of the neighborhood slots occupied by its elements. The lookup
+// visits only the slots set in the bitmap, so it does not depend on the
+// length of the probe sequences and stays short at high load factors.
+//
+// The new element takes the nearest free slot. If the slot is out of the
+// neighborhood, the elements between the home slot and the free one are
+// moved forward within their own neighborhoods, so the free slot hops back
+// to the home slot, and the table is grown if there is no such element.
+// With the neighborhoods of 64 slots it rarely happens below the load
+// factor of 0.9, so the loaded table is grown only a little. The table with
+// the low load factor is doubled a few times, and then std::length_error is
+// thrown, since the keys with equal tags can not be separated by growing.
+// The 32-bit tags folded from the hash values are stored in the slots and
+// the home slots are chosen by the tags, so the moves and the rehashing do
+// not call the hasher
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Allocator = std::allocator<std::pair<const _Key, _Data>>
+>
+class HopscotchHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<const _Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+    using _allocator_t   = _Allocator;
+
+    using iterator = __slot_iterator<HopscotchHashMap, _value_t>;
+    using const_iterator
+        = __slot_iterator<const HopscotchHashMap, const _value_t>;
+    class node_type;
+    struct insert_return_type;
+
+    // Key together with its hash value, see HashMap::hashed_key
+    class hashed_key
+    {
+    private:
+        const _key_t* _m_key_ptr;   // Pointer to the key
+        size_t _m_hash;             // Hash value of the key
+
+    public:
+        // Constructor with the key and its hash value
+        hashed_key(const _key_t& _key, size_t _hash) noexcept:
+            _m_key_ptr{&_key},
+            _m_hash{_hash}
+        {}
+
+        // Returns the key
+        const _key_t& key() const noexcept { return *_m_key_ptr; }
+        // Returns the hash value of the key
+        size_t hash() const noexcept { return _m_hash; }
+    };
+
+    // Count of slots in the neighborhood of the home slot
+    static constexpr size_t NEIGHBORHOOD_SIZE = 64;
+
+protected:
+    template <class, class> friend class __slot_iterator;
+
+    // The table is not smaller than the neighborhood, so the neighborhood
+    // can not wrap around onto itself
+    static constexpr size_t MIN_COUNT_BUCKETS = NEIGHBORHOOD_SIZE;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.9f;
+    // Max distance from the home slot to the free slot
+    static constexpr size_t MAX_PROBE_DISTANCE = 1024;
+    // The table without the room in the neighborhood is grown only by
+    // 1/GROW_DIVISOR, if its load factor exceeds HIGH_LOAD_PART of the max
+    // load factor, so it is not halved near the max load factor. Otherwise
+    // the neighborhood is crowded by the colliding keys, and the table is
+    // doubled at most MAX_GROW_RETRIES times for the new element
+    static constexpr float HIGH_LOAD_PART = 0.75f;
+    static constexpr size_t GROW_DIVISOR = 16;
+    static constexpr size_t MAX_GROW_RETRIES = 3;
+    static constexpr uint32_t OCCUPIED_BIT = 0x80000000u;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    // Slot of the table
+    struct _slot_t
+    {
+        uint64_t _m_hop;    // Bitmap of the neighborhood slots occupied by
+                            // the elements of this home slot
+        uint32_t _m_tag;    // Tag of the stored element, 0 if slot is free
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_storage;    // Storage of element
+
+        // Returns the stored element
+        _value_t& value() noexcept
+        { return *reinterpret_cast<_value_t*>(&_m_storage); }
+        const _value_t& value() const noexcept
+        { return *reinterpret_cast<const _value_t*>(&_m_storage); }
+    };
+
+    using _alloc_traits = std::allocator_traits<_allocator_t>;
+    using _slot_allocator_t
+        = typename _alloc_traits::template rebind_alloc<_slot_t>;
+    using _slot_traits = std::allocator_traits<_slot_allocator_t>;
+
+    _slot_t* _m_slots;                  // Slots of the table
+    size_t _m_count_buckets;            // Count of home slots
+    size_t _m_count;                    // Count of items in map
+    float _m_max_load_factor;           // Max load factor
+    _hasher_t _m_hasher;                // Hasher functor
+    _key_equal_t _m_key_equal;          // Key equal functor
+    _slot_allocator_t _m_allocator;     // Allocator of the slots
+
+    // Interface of the slot iterator
+
+    size_t _slot_count() const noexcept { return _m_count_buckets; }
+
+    bool _is_occupied(size_t _i) const noexcept
+    { return _m_slots[_i]._m_tag != 0; }
+
+    _value_t& _value_at(size_t _i) noexcept
+    { return _m_slots[_i].value(); }
+
+    const _value_t& _value_at(size_t _i) const noexcept
+    { return _m_slots[_i].value(); }
+
+    // Returns the index of the lowest set bit of the nonzero bitmap
+    static size_t _lowest_bit(uint64_t _bits) noexcept
+    { return __builtin_ctzll(_bits); }
+
+    // Returns the slot at the distance from the specified one, the
+    // neighborhoods of the last slots are wrapped around to the first ones
+    size_t _slot_at(size_t _slot, size_t _distance) const noexcept
+    {
+        size_t i = _slot + _distance;
+
+        return i < _m_count_buckets ? i : i - _m_count_buckets;
+    }
+
+    // Returns the distance from the first slot to the second one
+    size_t _distance(size_t _from, size_t _to) const noexcept
+    { return _to >= _from ? _to - _from : _to + _m_count_buckets - _from; }
+
+    // Allocates the specified count of home slots
+    void _allocate(size_t _count_buckets)
+    {
+        _m_count_buckets = _count_buckets;
+        _m_slots = _slot_traits::allocate(_m_allocator, _slot_count());
+
+        for (size_t i = 0; i < _slot_count(); i++)
+        {
+            _m_slots[i]._m_hop = 0;
+            _m_slots[i]._m_tag = 0;
+        }
+    }
+
+    // Destroys the elements and releases the slots
+    void _deallocate() noexcept
+    {
+        if (_m_slots == nullptr)
+            return;
+
+        for (size_t i = 0; i < _slot_count(); i++)
+            if (_is_occupied(i))
+                _value_at(i).~_value_t();
+
+        _slot_traits::deallocate(_m_allocator, _m_slots, _slot_count());
+
+        _m_slots = nullptr;
+        _m_count_buckets = 0;
+        _m_count = 0;
+    }
+
+    // Copies the elements of the other container to the same slots
+    void _copy_slots(const HopscotchHashMap& _other)
+    {
+        _allocate(_other._m_count_buckets);
+
+        for (size_t i = 0; i < _slot_count(); i++)
+        {
+            const _slot_t& slot = _other._m_slots[i];
+
+            _m_slots[i]._m_hop = slot._m_hop;
+
+            if (slot._m_tag != 0)
+            {
+                new (&_m_slots[i]._m_storage) _value_t(slot.value());
+                _m_slots[i]._m_tag = slot._m_tag;
+                _m_count++;
+            }
+        }
+    }
+
+    // Takes the slots of the other container
+    void _take(HopscotchHashMap& _other) noexcept
+    {
+        _m_slots = _other._m_slots;
+        _m_count_buckets = _other._m_count_buckets;
+        _m_count = _other._m_count;
+
+        _other._m_slots = nullptr;
+        _other._m_count_buckets = 0;
+        _other._m_count = 0;
+    }
+
+    // Returns the tag of the hash value. The hash value is mixed, since the
+    // hash values of integers are the integers themselves and the home
+    // slots of the regular keys would collide
+    static uint32_t _tag_of(size_t _hash) noexcept
+    {
+        uint64_t mixed = static_cast<uint64_t>(_hash);
+
+        mixed ^= mixed >> 33;
+        mixed *= 0xFF51AFD7ED558CCDull;
+        mixed ^= mixed >> 33;
+        mixed *= 0xC4CEB9FE1A85EC53ull;
+        mixed ^= mixed >> 33;
+
+        return static_cast<uint32_t>(mixed) | OCCUPIED_BIT;
+    }
+
+    // Returns the home slot of the tag
+    size_t _home_of(uint32_t _tag) const noexcept
+    { return mod_hash(_tag, _m_count_buckets); }
+
+    // Returns the index of the slot with the key or NPOS
+    size_t _find_slot(const hashed_key& _hkey) const
+    {
+        uint32_t tag = _tag_of(_hkey.hash());
+        size_t home = _home_of(tag);
+
+        for (uint64_t bits = _m_slots[home]._m_hop; bits != 0;
+            bits &= bits - 1)
+        {
+            size_t i = _slot_at(home, _lowest_bit(bits));
+
+            if
+            (
+                _m_slots[i]._m_tag == tag &&
+                _m_key_equal(_hkey.key(), _m_slots[i].value().first)
+            )
+                return i;
+        }
+
+        return NPOS;
+    }
+
+    // Moves the element from the slot to the free slot, both slots must be
+    // in the neighborhood of the element home slot
+    void _move_slot(size_t _home, size_t _from, size_t _to)
+    {
+        _slot_t& from = _m_slots[_from];
+        _slot_t& to = _m_slots[_to];
+
+        new (&to._m_storage) _value_t(std::move(from.value()));
+        to._m_tag = from._m_tag;
+
+        from.value().~_value_t();
+        from._m_tag = 0;
+
+        _m_slots[_home]._m_hop &= ~(uint64_t(1) << _distance(_home, _from));
+        _m_slots[_home]._m_hop |= uint64_t(1) << _distance(_home, _to);
+    }
+
+    // Moves the free slot closer to the home slot by moving an element from
+    // the slots preceding the free one, returns the new free slot or NPOS if
+    // no element can be moved
+    size_t _hop_back(size_t _free)
+    {
+        // The candidates are checked from the farthest home slot, so the
+        // free slot makes the longest hop
+        for (size_t dist = NEIGHBORHOOD_SIZE - 1; dist > 0; dist--)
+        {
+            size_t home = _slot_at(_free, _m_count_buckets - dist);
+            uint64_t bits = _m_slots[home]._m_hop;
+
+            if (bits == 0)
+                continue;
+
+            size_t offset = _lowest_bit(bits);
+
+            if (offset < dist)
+            {
+                size_t i = _slot_at(home, offset);
+
+                _move_slot(home, i, _free);
+                return i;
+            }
+        }
+
+        return NPOS;
+    }
+
+    // Frees a slot in the neighborhood of the home slot, returns the slot or
+    // NPOS if it is impossible without growing the table
+    size_t _make_room(size_t _home)
+    {
+        size_t max_dist = MAX_PROBE_DISTANCE < _m_count_buckets ?
+            MAX_PROBE_DISTANCE : _m_count_buckets;
+
+        size_t dist = 0;
+        while (dist < max_dist && _m_slots[_slot_at(_home, dist)]._m_tag != 0)
+            dist++;
+
+        if (dist == max_dist)
+            return NPOS;
+
+        size_t free = _slot_at(_home, dist);
+
+        while (dist >= NEIGHBORHOOD_SIZE)
+        {
+            free = _hop_back(free);
+
+            if (free == NPOS)
+                return NPOS;
+
+            dist = _distance(_home, free);
+        }
+
+        return free;
+    }
+
+    // Adds a new element with the specified tag to the container without
+    // checking for its presence, returns the index of its slot
+    template <class... _Args>
+    size_t _insert_tagged(uint32_t _tag, _Args&&... _args)
+    {
+        if (_m_count + 1 > _m_count_buckets * _m_max_load_factor)
+            rehash(_m_count_buckets * 2);
+
+        size_t home = _home_of(_tag);
+        size_t i = _make_room(home);
+
+        for (size_t retries = 0; i == NPOS; )
+        {
+            if (_m_count + 1 >
+                _m_count_buckets * _m_max_load_factor * HIGH_LOAD_PART)
+                rehash(_m_count_buckets + _m_count_buckets / GROW_DIVISOR);
+            else if (retries++ < MAX_GROW_RETRIES)
+                rehash(_m_count_buckets * 2);
+            else
+                throw std::length_error("too many keys of the hopscotch "
+                    "hash map have colliding hash values");
+
+            home = _home_of(_tag);
+            i = _make_room(home);
+        }
+
+        new (&_m_slots[i]._m_storage) _value_t(std::forward<_Args>(_args)...);
+        _m_slots[i]._m_tag = _tag;
+        _m_slots[home]._m_hop |= uint64_t(1) << _distance(home, i);
+        _m_count++;
+
+        return i;
+    }
+
+    // Adds a new element with the specified hash value of the key to the
+    // container without checking for its presence, returns the index of its
+    // slot
+    template <class... _Args>
+    size_t _insert_new(size_t _hash, _Args&&... _args)
+    { return _insert_tagged(_tag_of(_hash), std::forward<_Args>(_args)...); }
+
+    // Removes the element from the slot
+    void _erase_slot(size_t _i) noexcept
+    {
+        size_t home = _home_of(_m_slots[_i]._m_tag);
+
+        _m_slots[_i].value().~_value_t();
+        _m_slots[_i]._m_tag = 0;
+        _m_slots[home]._m_hop &= ~(uint64_t(1) << _distance(home, _i));
+        _m_count--;
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor with optional parameters
+    explicit HopscotchHashMap
+    (
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        _m_slots{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_max_load_factor{DEFAULT_MAX_LOAD_FACTOR},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal},
+        _m_allocator{_allocator}
+    {
+        _allocate(_count_buckets > MIN_COUNT_BUCKETS ?
+            _count_buckets : MIN_COUNT_BUCKETS);
+    }
+
+    // Constructor with the allocator parameter
+    explicit HopscotchHashMap(const _allocator_t& _alloc):
+        HopscotchHashMap(MIN_COUNT_BUCKETS, _hasher_t(), _key_equal_t(),
+            _alloc)
+    {}
+
+    // Range-based constructor
+    template <class InputIterator>
+    explicit HopscotchHashMap
+    (
+        const InputIterator& begin, const InputIterator& end,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        HopscotchHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(begin, end);
+    }
+
+    // Copy constructor
+    HopscotchHashMap(const HopscotchHashMap& _other):
+        _m_slots{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_hasher{_other._m_hasher},
+        _m_key_equal{_other._m_key_equal},
+        _m_allocator{_slot_traits::select_on_container_copy_construction(
+            _other._m_allocator)}
+    {
+        _copy_slots(_other);
+    }
+
+    // Move constructor
+    HopscotchHashMap(HopscotchHashMap&& _other):
+        _m_slots{nullptr},
+        _m_count_buckets{0},
+        _m_count{0},
+        _m_max_load_factor{_other._m_max_load_factor},
+        _m_hasher{std::move(_other._m_hasher)},
+        _m_key_equal{std::move(_other._m_key_equal)},
+        _m_allocator{std::move(_other._m_allocator)}
+    {
+        // The source is left empty with the minimum slots
+        _take(_other);
+        _other._allocate(MIN_COUNT_BUCKETS);
+    }
+
+    // Constructor based on the initialization list
+    HopscotchHashMap
+    (
+        std::initializer_list<_value_t> _il,
+        size_t _count_buckets = MIN_COUNT_BUCKETS,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t(),
+        const _allocator_t& _allocator = _allocator_t()
+    ):
+        HopscotchHashMap(_count_buckets, _hasher, _key_equal, _allocator)
+    {
+        insert(_il);
+    }
+
+    // Destructor
+    ~HopscotchHashMap()
+    { _deallocate(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Assigment operator
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assignment by copying
+    HopscotchHashMap& operator=(const HopscotchHashMap& _other)
+    {
+        if (this == &_other)
+            return *this;
+
+        _deallocate();
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_hasher = _other._m_hasher;
+        _m_key_equal = _other._m_key_equal;
+        _copy_slots(_other);
+
+        return *this;
+    }
+
+    // Assignment by moving
+    HopscotchHashMap& operator=(HopscotchHashMap&& _other) noexcept
+    {
+        if (this == &_other)
+            return *this;
+
+        _deallocate();
+        _m_max_load_factor = _other._m_max_load_factor;
+        _m_hasher = std::move(_other._m_hasher);
+        _m_key_equal = std::move(_other._m_key_equal);
+        _m_allocator = std::move(_other._m_allocator);
+        _take(_other);
+        _other._allocate(MIN_COUNT_BUCKETS);
+
+        return *this;
+    }
+
+    // Assignment based on the initialization list
+    HopscotchHashMap& operator=(std::initializer_list<_value_t> _il)
+    {
+        clear();
+        insert(_il);
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the container
+    iterator begin() noexcept { return iterator(*this, 0); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator begin() const noexcept { return const_iterator(*this, 0); }
+    // Returns the const iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept { return const_iterator(*this, 0); }
+    // Returns the iterator set to the end of the container
+    iterator end() noexcept { return iterator(*this, _slot_count()); }
+    // Returns the const iterator set to the end of the container
+    const_iterator end() const noexcept
+    { return const_iterator(*this, _slot_count()); }
+    // Returns the const iterator set to the end of the container
+    const_iterator cend() const noexcept
+    { return const_iterator(*this, _slot_count()); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_count; }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_count == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the handle of the specified key with its computed hash value
+    hashed_key hash_key(const _key_t& _key) const
+    { return hashed_key(_key, _m_hasher(_key)); }
+
+    // Accessing an element by key and returning an iterator
+
+    iterator find(const _key_t& _key) noexcept
+    { return find(hash_key(_key)); }
+
+    const_iterator find(const _key_t& _key) const noexcept
+    { return find(hash_key(_key)); }
+
+    iterator find(const hashed_key& _hkey) noexcept
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? iterator(*this, i) : end();
+    }
+
+    const_iterator find(const hashed_key& _hkey) const noexcept
+    {
+        size_t i = _find_slot(_hkey);
+
+        return i != NPOS ? const_iterator(*this, i) : cend();
+    }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const noexcept
+    { return _find_slot(hash_key(_key)) != NPOS; }
+
+    size_t count(const hashed_key& _hkey) const noexcept
+    { return _find_slot(_hkey) != NPOS; }
+
+    // Indexing operator
+
+    _mapped_t& operator[](const _key_t& _key)
+    { return (*this)[hash_key(_key)]; }
+
+    _mapped_t& operator[](_key_t&& _key)
+    {
+        size_t hash = _m_hasher(_key);
+        size_t i = _find_slot(hashed_key(_key, hash));
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            i = _insert_new(hash, std::move(_key), _mapped_t{});
+
+        return _value_at(i).second;
+    }
+
+    _mapped_t& operator[](const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was not founded, then add it
+        if (i == NPOS)
+            i = _insert_new(_hkey.hash(), _hkey.key(), _mapped_t{});
+
+        return _value_at(i).second;
+    }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+
+    _mapped_t& at(const _key_t& _key)
+    { return at(hash_key(_key)); }
+
+    const _mapped_t& at(const _key_t& _key) const
+    { return at(hash_key(_key)); }
+
+    _mapped_t& at(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _value_at(i).second;
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    const _mapped_t& at(const hashed_key& _hkey) const
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i != NPOS)
+            return _value_at(i).second;
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Insert operations
+
+    // Inserting a single element by copying
+    std::pair<iterator, bool> insert(const _value_t& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        return std::make_pair(iterator(*this, _insert_new(hash, _val)), true);
+    }
+
+    // Inserting a single element by moving
+    std::pair<iterator, bool> insert(_value_t&& _val)
+    {
+        size_t hash = _m_hasher(_val.first);
+        size_t i = _find_slot(hashed_key(_val.first, hash));
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(hash, std::move(_val));
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a single element with the prehashed key by copying
+    // the mapped value
+    std::pair<iterator, bool>
+    insert(const hashed_key& _hkey, const _mapped_t& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(_hkey.hash(), _hkey.key(), _data);
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a single element with the prehashed key by moving
+    // the mapped value
+    std::pair<iterator, bool> insert(const hashed_key& _hkey, _mapped_t&& _data)
+    {
+        size_t i = _find_slot(_hkey);
+
+        // If an element with such a key was founded
+        if (i != NPOS)
+            return std::make_pair(iterator(*this, i), false);
+
+        // Otherwise, add it to containter
+        i = _insert_new(_hkey.hash(), _hkey.key(), std::move(_data));
+
+        return std::make_pair(iterator(*this, i), true);
+    }
+
+    // Inserting a range of values
+    template <class InputIterator>
+    size_t insert(InputIterator _first, InputIterator _last)
+    {
+        reverse(_m_count + std::distance(_first, _last));
+
+        size_t result = 0;
+        for (InputIterator iter = _first; iter != _last; iter++)
+            if (insert(*iter).second)
+                result++;
+
+        return result;
+    }
+
+    // Inserting an initialization list
+    size_t insert(std::initializer_list<_value_t> _il)
+    { return insert(_il.begin(), _il.end()); }
+
+    // Erase operations
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    { return erase(hash_key(_key)); }
+
+    // Erase item from container by specified prehashed key
+    size_t erase(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i == NPOS)
+            return 0;
+
+        _erase_slot(i);
+
+        return 1;
+    }
+
+    // Erase item set by the iterator from container without the lookup
+    // of its key, returns the iterator following the removed item
+    iterator erase(const_iterator _pos)
+    {
+        _erase_slot(_pos.index());
+
+        return iterator(*this, _pos.index() + 1);
+    }
+
+    iterator erase(iterator _pos)
+    { return erase(const_iterator(_pos)); }
+
+    // Erase items in the range [first, last) from container, returns the
+    // iterator following the last removed item. The elements are never
+    // moved by the erasure, so the range is a range of the slots
+    iterator erase(const_iterator _first, const_iterator _last)
+    {
+        for (size_t i = _first.index(); i < _last.index(); i++)
+            if (_is_occupied(i))
+                _erase_slot(i);
+
+        return iterator(*this, _last.index());
+    }
+
+    // Erase all items satisfying the predicate from container in a single
+    // pass over the slots, returns count of removed items
+    template <class _Predicate>
+    size_t erase_if(_Predicate _pred)
+    {
+        size_t count_removed = 0;
+
+        for (size_t i = 0; i < _slot_count(); i++)
+            if
+            (
+                _is_occupied(i) &&
+                _pred(static_cast<const _value_t&>(_value_at(i)))
+            )
+            {
+                _erase_slot(i);
+                count_removed++;
+            }
+
+        return count_removed;
+    }
+
+    // Node operations
+
+    // Extracts the element by the specified key from the container and
+    // returns the node handle owning it, or empty handle if there is no
+    // such element
+    node_type extract(const _key_t& _key)
+    { return extract(hash_key(_key)); }
+
+    // Extracts the element by the specified prehashed key from the container
+    node_type extract(const hashed_key& _hkey)
+    {
+        size_t i = _find_slot(_hkey);
+
+        if (i == NPOS)
+            return node_type();
+
+        return extract(const_iterator(*this, i));
+    }
+
+    // Extracts the element set by the iterator from the container
+    node_type extract(const_iterator _pos)
+    {
+        node_type handle(_allocator_t(_m_allocator),
+            std::move(_value_at(_pos.index())));
+
+        _erase_slot(_pos.index());
+
+        return handle;
+    }
+
+    node_type extract(iterator _pos)
+    { return extract(const_iterator(_pos)); }
+
+    // Inserts the element owned by the node handle. If the container already
+    // has the element with such key, the node handle is returned back
+    insert_return_type insert(node_type&& _node)
+    {
+        if (_node.empty())
+            return insert_return_type{end(), false, node_type()};
+
+        size_t hash = _m_hasher(_node.key());
+        size_t i = _find_slot(hashed_key(_node.key(), hash));
+
+        if (i != NPOS)
+            return insert_return_type{iterator(*this, i), false,
+                std::move(_node)};
+
+        i = _insert_new(hash, std::move(_node.value()));
+        _node._reset();
+
+        return insert_return_type{iterator(*this, i), true, node_type()};
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified container, other elements remain in the source
+    void merge(HopscotchHashMap& _source)
+    {
+        if (&_source == this)
+            return;
+
+        for (size_t i = 0; i < _source._slot_count(); i++)
+        {
+            if (!_source._is_occupied(i))
+                continue;
+
+            _value_t& val = _source._value_at(i);
+            size_t hash = _m_hasher(val.first);
+
+            if (_find_slot(hashed_key(val.first, hash)) != NPOS)
+                continue;
+
+            _insert_new(hash, std::move(val));
+            _source._erase_slot(i);
+        }
+    }
+
+    // Moves the elements, whose keys are not in the container, from the
+    // specified temporary container
+    void merge(HopscotchHashMap&& _source)
+    { merge(_source); }
+
+    // Moves all elements from the specified container. The mapped value of
+    // the element, whose key is already in the container, is combined with
+    // the source one as "value = _combine(value, source_value)"
+    template <class _Combine>
+    void merge(HopscotchHashMap& _source, _Combine _combine)
+    {
+        if (&_source == this)
+            return;
+
+        reverse(_m_count + _source._m_count);
+
+        for (size_t i = 0; i < _source._slot_count(); i++)
+        {
+            if (!_source._is_occupied(i))
+                continue;
+
+            _value_t& val = _source._value_at(i);
+            size_t hash = _m_hasher(val.first);
+            size_t j = _find_slot(hashed_key(val.first, hash));
+
+            if (j != NPOS)
+                _value_at(j).second = _combine(_value_at(j).second,
+                    std::move(val.second));
+            else
+                _insert_new(hash, std::move(val));
+
+            _source._erase_slot(i);
+        }
+    }
+
+    // Moves all elements from the specified temporary container combining
+    // the mapped values of the equal keys
+    template <class _Combine>
+    void merge(HopscotchHashMap&& _source, _Combine _combine)
+    { merge(_source, std::move(_combine)); }
+
+    // Clear the container
+    void clear()
+    {
+        _deallocate();
+        _allocate(MIN_COUNT_BUCKETS);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Bucket interface
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns count of home slots
+    size_t buckets_count() const noexcept { return _m_count_buckets; }
+
+    // Returns count of items of the specified home slot
+    size_t bucket_size(size_t _n) const noexcept
+    {
+        size_t count = 0;
+
+        for (uint64_t bits = _m_slots[_n]._m_hop; bits != 0; bits &= bits - 1)
+            count++;
+
+        return count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Hash policy
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the ratio of the count of items to the count of home slots
+    float load_factor() const noexcept
+    { return (float)_m_count / _m_count_buckets; }
+
+    // Returns max load factor
+    float max_load_factor() const noexcept
+    { return _m_max_load_factor; }
+
+    // Sets max load factor, which can not exceed 1
+    void max_load_factor(float _ml) noexcept
+    { _m_max_load_factor = _ml < 1.0f ? _ml : 1.0f; }
+
+    // Sets the number of home slots to the specified one, if it does not
+    // makes load factor more than maximum load factor, and moves the
+    // elements to the new slots using their stored tags
+    void rehash(size_t _count_buckets)
+    {
+        size_t min_count_buckets = std::ceil((float)_m_count /
+            _m_max_load_factor);
+
+        if (_count_buckets < min_count_buckets)
+            _count_buckets = min_count_buckets;
+
+        if (_count_buckets < MIN_COUNT_BUCKETS)
+            _count_buckets = MIN_COUNT_BUCKETS;
+
+        if (_count_buckets == _m_count_buckets)
+            return;
+
+        HopscotchHashMap old(0, _m_hasher, _m_key_equal, _m_allocator);
+
+        old._deallocate();
+        old._take(*this);
+        _allocate(_count_buckets);
+
+        // The insertion can grow the new table again, the remaining
+        // elements are kept in the old one
+        for (size_t i = 0; i < old._slot_count(); i++)
+            if (old._is_occupied(i))
+            {
+                _insert_tagged(old._m_slots[i]._m_tag,
+                    std::move(old._m_slots[i].value()));
+                old._erase_slot(i);
+            }
+    }
+
+    // Sets the number of home slots to the number needed to accomodate at
+    // least count elements without exceeding maximum load factor and
+    // rehashes the container
+    void reverse(size_t _count)
+    {
+        size_t count_buckets = std::ceil((float)_count / _m_max_load_factor);
+
+        if (count_buckets > _m_count_buckets)
+            rehash(count_buckets);
+    }
+
+    // Returns the estimate of the memory in bytes used by the container
+    size_t memory_usage() const noexcept
+    { return sizeof(*this) + _slot_count() * sizeof(_slot_t); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare the keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    // Returns the allocator associated with the container
+    _allocator_t get_allocator() const noexcept
+    { return _allocator_t(_m_allocator); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Node handle. It owns the element moved out of the slot
+    class node_type
+    {
+    private:
+        friend class HopscotchHashMap;
+
+        typename std::aligned_storage<sizeof(_value_t),
+            alignof(_value_t)>::type _m_storage;    // Storage of element
+        bool _m_is_engaged;         // Whether the element is constructed
+        _allocator_t _m_allocator;  // Allocator of the container
+
+        // Constructor with the allocator and the moved element
+        node_type(const _allocator_t& _alloc, _value_t&& _value):
+            _m_is_engaged{false},
+            _m_allocator{_alloc}
+        {
+            new (&_m_storage) _value_t(std::move(_value));
+            _m_is_engaged = true;
+        }
+
+        // Destroys the owned element
+        void _reset() noexcept
+        {
+            if (_m_is_engaged)
+                value().~_value_t();
+
+            _m_is_engaged = false;
+        }
+
+    public:
+        // Default constructor
+        node_type(): _m_is_engaged{false} {}
+
+        // Move constructor
+        node_type(node_type&& _other):
+            _m_is_engaged{false},
+            _m_allocator{_other._m_allocator}
+        {
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+        }
+
+        // Destructor
+        ~node_type() { _reset(); }
+
+        // Assigment by moving
+        node_type& operator=(node_type&& _other)
+        {
+            if (this == &_other)
+                return *this;
+
+            _reset();
+            _m_allocator = _other._m_allocator;
+
+            if (_other._m_is_engaged)
+            {
+                new (&_m_storage) _value_t(std::move(_other.value()));
+                _m_is_engaged = true;
+                _other._reset();
+            }
+
+            return *this;
+        }
+
+        // Checking the node handle for emptiness
+        bool empty() const noexcept { return !_m_is_engaged; }
+        explicit operator bool() const noexcept { return _m_is_engaged; }
+
+        // Returns the key of the owned element
+        const _key_t& key() const
+        { return value().first; }
+
+        // Returns the owned element
+        _value_t& value()
+        { return *reinterpret_cast<_value_t*>(&_m_storage); }
+        const _value_t& value() const
+        { return *reinterpret_cast<const _value_t*>(&_m_storage); }
+
+        // Returns the mapped value of the owned key-value pair
+        _mapped_t& mapped() { return value().second; }
+        const _mapped_t& mapped() const { return value().second; }
+
+        // Returns the allocator of the container
+        _allocator_t get_allocator() const
+        { return _m_allocator; }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Result of the node handle insertion
+    struct insert_return_type
+    {
+        iterator position;  // Inserted element or element with the same key
+        bool inserted;      // Whether the node has been inserted
+        node_type node;     // Node handle if it has not been inserted
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // HopscotchHashMap
+
+
+#endif  // _HOPSCOTCHHASHMAP_
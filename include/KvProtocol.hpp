@@ -0,0 +1,325 @@
+// KvProtocol.hpp
+
+#ifndef _KVPROTOCOL_
+#define _KVPROTOCOL_
+
+
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <hash/hash_bytes.hpp>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+
+// Binary protocol of the key-value server. The server and the clients are
+// on the same host, so the numbers are in the host byte order. A request is
+// the header followed by the key and the value, a response is the header
+// followed by the value. The requests are pipelined: a client can send any
+// count of them at once, the responses come in the same order.
+//
+// Every shard of the server listens on its own address and owns the keys,
+// which are mapped to it by kv_shard_of, so the clients send a request
+// straight to the shard of its key
+
+// Operations of the requests
+enum kv_op : uint8_t
+{
+    KV_GET = 1,         // Returns the value of the key
+    KV_SET = 2,         // Sets the value of the key
+    KV_DEL = 3,         // Erases the key
+    KV_INFO = 4         // Returns the count of shards as uint32_t
+};
+
+// Statuses of the responses
+enum kv_status : uint8_t
+{
+    KV_OK = 0,
+    KV_NOT_FOUND = 1,
+    KV_WRONG_SHARD = 2  // The key belongs to other shard
+};
+
+// Header of the request
+struct kv_request_header
+{
+    uint8_t op;             // Operation
+    uint8_t reserved[3];
+    uint32_t key_size;      // Size of the key
+    uint32_t value_size;    // Size of the value
+};
+
+// Header of the response
+struct kv_response_header
+{
+    uint8_t status;         // Status
+    uint8_t reserved[3];
+    uint32_t value_size;    // Size of the value
+};
+
+// Request parsed in place, the key and the value point to the input buffer
+struct kv_request
+{
+    uint8_t op;
+    const char* key;
+    size_t key_size;
+    const char* value;
+    size_t value_size;
+};
+
+// Response parsed in place, the value points to the input buffer
+struct kv_response
+{
+    uint8_t status;
+    const char* value;
+    size_t value_size;
+};
+
+// Limits of the sizes, the larger requests are rejected as malformed
+const size_t KV_MAX_KEY_SIZE = 1 << 16;
+const size_t KV_MAX_VALUE_SIZE = 1 << 24;
+// Seed of the hash values, which map the keys to the shards
+const size_t KV_SHARD_SEED = 0x6b76;
+
+
+// Returns the shard of the key
+inline size_t kv_shard_of(const char* _key, size_t _size,
+    size_t _count_shards) noexcept
+{ return _Fnv_hash_bytes(_key, _size, KV_SHARD_SEED) % _count_shards; }
+
+// Appends the request to the output buffer
+inline void kv_append_request(std::string& _out, uint8_t _op,
+    const char* _key, size_t _key_size, const char* _value = nullptr,
+    size_t _value_size = 0)
+{
+    kv_request_header header{_op, {0, 0, 0}, uint32_t(_key_size),
+        uint32_t(_value_size)};
+
+    _out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    _out.append(_key, _key_size);
+
+    if (_value_size != 0)
+        _out.append(_value, _value_size);
+}
+
+// Appends the response to the output buffer
+inline void kv_append_response(std::string& _out, uint8_t _status,
+    const char* _value = nullptr, size_t _value_size = 0)
+{
+    kv_response_header header{_status, {0, 0, 0}, uint32_t(_value_size)};
+
+    _out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (_value_size != 0)
+        _out.append(_value, _value_size);
+}
+
+// Parses the request at the beginning of the data without copying, returns
+// the size of the request or 0 if the data does not hold it completely.
+// The malformed request throws
+inline size_t kv_parse_request(const char* _data, size_t _size,
+    kv_request& _request)
+{
+    kv_request_header header;
+
+    if (_size < sizeof(header))
+        return 0;
+
+    std::memcpy(&header, _data, sizeof(header));
+
+    if (header.op < KV_GET || header.op > KV_INFO ||
+        header.key_size > KV_MAX_KEY_SIZE ||
+        header.value_size > KV_MAX_VALUE_SIZE)
+        throw std::runtime_error("malformed request");
+
+    size_t size = sizeof(header) + header.key_size + header.value_size;
+
+    if (_size < size)
+        return 0;
+
+    _request.op = header.op;
+    _request.key = _data + sizeof(header);
+    _request.key_size = header.key_size;
+    _request.value = _request.key + header.key_size;
+    _request.value_size = header.value_size;
+
+    return size;
+}
+
+// Parses the response at the beginning of the data without copying, returns
+// the size of the response or 0 if the data does not hold it completely.
+// The malformed response throws
+inline size_t kv_parse_response(const char* _data, size_t _size,
+    kv_response& _response)
+{
+    kv_response_header header;
+
+    if (_size < sizeof(header))
+        return 0;
+
+    std::memcpy(&header, _data, sizeof(header));
+
+    if (header.status > KV_WRONG_SHARD ||
+        header.value_size > KV_MAX_VALUE_SIZE)
+        throw std::runtime_error("malformed response");
+
+    size_t size = sizeof(header) + header.value_size;
+
+    if (_size < size)
+        return 0;
+
+    _response.status = header.status;
+    _response.value = _data + sizeof(header);
+    _response.value_size = header.value_size;
+
+    return size;
+}
+
+
+// Address of the server: "unix:<path>" for the Unix domain sockets or
+// "tcp:<port>" for the loopback interface. The shard N listens on
+// "<path>.N" or on the port "<port> + N"
+struct kv_address
+{
+    bool is_unix;       // Whether it is the Unix domain socket
+    std::string path;   // Path of the socket
+    uint16_t port;      // Port of the first shard
+
+    // Parses the address
+    explicit kv_address(const std::string& _address):
+        is_unix{false},
+        port{0}
+    {
+        if (_address.compare(0, 5, "unix:") == 0 && _address.size() > 5)
+        {
+            is_unix = true;
+            path = _address.substr(5);
+        }
+        else if (_address.compare(0, 4, "tcp:") == 0)
+        {
+            char* end = nullptr;
+            unsigned long value = std::strtoul(_address.c_str() + 4, &end,
+                10);
+
+            if (end == _address.c_str() + 4 || *end != '\0' || value == 0 ||
+                value > UINT16_MAX)
+                throw std::invalid_argument("invalid port in " + _address);
+
+            port = value;
+        }
+        else
+            throw std::invalid_argument("the address must be \"unix:<path>\""
+                " or \"tcp:<port>\"");
+    }
+
+    // Returns the path of the socket of the shard
+    std::string shard_path(size_t _shard) const
+    { return path + "." + std::to_string(_shard); }
+
+    // Creates the socket of the shard and fills its address
+    int make_socket(size_t _shard, sockaddr_storage& _addr,
+        socklen_t& _addr_size) const
+    {
+        std::memset(&_addr, 0, sizeof(_addr));
+
+        if (is_unix)
+        {
+            sockaddr_un* addr = reinterpret_cast<sockaddr_un*>(&_addr);
+            std::string name = shard_path(_shard);
+
+            if (name.size() >= sizeof(addr->sun_path))
+                throw std::invalid_argument("the socket path is too long: " +
+                    name);
+
+            addr->sun_family = AF_UNIX;
+            std::memcpy(addr->sun_path, name.c_str(), name.size() + 1);
+            _addr_size = sizeof(sockaddr_un);
+        }
+        else
+        {
+            if (port + _shard > UINT16_MAX)
+                throw std::invalid_argument("the ports of the shards exceed "
+                    "the range");
+
+            sockaddr_in* addr = reinterpret_cast<sockaddr_in*>(&_addr);
+
+            addr->sin_family = AF_INET;
+            addr->sin_port = htons(uint16_t(port + _shard));
+            addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            _addr_size = sizeof(sockaddr_in);
+        }
+
+        int fd = ::socket(is_unix ? AF_UNIX : AF_INET,
+            SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to create the socket");
+
+        if (!is_unix)
+        {
+            // The pipelined batches are sent at once, so the delay of the
+            // small segments only adds the latency
+            int on = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+
+        return fd;
+    }
+
+    // Returns the listening socket of the shard
+    int listen(size_t _shard) const
+    {
+        sockaddr_storage addr;
+        socklen_t addr_size;
+        int fd = make_socket(_shard, addr, addr_size);
+        int on = 1;
+
+        if (is_unix)
+            ::unlink(shard_path(_shard).c_str());
+        else
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), addr_size) < 0 ||
+            ::listen(fd, SOMAXCONN) < 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(),
+                "failed to listen on the shard " + std::to_string(_shard));
+        }
+
+        return fd;
+    }
+
+    // Returns the socket connected to the shard
+    int connect(size_t _shard) const
+    {
+        sockaddr_storage addr;
+        socklen_t addr_size;
+        int fd = make_socket(_shard, addr, addr_size);
+
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), addr_size) < 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(),
+                "failed to connect to the shard " + std::to_string(_shard));
+        }
+
+        return fd;
+    }
+};
+
+
+#endif  // _KVPROTOCOL_
@@ -0,0 +1,163 @@
+// LatencyHistogram.hpp
+
+#ifndef _LATENCYHISTOGRAM_
+#define _LATENCYHISTOGRAM_
+
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+
+// Histogram of the latencies with the constant relative precision like the
+// HDR histogram. Every range [2^k, 2^(k + 1)) is split into SUB_COUNT equal
+// buckets, so the recorded value is rounded to less than 1/SUB_COUNT of it,
+// and the values less than SUB_COUNT are exact. The recording is a few
+// arithmetic operations without allocation, and the histograms of the
+// threads are merged for the percentiles
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SUB_BITS = 7;
+    static constexpr uint64_t SUB_COUNT = uint64_t(1) << SUB_BITS;
+    // The values of 2^MAX_BITS and larger are recorded to the last bucket,
+    // it is about 18 minutes in ns
+    static constexpr unsigned MAX_BITS = 40;
+    static constexpr size_t COUNT_BUCKETS = (MAX_BITS - SUB_BITS + 1) *
+        SUB_COUNT;
+
+private:
+    std::vector<uint64_t> _m_counts;    // Counts of the values of buckets
+    uint64_t _m_total;                  // Count of the recorded values
+    uint64_t _m_min;                    // Minimum recorded value
+    uint64_t _m_max;                    // Maximum recorded value
+    double _m_sum;                      // Sum of the recorded values
+
+    // Returns the bucket of the value
+    static size_t _index_of(uint64_t _value) noexcept
+    {
+        if (_value < SUB_COUNT)
+            return _value;
+
+        unsigned shift = 63 - __builtin_clzll(_value) - SUB_BITS;
+
+        if (shift >= MAX_BITS - SUB_BITS)
+            return COUNT_BUCKETS - 1;
+
+        return (shift + 1) * SUB_COUNT + ((_value >> shift) - SUB_COUNT);
+    }
+
+    // Returns the largest value of the bucket, the last bucket has no upper
+    // bound
+    static uint64_t _highest_of(size_t _index) noexcept
+    {
+        if (_index < SUB_COUNT)
+            return _index;
+
+        if (_index == COUNT_BUCKETS - 1)
+            return UINT64_MAX;
+
+        unsigned shift = _index / SUB_COUNT - 1;
+        uint64_t sub = _index % SUB_COUNT + SUB_COUNT;
+
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    // Constructors
+    ///////////////////////////////////////////////////////////////////////////
+
+    LatencyHistogram():
+        _m_counts(COUNT_BUCKETS),
+        _m_total{0},
+        _m_min{UINT64_MAX},
+        _m_max{0},
+        _m_sum{0}
+    {}
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Records the value
+    void record(uint64_t _value) noexcept
+    {
+        _m_counts[_index_of(_value)]++;
+        _m_total++;
+        _m_sum += _value;
+        _m_min = std::min(_m_min, _value);
+        _m_max = std::max(_m_max, _value);
+    }
+
+    // Adds the values of other histogram
+    void merge(const LatencyHistogram& _other) noexcept
+    {
+        for (size_t i = 0; i < COUNT_BUCKETS; i++)
+            _m_counts[i] += _other._m_counts[i];
+
+        _m_total += _other._m_total;
+        _m_sum += _other._m_sum;
+        _m_min = std::min(_m_min, _other._m_min);
+        _m_max = std::max(_m_max, _other._m_max);
+    }
+
+    // Removes all the values
+    void clear() noexcept
+    {
+        std::fill(_m_counts.begin(), _m_counts.end(), 0);
+        _m_total = 0;
+        _m_min = UINT64_MAX;
+        _m_max = 0;
+        _m_sum = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the count of the recorded values
+    uint64_t count() const noexcept { return _m_total; }
+
+    // Returns the exact minimum and maximum, 0 if there are no values
+    uint64_t min() const noexcept { return _m_total == 0 ? 0 : _m_min; }
+    uint64_t max() const noexcept { return _m_max; }
+
+    // Returns the mean of the recorded values
+    double mean() const noexcept
+    { return _m_total == 0 ? 0.0 : _m_sum / _m_total; }
+
+    // Returns the value, which is not less than the specified percent of
+    // the recorded values, with the precision of the bucket
+    uint64_t percentile(double _percent) const noexcept
+    {
+        if (_m_total == 0)
+            return 0;
+
+        uint64_t rank = std::ceil(_percent / 100.0 * _m_total);
+        rank = std::max<uint64_t>(1, std::min(rank, _m_total));
+
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < COUNT_BUCKETS; i++)
+        {
+            seen += _m_counts[i];
+
+            if (seen >= rank)
+                return std::min(_highest_of(i), _m_max);
+        }
+
+        return _m_max;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // LatencyHistogram
+
+
+#endif  // _LATENCYHISTOGRAM_
@@ -0,0 +1,398 @@
+// LruCache.hpp
+
+#ifndef _LRUCACHE_
+#define _LRUCACHE_
+
+
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+
+// Default weigher of the cache entries, which returns the size of the key
+// and the value objects
+struct __cache_entry_size
+{
+    template <class _Key, class _Data>
+    size_t operator()(const _Key&, const _Data&) const noexcept
+    { return sizeof(_Key) + sizeof(_Data); }
+};
+
+
+// Bounded cache built on the hash map. The entries are ordered by their
+// recency in the circular list, which links are stored in the map nodes
+// next to the values, so the lookup, the insertion and the eviction take
+// O(1) time without any additional allocations. The map nodes are never
+// reallocated, so the links remain valid after rehashing.
+//
+// The capacity is limited by the count of entries and optionally by their
+// total weight in bytes computed by "_Weigher" functor. With "_IsClock" set
+// the cache uses CLOCK (second chance) replacement instead of LRU: a hit only
+// sets the reference bit of the entry and the eviction hand skips the
+// entries with the set bit clearing it
+template
+<
+    class _Key, class _Data,
+    class _Hasher, class _KeyEqual, class _Weigher,
+    bool _IsClock
+>
+class __RecencyCache
+{
+public:
+    using _key_t            = _Key;
+    using _mapped_t         = _Data;
+    using _weigher_t        = _Weigher;
+    using _evict_callback_t = std::function<void(const _key_t&, _mapped_t&)>;
+
+    // Statistics of the cache
+    struct stats_t
+    {
+        size_t hits;        // Count of successful lookups
+        size_t misses;      // Count of failed lookups
+        size_t evictions;   // Count of evicted entries
+    };
+
+private:
+    struct _entry_t;
+    using _value_t = std::pair<const _key_t, _entry_t>;
+    using _map_t = HashMap<_key_t, _entry_t, _Hasher, _KeyEqual>;
+    using _map_iterator = typename _map_t::iterator;
+
+    // Cache entry with the links of the recency list
+    struct _entry_t
+    {
+        _mapped_t _m_data;      // Cached value
+        _value_t* _m_prev;      // Previous entry in the recency list
+        _value_t* _m_next;      // Next entry in the recency list
+        size_t _m_weight;       // Weight of the entry
+        bool _m_is_referenced;  // Reference bit of CLOCK replacement
+
+        // Constructor with the value and its weight
+        template <class _Arg>
+        _entry_t(_Arg&& _data, size_t _weight):
+            _m_data(std::forward<_Arg>(_data)),
+            _m_prev{nullptr},
+            _m_next{nullptr},
+            _m_weight{_weight},
+            _m_is_referenced{false}
+        {}
+    };
+
+    _map_t _m_map;                      // Entries of the cache
+    _value_t* _m_head;                  // Most recently used entry for LRU,
+                                        // eviction hand for CLOCK
+    size_t _m_max_entries;              // Max count of entries
+    size_t _m_max_weight;               // Max total weight, 0 if unbounded
+    size_t _m_weight;                   // Total weight of entries
+    _weigher_t _m_weigher;              // Weigher functor
+    _evict_callback_t _m_on_evict;      // Eviction callback
+    stats_t _m_stats;                   // Statistics
+
+    // Links the entry before the specified one in the recency list
+    void _link_before(_value_t* _pos, _value_t* _val) noexcept
+    {
+        if (_pos == nullptr)
+        {
+            _val->second._m_prev = _val;
+            _val->second._m_next = _val;
+            _m_head = _val;
+
+            return;
+        }
+
+        _val->second._m_next = _pos;
+        _val->second._m_prev = _pos->second._m_prev;
+        _pos->second._m_prev->second._m_next = _val;
+        _pos->second._m_prev = _val;
+    }
+
+    // Unlinks the entry from the recency list
+    void _unlink(_value_t* _val) noexcept
+    {
+        if (_val->second._m_next == _val)
+        {
+            _m_head = nullptr;
+            return;
+        }
+
+        if (_m_head == _val)
+            _m_head = _val->second._m_next;
+
+        _val->second._m_prev->second._m_next = _val->second._m_next;
+        _val->second._m_next->second._m_prev = _val->second._m_prev;
+    }
+
+    // Marks the entry as recently used
+    void _touch(_value_t* _val) noexcept
+    {
+        if (_IsClock)
+            _val->second._m_is_referenced = true;
+        else if (_m_head != _val)
+        {
+            _unlink(_val);
+            _link_before(_m_head, _val);
+            _m_head = _val;
+        }
+    }
+
+    // Links the new entry to the recency list
+    void _link_new(_value_t* _val) noexcept
+    {
+        // The new entry becomes the most recently used for LRU and the last
+        // one to be swept by the hand for CLOCK
+        _link_before(_m_head, _val);
+
+        if (!_IsClock)
+            _m_head = _val;
+    }
+
+    // Returns the entry to be evicted other than the specified one. For LRU
+    // the kept entry is the most recently used, so it is never the last one
+    // while there are other entries. For CLOCK the hand passes it by, since
+    // the new entry has the clear reference bit
+    _value_t* _victim(const _value_t* _keep) noexcept
+    {
+        if (!_IsClock)
+            return _m_head->second._m_prev;
+
+        while (_m_head == _keep || _m_head->second._m_is_referenced)
+        {
+            if (_m_head != _keep)
+                _m_head->second._m_is_referenced = false;
+
+            _m_head = _m_head->second._m_next;
+        }
+
+        return _m_head;
+    }
+
+    // Evicts the entries other than the just put one while the capacity is
+    // exceeded, the put entry is kept even if it exceeds the total weight
+    // alone
+    void _evict_overflow(const _value_t* _keep)
+    {
+        while
+        (
+            _m_map.size() > 1 &&
+            (
+                _m_map.size() > _m_max_entries ||
+                (_m_max_weight > 0 && _m_weight > _m_max_weight)
+            )
+        )
+        {
+            _value_t* victim = _victim(_keep);
+
+            if (_m_on_evict)
+                _m_on_evict(victim->first, victim->second._m_data);
+
+            _unlink(victim);
+            _m_weight -= victim->second._m_weight;
+            _m_stats.evictions++;
+
+            _m_map.erase(victim->first);
+        }
+    }
+
+    // Inserts or updates the entry
+    template <class _Arg>
+    void _put(const _key_t& _key, _Arg&& _data)
+    {
+        typename _map_t::hashed_key hkey = _m_map.hash_key(_key);
+        _map_iterator iter = _m_map.find(hkey);
+        size_t weight = _m_weigher(_key, _data);
+
+        if (iter != _m_map.end())
+        {
+            _entry_t& entry = (*iter).second;
+
+            entry._m_data = std::forward<_Arg>(_data);
+            _m_weight = _m_weight - entry._m_weight + weight;
+            entry._m_weight = weight;
+
+            _touch(&*iter);
+        }
+        else
+        {
+            iter = _m_map.insert
+            (
+                hkey, _entry_t(std::forward<_Arg>(_data), weight)
+            ).first;
+            _m_weight += weight;
+
+            _link_new(&*iter);
+        }
+
+        _evict_overflow(&*iter);
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructor with the capacity parameters. The maximum total weight
+    // equal to 0 means that the capacity is limited only by count of entries
+    explicit __RecencyCache
+    (
+        size_t _max_entries,
+        size_t _max_weight = 0,
+        const _weigher_t& _weigher = _weigher_t()
+    ):
+        _m_map{},
+        _m_head{nullptr},
+        _m_max_entries{_max_entries},
+        _m_max_weight{_max_weight},
+        _m_weight{0},
+        _m_weigher{_weigher},
+        _m_on_evict{},
+        _m_stats{0, 0, 0}
+    {
+        if (_max_entries == 0)
+            throw std::invalid_argument("the capacity of cache must be "
+                "positive");
+
+        // The map is never rehashed while the cache is being filled
+        _m_map.reverse(_max_entries + 1);
+    }
+
+    // The entries are linked by pointers, so the cache is not copyable
+    __RecencyCache(const __RecencyCache&) = delete;
+    __RecencyCache& operator=(const __RecencyCache&) = delete;
+
+    // Destructor
+    ~__RecencyCache() {}
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the pointer to the cached value and marks it as recently used,
+    // or nullptr if there is no such key in the cache
+    _mapped_t* get(const _key_t& _key)
+    {
+        _map_iterator iter = _m_map.find(_key);
+
+        if (iter == _m_map.end())
+        {
+            _m_stats.misses++;
+            return nullptr;
+        }
+
+        _m_stats.hits++;
+        _touch(&*iter);
+
+        return &(*iter).second._m_data;
+    }
+
+    // Checking the key for belonging to the cache without marking it as
+    // recently used and updating the statistics
+    bool contains(const _key_t& _key) const
+    { return _m_map.count(_key) > 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts the value by the key or replaces the cached one, then evicts
+    // the entries exceeding the capacity
+    void put(const _key_t& _key, const _mapped_t& _data)
+    { _put(_key, _data); }
+
+    void put(const _key_t& _key, _mapped_t&& _data)
+    { _put(_key, std::move(_data)); }
+
+    // Removes the entry by the key without calling the eviction callback
+    size_t erase(const _key_t& _key)
+    {
+        _map_iterator iter = _m_map.find(_key);
+
+        if (iter == _m_map.end())
+            return 0;
+
+        _unlink(&*iter);
+        _m_weight -= (*iter).second._m_weight;
+        _m_map.erase(iter);
+
+        return 1;
+    }
+
+    // Clear the cache without calling the eviction callback
+    void clear()
+    {
+        _m_map.clear();
+        _m_map.reverse(_m_max_entries + 1);
+        _m_head = nullptr;
+        _m_weight = 0;
+    }
+
+    // Sets the function called for every evicted entry
+    void on_evict(_evict_callback_t _callback)
+    { _m_on_evict = std::move(_callback); }
+
+    // Calls the function with the key and the value of every entry without
+    // marking them as recently used
+    template <class _Function>
+    void for_each(_Function _fn)
+    {
+        for (_value_t& val : _m_map)
+            _fn(val.first, val.second._m_data);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and statistics
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of entries in cache
+    size_t size() const noexcept { return _m_map.size(); }
+    // Checking the cache for emptiness
+    bool empty() const noexcept { return _m_map.empty(); }
+    // Returns max count of entries
+    size_t max_entries() const noexcept { return _m_max_entries; }
+    // Returns max total weight of entries, 0 if it is unbounded
+    size_t max_weight() const noexcept { return _m_max_weight; }
+    // Returns total weight of entries
+    size_t weight() const noexcept { return _m_weight; }
+
+    // Returns the statistics of the cache
+    stats_t stats() const noexcept { return _m_stats; }
+    // Resets the statistics of the cache
+    void reset_stats() noexcept { _m_stats = stats_t{0, 0, 0}; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // __RecencyCache
+
+
+// Bounded cache with LRU replacement
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Weigher = __cache_entry_size
+>
+using LruCache = __RecencyCache<_Key, _Data, _Hasher, _KeyEqual, _Weigher,
+    false>;
+
+// Bounded cache with CLOCK (second chance) replacement, which hit path does
+// not relink the entries
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>,
+    class _Weigher = __cache_entry_size
+>
+using ClockCache = __RecencyCache<_Key, _Data, _Hasher, _KeyEqual, _Weigher,
+    true>;
+
+
+#endif  // _LRUCACHE_
@@ -0,0 +1,375 @@
+// ParallelAggregator.hpp
+
+#ifndef _PARALLELAGGREGATOR_
+#define _PARALLELAGGREGATOR_
+
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+
+// Combine functors of the aggregated values
+
+// Sum of the values
+struct combine_sum
+{
+    template <class _Tp>
+    _Tp operator()(const _Tp& _acc, const _Tp& _val) const
+    { return _acc + _val; }
+};
+
+// Maximum of the values
+struct combine_max
+{
+    template <class _Tp>
+    const _Tp& operator()(const _Tp& _acc, const _Tp& _val) const
+    { return _acc < _val ? _val : _acc; }
+};
+
+// Minimum of the values
+struct combine_min
+{
+    template <class _Tp>
+    const _Tp& operator()(const _Tp& _acc, const _Tp& _val) const
+    { return _val < _acc ? _val : _acc; }
+};
+
+
+// Aggregation of the key-value pairs produced by several threads. Every
+// thread fills its own worker maps without synchronization, then the maps
+// are merged in parallel. The keys are split between the partitions by the
+// high bits of their mixed hash values, so the partitions of different
+// workers can be merged independently. All the maps take the seed of the
+// aggregator, so the nodes are relinked between them without rehashing of
+// the keys. The map reseeded by its chain length tripwire still works, its
+// keys are hashed again by the lookups and by the merging.
+//
+// The worker can spill its maps to the shared partitions when it grows past
+// the specified count of elements, which bounds the memory of the workers
+// with many unique keys. Only the spilling locks the shared partitions
+template
+<
+    class _Key, class _Data,
+    class _Combine = combine_sum,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>
+>
+class ParallelAggregator
+{
+public:
+    using _key_t        = _Key;
+    using _mapped_t     = _Data;
+    using _combine_t    = _Combine;
+    using _hasher_t     = _Hasher;
+    using _map_t        = HashMap<_Key, _Data, _Hasher, _KeyEqual>;
+    using hashed_key    = typename _map_t::hashed_key;
+
+    // Size of the cache line, which separates the data of the workers
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Local aggregation state of a single thread
+    class worker
+    {
+    private:
+        friend class ParallelAggregator;
+
+        // The padding keeps the counters of the workers allocated one
+        // after another in different cache lines
+        char _m_front_padding[CACHE_LINE_SIZE];
+        ParallelAggregator* _m_owner;   // Aggregator of the worker
+        std::vector<_map_t> _m_parts;   // Partitions of the worker
+        size_t _m_count;                // Count of elements in partitions
+        char _m_back_padding[CACHE_LINE_SIZE];
+
+        // Constructor with the aggregator
+        explicit worker(ParallelAggregator& _owner):
+            _m_owner{&_owner},
+            _m_parts(_owner._m_locks.size()),
+            _m_count{0}
+        {
+            for (_map_t& part : _m_parts)
+                part.reseed(_owner._m_seed);
+        }
+
+        // Returns the partition map of the hashed key. The worker spills
+        // its partitions before the addition of a new element, when it is
+        // full, so the references to the elements remain valid until the
+        // next addition
+        _map_t& _part_of(const hashed_key& _hkey)
+        {
+            size_t hash = __seed_hash(_m_owner->_m_hasher, _hkey.key(),
+                _hkey.hash(), _m_owner->_m_seed);
+            _map_t& part = _m_parts[_m_owner->_partition_index(hash)];
+
+            if
+            (
+                _m_owner->_m_spill_size > 0 &&
+                _m_count >= _m_owner->_m_spill_size &&
+                part.find(_hkey) == part.end()
+            )
+                spill();
+
+            return part;
+        }
+
+    public:
+        // Returns the hashed key for the worker maps
+        hashed_key hash_key(const _key_t& _key) const
+        {
+            return hashed_key(_key, __hash_without_seed(_m_owner->_m_hasher,
+                _key));
+        }
+
+        // Returns the reference to the aggregated value of the key, the
+        // value is default constructed if the key has not been added yet
+        _mapped_t& operator[](const _key_t& _key)
+        { return (*this)[hash_key(_key)]; }
+
+        _mapped_t& operator[](const hashed_key& _hkey)
+        {
+            _map_t& part = _part_of(_hkey);
+            size_t size = part.size();
+            _mapped_t& data = part[_hkey];
+
+            _m_count += part.size() - size;
+
+            return data;
+        }
+
+        // Combines the value with the aggregated value of the key, the
+        // value is inserted if the key has not been added yet
+        void add(const _key_t& _key, const _mapped_t& _data)
+        { add(hash_key(_key), _data); }
+
+        void add(const hashed_key& _hkey, const _mapped_t& _data)
+        {
+            _map_t& part = _part_of(_hkey);
+            std::pair<typename _map_t::iterator, bool> res
+                = part.insert(_hkey, _data);
+
+            if (res.second)
+                _m_count++;
+            else
+                (*res.first).second = _m_owner->_m_combine((*res.first).second,
+                    _data);
+        }
+
+        // Moves the elements of the worker to the shared partitions
+        void spill()
+        {
+            for (size_t i = 0; i < _m_parts.size(); i++)
+            {
+                if (_m_parts[i].empty())
+                    continue;
+
+                std::lock_guard<std::mutex> lock(_m_owner->_m_locks[i]);
+                _m_owner->_m_parts[i].merge(_m_parts[i], _m_owner->_m_combine);
+            }
+
+            _m_count = 0;
+        }
+
+        // Count of elements in the worker
+        size_t size() const noexcept { return _m_count; }
+    };
+
+private:
+    std::vector<std::unique_ptr<worker>> _m_workers;    // Workers
+    std::vector<_map_t> _m_parts;                       // Shared partitions
+    std::vector<std::mutex> _m_locks;                   // Partitions locks
+    unsigned _m_partition_bits;                         // Bits of partition
+    size_t _m_spill_size;                               // Max worker size
+    _combine_t _m_combine;                              // Combine functor
+    _hasher_t _m_hasher;                                // Hasher functor
+    size_t _m_seed;                                     // Seed of the maps
+
+    // Returns the index of partition by the hash value. The hash is mixed
+    // by the multiplication with the golden ratio, because the buckets of
+    // the maps are chosen by its low bits
+    size_t _partition_index(size_t _hash) const noexcept
+    {
+        if (_m_partition_bits == 0)
+            return 0;
+
+        return static_cast<size_t>((static_cast<uint64_t>(_hash) *
+            0x9E3779B97F4A7C15ull) >> (64 - _m_partition_bits));
+    }
+
+    // Calls the function with the index for every index less than the
+    // specified count in separate threads and rethrows the first exception
+    template <class _Function>
+    static void _parallel_for(size_t _count, _Function _fn)
+    {
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(_count);
+
+        threads.reserve(_count);
+        for (size_t i = 0; i < _count; i++)
+            threads.emplace_back([&_fn, &errors, i]()
+            {
+                try
+                {
+                    _fn(i);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            });
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (std::exception_ptr& error : errors)
+            if (error)
+                std::rethrow_exception(error);
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructor with the count of workers, the max count of elements in
+    // the worker before spilling (0 means that the workers never spill),
+    // the combine functor and the count of partitions. The count of
+    // partitions is rounded up to a power of two and by default it is
+    // chosen by the count of workers
+    explicit ParallelAggregator
+    (
+        size_t _count_workers,
+        size_t _spill_size = 0,
+        const _combine_t& _combine = _combine_t(),
+        size_t _count_partitions = 0
+    ):
+        _m_workers{},
+        _m_parts{},
+        _m_locks{},
+        _m_partition_bits{0},
+        _m_spill_size{_spill_size},
+        _m_combine{_combine},
+        _m_hasher{},
+        _m_seed{_Random_seed()}
+    {
+        if (_count_workers == 0)
+            throw std::invalid_argument("the count of workers must be "
+                "positive");
+
+        if (_count_partitions == 0)
+            _count_partitions = _count_workers * 4;
+
+        while ((size_t(1) << _m_partition_bits) < _count_partitions)
+            _m_partition_bits++;
+
+        _m_parts = std::vector<_map_t>(size_t(1) << _m_partition_bits);
+        _m_locks = std::vector<std::mutex>(_m_parts.size());
+
+        for (_map_t& part : _m_parts)
+            part.reseed(_m_seed);
+
+        _m_workers.reserve(_count_workers);
+        for (size_t i = 0; i < _count_workers; i++)
+            _m_workers.emplace_back(new worker(*this));
+    }
+
+    // The workers refer to the aggregator, so it is not copyable
+    ParallelAggregator(const ParallelAggregator&) = delete;
+    ParallelAggregator& operator=(const ParallelAggregator&) = delete;
+
+    // Destructor
+    ~ParallelAggregator() {}
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Aggregation
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the worker by its index. Every worker must be used by one
+    // thread at a time
+    worker& local(size_t _n) { return *_m_workers.at(_n); }
+
+    // Count of workers
+    size_t count_workers() const noexcept { return _m_workers.size(); }
+    // Count of partitions
+    size_t count_partitions() const noexcept { return _m_parts.size(); }
+
+    // Calls the function with the worker and its index in a separate thread
+    // for every worker and waits for them
+    template <class _Function>
+    void run(_Function _fn)
+    {
+        _parallel_for(_m_workers.size(), [this, &_fn](size_t _n)
+        { _fn(*_m_workers[_n], _n); });
+    }
+
+    // Merges the workers into the shared partitions in parallel. Every
+    // thread merges its own subset of partitions, so no locking is needed.
+    // It must not be called concurrently with the workers
+    void merge()
+    {
+        size_t count_threads = _m_workers.size();
+
+        if (count_threads > _m_parts.size())
+            count_threads = _m_parts.size();
+
+        _parallel_for(count_threads, [this, count_threads](size_t _n)
+        {
+            for (size_t i = _n; i < _m_parts.size(); i += count_threads)
+                for (std::unique_ptr<worker>& w : _m_workers)
+                    _m_parts[i].merge(w->_m_parts[i], _m_combine);
+        });
+
+        for (std::unique_ptr<worker>& w : _m_workers)
+            w->_m_count = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Result
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the merged partitions, the key can be only in one of them
+    const std::vector<_map_t>& partitions() const noexcept { return _m_parts; }
+
+    // Count of merged elements
+    size_t size() const noexcept
+    {
+        size_t count = 0;
+
+        for (const _map_t& part : _m_parts)
+            count += part.size();
+
+        return count;
+    }
+
+    // Moves the merged partitions to the single map. The partitions do not
+    // intersect, so their nodes are only relinked
+    _map_t release()
+    {
+        _map_t result;
+
+        result.reseed(_m_seed);
+        result.reverse(size());
+        for (_map_t& part : _m_parts)
+            result.merge(part);
+
+        return result;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // ParallelAggregator
+
+
+#endif  // _PARALLELAGGREGATOR_
@@ -0,0 +1,1059 @@
+// PersistentHashMap.hpp
+
+#ifndef _PERSISTENTHASHMAP_
+#define _PERSISTENTHASHMAP_
+
+
+#include <initializer_list>
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+
+// Persistent hash map based on the hash array mapped trie. Every node has
+// two 32-bit bitmaps indexed by 5 bits of the hash value: the bitmap of the
+// elements stored in the node and the bitmap of the child nodes, the arrays
+// of the elements and the children are compacted and indexed by the
+// population count of the lower bits. The keys with equal hash values are
+// stored in the collision node below the last level.
+//
+// The nodes are immutable and shared by reference counting, so the copy of
+// the map (snapshot) takes O(1) time and the update copies only the nodes on
+// the path to the element, which takes O(log32 n) allocations. The versions
+// can be read by different threads, because the reference counters are
+// atomic. The element is stored in the node, while the subtree with a single
+// element is replaced by the element, so the trie of the same elements has
+// the same shape regardless of the order of the updates.
+//
+// The transient of the map modifies the nodes created by itself in place,
+// which is used for the bulk building. Its nodes are marked by the unique
+// edit token, the token is replaced when the transient gives the persistent
+// map, so the nodes of the given map are never modified again
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>
+>
+class PersistentHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<const _Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+
+    class const_iterator;
+    using iterator = const_iterator;
+    class transient_type;
+
+protected:
+    static constexpr unsigned BITS = 5;
+    static constexpr size_t MASK = (size_t(1) << BITS) - 1;
+    static constexpr unsigned HASH_BITS = sizeof(size_t) * 8;
+    // Max count of the nodes on the path with the collision node
+    static constexpr unsigned MAX_DEPTH = (HASH_BITS + BITS - 1) / BITS + 1;
+
+    // Node of the trie, the arrays of the elements and the children follow
+    // it in the same block of memory
+    struct _node_t
+    {
+        std::atomic<size_t> _m_refs;    // Count of references
+        uint64_t _m_owner;              // Edit token of the transient
+        uint32_t _m_datamap;            // Bitmap of the elements
+        uint32_t _m_nodemap;            // Bitmap of the children
+        uint32_t _m_count_values;       // Count of the elements
+        uint32_t _m_count_nodes;        // Count of the children
+        bool _m_is_collision;           // Whether it is the collision node
+    };
+
+    _node_t* _m_root;                   // Root node, nullptr if it is empty
+    size_t _m_count;                    // Count of items in map
+    _hasher_t _m_hasher;                // Hasher functor
+    _key_equal_t _m_key_equal;          // Key equal functor
+    size_t _m_seed;                     // Seed of the hash values
+
+    // Returns the unique edit token of the transient
+    static uint64_t _new_token() noexcept
+    {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    // Offsets of the arrays of the node
+
+    static size_t _values_offset() noexcept
+    {
+        return (sizeof(_node_t) + alignof(_value_t) - 1) /
+            alignof(_value_t) * alignof(_value_t);
+    }
+
+    static size_t _nodes_offset(uint32_t _count_values) noexcept
+    {
+        size_t offset = _values_offset() + _count_values * sizeof(_value_t);
+
+        return (offset + alignof(_node_t*) - 1) / alignof(_node_t*) *
+            alignof(_node_t*);
+    }
+
+    // Returns the arrays of the node
+
+    static _value_t* _values(const _node_t* _node) noexcept
+    {
+        return reinterpret_cast<_value_t*>(const_cast<char*>(
+            reinterpret_cast<const char*>(_node) + _values_offset()));
+    }
+
+    static _node_t** _nodes(const _node_t* _node) noexcept
+    {
+        return reinterpret_cast<_node_t**>(const_cast<char*>(
+            reinterpret_cast<const char*>(_node) +
+            _nodes_offset(_node->_m_count_values)));
+    }
+
+    // Returns the bit of the hash value at the level
+    static uint32_t _bit(size_t _hash, unsigned _shift) noexcept
+    { return uint32_t(1) << ((_hash >> _shift) & MASK); }
+
+    // Returns the index in the compacted array by the bitmap and the bit
+    static uint32_t _index(uint32_t _bitmap, uint32_t _bit) noexcept
+    { return __builtin_popcount(_bitmap & (_bit - 1)); }
+
+    // Checks that the node has a single element and no children
+    static bool _is_singleton(const _node_t* _node) noexcept
+    { return _node->_m_count_values == 1 && _node->_m_count_nodes == 0; }
+
+    // Adds the reference to the node
+    static _node_t* _retain(_node_t* _node) noexcept
+    {
+        if (_node != nullptr)
+            _node->_m_refs.fetch_add(1, std::memory_order_relaxed);
+
+        return _node;
+    }
+
+    // Removes the reference to the node, the node without references is
+    // destroyed with its elements and releases its children
+    static void _release(_node_t* _node) noexcept
+    {
+        if
+        (
+            _node == nullptr ||
+            _node->_m_refs.fetch_sub(1, std::memory_order_acq_rel) != 1
+        )
+            return;
+
+        for (uint32_t i = 0; i < _node->_m_count_values; i++)
+            _values(_node)[i].~_value_t();
+
+        for (uint32_t i = 0; i < _node->_m_count_nodes; i++)
+            _release(_nodes(_node)[i]);
+
+        _node->~_node_t();
+        ::operator delete(_node);
+    }
+
+    // Creates the node with one reference. The elements are copied from
+    // "_value_at(i)" and the children are retained from "_node_at(i)"
+    template <class _ValueAt, class _NodeAt>
+    static _node_t* _make
+    (
+        uint32_t _datamap, uint32_t _nodemap,
+        uint32_t _count_values, uint32_t _count_nodes,
+        bool _is_collision, uint64_t _owner,
+        _ValueAt _value_at, _NodeAt _node_at
+    )
+    {
+        void* memory = ::operator new(_nodes_offset(_count_values) +
+            _count_nodes * sizeof(_node_t*));
+        _node_t* node = new (memory) _node_t;
+
+        node->_m_refs.store(1, std::memory_order_relaxed);
+        node->_m_owner = _owner;
+        node->_m_datamap = _datamap;
+        node->_m_nodemap = _nodemap;
+        node->_m_count_values = _count_values;
+        node->_m_count_nodes = _count_nodes;
+        node->_m_is_collision = _is_collision;
+
+        uint32_t i = 0;
+
+        try
+        {
+            for (; i < _count_values; i++)
+                new (&_values(node)[i]) _value_t(_value_at(i));
+        }
+        catch (...)
+        {
+            while (i-- > 0)
+                _values(node)[i].~_value_t();
+
+            node->~_node_t();
+            ::operator delete(memory);
+            throw;
+        }
+
+        for (i = 0; i < _count_nodes; i++)
+            _nodes(node)[i] = _retain(_node_at(i));
+
+        return node;
+    }
+
+    // Returns the copy of the node owned by the edit token, or the node
+    // itself retained if it is already owned by the token
+    static _node_t* _editable(_node_t* _node, uint64_t _token)
+    {
+        if (_token != 0 && _node->_m_owner == _token)
+            return _retain(_node);
+
+        const _value_t* values = _values(_node);
+        _node_t** nodes = _nodes(_node);
+
+        return _make(_node->_m_datamap, _node->_m_nodemap,
+            _node->_m_count_values, _node->_m_count_nodes,
+            _node->_m_is_collision, _token,
+            [values](uint32_t _i) -> const _value_t& { return values[_i]; },
+            [nodes](uint32_t _i) { return nodes[_i]; });
+    }
+
+    // Returns the node with the child replaced by the new one, the reference
+    // to the new child is taken by the node
+    static _node_t* _replace_child(_node_t* _node, uint32_t _n,
+        _node_t* _child, uint64_t _token)
+    {
+        if (_nodes(_node)[_n] == _child)
+        {
+            _release(_child);
+            return _retain(_node);
+        }
+
+        _node_t* edit;
+
+        try
+        {
+            edit = _editable(_node, _token);
+        }
+        catch (...)
+        {
+            _release(_child);
+            throw;
+        }
+
+        _release(_nodes(edit)[_n]);
+        _nodes(edit)[_n] = _child;
+
+        return edit;
+    }
+
+    // Returns the hash value of the key
+    size_t _hash(const _key_t& _key) const
+    { return __hash_with_seed(_m_hasher, _key, _m_seed); }
+
+    // Creates the subtrie of two elements with different keys starting from
+    // the level of the shift
+    _node_t* _make_pair
+    (
+        const _value_t& _first, size_t _first_hash,
+        const _value_t& _second, size_t _second_hash,
+        unsigned _shift, uint64_t _token
+    ) const
+    {
+        if (_shift >= HASH_BITS)
+            return _make(0, 0, 2, 0, true, _token,
+                [&](uint32_t _i) -> const _value_t&
+                { return _i == 0 ? _first : _second; },
+                [](uint32_t) { return (_node_t*)nullptr; });
+
+        uint32_t first_bit = _bit(_first_hash, _shift);
+        uint32_t second_bit = _bit(_second_hash, _shift);
+
+        if (first_bit != second_bit)
+            return _make(first_bit | second_bit, 0, 2, 0, false, _token,
+                [&](uint32_t _i) -> const _value_t&
+                {
+                    return (_i == 0) == (first_bit < second_bit) ?
+                        _first : _second;
+                },
+                [](uint32_t) { return (_node_t*)nullptr; });
+
+        _node_t* child = _make_pair(_first, _first_hash, _second,
+            _second_hash, _shift + BITS, _token);
+        _node_t* node;
+
+        try
+        {
+            node = _make(0, first_bit, 0, 1, false, _token,
+                [&](uint32_t) -> const _value_t& { return _first; },
+                [child](uint32_t) { return child; });
+        }
+        catch (...)
+        {
+            _release(child);
+            throw;
+        }
+
+        _release(child);
+
+        return node;
+    }
+
+    // Returns the node with the inserted or assigned element, the returned
+    // reference is owned by the caller. The element is assigned if the key
+    // is present and "_is_assign" is set
+    _node_t* _insert
+    (
+        _node_t* _node, size_t _key_hash, unsigned _shift,
+        const _value_t& _val, bool _is_assign, uint64_t _token,
+        bool& _is_inserted
+    ) const
+    {
+        const _value_t* values = _values(_node);
+        _node_t** nodes = _nodes(_node);
+        uint32_t count_values = _node->_m_count_values;
+        uint32_t count_nodes = _node->_m_count_nodes;
+        uint32_t index = count_values;
+
+        if (_node->_m_is_collision)
+        {
+            for (uint32_t i = 0; i < count_values; i++)
+                if (_m_key_equal(_val.first, values[i].first))
+                    index = i;
+        }
+        else
+        {
+            uint32_t bit = _bit(_key_hash, _shift);
+            uint32_t datamap = _node->_m_datamap;
+            uint32_t nodemap = _node->_m_nodemap;
+
+            if (nodemap & bit)
+            {
+                uint32_t n = _index(nodemap, bit);
+                _node_t* child = _insert(nodes[n], _key_hash, _shift + BITS,
+                    _val, _is_assign, _token, _is_inserted);
+
+                return _replace_child(_node, n, child, _token);
+            }
+
+            uint32_t i = _index(datamap, bit);
+
+            if (!(datamap & bit))
+            {
+                // The element is added to the node
+                _is_inserted = true;
+
+                return _make(datamap | bit, nodemap, count_values + 1,
+                    count_nodes, false, _token,
+                    [&](uint32_t _i) -> const _value_t&
+                    {
+                        return _i < i ? values[_i] :
+                            _i == i ? _val : values[_i - 1];
+                    },
+                    [nodes](uint32_t _i) { return nodes[_i]; });
+            }
+
+            if (_m_key_equal(_val.first, values[i].first))
+                index = i;
+            else
+            {
+                // The element and the stored one are moved to the child
+                _node_t* child = _make_pair(values[i],
+                    _hash(values[i].first), _val, _key_hash, _shift + BITS,
+                    _token);
+                uint32_t n = _index(nodemap, bit);
+                _node_t* node;
+
+                try
+                {
+                    node = _make(datamap & ~bit, nodemap | bit,
+                        count_values - 1, count_nodes + 1, false, _token,
+                        [&](uint32_t _i) -> const _value_t&
+                        { return values[_i < i ? _i : _i + 1]; },
+                        [&](uint32_t _i)
+                        {
+                            return _i < n ? nodes[_i] :
+                                _i == n ? child : nodes[_i - 1];
+                        });
+                }
+                catch (...)
+                {
+                    _release(child);
+                    throw;
+                }
+
+                _release(child);
+                _is_inserted = true;
+
+                return node;
+            }
+        }
+
+        if (index < count_values)
+        {
+            if (!_is_assign)
+                return _retain(_node);
+
+            _node_t* edit = _editable(_node, _token);
+
+            _values(edit)[index].second = _val.second;
+
+            return edit;
+        }
+
+        // The element is added to the collision node
+        _is_inserted = true;
+
+        return _make(0, 0, count_values + 1, 0, true, _token,
+            [&](uint32_t _i) -> const _value_t&
+            { return _i < count_values ? values[_i] : _val; },
+            [](uint32_t) { return (_node_t*)nullptr; });
+    }
+
+    // Returns the node without the element with the key or nullptr if the
+    // node becomes empty, the returned reference is owned by the caller
+    _node_t* _erase
+    (
+        _node_t* _node, size_t _key_hash, unsigned _shift,
+        const _key_t& _key, uint64_t _token, bool& _is_removed
+    ) const
+    {
+        const _value_t* values = _values(_node);
+        _node_t** nodes = _nodes(_node);
+        uint32_t count_values = _node->_m_count_values;
+        uint32_t count_nodes = _node->_m_count_nodes;
+
+        if (_node->_m_is_collision)
+        {
+            for (uint32_t i = 0; i < count_values; i++)
+            {
+                if (!_m_key_equal(_key, values[i].first))
+                    continue;
+
+                _is_removed = true;
+
+                if (count_values == 1)
+                    return nullptr;
+
+                return _make(0, 0, count_values - 1, 0, true, _token,
+                    [&](uint32_t _i) -> const _value_t&
+                    { return values[_i < i ? _i : _i + 1]; },
+                    [](uint32_t) { return (_node_t*)nullptr; });
+            }
+
+            return _retain(_node);
+        }
+
+        uint32_t bit = _bit(_key_hash, _shift);
+        uint32_t datamap = _node->_m_datamap;
+        uint32_t nodemap = _node->_m_nodemap;
+
+        if (datamap & bit)
+        {
+            uint32_t i = _index(datamap, bit);
+
+            if (!_m_key_equal(_key, values[i].first))
+                return _retain(_node);
+
+            _is_removed = true;
+
+            if (count_values == 1 && count_nodes == 0)
+                return nullptr;
+
+            return _make(datamap & ~bit, nodemap, count_values - 1,
+                count_nodes, false, _token,
+                [&](uint32_t _i) -> const _value_t&
+                { return values[_i < i ? _i : _i + 1]; },
+                [nodes](uint32_t _i) { return nodes[_i]; });
+        }
+
+        if (!(nodemap & bit))
+            return _retain(_node);
+
+        uint32_t n = _index(nodemap, bit);
+        _node_t* child = _erase(nodes[n], _key_hash, _shift + BITS, _key,
+            _token, _is_removed);
+
+        if (child == nodes[n])
+        {
+            _release(child);
+            return _retain(_node);
+        }
+
+        if (child == nullptr)
+        {
+            if (count_values == 0 && count_nodes == 1)
+                return nullptr;
+
+            return _make(datamap, nodemap & ~bit, count_values,
+                count_nodes - 1, false, _token,
+                [values](uint32_t _i) -> const _value_t&
+                { return values[_i]; },
+                [&](uint32_t _i) { return nodes[_i < n ? _i : _i + 1]; });
+        }
+
+        if (!_is_singleton(child))
+            return _replace_child(_node, n, child, _token);
+
+        // The single element of the child is inlined to the node, the node
+        // with this child only is inlined to its parent in turn
+        if (count_values == 0 && count_nodes == 1 && _shift > 0)
+            return child;
+
+        const _value_t& val = _values(child)[0];
+        uint32_t i = _index(datamap, bit);
+        _node_t* node;
+
+        try
+        {
+            node = _make(datamap | bit, nodemap & ~bit, count_values + 1,
+                count_nodes - 1, false, _token,
+                [&](uint32_t _i) -> const _value_t&
+                {
+                    return _i < i ? values[_i] :
+                        _i == i ? val : values[_i - 1];
+                },
+                [&](uint32_t _i) { return nodes[_i < n ? _i : _i + 1]; });
+        }
+        catch (...)
+        {
+            _release(child);
+            throw;
+        }
+
+        _release(child);
+
+        return node;
+    }
+
+    // Inserts or assigns the element, returns whether it was inserted. The
+    // nodes owned by the token are modified in place
+    bool _update(const _value_t& _val, bool _is_assign, uint64_t _token)
+    {
+        size_t hash = _hash(_val.first);
+        bool is_inserted = false;
+        _node_t* root;
+
+        if (_m_root == nullptr)
+        {
+            root = _make(_bit(hash, 0), 0, 1, 0, false, _token,
+                [&](uint32_t) -> const _value_t& { return _val; },
+                [](uint32_t) { return (_node_t*)nullptr; });
+            is_inserted = true;
+        }
+        else
+            root = _insert(_m_root, hash, 0, _val, _is_assign, _token,
+                is_inserted);
+
+        _release(_m_root);
+        _m_root = root;
+
+        if (is_inserted)
+            _m_count++;
+
+        return is_inserted;
+    }
+
+    // Erases the element by the key, returns count of removed elements
+    size_t _remove(const _key_t& _key, uint64_t _token)
+    {
+        if (_m_root == nullptr)
+            return 0;
+
+        bool is_removed = false;
+        _node_t* root = _erase(_m_root, _hash(_key), 0, _key, _token,
+            is_removed);
+
+        _release(_m_root);
+        _m_root = root;
+
+        if (!is_removed)
+            return 0;
+
+        _m_count--;
+
+        return 1;
+    }
+
+public:
+    // Iterator over the elements of the map. It keeps the path from the
+    // root to the current element, so it is valid while the version of the
+    // map is alive
+    class const_iterator:
+        public std::iterator<std::forward_iterator_tag, const _value_t>
+    {
+    private:
+        friend class PersistentHashMap;
+
+        // Node on the path and the position in it, the positions of the
+        // elements are followed by the positions of the children
+        struct _frame_t
+        {
+            const _node_t* _m_node;
+            uint32_t _m_pos;
+        };
+
+        _frame_t _m_stack[MAX_DEPTH];   // Path to the current element
+        unsigned _m_depth;              // Length of the path, 0 at the end
+
+        // Pushes the node to the path
+        void _push(const _node_t* _node, uint32_t _pos) noexcept
+        { _m_stack[_m_depth++] = _frame_t{_node, _pos}; }
+
+        // Moves the iterator to the first element starting from its
+        // position
+        void _settle() noexcept
+        {
+            while (_m_depth > 0)
+            {
+                _frame_t& top = _m_stack[_m_depth - 1];
+                uint32_t count_values = top._m_node->_m_count_values;
+
+                if (top._m_pos < count_values)
+                    return;
+
+                if (top._m_pos < count_values + top._m_node->_m_count_nodes)
+                {
+                    const _node_t* child
+                        = _nodes(top._m_node)[top._m_pos++ - count_values];
+
+                    _push(child, 0);
+                    continue;
+                }
+
+                _m_depth--;
+            }
+        }
+
+    public:
+        // Default constructor
+        const_iterator() noexcept: _m_depth{0} {}
+
+        // Equality operator
+        bool operator==(const const_iterator& _other) const noexcept
+        {
+            if (_m_depth != _other._m_depth)
+                return false;
+
+            return _m_depth == 0 ||
+                (
+                    _m_stack[_m_depth - 1]._m_node ==
+                        _other._m_stack[_m_depth - 1]._m_node &&
+                    _m_stack[_m_depth - 1]._m_pos ==
+                        _other._m_stack[_m_depth - 1]._m_pos
+                );
+        }
+
+        // Inequality operator
+        bool operator!=(const const_iterator& _other) const noexcept
+        { return !(*this == _other); }
+
+        // Dereference operators
+        const _value_t& operator*() const noexcept
+        {
+            const _frame_t& top = _m_stack[_m_depth - 1];
+            return _values(top._m_node)[top._m_pos];
+        }
+
+        const _value_t* operator->() const noexcept
+        { return &**this; }
+
+        // Prefix increment operator
+        const_iterator& operator++() noexcept
+        {
+            _m_stack[_m_depth - 1]._m_pos++;
+            _settle();
+
+            return *this;
+        }
+
+        // Postfix increment operator
+        const_iterator operator++(int) noexcept
+        {
+            const_iterator temp = *this;
+            ++(*this);
+
+            return temp;
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Transient of the map. It modifies its own nodes in place and shares
+    // the rest with the maps
+    class transient_type
+    {
+    private:
+        friend class PersistentHashMap;
+
+        PersistentHashMap _m_map;   // Current version
+        uint64_t _m_token;          // Edit token of the nodes
+
+        // Constructor with the initial version
+        explicit transient_type(const PersistentHashMap& _map):
+            _m_map(_map),
+            _m_token{_new_token()}
+        {}
+
+    public:
+        // Move constructor
+        transient_type(transient_type&& _other) noexcept:
+            _m_map(std::move(_other._m_map)),
+            _m_token{_other._m_token}
+        { _other._m_token = _new_token(); }
+
+        // The nodes are owned by the single transient
+        transient_type(const transient_type&) = delete;
+        transient_type& operator=(const transient_type&) = delete;
+
+        // Count of items in container
+        size_t size() const noexcept { return _m_map.size(); }
+        // Checking the container for emptiness
+        bool empty() const noexcept { return _m_map.empty(); }
+
+        // Returns count of items with specified key in container
+        size_t count(const _key_t& _key) const
+        { return _m_map.count(_key); }
+
+        // Access to the element by key, if the element is not found,
+        // an out_of_range exception is thrown
+        const _mapped_t& at(const _key_t& _key) const
+        { return _m_map.at(_key); }
+
+        // Inserts the element if there is no element with its key, returns
+        // whether it was inserted
+        bool insert(const _value_t& _val)
+        { return _m_map._update(_val, false, _m_token); }
+
+        // Inserts the element or replaces the mapped value of the element
+        // with the same key, returns whether the element was inserted
+        bool insert_or_assign(const _key_t& _key, const _mapped_t& _data)
+        { return _m_map._update(_value_t(_key, _data), true, _m_token); }
+
+        // Erase item from container by specified key
+        size_t erase(const _key_t& _key)
+        { return _m_map._remove(_key, _m_token); }
+
+        // Returns the persistent map of the current elements. The edit
+        // token is replaced, so the nodes of the map are not modified by
+        // the following updates of the transient
+        PersistentHashMap persistent()
+        {
+            _m_token = _new_token();
+            return _m_map;
+        }
+    };
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Default constructor with optional parameters
+    explicit PersistentHashMap
+    (
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        _m_root{nullptr},
+        _m_count{0},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal},
+        _m_seed{_Random_seed()}
+    {}
+
+    // Range-based constructor
+    template <class InputIterator>
+    PersistentHashMap
+    (
+        const InputIterator& _first, const InputIterator& _last,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        PersistentHashMap(_hasher, _key_equal)
+    {
+        insert(_first, _last);
+    }
+
+    // Constructor based on the initialization list
+    PersistentHashMap
+    (
+        std::initializer_list<_value_t> _il,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        PersistentHashMap(_hasher, _key_equal)
+    {
+        insert(_il);
+    }
+
+    // Copy constructor, the nodes are shared
+    PersistentHashMap(const PersistentHashMap& _other) noexcept:
+        _m_root{_retain(_other._m_root)},
+        _m_count{_other._m_count},
+        _m_hasher{_other._m_hasher},
+        _m_key_equal{_other._m_key_equal},
+        _m_seed{_other._m_seed}
+    {}
+
+    // Move constructor
+    PersistentHashMap(PersistentHashMap&& _other) noexcept:
+        _m_root{_other._m_root},
+        _m_count{_other._m_count},
+        _m_hasher{std::move(_other._m_hasher)},
+        _m_key_equal{std::move(_other._m_key_equal)},
+        _m_seed{_other._m_seed}
+    {
+        _other._m_root = nullptr;
+        _other._m_count = 0;
+    }
+
+    // Destructor
+    ~PersistentHashMap() { _release(_m_root); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Assigment operator
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assignment by copying, the nodes are shared
+    PersistentHashMap& operator=(const PersistentHashMap& _other)
+    {
+        _node_t* root = _retain(_other._m_root);
+
+        _release(_m_root);
+        _m_root = root;
+        _m_count = _other._m_count;
+        _m_hasher = _other._m_hasher;
+        _m_key_equal = _other._m_key_equal;
+        _m_seed = _other._m_seed;
+
+        return *this;
+    }
+
+    // Assignment by moving
+    PersistentHashMap& operator=(PersistentHashMap&& _other) noexcept
+    {
+        if (this == &_other)
+            return *this;
+
+        _release(_m_root);
+        _m_root = _other._m_root;
+        _m_count = _other._m_count;
+        _m_hasher = std::move(_other._m_hasher);
+        _m_key_equal = std::move(_other._m_key_equal);
+        _m_seed = _other._m_seed;
+        _other._m_root = nullptr;
+        _other._m_count = 0;
+
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the iterator set to the beginning of the container
+    const_iterator begin() const noexcept
+    {
+        const_iterator iter;
+
+        if (_m_root != nullptr)
+        {
+            iter._push(_m_root, 0);
+            iter._settle();
+        }
+
+        return iter;
+    }
+
+    // Returns the iterator set to the beginning of the container
+    const_iterator cbegin() const noexcept { return begin(); }
+    // Returns the iterator set to the end of the container
+    const_iterator end() const noexcept { return const_iterator(); }
+    // Returns the iterator set to the end of the container
+    const_iterator cend() const noexcept { return const_iterator(); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const noexcept { return _m_count; }
+    // Checking the container for emptiness
+    bool empty() const noexcept { return _m_count == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Accessing an element by key and returning an iterator
+    const_iterator find(const _key_t& _key) const
+    {
+        const_iterator iter;
+
+        if (_m_root == nullptr)
+            return iter;
+
+        size_t hash = _hash(_key);
+        const _node_t* node = _m_root;
+
+        for (unsigned shift = 0; ; shift += BITS)
+        {
+            const _value_t* values = _values(node);
+
+            if (node->_m_is_collision)
+            {
+                for (uint32_t i = 0; i < node->_m_count_values; i++)
+                {
+                    if (_m_key_equal(_key, values[i].first))
+                    {
+                        iter._push(node, i);
+                        return iter;
+                    }
+                }
+
+                return end();
+            }
+
+            uint32_t bit = _bit(hash, shift);
+
+            if (node->_m_datamap & bit)
+            {
+                uint32_t i = _index(node->_m_datamap, bit);
+
+                if (!_m_key_equal(_key, values[i].first))
+                    return end();
+
+                iter._push(node, i);
+                return iter;
+            }
+
+            if (!(node->_m_nodemap & bit))
+                return end();
+
+            // The position in the parent follows the child, as the
+            // iterator goes on from it after the child
+            uint32_t n = _index(node->_m_nodemap, bit);
+
+            iter._push(node, node->_m_count_values + n + 1);
+            node = _nodes(node)[n];
+        }
+    }
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const
+    { return find(_key) != end(); }
+
+    // Access to the element by key, if the element is not found,
+    // an out_of_range exception is thrown
+    const _mapped_t& at(const _key_t& _key) const
+    {
+        const_iterator iter = find(_key);
+
+        if (iter != end())
+            return (*iter).second;
+        else
+            throw std::out_of_range("the element with this key was not found");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts the element if there is no element with its key, the nodes on
+    // the path to the element are copied
+    std::pair<const_iterator, bool> insert(const _value_t& _val)
+    {
+        bool is_inserted = _update(_val, false, 0);
+
+        return std::make_pair(find(_val.first), is_inserted);
+    }
+
+    // Inserts the range of elements, the new nodes are modified in place
+    // as by the transient
+    template <class InputIterator>
+    size_t insert(InputIterator _first, InputIterator _last)
+    {
+        uint64_t token = _new_token();
+        size_t result = 0;
+
+        for (InputIterator iter = _first; iter != _last; iter++)
+            if (_update(*iter, false, token))
+                result++;
+
+        return result;
+    }
+
+    // Inserting an initialization list
+    size_t insert(std::initializer_list<_value_t> _il)
+    { return insert(_il.begin(), _il.end()); }
+
+    // Inserts the element or replaces the mapped value of the element with
+    // the same key, returns whether the element was inserted
+    bool insert_or_assign(const _key_t& _key, const _mapped_t& _data)
+    { return _update(_value_t(_key, _data), true, 0); }
+
+    // Erase item from container by specified key
+    size_t erase(const _key_t& _key)
+    { return _remove(_key, 0); }
+
+    // Clear the container
+    void clear() noexcept
+    {
+        _release(_m_root);
+        _m_root = nullptr;
+        _m_count = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Versions
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the snapshot of the map sharing all its nodes
+    PersistentHashMap snapshot() const noexcept { return *this; }
+
+    // Returns the transient, which starts from the current elements
+    transient_type transient() const { return transient_type(*this); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    // Returns the seed of the hash values of the keys
+    size_t seed() const noexcept { return _m_seed; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // PersistentHashMap
+
+
+#endif  // _PERSISTENTHASHMAP_
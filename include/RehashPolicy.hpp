@@ -0,0 +1,133 @@
+// RehashPolicy.hpp
+
+#ifndef _REHASHPOLICY_
+#define _REHASHPOLICY_
+
+
+#include <cstdint>
+#include <cstddef>
+
+#include <hash/hash_functions.hpp>
+
+
+// The rehash policy of the hash table with the collision chains decides how
+// the bucket array grows and shrinks. It is a class with the static members:
+//
+//   MIN_COUNT_BUCKETS          - the least count of buckets
+//   DEFAULT_MAX_LOAD_FACTOR    - the initial maximum load factor
+//   DEFAULT_MIN_LOAD_FACTOR    - the initial minimum load factor, 0 disables
+//                                the shrinking
+//   SHRINK_DIVISOR             - the minimum load factor is limited by the
+//                                maximum one divided by it, so the resized
+//                                container is far from both limits
+//   grow(count)                - the count of elements the full or the
+//                                sparse container with the count of
+//                                elements is resized for
+//   count_buckets(count)       - the count of buckets of the sequence,
+//                                which is not less than the specified one
+//   index(hash, count)         - the bucket of the hash value among the
+//                                count of buckets from the sequence
+
+
+// Returns the least prime number not less than the specified one
+inline size_t __next_prime(size_t _n) noexcept
+{
+    if (_n <= 2)
+        return 2;
+
+    for (size_t n = _n | 1; ; n += 2)
+    {
+        bool is_prime = true;
+
+        for (size_t d = 3; d <= n / d; d += 2)
+            if (n % d == 0)
+            {
+                is_prime = false;
+                break;
+            }
+
+        if (is_prime)
+            return n;
+    }
+}
+
+// Returns the least power of two not less than the specified number
+inline size_t __next_power_of_two(size_t _n) noexcept
+{
+    size_t n = 1;
+
+    while (n < _n)
+        n <<= 1;
+
+    return n;
+}
+
+
+// Policy of the container by default: the container doubles the count of
+// elements it is sized for, the count of buckets is exactly the requested
+// one and the bucket is the remainder of the hash value
+struct DefaultRehashPolicy
+{
+    static constexpr size_t MIN_COUNT_BUCKETS = 16;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+    static constexpr float DEFAULT_MIN_LOAD_FACTOR = 0.0f;
+    static constexpr float SHRINK_DIVISOR = 4.0f;
+
+    static size_t grow(size_t _count) noexcept { return _count * 2; }
+
+    static size_t count_buckets(size_t _count) noexcept { return _count; }
+
+    static size_t index(size_t _hash, size_t _count_buckets) noexcept
+    { return mod_hash(_hash, _count_buckets); }
+};
+
+// Policy for the tight memory: the chains are longer, the container grows by
+// half, and shrinks when the erasures leave it a quarter full. The reserved
+// buckets are kept till then. The bucket counts are prime, so the remainders
+// of the hash values spread well for any count
+struct LowMemoryRehashPolicy
+{
+    static constexpr size_t MIN_COUNT_BUCKETS = 5;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 2.0f;
+    static constexpr float DEFAULT_MIN_LOAD_FACTOR = 0.5f;
+    static constexpr float SHRINK_DIVISOR = 4.0f;
+
+    static size_t grow(size_t _count) noexcept
+    { return _count + _count / 2 + 1; }
+
+    static size_t count_buckets(size_t _count) noexcept
+    { return __next_prime(_count); }
+
+    static size_t index(size_t _hash, size_t _count_buckets) noexcept
+    { return mod_hash(_hash, _count_buckets); }
+};
+
+// Policy for the low latency: the chains are short, the container grows
+// four times, so it is rehashed rarely, and never shrinks by itself. The
+// bucket counts are powers of two, so the bucket is taken from the high
+// bits of the hash value multiplied by the golden ratio instead of the
+// division
+struct LowLatencyRehashPolicy
+{
+    static constexpr size_t MIN_COUNT_BUCKETS = 64;
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 0.75f;
+    static constexpr float DEFAULT_MIN_LOAD_FACTOR = 0.0f;
+    static constexpr float SHRINK_DIVISOR = 4.0f;
+
+    static size_t grow(size_t _count) noexcept { return _count * 4; }
+
+    static size_t count_buckets(size_t _count) noexcept
+    { return __next_power_of_two(_count); }
+
+    static size_t index(size_t _hash, size_t _count_buckets) noexcept
+    {
+        if (_count_buckets == 1)
+            return 0;
+
+        return (uint64_t(_hash) * 0x9E3779B97F4A7C15ull) >>
+            (64 - __builtin_ctzll(_count_buckets));
+    }
+};
+
+
+#endif  // _REHASHPOLICY_
@@ -0,0 +1,706 @@
+// SharedHashMap.hpp
+
+#ifndef _SHAREDHASHMAP_
+#define _SHAREDHASHMAP_
+
+
+#include <string>
+#include <functional>
+#include <utility>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <cmath>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+// Pointer stored as the offset from its own address, so the structures
+// linked by such pointers remain valid when the memory is mapped at
+// different addresses. The zero offset means nullptr
+template <class _Tp>
+class __offset_ptr
+{
+private:
+    ptrdiff_t _m_offset;    // Offset of the object from this pointer
+
+public:
+    // Default constructor, the pointer is null
+    __offset_ptr() noexcept: _m_offset{0} {}
+
+    // Constructor with the raw pointer
+    __offset_ptr(_Tp* _ptr) noexcept: _m_offset{0} { *this = _ptr; }
+
+    // Copy constructor, the offset is computed for the new address
+    __offset_ptr(const __offset_ptr& _other) noexcept: _m_offset{0}
+    { *this = _other.get(); }
+
+    // Assignment of the raw pointer
+    __offset_ptr& operator=(_Tp* _ptr) noexcept
+    {
+        _m_offset = _ptr == nullptr ? 0 : reinterpret_cast<char*>(_ptr) -
+            reinterpret_cast<char*>(this);
+
+        return *this;
+    }
+
+    // Assignment by copying, the offset is computed for the new address
+    __offset_ptr& operator=(const __offset_ptr& _other) noexcept
+    { return *this = _other.get(); }
+
+    // Returns the raw pointer
+    _Tp* get() const noexcept
+    {
+        return _m_offset == 0 ? nullptr : reinterpret_cast<_Tp*>(
+            const_cast<char*>(reinterpret_cast<const char*>(this)) +
+            _m_offset);
+    }
+
+    // Dereference operators
+    _Tp& operator*() const noexcept { return *get(); }
+    _Tp* operator->() const noexcept { return get(); }
+
+    // Checking the pointer for null
+    explicit operator bool() const noexcept { return _m_offset != 0; }
+}; // __offset_ptr
+
+
+// Hash map in the POSIX shared memory segment, which is used by several
+// processes at once. The segment holds the header, the bucket array and the
+// nodes, they are linked by the offset pointers, so every process can map
+// the segment at any address. The first process creates and initializes
+// the segment, the next ones open it and use the table as it is.
+//
+// The count of nodes is fixed on creation, because the segment mapped by
+// other processes can not be reallocated, so the insertion to the full map
+// throws. The bucket array is sized for the capacity by the maximum load
+// factor. The erased nodes are reused through the list of free nodes.
+//
+// The readers and the writers of all processes are coordinated by the
+// process-shared read-write lock in the header, the lookups take it shared.
+// The elements are returned by value, because they can be changed by other
+// processes after the unlocking. The keys and the mapped values must be
+// trivially copyable and the hasher must be the same for all processes, the
+// seed of the hash values is stored in the segment.
+//
+// The read-write lock is not robust: if a process dies holding it, for
+// example killed inside "update", the lock is never released and the other
+// processes block on it forever. The segment must then be removed and
+// created again, so the processes, which can be killed, must not share the
+// map with the ones, which must keep working
+template
+<
+    class _Key, class _Data,
+    class _Hasher = hash<_Key>,
+    class _KeyEqual = std::equal_to<_Key>
+>
+class SharedHashMap
+{
+public:
+    using _key_t         = _Key;
+    using _mapped_t      = _Data;
+    using _value_t       = std::pair<_Key, _Data>;
+    using _hasher_t      = _Hasher;
+    using _key_equal_t   = _KeyEqual;
+
+    static_assert(std::is_trivially_copyable<_Key>::value &&
+        std::is_trivially_copyable<_Data>::value,
+        "the keys and the mapped values must be trivially copyable");
+
+    static constexpr float DEFAULT_MAX_LOAD_FACTOR = 1.0f;
+    // Time of waiting for the segment being initialized by other process
+    static constexpr unsigned OPEN_TIMEOUT_MS = 5000;
+
+protected:
+    static constexpr uint64_t MAGIC = 0x50414d4853524853ull; // "SHRSHMAP"
+    static constexpr uint32_t VERSION = 1;
+
+    // Node of the map in the segment
+    struct _node_t
+    {
+        __offset_ptr<_node_t> _m_next;  // Next node of the chain
+        size_t _m_hash;                 // Hash value of the key
+        _key_t _m_key;                  // Key
+        _mapped_t _m_data;              // Mapped value
+    };
+
+    using _bucket_t = __offset_ptr<_node_t>;
+
+    // Header of the segment, the bucket array and the nodes follow it
+    struct _header_t
+    {
+        std::atomic<uint32_t> _m_is_ready;  // Whether it is initialized
+        uint32_t _m_version;                // Version of the layout
+        uint64_t _m_magic;                  // Signature of the segment
+        uint64_t _m_key_size;               // Size of the key
+        uint64_t _m_mapped_size;            // Size of the mapped value
+        uint64_t _m_capacity;               // Count of nodes
+        uint64_t _m_count_buckets;          // Count of buckets
+        uint64_t _m_count;                  // Count of elements
+        uint64_t _m_used;                   // Count of nodes taken
+        uint64_t _m_seed;                   // Seed of the hash values
+        __offset_ptr<_node_t> _m_free;      // First free node
+        pthread_rwlock_t _m_lock;           // Lock of the map
+    };
+
+    // Shared and exclusive guards of the lock of the map
+
+    class _read_guard
+    {
+    private:
+        pthread_rwlock_t* _m_lock;
+
+    public:
+        explicit _read_guard(pthread_rwlock_t& _lock): _m_lock{&_lock}
+        {
+            int res = pthread_rwlock_rdlock(_m_lock);
+
+            if (res != 0)
+                throw std::system_error(res, std::generic_category(),
+                    "failed to lock the shared map");
+        }
+
+        ~_read_guard() { pthread_rwlock_unlock(_m_lock); }
+    };
+
+    class _write_guard
+    {
+    private:
+        pthread_rwlock_t* _m_lock;
+
+    public:
+        explicit _write_guard(pthread_rwlock_t& _lock): _m_lock{&_lock}
+        {
+            int res = pthread_rwlock_wrlock(_m_lock);
+
+            if (res != 0)
+                throw std::system_error(res, std::generic_category(),
+                    "failed to lock the shared map");
+        }
+
+        ~_write_guard() { pthread_rwlock_unlock(_m_lock); }
+    };
+
+    std::string _m_name;            // Name of the segment
+    int _m_fd;                      // Descriptor of the segment
+    size_t _m_size;                 // Size of the segment
+    void* _m_memory;                // Mapped segment
+    _header_t* _m_header;           // Header of the segment
+    _bucket_t* _m_buckets;          // Bucket array in the segment
+    _node_t* _m_nodes;              // Nodes in the segment
+    _hasher_t _m_hasher;            // Hasher functor
+    _key_equal_t _m_key_equal;      // Key equal functor
+
+    // Returns the offset of the array aligned for the type
+    template <class _Tp>
+    static size_t _align(size_t _offset) noexcept
+    { return (_offset + alignof(_Tp) - 1) / alignof(_Tp) * alignof(_Tp); }
+
+    // Returns the offsets of the bucket array and the nodes and the size of
+    // the segment
+
+    static size_t _buckets_offset() noexcept
+    { return _align<_bucket_t>(sizeof(_header_t)); }
+
+    static size_t _nodes_offset(size_t _count_buckets) noexcept
+    {
+        return _align<_node_t>(_buckets_offset() +
+            _count_buckets * sizeof(_bucket_t));
+    }
+
+    static size_t _segment_size(size_t _count_buckets, size_t _capacity)
+        noexcept
+    { return _nodes_offset(_count_buckets) + _capacity * sizeof(_node_t); }
+
+    // Throws the exception with the error code of the failed call
+    static void _throw_errno(const std::string& _what)
+    { throw std::system_error(errno, std::generic_category(), _what); }
+
+    // Sets the pointers to the parts of the mapped segment
+    void _attach(size_t _count_buckets) noexcept
+    {
+        char* memory = static_cast<char*>(_m_memory);
+
+        _m_header = reinterpret_cast<_header_t*>(memory);
+        _m_buckets = reinterpret_cast<_bucket_t*>(memory +
+            _buckets_offset());
+        _m_nodes = reinterpret_cast<_node_t*>(memory +
+            _nodes_offset(_count_buckets));
+    }
+
+    // Maps the segment of the specified size
+    void _map(size_t _size)
+    {
+        _m_memory = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, _m_fd, 0);
+
+        if (_m_memory == MAP_FAILED)
+        {
+            _m_memory = nullptr;
+            _throw_errno("failed to map the shared memory " + _m_name);
+        }
+
+        _m_size = _size;
+    }
+
+    // Sizes, maps and initializes the new segment
+    void _create(size_t _capacity, float _max_load_factor)
+    {
+        if (_capacity == 0 || _capacity >= SIZE_MAX / sizeof(_node_t))
+            throw std::invalid_argument("the capacity of the shared map is "
+                "invalid");
+
+        size_t count_buckets = std::ceil(_capacity / _max_load_factor);
+
+        if (count_buckets == 0)
+            count_buckets = 1;
+
+        size_t size = _segment_size(count_buckets, _capacity);
+
+        if (::ftruncate(_m_fd, size) < 0)
+            _throw_errno("failed to size the shared memory " + _m_name);
+
+        _map(size);
+        _attach(count_buckets);
+
+        // The segment is zeroed, so the buckets and the free list are null
+        _header_t* header = new (_m_header) _header_t;
+
+        header->_m_version = VERSION;
+        header->_m_magic = MAGIC;
+        header->_m_key_size = sizeof(_key_t);
+        header->_m_mapped_size = sizeof(_mapped_t);
+        header->_m_capacity = _capacity;
+        header->_m_count_buckets = count_buckets;
+        header->_m_count = 0;
+        header->_m_used = 0;
+        header->_m_seed = _Random_seed();
+        header->_m_free = nullptr;
+
+        pthread_rwlockattr_t attr;
+        int res = pthread_rwlockattr_init(&attr);
+
+        if (res == 0)
+        {
+            res = pthread_rwlockattr_setpshared(&attr,
+                PTHREAD_PROCESS_SHARED);
+
+            if (res == 0)
+                res = pthread_rwlock_init(&header->_m_lock, &attr);
+
+            pthread_rwlockattr_destroy(&attr);
+        }
+
+        if (res != 0)
+            throw std::system_error(res, std::generic_category(),
+                "failed to initialize the lock of the shared map");
+
+        header->_m_is_ready.store(1, std::memory_order_release);
+    }
+
+    // Maps the existing segment, waiting for its creator to initialize it
+    void _open()
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::milliseconds(unsigned(OPEN_TIMEOUT_MS));
+        struct stat st;
+
+        while (true)
+        {
+            if (::fstat(_m_fd, &st) < 0)
+                _throw_errno("failed to read the size of the shared memory " +
+                    _m_name);
+
+            if (size_t(st.st_size) >= sizeof(_header_t))
+            {
+                if (_m_memory == nullptr)
+                    _map(st.st_size);
+
+                if (static_cast<_header_t*>(_m_memory)->_m_is_ready.load(
+                    std::memory_order_acquire))
+                    break;
+            }
+
+            if (std::chrono::steady_clock::now() > deadline)
+                throw std::runtime_error("the shared memory " + _m_name +
+                    " has not been initialized");
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const _header_t* header = static_cast<_header_t*>(_m_memory);
+
+        if
+        (
+            header->_m_magic != MAGIC ||
+            header->_m_version != VERSION ||
+            header->_m_key_size != sizeof(_key_t) ||
+            header->_m_mapped_size != sizeof(_mapped_t) ||
+            _segment_size(header->_m_count_buckets, header->_m_capacity) >
+                _m_size
+        )
+            throw std::runtime_error("the shared memory " + _m_name +
+                " does not hold the map of these types");
+
+        _attach(header->_m_count_buckets);
+    }
+
+    // Releases the mapping and the descriptor
+    void _close() noexcept
+    {
+        if (_m_memory != nullptr)
+            ::munmap(_m_memory, _m_size);
+
+        if (_m_fd >= 0)
+            ::close(_m_fd);
+    }
+
+    // Returns the hash value of the key
+    size_t _hash(const _key_t& _key) const
+    { return __hash_with_seed(_m_hasher, _key, _m_header->_m_seed); }
+
+    // Returns the bucket by the hash value
+    _bucket_t& _bucket(size_t _key_hash) const noexcept
+    { return _m_buckets[mod_hash(_key_hash, _m_header->_m_count_buckets)]; }
+
+    // Returns the node with the key in the chain or nullptr
+    _node_t* _find_node(const _key_t& _key, size_t _key_hash) const
+    {
+        for (_node_t* node = _bucket(_key_hash).get(); node != nullptr;
+            node = node->_m_next.get())
+        {
+            if (node->_m_hash == _key_hash &&
+                _m_key_equal(_key, node->_m_key))
+                return node;
+        }
+
+        return nullptr;
+    }
+
+    // Adds the new element to the front of its chain, the node is taken
+    // from the list of free nodes or from the unused ones
+    _node_t* _insert_new(const _key_t& _key, const _mapped_t& _data,
+        size_t _key_hash)
+    {
+        _header_t* header = _m_header;
+        _node_t* node = header->_m_free.get();
+
+        if (node != nullptr)
+            header->_m_free = node->_m_next.get();
+        else if (header->_m_used < header->_m_capacity)
+            node = &_m_nodes[header->_m_used++];
+        else
+            throw std::length_error("the shared map is full");
+
+        _bucket_t& bucket = _bucket(_key_hash);
+
+        new (&node->_m_key) _key_t(_key);
+        new (&node->_m_data) _mapped_t(_data);
+        node->_m_hash = _key_hash;
+        node->_m_next = bucket.get();
+        bucket = node;
+        header->_m_count++;
+
+        return node;
+    }
+
+public:
+    // Constructors and destructor
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Constructor with the name of the segment and the count of elements.
+    // The segment is created for the specified count of elements if it does
+    // not exist, otherwise the existing one is opened with its own capacity
+    SharedHashMap
+    (
+        const std::string& _name,
+        size_t _capacity,
+        float _max_load_factor = DEFAULT_MAX_LOAD_FACTOR,
+        const _hasher_t& _hasher = _hasher_t(),
+        const _key_equal_t& _key_equal = _key_equal_t()
+    ):
+        _m_name{_name},
+        _m_fd{-1},
+        _m_size{0},
+        _m_memory{nullptr},
+        _m_header{nullptr},
+        _m_buckets{nullptr},
+        _m_nodes{nullptr},
+        _m_hasher{_hasher},
+        _m_key_equal{_key_equal}
+    {
+        if (!(_max_load_factor > 0))
+            throw std::invalid_argument("the max load factor must be "
+                "positive");
+
+        try
+        {
+            _m_fd = ::shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL,
+                0600);
+
+            if (_m_fd >= 0)
+            {
+                try
+                {
+                    _create(_capacity, _max_load_factor);
+                }
+                catch (...)
+                {
+                    ::shm_unlink(_name.c_str());
+                    throw;
+                }
+            }
+            else if (errno == EEXIST)
+            {
+                _m_fd = ::shm_open(_name.c_str(), O_RDWR, 0600);
+
+                if (_m_fd < 0)
+                    _throw_errno("failed to open the shared memory " + _name);
+
+                _open();
+            }
+            else
+                _throw_errno("failed to create the shared memory " + _name);
+        }
+        catch (...)
+        {
+            _close();
+            throw;
+        }
+    }
+
+    // The map owns the mapping, so it is not copyable
+    SharedHashMap(const SharedHashMap&) = delete;
+    SharedHashMap& operator=(const SharedHashMap&) = delete;
+
+    // Destructor, the segment remains for other processes
+    ~SharedHashMap() { _close(); }
+
+    // Removes the segment with the specified name, the processes, which
+    // have mapped it, still use it
+    static void remove(const std::string& _name)
+    {
+        if (::shm_unlink(_name.c_str()) < 0 && errno != ENOENT)
+            _throw_errno("failed to remove the shared memory " + _name);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity and size
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Count of items in container
+    size_t size() const
+    {
+        _read_guard guard(_m_header->_m_lock);
+        return _m_header->_m_count;
+    }
+
+    // Checking the container for emptiness
+    bool empty() const { return size() == 0; }
+
+    // Returns max count of elements
+    size_t capacity() const noexcept { return _m_header->_m_capacity; }
+
+    // Returns count of buckets in container
+    size_t buckets_count() const noexcept
+    { return _m_header->_m_count_buckets; }
+
+    // Returns the name of the segment
+    const std::string& name() const noexcept { return _m_name; }
+
+    // Returns the size of the segment in bytes
+    size_t memory_usage() const noexcept { return _m_size; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Elements access
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns count of items with specified key in container
+    // (1 if there is such an element, 0 otherwise)
+    size_t count(const _key_t& _key) const
+    {
+        size_t hash = _hash(_key);
+        _read_guard guard(_m_header->_m_lock);
+
+        return _find_node(_key, hash) != nullptr;
+    }
+
+    // Copies the mapped value by the key, returns false if there is no such
+    // element
+    bool get(const _key_t& _key, _mapped_t& _data) const
+    {
+        size_t hash = _hash(_key);
+        _read_guard guard(_m_header->_m_lock);
+        _node_t* node = _find_node(_key, hash);
+
+        if (node == nullptr)
+            return false;
+
+        _data = node->_m_data;
+
+        return true;
+    }
+
+    // Returns the mapped value by the key, if the element is not found,
+    // an out_of_range exception is thrown
+    _mapped_t at(const _key_t& _key) const
+    {
+        _mapped_t data;
+
+        if (!get(_key, data))
+            throw std::out_of_range("the element with this key was not found");
+
+        return data;
+    }
+
+    // Calls the function with the key and the mapped value of every element
+    // holding the shared lock, so the function must not modify the map
+    template <class _Function>
+    void for_each(_Function _fn) const
+    {
+        _read_guard guard(_m_header->_m_lock);
+
+        for (size_t i = 0; i < _m_header->_m_count_buckets; i++)
+            for (const _node_t* node = _m_buckets[i].get(); node != nullptr;
+                node = node->_m_next.get())
+                _fn(static_cast<const _key_t&>(node->_m_key),
+                    static_cast<const _mapped_t&>(node->_m_data));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Modifiers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Inserts the element if there is no element with its key, returns
+    // whether it was inserted
+    bool insert(const _value_t& _val)
+    {
+        size_t hash = _hash(_val.first);
+        _write_guard guard(_m_header->_m_lock);
+
+        if (_find_node(_val.first, hash) != nullptr)
+            return false;
+
+        _insert_new(_val.first, _val.second, hash);
+
+        return true;
+    }
+
+    // Inserts the element or replaces the mapped value of the element with
+    // the same key, returns whether the element was inserted
+    bool insert_or_assign(const _key_t& _key, const _mapped_t& _data)
+    {
+        size_t hash = _hash(_key);
+        _write_guard guard(_m_header->_m_lock);
+        _node_t* node = _find_node(_key, hash);
+
+        if (node == nullptr)
+        {
+            _insert_new(_key, _data, hash);
+            return true;
+        }
+
+        node->_m_data = _data;
+
+        return false;
+    }
+
+    // Calls the function with the mapped value by the key holding the
+    // exclusive lock, so the read-modify-write is atomic for all processes.
+    // The absent element is inserted with the default mapped value, returns
+    // whether it was inserted
+    template <class _Function>
+    bool update(const _key_t& _key, _Function _fn)
+    {
+        size_t hash = _hash(_key);
+        _write_guard guard(_m_header->_m_lock);
+        _node_t* node = _find_node(_key, hash);
+        bool is_inserted = node == nullptr;
+
+        if (is_inserted)
+            node = _insert_new(_key, _mapped_t{}, hash);
+
+        _fn(node->_m_data);
+
+        return is_inserted;
+    }
+
+    // Erase item from container by specified key, its node is reused
+    size_t erase(const _key_t& _key)
+    {
+        size_t hash = _hash(_key);
+        _write_guard guard(_m_header->_m_lock);
+        _bucket_t* link = &_bucket(hash);
+
+        while (*link)
+        {
+            _node_t* node = link->get();
+
+            if (node->_m_hash == hash && _m_key_equal(_key, node->_m_key))
+            {
+                *link = node->_m_next.get();
+                node->_m_next = _m_header->_m_free.get();
+                _m_header->_m_free = node;
+                _m_header->_m_count--;
+
+                return 1;
+            }
+
+            link = &node->_m_next;
+        }
+
+        return 0;
+    }
+
+    // Clear the container, all the nodes become unused
+    void clear()
+    {
+        _write_guard guard(_m_header->_m_lock);
+
+        for (size_t i = 0; i < _m_header->_m_count_buckets; i++)
+            _m_buckets[i] = nullptr;
+
+        _m_header->_m_free = nullptr;
+        _m_header->_m_used = 0;
+        _m_header->_m_count = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Observers
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the function used to hash the keys
+    _hasher_t hash_function() const noexcept
+    { return _m_hasher; }
+
+    // Returns the function used to compare keys for equality
+    _key_equal_t key_eq() const noexcept
+    { return _m_key_equal; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+}; // SharedHashMap
+
+
+#endif  // _SHAREDHASHMAP_
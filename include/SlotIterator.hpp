@@ -0,0 +1,94 @@
+// SlotIterator.hpp
+
+#ifndef _SLOTITERATOR_
+#define _SLOTITERATOR_
+
+
+#include <iterator>
+#include <cstddef>
+
+
+// Iterator over the occupied slots of the open addressing table. The table
+// must provide "_slot_count()", "_is_occupied(i)" and "_value_at(i)"
+template <class _Table, class _Value>
+class __slot_iterator:
+    public std::iterator<std::forward_iterator_tag, _Value>
+{
+private:
+    template <class, class> friend class __slot_iterator;
+
+    _Table* _m_table_ptr;   // Table of the iterator
+    size_t _m_index;        // Index of the slot, count of slots at the end
+
+    // Moves the iterator to the first occupied slot from the current one
+    void _skip_empty() noexcept
+    {
+        while
+        (
+            _m_index < _m_table_ptr->_slot_count() &&
+            !_m_table_ptr->_is_occupied(_m_index)
+        )
+            _m_index++;
+    }
+
+public:
+    // Default constructor
+    __slot_iterator(): _m_table_ptr{nullptr}, _m_index{0} {}
+
+    // Constructor with the table and the index of the slot, the iterator is
+    // moved to the first occupied slot at or after the specified one
+    __slot_iterator(_Table& _table, size_t _index) noexcept:
+        _m_table_ptr{&_table},
+        _m_index{_index}
+    {
+        _skip_empty();
+    }
+
+    // Converting constructor from the iterator over mutable elements
+    template <class _OtherTable, class _OtherValue>
+    __slot_iterator(const __slot_iterator<_OtherTable, _OtherValue>& _other):
+        _m_table_ptr{_other._m_table_ptr},
+        _m_index{_other._m_index}
+    {}
+
+    // Returns the index of the slot
+    size_t index() const noexcept { return _m_index; }
+
+    // Equality operator
+    bool operator==(const __slot_iterator& _other) const noexcept
+    {
+        return _m_table_ptr == _other._m_table_ptr &&
+            _m_index == _other._m_index;
+    }
+
+    // Inequality operator
+    bool operator!=(const __slot_iterator& _other) const noexcept
+    { return !(*this == _other); }
+
+    // Dereference operators
+    _Value& operator*() const noexcept
+    { return _m_table_ptr->_value_at(_m_index); }
+    _Value* operator->() const noexcept
+    { return &_m_table_ptr->_value_at(_m_index); }
+
+    // Prefix increment operator
+    __slot_iterator& operator++() noexcept
+    {
+        _m_index++;
+        _skip_empty();
+
+        return *this;
+    }
+
+    // Postfix increment operator
+    __slot_iterator operator++(int) noexcept
+    {
+        __slot_iterator temp = *this;
+        ++(*this);
+
+        return temp;
+    }
+};
+
+
+#endif  // _SLOTITERATOR_
@@ -0,0 +1,508 @@
+// StaticHashMap.hpp
+
+#ifndef _STATICHASHMAP_
+#define _STATICHASHMAP_
+
+
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+
+#include <hash/hash_impl.hpp>
+
+
+// Element of the literal list of a static map
+template <class _Key, class _Data>
+struct static_entry
+{
+    _Key  _m_key;       // Key
+    _Data _m_value;     // Mapped value
+}; // static_entry
+
+
+// Sequence of the indices known at compile time
+template <size_t... _Indices>
+struct __index_sequence
+{ };
+
+template <class _First, class _Second>
+struct __concat_sequence;
+
+template <size_t... _First, size_t... _Second>
+struct __concat_sequence<__index_sequence<_First...>,
+    __index_sequence<_Second...>>
+{
+    using type = __index_sequence<_First..., (sizeof...(_First) + _Second)...>;
+};
+
+// Sequence "0, 1, ..., _Count - 1" built with the logarithmic depth
+template <size_t _Count>
+struct __make_index_sequence
+{
+    using type = typename __concat_sequence<
+        typename __make_index_sequence<_Count / 2>::type,
+        typename __make_index_sequence<_Count - _Count / 2>::type>::type;
+};
+
+template <>
+struct __make_index_sequence<0>
+{ using type = __index_sequence<>; };
+
+template <>
+struct __make_index_sequence<1>
+{ using type = __index_sequence<0>; };
+
+template <class _Generator, class _Sequence>
+struct __static_array_impl;
+
+template <class _Generator, size_t... _Indices>
+struct __static_array_impl<_Generator, __index_sequence<_Indices...>>
+{
+    using _value_t = typename _Generator::_value_t;
+
+    static constexpr _value_t values[sizeof...(_Indices) + 1] =
+        { _Generator::at(_Indices)..., _value_t() };
+};
+
+template <class _Generator, size_t... _Indices>
+constexpr typename __static_array_impl<_Generator,
+    __index_sequence<_Indices...>>::_value_t
+__static_array_impl<_Generator, __index_sequence<_Indices...>>::values[];
+
+// Array in the read-only data filled with "_Generator::at(i)" at compile
+// time. The count of elements is not evaluated until the array is used
+template <class _Generator>
+struct __static_array : __static_array_impl<_Generator,
+    typename __make_index_sequence<_Generator::COUNT>::type>
+{ };
+
+
+// Hashing and comparison of the keys of static maps at compile time
+template <class _Key, class = void>
+struct __static_key;
+
+// Null-terminated strings
+template <>
+struct __static_key<const char*>
+{
+    static constexpr size_t hash(const char* _key, size_t _seed)
+    { return __hash_impl::FNV::hash_cstring(_key, _seed); }
+
+    static constexpr bool equal(const char* _first, const char* _second)
+    {
+        return *_first == *_second &&
+            (*_first == '\0' || equal(_first + 1, _second + 1));
+    }
+};
+
+// Integral and enumeration types
+template <class _Key>
+struct __static_key<_Key, typename std::enable_if<
+    std::is_integral<_Key>::value || std::is_enum<_Key>::value>::type>
+{
+    static constexpr size_t hash(_Key _key, size_t _seed)
+    { return __hash_impl::FNV::hash_integer(_key, _seed); }
+
+    static constexpr bool equal(_Key _first, _Key _second)
+    { return _first == _second; }
+};
+
+
+// Two-level perfect hashing. The keys are distributed over "N" buckets by
+// the FNV hash with the initial seed, and the keys of a bucket with "n" keys
+// are placed into its own range of "n * n" slots by the FNV hash with the
+// seed found by the search, such that they do not collide. The expected
+// count of slots is less than "2 * N" and the expected count of seeds tried
+// for a bucket is less than 2.
+//
+// The layout is computed in stages, every stage is a static array read by
+// the next ones, so nothing is computed twice: the buckets of the entries,
+// the sizes of the buckets, the descriptors of the buckets with the seeds,
+// the slots of the entries and the entries of the slots. All the sums and
+// searches are done by the recursion halving the ranges to keep its depth
+// logarithmic
+template <class _Entries, _Entries& _Table>
+struct __static_layout
+{
+    using _entry_t = typename std::remove_cv<
+        typename std::remove_extent<_Entries>::type>::type;
+    using _key_t   = typename std::decay<decltype(_entry_t::_m_key)>::type;
+    using _traits_t = __static_key<_key_t>;
+
+    static constexpr size_t COUNT_ENTRIES = std::extent<_Entries>::value;
+    static constexpr size_t COUNT_BUCKETS =
+        COUNT_ENTRIES == 0 ? 1 : COUNT_ENTRIES;
+    static constexpr size_t MAX_SEED = 256;
+
+    struct _bucket_t
+    {
+        size_t _m_offset;
+        size_t _m_size;
+        size_t _m_seed;
+    };
+
+    struct entry_bucket_generator;
+    struct bucket_size_generator;
+    struct bucket_generator;
+    struct entry_slot_generator;
+    struct slot_generator;
+
+    using _entry_buckets_t = __static_array<entry_bucket_generator>;
+    using _bucket_sizes_t  = __static_array<bucket_size_generator>;
+    using _buckets_t       = __static_array<bucket_generator>;
+    using _entry_slots_t   = __static_array<entry_slot_generator>;
+    using _slots_t         = __static_array<slot_generator>;
+
+    // Returns the hash with the high bits mixed into the low ones. The low
+    // bits of FNV depend only on the low bits of the seed and of the bytes,
+    // so the reduction by a small modulus would not separate some keys
+    static constexpr size_t mix(size_t _hash)
+    {
+#if __SIZEOF_SIZE_T__ == 4
+        return _xor_shift((_xor_shift(_hash, 16) * 0x85ebca6bU), 13);
+#elif __SIZEOF_SIZE_T__ == 8
+        return _xor_shift((_xor_shift(_hash, 33) * 0xff51afd7ed558ccdULL), 33);
+#endif
+    }
+
+    static constexpr size_t _xor_shift(size_t _hash, unsigned _shift)
+    { return _hash ^ (_hash >> _shift); }
+
+    // Returns the seed of the hash with the number "seed"
+    static constexpr size_t hash_seed(size_t _seed)
+    { return __hash_impl::FNV::INITIAL_SEED + _seed; }
+
+    static constexpr size_t bucket_of_hash(size_t _hash)
+    { return mix(_hash) % COUNT_BUCKETS; }
+
+    static constexpr size_t bucket_of(const _key_t& _key)
+    {
+        return bucket_of_hash(
+            _traits_t::hash(_key, __hash_impl::FNV::INITIAL_SEED));
+    }
+
+    static constexpr size_t bucket(size_t _entry)
+    { return _entry_buckets_t::values[_entry]; }
+
+    // Returns the count of entries in [first, last) hashed into the bucket
+    static constexpr size_t
+    count_in_bucket(size_t _bucket_n, size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? 0 :
+            _last - _first == 1 ? (bucket(_first) == _bucket_n ? 1 : 0) :
+            count_in_bucket(_bucket_n, _first, (_first + _last) / 2) +
+            count_in_bucket(_bucket_n, (_first + _last) / 2, _last);
+    }
+
+    // Returns the sum of sizes of the buckets [first, last)
+    static constexpr size_t sum_sizes(size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? 0 :
+            _last - _first == 1 ? _bucket_sizes_t::values[_first] :
+            sum_sizes(_first, (_first + _last) / 2) +
+            sum_sizes((_first + _last) / 2, _last);
+    }
+
+    static constexpr size_t
+    slot_in_bucket(size_t _entry, size_t _size, size_t _seed)
+    { return mix(_traits_t::hash(_Table[_entry]._m_key, _seed)) % _size; }
+
+    // Returns true if the entry collides with any of [first, last)
+    static constexpr bool collides_with(size_t _entry, size_t _size,
+        size_t _seed, size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? false :
+            _last - _first == 1 ? bucket(_first) == bucket(_entry) &&
+                slot_in_bucket(_first, _size, _seed) ==
+                slot_in_bucket(_entry, _size, _seed) :
+            collides_with(_entry, _size, _seed, _first,
+                (_first + _last) / 2) ||
+            collides_with(_entry, _size, _seed, (_first + _last) / 2,
+                _last);
+    }
+
+    // Returns true if any two entries of the bucket collide with the seed
+    static constexpr bool has_collision(size_t _bucket_n, size_t _size,
+        size_t _seed, size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? false :
+            _last - _first == 1 ? bucket(_first) == _bucket_n &&
+                collides_with(_first, _size, _seed, _first + 1,
+                    COUNT_ENTRIES) :
+            has_collision(_bucket_n, _size, _seed, _first,
+                (_first + _last) / 2) ||
+            has_collision(_bucket_n, _size, _seed, (_first + _last) / 2,
+                _last);
+    }
+
+    // Returns the number of the first seed placing the bucket without
+    // collisions or MAX_SEED if there is no such seed
+    static constexpr size_t
+    find_seed(size_t _bucket_n, size_t _size, size_t _seed = 0)
+    {
+        return _size <= 1 ? 0 : _seed == MAX_SEED ? MAX_SEED :
+            !has_collision(_bucket_n, _size, hash_seed(_seed), 0,
+                COUNT_ENTRIES) ?
+                _seed : find_seed(_bucket_n, _size, _seed + 1);
+    }
+
+    // Returns true if the seeds are found for all the buckets [first, last)
+    static constexpr bool is_perfect(size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? true :
+            _last - _first == 1 ?
+                _buckets_t::values[_first]._m_seed != hash_seed(MAX_SEED) :
+            is_perfect(_first, (_first + _last) / 2) &&
+            is_perfect((_first + _last) / 2, _last);
+    }
+
+    // Returns the entry placed into the slot or COUNT_ENTRIES if it is free
+    static constexpr size_t
+    entry_in_slot(size_t _slot, size_t _first, size_t _last)
+    {
+        return _last - _first == 0 ? COUNT_ENTRIES :
+            _last - _first == 1 ?
+                (_entry_slots_t::values[_first] == _slot ? _first :
+                    COUNT_ENTRIES) :
+            _min(entry_in_slot(_slot, _first, (_first + _last) / 2),
+                entry_in_slot(_slot, (_first + _last) / 2, _last));
+    }
+
+    static constexpr size_t _min(size_t _first, size_t _second)
+    { return _first < _second ? _first : _second; }
+
+    struct entry_bucket_generator
+    {
+        using _value_t = size_t;
+
+        static constexpr size_t COUNT = COUNT_ENTRIES;
+
+        static constexpr size_t at(size_t _entry)
+        { return bucket_of(_Table[_entry]._m_key); }
+    };
+
+    struct bucket_size_generator
+    {
+        using _value_t = size_t;
+
+        static constexpr size_t COUNT = COUNT_BUCKETS;
+
+        static constexpr size_t at(size_t _bucket_n)
+        { return _square(count_in_bucket(_bucket_n, 0, COUNT_ENTRIES)); }
+
+        static constexpr size_t _square(size_t _count)
+        { return _count * _count; }
+    };
+
+    struct bucket_generator
+    {
+        using _value_t = _bucket_t;
+
+        static constexpr size_t COUNT = COUNT_BUCKETS;
+
+        static constexpr _bucket_t at(size_t _bucket_n)
+        {
+            return _bucket_t{ sum_sizes(0, _bucket_n),
+                _bucket_sizes_t::values[_bucket_n],
+                hash_seed(find_seed(_bucket_n,
+                    _bucket_sizes_t::values[_bucket_n])) };
+        }
+    };
+
+    struct entry_slot_generator
+    {
+        using _value_t = size_t;
+
+        static constexpr size_t COUNT = COUNT_ENTRIES;
+
+        static constexpr size_t at(size_t _entry)
+        {
+            return _buckets_t::values[bucket(_entry)]._m_offset +
+                slot_in_bucket(_entry,
+                    _buckets_t::values[bucket(_entry)]._m_size,
+                    _buckets_t::values[bucket(_entry)]._m_seed);
+        }
+    };
+
+    struct slot_generator
+    {
+        using _value_t = size_t;
+
+        static constexpr size_t COUNT = sum_sizes(0, COUNT_BUCKETS);
+
+        static constexpr size_t at(size_t _slot)
+        { return entry_in_slot(_slot, 0, COUNT_ENTRIES); }
+    };
+}; // __static_layout
+
+
+// Read-only hash map built at compile time from the literal list of entries
+// with the static storage duration. The layout is collision-free, so the
+// lookup reads one bucket descriptor, one slot and one entry, and compares
+// the key once. All the tables are constant expressions placed into the
+// read-only data, so there is no initialization at run time, and the
+// lookups are constant expressions too. The keys can be null-terminated
+// strings or of integral or enumeration types, they must be unique. The
+// time of compilation grows quadratically with the count of entries, so the
+// map is intended for the tables of up to a few hundreds of keys.
+//
+//   constexpr static_entry<const char*, int> COMMANDS[] =
+//       { { "get", 1 }, { "set", 2 }, { "del", 3 } };
+//   using commands_t = StaticHashMap<decltype(COMMANDS), COMMANDS>;
+//
+//   static_assert(commands_t::at("set") == 2, "");
+template <class _Entries, _Entries& _Table>
+class StaticHashMap
+{
+    using _layout_t = __static_layout<_Entries, _Table>;
+
+    static_assert(_layout_t::is_perfect(0, _layout_t::COUNT_BUCKETS),
+        "the keys of a static map must be unique");
+
+public:
+    using _entry_t  = typename _layout_t::_entry_t;
+    using _key_t    = typename _layout_t::_key_t;
+    using _mapped_t = typename std::decay<decltype(_entry_t::_m_value)>::type;
+
+    using iterator       = const _entry_t*;
+    using const_iterator = const _entry_t*;
+
+private:
+    using _traits_t = typename _layout_t::_traits_t;
+    using _buckets_t = typename _layout_t::_buckets_t;
+    using _slots_t   = typename _layout_t::_slots_t;
+
+    // The free slot and the lookup of the empty bucket
+    static constexpr size_t NPOS    = _layout_t::COUNT_ENTRIES;
+    static constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+
+public:
+    // Iterators
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns an iterator to the first entry in the order of the list
+    static constexpr const_iterator begin() noexcept
+    { return _Table; }
+
+    // Returns an iterator past the last entry
+    static constexpr const_iterator end() noexcept
+    { return _Table + _layout_t::COUNT_ENTRIES; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Capacity
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the count of entries
+    static constexpr size_t size() noexcept
+    { return _layout_t::COUNT_ENTRIES; }
+
+    // Checks that the map has no entries
+    static constexpr bool empty() noexcept
+    { return _layout_t::COUNT_ENTRIES == 0; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Lookup
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the pointer to the value of the key or nullptr
+    static constexpr const _mapped_t* find(const _key_t& _key) noexcept
+    {
+        return _index_of_slot(_key, _slot_of(
+            _buckets_t::values[_layout_t::bucket_of(_key)],
+            _traits_t::hash(_key,
+                _buckets_t::values[_layout_t::bucket_of(_key)]._m_seed)));
+    }
+
+    // Returns the pointer to the value of the string key or nullptr. The
+    // string is hashed at run time with the same FNV hash
+    template <class _K = _key_t, class = typename std::enable_if<
+        std::is_same<_K, const char*>::value>::type>
+    static const _mapped_t* find(const std::string& _key) noexcept
+    {
+        const auto& bucket = _buckets_t::values[_layout_t::bucket_of_hash(
+            __hash_impl::FNV::hash(_key.data(), _key.size()))];
+        const size_t slot = _slot_of(bucket,
+            __hash_impl::FNV::hash(_key.data(), _key.size(), bucket._m_seed));
+
+        if (slot == NO_SLOT || _slots_t::values[slot] == NPOS)
+            return nullptr;
+
+        const auto& entry = _Table[_slots_t::values[slot]];
+        return _key == entry._m_key ? &entry._m_value : nullptr;
+    }
+
+    // Returns the count of entries with the key, 0 or 1
+    static constexpr size_t count(const _key_t& _key) noexcept
+    { return find(_key) != nullptr ? 1 : 0; }
+
+    template <class _K = _key_t, class = typename std::enable_if<
+        std::is_same<_K, const char*>::value>::type>
+    static size_t count(const std::string& _key) noexcept
+    { return find(_key) != nullptr ? 1 : 0; }
+
+    // Returns the value of the key or throws std::out_of_range
+    static constexpr const _mapped_t& at(const _key_t& _key)
+    {
+        return find(_key) != nullptr ? *find(_key) :
+            throw std::out_of_range("there is no such key in the map");
+    }
+
+    template <class _K = _key_t, class = typename std::enable_if<
+        std::is_same<_K, const char*>::value>::type>
+    static const _mapped_t& at(const std::string& _key)
+    {
+        const _mapped_t* value = find(_key);
+        if (value == nullptr)
+            throw std::out_of_range("there is no such key in the map");
+
+        return *value;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+
+    // Layout
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Returns the count of buckets of the first level
+    static constexpr size_t buckets_count() noexcept
+    { return _layout_t::COUNT_BUCKETS; }
+
+    // Returns the count of slots of the second level
+    static constexpr size_t slots_count() noexcept
+    { return _layout_t::slot_generator::COUNT; }
+
+    // Returns the size of the tables of the layout in bytes, without the
+    // list of entries
+    static constexpr size_t memory_usage() noexcept
+    { return sizeof(_buckets_t::values) + sizeof(_slots_t::values); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+private:
+    // Returns the slot of the hash in the bucket or NO_SLOT if it is empty
+    static constexpr size_t
+    _slot_of(const typename _layout_t::_bucket_t& _bucket, size_t _hash)
+    {
+        return _bucket._m_size == 0 ? NO_SLOT :
+            _bucket._m_offset + _layout_t::mix(_hash) % _bucket._m_size;
+    }
+
+    // Returns the pointer to the value of the key placed into the slot or
+    // nullptr if the slot holds other key
+    static constexpr const _mapped_t*
+    _index_of_slot(const _key_t& _key, size_t _slot)
+    {
+        return _slot == NO_SLOT || _slots_t::values[_slot] == NPOS ? nullptr :
+            _traits_t::equal(_Table[_slots_t::values[_slot]]._m_key, _key) ?
+                &_Table[_slots_t::values[_slot]]._m_value : nullptr;
+    }
+}; // StaticHashMap
+
+
+#endif  // _STATICHASHMAP_
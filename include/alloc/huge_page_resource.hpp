@@ -0,0 +1,388 @@
+// huge_page_resource.hpp
+
+#ifndef _HUGE_PAGE_RESOURCE_
+#define _HUGE_PAGE_RESOURCE_
+
+
+#include <new>
+#include <map>
+#include <fstream>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include <alloc/memory_resource.hpp>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+
+// Memory resource which takes the memory directly from the operating system
+// and backs it with the huge pages, so the random access to the large bucket
+// arrays and node pools causes fewer TLB misses. The memory can also be
+// placed on the specified NUMA nodes.
+//
+// The large blocks are mapped separately, the small blocks are carved out of
+// shared regions of the huge page size, which are unmapped when all their
+// blocks are released. If the huge pages or the NUMA policy are unavailable,
+// the resource silently falls back to the ordinary pages and the default
+// placement. The bucket array can take the memory from this resource
+// directly, the nodes - through unsynchronized_pool_resource using this
+// resource as upstream. This resource is not thread-safe
+class huge_page_resource: public memory_resource
+{
+public:
+    // Kind of the pages backing the memory
+    enum class page_mode
+    {
+        NORMAL,         // Ordinary pages
+        TRANSPARENT,    // Transparent huge pages requested by madvise()
+        EXPLICIT        // Reserved huge pages mapped with MAP_HUGETLB,
+                        // transparent huge pages if there are no reserved
+    };
+
+    // Placement of the memory on the NUMA nodes
+    enum class numa_mode
+    {
+        DEFAULT,        // Placement by the policy of the thread
+        INTERLEAVE,     // Pages are interleaved over all online nodes
+        PREFERRED,      // Pages are placed on the specified node if possible
+        BIND            // Pages are placed only on the specified node
+    };
+
+    // Statistics of the mapped memory
+    struct stats_t
+    {
+        size_t explicit_bytes;      // Bytes backed by reserved huge pages
+        size_t transparent_bytes;   // Bytes advised as transparent huge pages
+        size_t normal_bytes;        // Bytes backed by ordinary pages
+        size_t numa_failures;       // Count of failed NUMA policy requests
+    };
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+
+private:
+    // Blocks larger than this size are mapped separately
+    static constexpr size_t MAX_SHARED_BLOCK = HUGE_PAGE_SIZE / 4;
+
+    // Mapped memory region
+    struct _region_t
+    {
+        size_t _m_size;         // Size of the region
+        size_t _m_count_used;   // Count of blocks in use
+        page_mode _m_mode;      // Kind of the pages backing the region
+    };
+
+    page_mode _m_page_mode;                 // Requested kind of the pages
+    numa_mode _m_numa_mode;                 // Requested placement
+    int _m_numa_node;                       // Node for the placement
+    std::map<uintptr_t, _region_t> _m_regions; // Regions by their address
+    uintptr_t _m_shared;                    // Current shared region
+    size_t _m_shared_offset;                // Free offset in shared region
+    stats_t _m_stats;                       // Statistics
+
+    // Returns the mask of the online NUMA nodes
+    static unsigned long _online_nodes()
+    {
+        std::ifstream file("/sys/devices/system/node/online");
+        std::string list;
+        unsigned long mask = 0;
+
+        if (!(file >> list))
+            return 1;
+
+        // The list has the format like "0-3,5"
+        size_t pos = 0;
+        while (pos < list.size())
+        {
+            size_t end = list.find(',', pos);
+            std::string range = list.substr(pos, end - pos);
+            size_t dash = range.find('-');
+
+            unsigned long first = std::stoul(range.substr(0, dash));
+            unsigned long last = dash == std::string::npos ?
+                first : std::stoul(range.substr(dash + 1));
+
+            for (unsigned long node = first;
+                node <= last && node < sizeof(mask) * 8; node++)
+                mask |= 1UL << node;
+
+            pos = end == std::string::npos ? list.size() : end + 1;
+        }
+
+        return mask != 0 ? mask : 1;
+    }
+
+    // Applies the NUMA policy to the mapped memory
+    void _apply_numa(void* _ptr, size_t _size)
+    {
+        if (_m_numa_mode == numa_mode::DEFAULT)
+            return;
+
+#if defined(__linux__) && defined(SYS_mbind)
+        // Values of the memory policies from <linux/mempolicy.h>
+        constexpr int MPOL_PREFERRED_MODE = 1;
+        constexpr int MPOL_BIND_MODE = 2;
+        constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+        unsigned long mask = 0;
+        int mode = 0;
+
+        // The node out of the mask can not be requested
+        if (_m_numa_mode != numa_mode::INTERLEAVE && (_m_numa_node < 0 ||
+            size_t(_m_numa_node) >= sizeof(mask) * 8))
+        {
+            _m_stats.numa_failures++;
+            return;
+        }
+
+        switch (_m_numa_mode)
+        {
+        case numa_mode::INTERLEAVE:
+            mask = _online_nodes();
+            mode = MPOL_INTERLEAVE_MODE;
+            break;
+        case numa_mode::PREFERRED:
+            mask = 1UL << _m_numa_node;
+            mode = MPOL_PREFERRED_MODE;
+            break;
+        default:
+            mask = 1UL << _m_numa_node;
+            mode = MPOL_BIND_MODE;
+            break;
+        }
+
+        if (syscall(SYS_mbind, _ptr, _size, mode, &mask,
+            sizeof(mask) * 8 + 1, 0) != 0)
+            _m_stats.numa_failures++;
+#else
+        (void)_ptr;
+        (void)_size;
+        _m_stats.numa_failures++;
+#endif
+    }
+
+    // Maps the memory region of the specified size, which is the multiple
+    // of the huge page size, and returns the kind of its pages
+    void* _map(size_t _size, page_mode& _mode)
+    {
+#if defined(__unix__)
+        void* ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+        if (_m_page_mode == page_mode::EXPLICIT)
+        {
+            ptr = mmap(nullptr, _size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            _mode = page_mode::EXPLICIT;
+        }
+#endif
+
+        if (ptr == MAP_FAILED)
+        {
+            // The region is mapped with a reserve and trimmed, so it is
+            // aligned to the huge page size as transparent huge pages require
+            size_t size = _size + HUGE_PAGE_SIZE;
+            char* raw = static_cast<char*>(mmap(nullptr, size,
+                PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+            if (raw == MAP_FAILED)
+                throw std::bad_alloc();
+
+            uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+            uintptr_t aligned = (addr + HUGE_PAGE_SIZE - 1) &
+                ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+            size_t head = aligned - addr;
+
+            if (head > 0)
+                munmap(raw, head);
+            if (HUGE_PAGE_SIZE - head > 0)
+                munmap(raw + head + _size, HUGE_PAGE_SIZE - head);
+
+            ptr = reinterpret_cast<void*>(aligned);
+            _mode = page_mode::NORMAL;
+
+#if defined(MADV_HUGEPAGE)
+            if
+            (
+                _m_page_mode != page_mode::NORMAL &&
+                madvise(ptr, _size, MADV_HUGEPAGE) == 0
+            )
+                _mode = page_mode::TRANSPARENT;
+#endif
+        }
+
+        _apply_numa(ptr, _size);
+
+        switch (_mode)
+        {
+        case page_mode::EXPLICIT:
+            _m_stats.explicit_bytes += _size;
+            break;
+        case page_mode::TRANSPARENT:
+            _m_stats.transparent_bytes += _size;
+            break;
+        default:
+            _m_stats.normal_bytes += _size;
+            break;
+        }
+
+        return ptr;
+#else
+        _mode = page_mode::NORMAL;
+        _m_stats.normal_bytes += _size;
+
+        return new_delete_resource()->allocate(_size, MAX_ALIGN);
+#endif
+    }
+
+    // Unmaps the memory region
+    void _unmap(uintptr_t _addr, const _region_t& _region)
+    {
+        switch (_region._m_mode)
+        {
+        case page_mode::EXPLICIT:
+            _m_stats.explicit_bytes -= _region._m_size;
+            break;
+        case page_mode::TRANSPARENT:
+            _m_stats.transparent_bytes -= _region._m_size;
+            break;
+        default:
+            _m_stats.normal_bytes -= _region._m_size;
+            break;
+        }
+
+#if defined(__unix__)
+        munmap(reinterpret_cast<void*>(_addr), _region._m_size);
+#else
+        new_delete_resource()->deallocate(reinterpret_cast<void*>(_addr),
+            _region._m_size, MAX_ALIGN);
+#endif
+    }
+
+    // Maps the new region and registers it
+    uintptr_t _new_region(size_t _size)
+    {
+        _region_t region{_size, 0, page_mode::NORMAL};
+        uintptr_t addr
+            = reinterpret_cast<uintptr_t>(_map(_size, region._m_mode));
+
+        _m_regions.emplace(addr, region);
+
+        return addr;
+    }
+
+protected:
+    void* do_allocate(size_t _bytes, size_t _alignment) override
+    {
+        // Large blocks are mapped separately
+        if (_bytes + _alignment > MAX_SHARED_BLOCK)
+        {
+            size_t size = (_bytes + HUGE_PAGE_SIZE - 1) &
+                ~(HUGE_PAGE_SIZE - 1);
+            uintptr_t addr = _new_region(size);
+            _m_regions[addr]._m_count_used = 1;
+
+            return reinterpret_cast<void*>(addr);
+        }
+
+        size_t offset = (_m_shared_offset + _alignment - 1) &
+            ~(_alignment - 1);
+
+        if (_m_shared == 0 || offset + _bytes > HUGE_PAGE_SIZE)
+        {
+            // The previous shared region is unmapped if it is not in use
+            auto iter = _m_regions.find(_m_shared);
+            if (iter != _m_regions.end() && iter->second._m_count_used == 0)
+            {
+                _unmap(iter->first, iter->second);
+                _m_regions.erase(iter);
+            }
+
+            _m_shared = _new_region(HUGE_PAGE_SIZE);
+            offset = 0;
+        }
+
+        _m_regions[_m_shared]._m_count_used++;
+        _m_shared_offset = offset + _bytes;
+
+        return reinterpret_cast<void*>(_m_shared + offset);
+    }
+
+    void do_deallocate(void* _ptr, size_t, size_t) override
+    {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(_ptr);
+        auto iter = --_m_regions.upper_bound(addr);
+
+        if (--iter->second._m_count_used > 0)
+            return;
+
+        // The empty shared region in use is reused from the beginning
+        if (iter->first == _m_shared)
+            _m_shared_offset = 0;
+        else
+        {
+            _unmap(iter->first, iter->second);
+            _m_regions.erase(iter);
+        }
+    }
+
+public:
+    // Constructor with the kind of pages and the NUMA placement parameters
+    explicit huge_page_resource
+    (
+        page_mode _page_mode = page_mode::TRANSPARENT,
+        numa_mode _numa_mode = numa_mode::DEFAULT,
+        int _numa_node = 0
+    ):
+        _m_page_mode{_page_mode},
+        _m_numa_mode{_numa_mode},
+        _m_numa_node{_numa_node},
+        _m_regions{},
+        _m_shared{0},
+        _m_shared_offset{0},
+        _m_stats{0, 0, 0, 0}
+    {}
+
+    huge_page_resource(const huge_page_resource&) = delete;
+    huge_page_resource& operator=(const huge_page_resource&) = delete;
+
+    // Destructor
+    ~huge_page_resource() { release(); }
+
+    // Unmaps all regions, including the regions with the blocks in use
+    void release()
+    {
+        for (auto& region : _m_regions)
+            _unmap(region.first, region.second);
+
+        _m_regions.clear();
+        _m_shared = 0;
+        _m_shared_offset = 0;
+    }
+
+    // Returns the statistics of the mapped memory
+    stats_t stats() const noexcept { return _m_stats; }
+
+    // Returns the NUMA node of the CPU running the calling thread, which
+    // can be used for the placement of the shard owned by this thread
+    static int current_numa_node() noexcept
+    {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+            return static_cast<int>(node);
+#endif
+        return 0;
+    }
+};
+
+
+#endif  // _HUGE_PAGE_RESOURCE_
@@ -0,0 +1,574 @@
+// memory_resource.hpp
+
+#ifndef _MEMORY_RESOURCE_
+#define _MEMORY_RESOURCE_
+
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+
+// Interface of the memory resource. It is a source of the raw memory for
+// the polymorphic allocator, so containers with the same type can take their
+// memory from different resources
+class memory_resource
+{
+protected:
+    static constexpr size_t MAX_ALIGN = alignof(std::max_align_t);
+
+    // Allocates a block of the specified size and alignment
+    virtual void* do_allocate(size_t _bytes, size_t _alignment) = 0;
+    // Releases a block allocated by this resource
+    virtual void do_deallocate(void* _ptr, size_t _bytes, size_t _alignment)
+        = 0;
+    // Checks that the memory allocated by this resource can be released by
+    // other resource and vice versa
+    virtual bool do_is_equal(const memory_resource& _other) const noexcept
+    { return this == &_other; }
+
+public:
+    // Destructor
+    virtual ~memory_resource() {}
+
+    // Allocates a block of the specified size and alignment
+    void* allocate(size_t _bytes, size_t _alignment = MAX_ALIGN)
+    { return do_allocate(_bytes, _alignment); }
+
+    // Releases a block allocated by this resource
+    void deallocate(void* _ptr, size_t _bytes, size_t _alignment = MAX_ALIGN)
+    { do_deallocate(_ptr, _bytes, _alignment); }
+
+    // Checks that the memory allocated by this resource can be released by
+    // other resource and vice versa
+    bool is_equal(const memory_resource& _other) const noexcept
+    { return do_is_equal(_other); }
+
+    // Returns the cached unused memory to its source. Resources that do not
+    // cache memory do nothing
+    virtual void trim() {}
+};
+
+inline bool operator==(const memory_resource& _a, const memory_resource& _b)
+    noexcept
+{ return &_a == &_b || _a.is_equal(_b); }
+
+inline bool operator!=(const memory_resource& _a, const memory_resource& _b)
+    noexcept
+{ return !(_a == _b); }
+
+
+// Memory resource using the global operators new and delete
+class new_delete_resource_t: public memory_resource
+{
+protected:
+    void* do_allocate(size_t _bytes, size_t _alignment) override
+    {
+        if (_alignment <= MAX_ALIGN)
+            return ::operator new(_bytes);
+
+        // For the extended alignment the block is allocated with a reserve
+        // and the original pointer is stored right before the aligned one
+        void* raw = ::operator new(_bytes + _alignment + sizeof(void*));
+        uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+        addr = (addr + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+
+        reinterpret_cast<void**>(addr)[-1] = raw;
+
+        return reinterpret_cast<void*>(addr);
+    }
+
+    void do_deallocate(void* _ptr, size_t _bytes, size_t _alignment) override
+    {
+        if (_alignment <= MAX_ALIGN)
+            ::operator delete(_ptr);
+        else
+            ::operator delete(static_cast<void**>(_ptr)[-1]);
+    }
+};
+
+// Returns the memory resource using the global operators new and delete
+inline memory_resource* new_delete_resource() noexcept
+{
+    static new_delete_resource_t resource;
+    return &resource;
+}
+
+// Returns the pointer to the default memory resource variable
+inline memory_resource*& __default_resource() noexcept
+{
+    static memory_resource* resource = new_delete_resource();
+    return resource;
+}
+
+// Returns the default memory resource
+inline memory_resource* get_default_resource() noexcept
+{ return __default_resource(); }
+
+// Sets the default memory resource and returns the previous one
+inline memory_resource* set_default_resource(memory_resource* _res) noexcept
+{
+    memory_resource* old = __default_resource();
+    __default_resource() = _res != nullptr ? _res : new_delete_resource();
+
+    return old;
+}
+
+
+// Memory resource which releases the allocated memory only when it is
+// destroyed or when release() is called. The allocation is a pointer bump
+// in the current block, the deallocation does nothing. The first block may
+// be the buffer specified by user (for example, array on the stack), the
+// next blocks are taken from the upstream resource with geometric growth
+class monotonic_buffer_resource: public memory_resource
+{
+private:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1024;
+
+    // Header of the block taken from the upstream resource
+    struct _block_t
+    {
+        _block_t* _m_next;  // Previous allocated block
+        size_t _m_size;     // Size of the block including header
+    };
+
+    memory_resource* _m_upstream;   // Source of the blocks
+    void* _m_initial_buffer;        // Buffer specified by user
+    size_t _m_initial_size;         // Size of buffer specified by user
+    char* _m_current;               // Free memory in the current block
+    size_t _m_space;                // Size of free memory in current block
+    size_t _m_next_size;            // Size of the next block
+    _block_t* _m_blocks;            // List of the blocks from upstream
+
+    // Takes a new block from the upstream resource which can accomodate
+    // the specified number of bytes
+    void _new_block(size_t _bytes, size_t _alignment)
+    {
+        size_t size = _m_next_size;
+        size_t need = sizeof(_block_t) + _bytes + _alignment;
+
+        while (size < need)
+            size *= 2;
+
+        _block_t* block = static_cast<_block_t*>(
+            _m_upstream->allocate(size, MAX_ALIGN));
+
+        block->_m_next = _m_blocks;
+        block->_m_size = size;
+        _m_blocks = block;
+
+        _m_current = reinterpret_cast<char*>(block + 1);
+        _m_space = size - sizeof(_block_t);
+        _m_next_size = size * 2;
+    }
+
+protected:
+    void* do_allocate(size_t _bytes, size_t _alignment) override
+    {
+        void* ptr = _m_current;
+
+        if (std::align(_alignment, _bytes, ptr, _m_space) == nullptr)
+        {
+            _new_block(_bytes, _alignment);
+
+            ptr = _m_current;
+            std::align(_alignment, _bytes, ptr, _m_space);
+        }
+
+        _m_current = static_cast<char*>(ptr) + _bytes;
+        _m_space -= _bytes;
+
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+public:
+    // Constructor with the upstream resource parameter
+    explicit monotonic_buffer_resource
+    (
+        memory_resource* _upstream = get_default_resource()
+    ):
+        monotonic_buffer_resource(nullptr, 0, _upstream)
+    {}
+
+    // Constructor with the size of the first block
+    explicit monotonic_buffer_resource
+    (
+        size_t _initial_size,
+        memory_resource* _upstream = get_default_resource()
+    ):
+        monotonic_buffer_resource(nullptr, 0, _upstream)
+    {
+        if (_initial_size > 0)
+            _m_next_size = _initial_size;
+    }
+
+    // Constructor with the buffer specified by user
+    monotonic_buffer_resource
+    (
+        void* _buffer, size_t _size,
+        memory_resource* _upstream = get_default_resource()
+    ):
+        _m_upstream{_upstream},
+        _m_initial_buffer{_buffer},
+        _m_initial_size{_size},
+        _m_current{static_cast<char*>(_buffer)},
+        _m_space{_size},
+        _m_next_size
+        {
+            _size > DEFAULT_BLOCK_SIZE ? _size * 2 : DEFAULT_BLOCK_SIZE
+        },
+        _m_blocks{nullptr}
+    {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&)
+        = delete;
+
+    // Destructor
+    ~monotonic_buffer_resource() { release(); }
+
+    // Releases all blocks taken from the upstream resource and makes the
+    // buffer specified by user available again
+    void release()
+    {
+        while (_m_blocks != nullptr)
+        {
+            _block_t* next = _m_blocks->_m_next;
+            _m_upstream->deallocate(_m_blocks, _m_blocks->_m_size, MAX_ALIGN);
+            _m_blocks = next;
+        }
+
+        _m_current = static_cast<char*>(_m_initial_buffer);
+        _m_space = _m_initial_size;
+    }
+
+    // Returns the upstream resource
+    memory_resource* upstream_resource() const noexcept
+    { return _m_upstream; }
+};
+
+
+// Memory resource which keeps the released blocks in the pools of fixed
+// size blocks and reuses them for the next allocations. Each pool takes
+// memory from the upstream resource in chunks of many blocks. Blocks
+// larger than the largest pool are taken from the upstream directly.
+// This resource is not thread-safe
+class unsynchronized_pool_resource: public memory_resource
+{
+private:
+    static constexpr size_t MIN_BLOCK_SIZE = sizeof(void*);
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+    static constexpr size_t COUNT_POOLS = 10;   // From 8 to 4096 bytes
+    static constexpr size_t MIN_CHUNK_BLOCKS = 16;
+    static constexpr size_t MAX_CHUNK_SIZE = 1 << 20;
+
+    // Free block of the pool
+    struct _free_block_t
+    {
+        _free_block_t* _m_next;
+    };
+
+    // Header of the chunk placed at its end
+    struct _chunk_t
+    {
+        _chunk_t* _m_next;      // Next chunk of the pool
+        char* _m_begin;         // Beginning of the chunk memory
+        size_t _m_size;         // Size of the chunk memory with header
+        size_t _m_count_blocks; // Count of blocks in the chunk
+        size_t _m_count_free;   // Count of free blocks, used by trim()
+    };
+
+    // Pool of the blocks of the same size
+    struct _pool_t
+    {
+        _free_block_t* _m_free;     // List of free blocks
+        _chunk_t* _m_chunks;        // List of chunks
+        size_t _m_next_blocks;      // Count of blocks in the next chunk
+    };
+
+    memory_resource* _m_upstream;       // Source of the chunks
+    _pool_t _m_pools[COUNT_POOLS];      // Pools from the smallest blocks
+
+    // Returns the index of the pool for the specified block
+    static size_t _pool_index(size_t _bytes, size_t _alignment) noexcept
+    {
+        size_t size = _bytes > _alignment ? _bytes : _alignment;
+        size_t index = 0;
+
+        for (size_t block = MIN_BLOCK_SIZE; block < size; block <<= 1)
+            index++;
+
+        return index;
+    }
+
+    // Returns the block size of pool with the specified index
+    static size_t _block_size(size_t _index) noexcept
+    { return MIN_BLOCK_SIZE << _index; }
+
+    // Takes a new chunk for the specified pool from the upstream resource
+    void _new_chunk(size_t _index)
+    {
+        _pool_t& pool = _m_pools[_index];
+        size_t block_size = _block_size(_index);
+        size_t count = pool._m_next_blocks;
+        size_t size = count * block_size + sizeof(_chunk_t);
+
+        char* memory = static_cast<char*>(
+            _m_upstream->allocate(size, MAX_ALIGN));
+
+        _chunk_t* chunk = reinterpret_cast<_chunk_t*>(
+            memory + count * block_size);
+        chunk->_m_next = pool._m_chunks;
+        chunk->_m_begin = memory;
+        chunk->_m_size = size;
+        chunk->_m_count_blocks = count;
+        pool._m_chunks = chunk;
+
+        for (size_t i = count; i > 0; i--)
+        {
+            _free_block_t* block = reinterpret_cast<_free_block_t*>(
+                memory + (i - 1) * block_size);
+            block->_m_next = pool._m_free;
+            pool._m_free = block;
+        }
+
+        if (2 * count * block_size <= MAX_CHUNK_SIZE)
+            pool._m_next_blocks = 2 * count;
+    }
+
+protected:
+    void* do_allocate(size_t _bytes, size_t _alignment) override
+    {
+        if (_bytes > MAX_BLOCK_SIZE || _alignment > MAX_ALIGN)
+            return _m_upstream->allocate(_bytes, _alignment);
+
+        size_t index = _pool_index(_bytes, _alignment);
+        _pool_t& pool = _m_pools[index];
+
+        if (pool._m_free == nullptr)
+            _new_chunk(index);
+
+        _free_block_t* block = pool._m_free;
+        pool._m_free = block->_m_next;
+
+        return block;
+    }
+
+    void do_deallocate(void* _ptr, size_t _bytes, size_t _alignment) override
+    {
+        if (_bytes > MAX_BLOCK_SIZE || _alignment > MAX_ALIGN)
+        {
+            _m_upstream->deallocate(_ptr, _bytes, _alignment);
+            return;
+        }
+
+        _pool_t& pool = _m_pools[_pool_index(_bytes, _alignment)];
+        _free_block_t* block = static_cast<_free_block_t*>(_ptr);
+
+        block->_m_next = pool._m_free;
+        pool._m_free = block;
+    }
+
+public:
+    // Constructor with the upstream resource parameter
+    explicit unsynchronized_pool_resource
+    (
+        memory_resource* _upstream = get_default_resource()
+    ):
+        _m_upstream{_upstream}
+    {
+        for (size_t i = 0; i < COUNT_POOLS; i++)
+        {
+            _m_pools[i]._m_free = nullptr;
+            _m_pools[i]._m_chunks = nullptr;
+            _m_pools[i]._m_next_blocks = MIN_CHUNK_BLOCKS;
+        }
+    }
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&)
+        = delete;
+    unsynchronized_pool_resource&
+    operator=(const unsynchronized_pool_resource&) = delete;
+
+    // Destructor
+    ~unsynchronized_pool_resource() { release(); }
+
+    // Returns all chunks to the upstream resource, including the chunks
+    // with the blocks in use
+    void release()
+    {
+        for (size_t i = 0; i < COUNT_POOLS; i++)
+        {
+            _pool_t& pool = _m_pools[i];
+
+            while (pool._m_chunks != nullptr)
+            {
+                _chunk_t* next = pool._m_chunks->_m_next;
+                _m_upstream->deallocate(pool._m_chunks->_m_begin,
+                    pool._m_chunks->_m_size, MAX_ALIGN);
+                pool._m_chunks = next;
+            }
+
+            pool._m_free = nullptr;
+            pool._m_next_blocks = MIN_CHUNK_BLOCKS;
+        }
+    }
+
+    // Returns the chunks, all blocks of which are free, to the upstream
+    // resource
+    void trim() override
+    {
+        for (size_t i = 0; i < COUNT_POOLS; i++)
+            _trim_pool(_m_pools[i]);
+    }
+
+    // Returns the upstream resource
+    memory_resource* upstream_resource() const noexcept
+    { return _m_upstream; }
+
+private:
+    // Returns the chunks of the pool, all blocks of which are free, to the
+    // upstream resource
+    void _trim_pool(_pool_t& _pool)
+    {
+        if (_pool._m_free == nullptr)
+            return;
+
+        // Chunks are sorted by address to find the chunk of a free block
+        std::vector<_chunk_t*> chunks;
+
+        for (_chunk_t* chunk = _pool._m_chunks; chunk != nullptr;
+            chunk = chunk->_m_next)
+        {
+            chunk->_m_count_free = 0;
+            chunks.push_back(chunk);
+        }
+
+        auto less_begin = [](const _chunk_t* _chunk, const char* _ptr)
+        { return _chunk->_m_begin + _chunk->_m_size <= _ptr; };
+
+        std::sort
+        (
+            chunks.begin(), chunks.end(),
+            [](const _chunk_t* _a, const _chunk_t* _b)
+            { return _a->_m_begin < _b->_m_begin; }
+        );
+
+        auto chunk_of = [&](const _free_block_t* _block) -> _chunk_t*
+        {
+            return *std::lower_bound(chunks.begin(), chunks.end(),
+                reinterpret_cast<const char*>(_block), less_begin);
+        };
+
+        for (_free_block_t* block = _pool._m_free; block != nullptr;
+            block = block->_m_next)
+            chunk_of(block)->_m_count_free++;
+
+        // Free blocks of the released chunks are removed from the free list
+        _free_block_t** link = &_pool._m_free;
+
+        while (*link != nullptr)
+        {
+            _chunk_t* chunk = chunk_of(*link);
+
+            if (chunk->_m_count_free == chunk->_m_count_blocks)
+                *link = (*link)->_m_next;
+            else
+                link = &(*link)->_m_next;
+        }
+
+        _chunk_t** chunk_link = &_pool._m_chunks;
+
+        while (*chunk_link != nullptr)
+        {
+            _chunk_t* chunk = *chunk_link;
+
+            if (chunk->_m_count_free == chunk->_m_count_blocks)
+            {
+                *chunk_link = chunk->_m_next;
+                _m_upstream->deallocate(chunk->_m_begin, chunk->_m_size,
+                    MAX_ALIGN);
+            }
+            else
+                chunk_link = &chunk->_m_next;
+        }
+
+        if (_pool._m_chunks == nullptr)
+            _pool._m_next_blocks = MIN_CHUNK_BLOCKS;
+    }
+};
+
+
+// Allocator which takes the memory from the memory resource
+template <class _Type>
+class polymorphic_allocator
+{
+private:
+    template <class> friend class polymorphic_allocator;
+
+    memory_resource* _m_resource;   // Source of the memory
+
+public:
+    using value_type = _Type;
+
+    // Default constructor using the default memory resource
+    polymorphic_allocator() noexcept:
+        _m_resource{get_default_resource()}
+    {}
+
+    // Constructor with the memory resource parameter
+    polymorphic_allocator(memory_resource* _resource) noexcept:
+        _m_resource{_resource}
+    {}
+
+    // Copy constructor
+    polymorphic_allocator(const polymorphic_allocator& _other) = default;
+
+    // Converting constructor from allocator for other type
+    template <class _Other>
+    polymorphic_allocator(const polymorphic_allocator<_Other>& _other)
+        noexcept:
+        _m_resource{_other._m_resource}
+    {}
+
+    polymorphic_allocator& operator=(const polymorphic_allocator&) = default;
+
+    // Allocates memory for the specified count of objects
+    _Type* allocate(size_t _count)
+    {
+        return static_cast<_Type*>(
+            _m_resource->allocate(_count * sizeof(_Type), alignof(_Type)));
+    }
+
+    // Releases memory for the specified count of objects
+    void deallocate(_Type* _ptr, size_t _count)
+    { _m_resource->deallocate(_ptr, _count * sizeof(_Type), alignof(_Type)); }
+
+    // Returns the memory resource
+    memory_resource* resource() const noexcept { return _m_resource; }
+};
+
+template <class _Type1, class _Type2>
+bool operator==
+(
+    const polymorphic_allocator<_Type1>& _a,
+    const polymorphic_allocator<_Type2>& _b
+) noexcept
+{ return *_a.resource() == *_b.resource(); }
+
+template <class _Type1, class _Type2>
+bool operator!=
+(
+    const polymorphic_allocator<_Type1>& _a,
+    const polymorphic_allocator<_Type2>& _b
+) noexcept
+{ return !(_a == _b); }
+
+
+#endif  // _MEMORY_RESOURCE_
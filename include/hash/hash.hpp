@@ -8,6 +8,7 @@
 #include <cstring>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include <hash/hash_impl.hpp>
 
@@ -43,12 +44,20 @@ template <class _Type, __hashable_types = static_cast<__hashable_types>(
 struct hash;
 
 
+// The functors have the second call operator with the seed, which the
+// containers use to make the hash values of the keys different in every
+// container. The integral, enumeration and pointer values are mixed with
+// the seed, other values are hashed with the seed
+
 // Hash functor for generic type
 template <class _Type>
 struct hash<_Type, __hashable_types::OTHER>
 {
 	size_t operator()(const _Type& value) const noexcept
 	{ return __hash_method::hash(value); }
+
+	size_t operator()(const _Type& value, size_t seed) const noexcept
+	{ return __hash_method::hash_seeded(value, seed); }
 };
 
 // Explicit specialization of hash functor for std::string type
@@ -60,6 +69,12 @@ struct hash<std::string, __hashable_types::OTHER>
 		return __hash_method::hash(value.c_str(),
 			sizeof(char) * value.size()); 
 	}
+
+	size_t operator()(const std::string& value, size_t seed) const noexcept
+	{
+		return __hash_method::hash(value.c_str(),
+			sizeof(char) * value.size(), seed);
+	}
 };
 
 // Explicit specialization of hash functor for pointer types
@@ -68,6 +83,9 @@ struct hash<_Type, __hashable_types::POINTERS>
 {
 	size_t operator()(const _Type value) const noexcept
 	{ return reinterpret_cast<size_t>(value); }
+
+	size_t operator()(const _Type value, size_t seed) const noexcept
+	{ return __hash_impl::mix_seed(reinterpret_cast<size_t>(value), seed); }
 };
 
 // Explicit specialization of hash functor for lvalue references types
@@ -76,6 +94,9 @@ struct hash<_Type, __hashable_types::LV_REFERENCES>
 {
 	size_t operator()(const _Type value) const noexcept
 	{ return reinterpret_cast<size_t>(&value); }
+
+	size_t operator()(const _Type value, size_t seed) const noexcept
+	{ return __hash_impl::mix_seed(reinterpret_cast<size_t>(&value), seed); }
 };
 
 // Explicit specialization of hash functor for enum types
@@ -84,6 +105,9 @@ struct hash<_Type, __hashable_types::ENUM>
 {
 	size_t operator()(const _Type value) const noexcept
 	{ return static_cast<size_t>(value); }
+
+	size_t operator()(const _Type value, size_t seed) const noexcept
+	{ return __hash_impl::mix_seed(static_cast<size_t>(value), seed); }
 };
 
 // Explicit specialization of hash functor for integral types
@@ -92,6 +116,9 @@ struct hash<_Type, __hashable_types::INTEGRAL>
 {
 	size_t operator()(const _Type value) const noexcept
 	{ return static_cast<size_t>(value); }
+
+	size_t operator()(const _Type value, size_t seed) const noexcept
+	{ return __hash_impl::mix_seed(static_cast<size_t>(value), seed); }
 };
 
 // Explicit specialization of hash functor for floating point types
@@ -100,6 +127,10 @@ struct hash<_Type, __hashable_types::FLOATING_POINT>
 {
 	size_t operator()(const _Type value) const noexcept
 	{ return value == 0 ? 0 : __hash_method::hash(value); }
+
+	// Both zeros are hashed as the positive one
+	size_t operator()(const _Type value, size_t seed) const noexcept
+	{ return __hash_method::hash_seeded(value == 0 ? _Type() : value, seed); }
 };
 
 // Explicit specialization for nullptr type
@@ -107,6 +138,9 @@ template<>
 struct hash<nullptr_t, __hashable_types::NULLPTR>
 {
 	size_t operator()(const nullptr_t value) const noexcept { return 0; }
+
+	size_t operator()(const nullptr_t, size_t seed) const noexcept
+	{ return __hash_impl::mix_seed(0, seed); }
 };
 
 // Explicit specialization for void type
@@ -117,4 +151,103 @@ struct hash<_Type, __hashable_types::VOID>
 };
 
 
+// Keyed hash functor using SipHash-1-3 over the bytes of the value. It is
+// slower than the default functors, but the keys colliding for the secret
+// seed of the container cannot be chosen, so it is intended for the keys
+// coming from untrusted sources
+template <class _Type>
+struct sip_hash
+{
+	size_t operator()(const _Type& value) const noexcept
+	{ return __hash_impl::SipHash::hash(value); }
+
+	size_t operator()(const _Type& value, size_t seed) const noexcept
+	{ return __hash_impl::SipHash::hash_seeded(value, seed); }
+};
+
+// Explicit specialization of keyed hash functor for std::string type
+template <>
+struct sip_hash<std::string>
+{
+	size_t operator()(const std::string& value) const noexcept
+	{ return __hash_impl::SipHash::hash(value.data(), value.size()); }
+
+	size_t operator()(const std::string& value, size_t seed) const noexcept
+	{ return __hash_impl::SipHash::hash(value.data(), value.size(), seed); }
+};
+
+
+// Checks that the hasher has the call operator with the seed
+template <class _Hasher, class _Key, class = void>
+struct __is_seeded_hasher: std::false_type
+{};
+
+template <class _Hasher, class _Key>
+struct __is_seeded_hasher<_Hasher, _Key, decltype(void(
+	std::declval<const _Hasher&>()(std::declval<const _Key&>(), size_t())))>:
+	std::true_type
+{};
+
+template <class _Hasher, class _Key>
+size_t __hash_with_seed(const _Hasher& hasher, const _Key& key, size_t seed,
+	std::true_type)
+{ return hasher(key, seed); }
+
+template <class _Hasher, class _Key>
+size_t __hash_with_seed(const _Hasher& hasher, const _Key& key, size_t seed,
+	std::false_type)
+{ return __hash_impl::mix_seed(hasher(key), seed); }
+
+// Returns the hash value of the key with the seed. The value of the hasher
+// without the seed is mixed with the seed, which makes the buckets of the
+// keys unpredictable, but the keys with equal hash values still collide
+template <class _Hasher, class _Key>
+size_t __hash_with_seed(const _Hasher& hasher, const _Key& key, size_t seed)
+{
+	return __hash_with_seed(hasher, key, seed,
+		__is_seeded_hasher<_Hasher, _Key>());
+}
+
+template <class _Hasher, class _Key>
+size_t __hash_without_seed(const _Hasher& hasher, const _Key& key,
+	std::true_type)
+{ return hasher(key, 0); }
+
+template <class _Hasher, class _Key>
+size_t __hash_without_seed(const _Hasher& hasher, const _Key& key,
+	std::false_type)
+{ return hasher(key); }
+
+// Returns the hash value of the key, which does not depend on the seed of
+// the container. The hashers with the seed are called with the zero seed
+template <class _Hasher, class _Key>
+size_t __hash_without_seed(const _Hasher& hasher, const _Key& key)
+{
+	return __hash_without_seed(hasher, key,
+		__is_seeded_hasher<_Hasher, _Key>());
+}
+
+template <class _Hasher, class _Key>
+size_t __seed_hash(const _Hasher& hasher, const _Key& key, size_t, size_t seed,
+	std::true_type)
+{ return hasher(key, seed); }
+
+template <class _Hasher, class _Key>
+size_t __seed_hash(const _Hasher&, const _Key&, size_t hash, size_t seed,
+	std::false_type)
+{ return __hash_impl::mix_seed(hash, seed); }
+
+// Returns the hash value of the key with the seed by its value without the
+// seed, it equals "__hash_with_seed" of the key. The values of the hashers
+// with the seed for different seeds are unrelated, so the key is hashed
+// again
+template <class _Hasher, class _Key>
+size_t __seed_hash(const _Hasher& hasher, const _Key& key, size_t hash,
+	size_t seed)
+{
+	return __seed_hash(hasher, key, hash, seed,
+		__is_seeded_hasher<_Hasher, _Key>());
+}
+
+
 #endif  // _HASH_
@@ -5,9 +5,18 @@
 
 
 #include <cstddef>
+#include <cstdint>
 
 
 size_t _Fnv_hash_bytes(const void* ptr, size_t length, size_t seed);
 
+// SipHash-1-3 keyed by the 128-bit key "k0, k1"
+uint64_t _Sip13_hash_bytes(const void* ptr, size_t length,
+						   uint64_t k0, uint64_t k1);
+
+// Returns a new seed for hashing. The first call takes the entropy from the
+// system, the next ones derive the distinct seeds from it
+size_t _Random_seed();
+
 
 #endif
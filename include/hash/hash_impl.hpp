@@ -5,6 +5,7 @@
 
 
 #include <cstddef>
+#include <cstdint>
 
 #include <hash/hash_bytes.hpp>
 
@@ -17,8 +18,10 @@ namespace __hash_impl
     {
 #if __SIZEOF_SIZE_T__ == 4
         constexpr static size_t INITIAL_SEED = 0x811c9dc5;
+        constexpr static size_t PRIME = 0x01000193;
 #elif __SIZEOF_SIZE_T__ == 8
         constexpr static size_t INITIAL_SEED = 0xcbf29ce484222325;
+        constexpr static size_t PRIME = 0x100000001b3;
 #endif
 
         static size_t
@@ -29,10 +32,95 @@ namespace __hash_impl
         static size_t hash(const _Type& value)
         { return hash(&value, sizeof(value)); }
 
+        template<typename _Type>
+        static size_t hash_seeded(const _Type& value, size_t seed)
+        { return hash(&value, sizeof(value), seed); }
+
         template<typename _Type>
         static size_t _hash_combine(const _Type& value, size_t hash)
         { return hash(&value, sizeof(value), hash); }
+
+        // Compile-time variants of the hash functions. They are equal to
+        // the hash of the same bytes computed by "hash", the characters are
+        // extended to size_t with their sign in the same way
+
+        // Hash of the null-terminated string without the terminating null
+        constexpr static size_t
+        hash_cstring(const char* str, size_t seed = INITIAL_SEED)
+        {
+            return *str == '\0' ? seed :
+                hash_cstring(str + 1, (seed ^ static_cast<size_t>(*str)) *
+                    PRIME);
+        }
+
+        // Hash of the bytes of the integer in little-endian byte order
+        template<typename _Type>
+        constexpr static size_t
+        hash_integer(_Type value, size_t seed = INITIAL_SEED)
+        {
+            return _hash_integer_bytes(static_cast<unsigned long long>(value),
+                sizeof(_Type), seed);
+        }
+
+        constexpr static size_t _hash_integer_bytes(unsigned long long value,
+            size_t length, size_t seed)
+        {
+            return length == 0 ? seed :
+                _hash_integer_bytes(value >> 8, length - 1,
+                    (seed ^ static_cast<size_t>(static_cast<signed char>(
+                        value & 0xff))) * PRIME);
+        }
     };
+
+    // Keyed hash functions using the SipHash-1-3 algorithm. They resist
+    // the collision flooding while the seed is secret. The 128-bit key is
+    // expanded from the seed
+    struct SipHash
+    {
+        constexpr static size_t INITIAL_SEED = FNV::INITIAL_SEED;
+
+        static size_t
+        hash(const void* ptr, size_t length, size_t seed = INITIAL_SEED)
+        {
+            return static_cast<size_t>(_Sip13_hash_bytes(ptr, length, seed,
+                _second_key(seed)));
+        }
+
+        template<typename _Type>
+        static size_t hash(const _Type& value)
+        { return hash(&value, sizeof(value)); }
+
+        template<typename _Type>
+        static size_t hash_seeded(const _Type& value, size_t seed)
+        { return hash(&value, sizeof(value), seed); }
+
+        // Returns the second half of the key, which differs from the seed
+        // in about half of the bits
+        static uint64_t _second_key(size_t seed)
+        {
+            uint64_t key = (static_cast<uint64_t>(seed) ^
+                0x9e3779b97f4a7c15ULL) * 0xbf58476d1ce4e5b9ULL;
+            return key ^ (key >> 31);
+        }
+    };
+
+    // Returns the value mixed with the seed by the finalizer of MurmurHash3.
+    // The mixing is a bijection for every seed, so the distinct values
+    // remain distinct, but their low bits are unpredictable without the seed
+    inline size_t mix_seed(size_t value, size_t seed)
+    {
+#if __SIZEOF_SIZE_T__ == 4
+        uint32_t hash = static_cast<uint32_t>(value ^ seed);
+        hash = (hash ^ (hash >> 16)) * 0x85ebca6bU;
+        hash = (hash ^ (hash >> 13)) * 0xc2b2ae35U;
+        return hash ^ (hash >> 16);
+#elif __SIZEOF_SIZE_T__ == 8
+        uint64_t hash = static_cast<uint64_t>(value ^ seed);
+        hash = (hash ^ (hash >> 33)) * 0xff51afd7ed558ccdULL;
+        hash = (hash ^ (hash >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+        return hash ^ (hash >> 33);
+#endif
+    }
 }
 
 
@@ -0,0 +1,131 @@
+// aggregator_bench.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <ParallelAggregator.hpp>
+
+
+using input_t = std::vector<std::pair<uint64_t, uint64_t>>;
+
+
+// Returns the time in ms elapsed from the specified moment
+double elapsed_ms(std::chrono::steady_clock::time_point _start);
+// Returns the sum of the values of the map, which is compared between the
+// runs and prevents the removal of the aggregation
+uint64_t checksum(const HashMap<uint64_t, uint64_t>& _map);
+
+
+int main(int argc, char* argv[])
+{
+    const size_t DEFAULT_COUNT_ITEMS = 20000000;
+    const size_t DEFAULT_COUNT_KEYS = 1000000;
+
+    size_t count_items = argc > 1 ? std::strtoul(argv[1], nullptr, 10) :
+        DEFAULT_COUNT_ITEMS;
+    size_t count_keys = argc > 2 ? std::strtoul(argv[2], nullptr, 10) :
+        DEFAULT_COUNT_KEYS;
+    size_t max_threads = std::thread::hardware_concurrency();
+
+    if (count_keys == 0)
+        count_keys = 1;
+    if (max_threads == 0)
+        max_threads = 1;
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<uint64_t> key_of(0, count_keys - 1);
+    input_t input(count_items);
+
+    for (std::pair<uint64_t, uint64_t>& item : input)
+        item = std::make_pair(key_of(random), random() & 0xFF);
+
+    std::cout << "Benchmark of the aggregation of " << count_items
+        << " pairs with " << count_keys << " unique keys.\nThe time of the "
+        << "aggregation is split into the local and the merge phases.\n\n";
+    std::cout << std::left << std::setw(12) << "threads"
+        << std::right << std::setw(12) << "local,ms"
+        << std::setw(12) << "merge,ms"
+        << std::setw(12) << "total,ms"
+        << std::setw(12) << "speedup" << std::endl;
+
+    // The serial fold into a single map is the baseline
+    auto start = std::chrono::steady_clock::now();
+    HashMap<uint64_t, uint64_t> serial;
+    for (const std::pair<uint64_t, uint64_t>& item : input)
+        serial[item.first] += item.second;
+    double serial_ms = elapsed_ms(start);
+    uint64_t expected = checksum(serial);
+
+    std::cout << std::left << std::setw(12) << "serial" << std::right
+        << std::fixed << std::setprecision(1)
+        << std::setw(12) << serial_ms
+        << std::setw(12) << 0.0
+        << std::setw(12) << serial_ms
+        << std::setw(12) << 1.0 << std::endl;
+
+    for (size_t count_threads = 1; count_threads <= max_threads;
+        count_threads *= 2)
+    {
+        ParallelAggregator<uint64_t, uint64_t> aggregator(count_threads);
+        size_t slice = (input.size() + count_threads - 1) / count_threads;
+
+        start = std::chrono::steady_clock::now();
+        aggregator.run([&input, slice](
+            ParallelAggregator<uint64_t, uint64_t>::worker& _worker,
+            size_t _n)
+        {
+            size_t end = std::min(input.size(), (_n + 1) * slice);
+
+            for (size_t i = _n * slice; i < end; i++)
+                _worker.add(input[i].first, input[i].second);
+        });
+        double local_ms = elapsed_ms(start);
+
+        start = std::chrono::steady_clock::now();
+        aggregator.merge();
+        double merge_ms = elapsed_ms(start);
+
+        if (checksum(aggregator.release()) != expected)
+            std::cout << "Error: the result differs from the serial fold."
+                << std::endl;
+
+        std::cout << std::left << std::setw(12) << count_threads
+            << std::right
+            << std::setw(12) << local_ms
+            << std::setw(12) << merge_ms
+            << std::setw(12) << local_ms + merge_ms
+            << std::setw(12) << serial_ms / (local_ms + merge_ms)
+            << std::endl;
+    }
+
+    return 0;
+}
+
+
+double elapsed_ms(std::chrono::steady_clock::time_point _start)
+{
+    std::chrono::duration<double, std::milli> elapsed
+        = std::chrono::steady_clock::now() - _start;
+
+    return elapsed.count();
+}
+
+uint64_t checksum(const HashMap<uint64_t, uint64_t>& _map)
+{
+    uint64_t sum = 0;
+
+    for (const auto& item : _map)
+        sum += item.first * 31 + item.second;
+
+    return sum;
+}
@@ -0,0 +1,158 @@
+// disk_bench.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#include <DiskHashMap.hpp>
+
+#include <unistd.h>
+
+
+// Results of the benchmark of a single operation
+struct bench_result
+{
+    double ns;              // Time in ns per key
+    double reads;           // Count of the pages read per key
+    double writes;          // Count of the pages written per key
+};
+
+
+// Returns the time in ns per key elapsed from the specified moment
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count);
+// Returns the results of the operation from the statistics of the map
+bench_result make_result(double _ns, const DiskHashMap<uint64_t,
+    uint64_t>::stats_t& _stats, size_t _count);
+// Prints the row of the results table
+void print_result(const std::string& _name, const bench_result& _result);
+
+
+// The dataset is ten times larger than the page cache of the map by default,
+// which models the map ten times larger than the memory. The pages read from
+// the file can still be cached by the operating system, so the results are
+// the lower bound of the time on the cold storage
+int main(int argc, char* argv[])
+{
+    const size_t DEFAULT_COUNT_KEYS = 4000000;
+    const size_t DEFAULT_RATIO = 10;
+    const size_t PAGE_SIZE = DiskHashMap<uint64_t, uint64_t>::DEFAULT_PAGE_SIZE;
+    const size_t ENTRY_SIZE = 2 * sizeof(uint64_t);
+
+    size_t count_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) :
+        DEFAULT_COUNT_KEYS;
+    size_t ratio = argc > 2 ? std::strtoul(argv[2], nullptr, 10) :
+        DEFAULT_RATIO;
+    std::string path = argc > 3 ? argv[3] : "disk_bench.db";
+
+    if (count_keys == 0 || ratio == 0)
+    {
+        std::cout << "Usage: disk_bench [count of keys] "
+            << "[ratio of data to cache] [path of file]" << std::endl;
+        return 1;
+    }
+
+    // The pages are about 3/4 full after the splitting
+    size_t count_pages = count_keys * ENTRY_SIZE * 4 / 3 / PAGE_SIZE + 1;
+    size_t cache_pages = count_pages / ratio;
+
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(count_keys);
+    std::vector<uint64_t> misses(count_keys);
+
+    for (size_t i = 0; i < count_keys; i++)
+    {
+        keys[i] = random();
+        misses[i] = random();
+    }
+
+    std::vector<uint64_t> lookups(keys);
+    std::shuffle(lookups.begin(), lookups.end(), random);
+
+    ::unlink(path.c_str());
+
+    std::cout << "Benchmark of the disk hash map with " << count_keys
+        << " keys and the cache of " << cache_pages << " pages ("
+        << ratio << " times less than the data).\n\n";
+    std::cout << std::left << std::setw(12) << "operation"
+        << std::right << std::setw(12) << "time,ns"
+        << std::setw(12) << "reads/key"
+        << std::setw(12) << "writes/key" << std::endl;
+
+    {
+        DiskHashMap<uint64_t, uint64_t> map(path, cache_pages);
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t key : keys)
+            map.insert(std::make_pair(key, key));
+        print_result("insert", make_result(elapsed_ns(start, keys.size()),
+            map.stats(), keys.size()));
+
+        // The sum of the found values prevents the removal of the lookups
+        uint64_t sum = 0;
+
+        map.reset_stats();
+        start = std::chrono::steady_clock::now();
+        for (uint64_t key : lookups)
+            sum += map.at(key);
+        print_result("hit", make_result(elapsed_ns(start, lookups.size()),
+            map.stats(), lookups.size()));
+
+        map.reset_stats();
+        start = std::chrono::steady_clock::now();
+        for (uint64_t key : misses)
+            sum += map.count(key);
+        print_result("miss", make_result(elapsed_ns(start, misses.size()),
+            map.stats(), misses.size()));
+
+        map.reset_stats();
+        start = std::chrono::steady_clock::now();
+        for (const std::pair<uint64_t, uint64_t>& val : map)
+            sum += val.second;
+        print_result("iterate", make_result(elapsed_ns(start, map.size()),
+            map.stats(), map.size()));
+
+        if (sum == 0)
+            std::cout << "Error: the lookups have not found the keys."
+                << std::endl;
+
+        std::cout << "\nPages in the file: " << map.count_pages()
+            << ", depth of the directory: " << map.depth() << std::endl;
+    }
+
+    ::unlink(path.c_str());
+
+    return 0;
+}
+
+
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count)
+{
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - _start;
+
+    return elapsed.count() / _count;
+}
+
+bench_result make_result(double _ns, const DiskHashMap<uint64_t,
+    uint64_t>::stats_t& _stats, size_t _count)
+{
+    return bench_result{_ns, (double)_stats.reads / _count,
+        (double)_stats.writes / _count};
+}
+
+void print_result(const std::string& _name, const bench_result& _result)
+{
+    std::cout << std::left << std::setw(12) << _name << std::right
+        << std::fixed << std::setprecision(1)
+        << std::setw(12) << _result.ns
+        << std::setprecision(3)
+        << std::setw(12) << _result.reads
+        << std::setw(12) << _result.writes << std::endl;
+}
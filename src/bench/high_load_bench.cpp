@@ -0,0 +1,150 @@
+// high_load_bench.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <HopscotchHashMap.hpp>
+
+
+// Results of the benchmark of a single container
+struct bench_result
+{
+    float load_factor;      // Load factor after the insertions
+    double insert_ns;       // Time of the insertion in ns per key
+    double hit_ns;          // Time of the successful lookup in ns per key
+    double miss_ns;         // Time of the failed lookup in ns per key
+    size_t memory;          // Memory used by the container in bytes
+};
+
+
+// Returns the time in ns per key elapsed from the specified moment
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count);
+// Runs the benchmark of the container filled up to the load factor
+template <class _Map>
+bench_result run_bench(const std::vector<uint64_t>& _keys,
+    const std::vector<uint64_t>& _lookups,
+    const std::vector<uint64_t>& _misses, float _load_factor);
+// Prints the row of the results table
+void print_result(const std::string& _name, float _target,
+    const bench_result& _result);
+
+
+int main(int argc, char* argv[])
+{
+    const size_t DEFAULT_COUNT_KEYS = 1000000;
+    const float LOAD_FACTORS[] = { 0.5f, 0.75f, 0.9f, 0.95f };
+
+    size_t count_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) :
+        DEFAULT_COUNT_KEYS;
+
+    // The keys of the failed lookups are random too, the probability of
+    // their collision with the inserted keys is negligible
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(count_keys);
+    std::vector<uint64_t> misses(count_keys);
+
+    for (size_t i = 0; i < count_keys; i++)
+    {
+        keys[i] = random();
+        misses[i] = random();
+    }
+
+    std::vector<uint64_t> lookups(keys);
+    std::shuffle(lookups.begin(), lookups.end(), random);
+
+    std::cout << "Benchmark of the containers with " << count_keys
+        << " keys at high load factors.\nThe actual load factor is below "
+        << "the target one if the container has grown before it.\n\n";
+    std::cout << std::left << std::setw(12) << "container"
+        << std::right << std::setw(8) << "target"
+        << std::setw(8) << "actual"
+        << std::setw(12) << "insert,ns"
+        << std::setw(12) << "hit,ns"
+        << std::setw(12) << "miss,ns"
+        << std::setw(12) << "memory,MB" << std::endl;
+
+    for (float load_factor : LOAD_FACTORS)
+    {
+        print_result("chaining", load_factor,
+            run_bench<HashMap<uint64_t, uint64_t>>(keys, lookups, misses,
+                load_factor));
+        print_result("hopscotch", load_factor,
+            run_bench<HopscotchHashMap<uint64_t, uint64_t>>(keys, lookups,
+                misses, load_factor));
+    }
+
+    return 0;
+}
+
+
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count)
+{
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - _start;
+
+    return elapsed.count() / _count;
+}
+
+template <class _Map>
+bench_result run_bench(const std::vector<uint64_t>& _keys,
+    const std::vector<uint64_t>& _lookups,
+    const std::vector<uint64_t>& _misses, float _load_factor)
+{
+    bench_result result;
+    _Map map;
+
+    map.max_load_factor(_load_factor);
+    map.reverse(_keys.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t key : _keys)
+        map[key] = key;
+    result.insert_ns = elapsed_ns(start, _keys.size());
+
+    // The sum of the found values prevents the removal of the lookups
+    uint64_t sum = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t key : _lookups)
+        sum += (*map.find(key)).second;
+    result.hit_ns = elapsed_ns(start, _lookups.size());
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t key : _misses)
+        sum += map.count(key);
+    result.miss_ns = elapsed_ns(start, _misses.size());
+
+    if (sum == 0)
+        std::cout << "Error: the lookups have not found the keys."
+            << std::endl;
+
+    result.load_factor = map.load_factor();
+    result.memory = map.memory_usage();
+
+    return result;
+}
+
+void print_result(const std::string& _name, float _target,
+    const bench_result& _result)
+{
+    const double MEGABYTE = 1024.0 * 1024.0;
+
+    std::cout << std::left << std::setw(12) << _name << std::right
+        << std::fixed << std::setprecision(2)
+        << std::setw(8) << _target
+        << std::setw(8) << _result.load_factor
+        << std::setprecision(1)
+        << std::setw(12) << _result.insert_ns
+        << std::setw(12) << _result.hit_ns
+        << std::setw(12) << _result.miss_ns
+        << std::setw(12) << _result.memory / MEGABYTE << std::endl;
+}
@@ -0,0 +1,135 @@
+// huge_page_bench.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include <utility>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <alloc/memory_resource.hpp>
+#include <alloc/huge_page_resource.hpp>
+
+
+using map_t = HashMap<uint64_t, uint64_t, hash<uint64_t>,
+    std::equal_to<uint64_t>,
+    polymorphic_allocator<std::pair<const uint64_t, uint64_t>>>;
+
+
+// Returns the time in ns per key elapsed from the specified moment
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count);
+// Fills the map over the resource with the keys and returns the time of the
+// random lookups of them in ns per key
+double run_bench(const std::vector<uint64_t>& _keys,
+    const std::vector<uint64_t>& _lookups, memory_resource* _resource);
+// Prints the row of the results table
+void print_result(const std::string& _name, double _find_ns,
+    const huge_page_resource::stats_t& _stats);
+
+
+int main(int argc, char* argv[])
+{
+    const size_t DEFAULT_COUNT_KEYS = 4000000;
+    const size_t COUNT_LOOKUPS = 10000000;
+
+    size_t count_keys = argc > 1 ? std::strtoul(argv[1], nullptr, 10) :
+        DEFAULT_COUNT_KEYS;
+
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(count_keys);
+    for (uint64_t& key : keys)
+        key = random();
+
+    // The lookups are spread over the whole map, so most of them miss the
+    // TLB with the normal pages
+    std::vector<uint64_t> lookups(COUNT_LOOKUPS);
+    std::uniform_int_distribution<size_t> index(0, count_keys - 1);
+    for (uint64_t& key : lookups)
+        key = keys[index(random)];
+
+    std::cout << "Benchmark of the random lookups in the map with "
+        << count_keys << " keys.\nThe nodes are taken from the pool over "
+        << "the specified resource.\n\n";
+    std::cout << std::left << std::setw(16) << "resource"
+        << std::right << std::setw(12) << "find,ns"
+        << std::setw(14) << "explicit,MB"
+        << std::setw(14) << "thp,MB"
+        << std::setw(14) << "normal,MB" << std::endl;
+
+    {
+        unsynchronized_pool_resource pool(new_delete_resource());
+        huge_page_resource::stats_t none = { 0, 0, 0, 0 };
+        print_result("new_delete", run_bench(keys, lookups, &pool), none);
+    }
+
+    const std::pair<const char*, huge_page_resource::page_mode> MODES[] = {
+        { "huge_normal", huge_page_resource::page_mode::NORMAL },
+        { "huge_thp", huge_page_resource::page_mode::TRANSPARENT },
+        { "huge_explicit", huge_page_resource::page_mode::EXPLICIT }
+    };
+
+    for (const auto& mode : MODES)
+    {
+        huge_page_resource resource(mode.second);
+        unsynchronized_pool_resource pool(&resource);
+        double find_ns = run_bench(keys, lookups, &pool);
+
+        // The regions of the failed explicit pages fall back to the other
+        // kinds, so the table shows what has been actually mapped
+        print_result(mode.first, find_ns, resource.stats());
+    }
+
+    return 0;
+}
+
+
+double elapsed_ns(std::chrono::steady_clock::time_point _start, size_t _count)
+{
+    std::chrono::duration<double, std::nano> elapsed
+        = std::chrono::steady_clock::now() - _start;
+
+    return elapsed.count() / _count;
+}
+
+double run_bench(const std::vector<uint64_t>& _keys,
+    const std::vector<uint64_t>& _lookups, memory_resource* _resource)
+{
+    map_t map(_resource);
+
+    map.reverse(_keys.size());
+    for (uint64_t key : _keys)
+        map[key] = key;
+
+    // The sum of the found values prevents the removal of the lookups
+    uint64_t sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t key : _lookups)
+        sum += (*map.find(key)).second;
+    double find_ns = elapsed_ns(start, _lookups.size());
+
+    if (sum == 0)
+        std::cout << "Error: the lookups have not found the keys."
+            << std::endl;
+
+    return find_ns;
+}
+
+void print_result(const std::string& _name, double _find_ns,
+    const huge_page_resource::stats_t& _stats)
+{
+    const double MEGABYTE = 1024.0 * 1024.0;
+
+    std::cout << std::left << std::setw(16) << _name << std::right
+        << std::fixed << std::setprecision(1)
+        << std::setw(12) << _find_ns
+        << std::setw(14) << _stats.explicit_bytes / MEGABYTE
+        << std::setw(14) << _stats.transparent_bytes / MEGABYTE
+        << std::setw(14) << _stats.normal_bytes / MEGABYTE << std::endl;
+}
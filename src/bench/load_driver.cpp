@@ -0,0 +1,384 @@
+// load_driver.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <LatencyHistogram.hpp>
+
+
+// Distributions of the keys
+enum class key_distribution
+{
+    uniform,        // Every key with the same probability
+    zipf,           // Rank k with the probability proportional to 1/k^theta
+    sequential,     // Keys in turn, every thread from its own offset
+    hotset          // Small set of the keys gets the most of the accesses
+};
+
+// Parameters of the load
+struct load_options
+{
+    size_t count_keys;          // Count of the keys
+    size_t count_threads;       // Count of the threads
+    double seconds;             // Duration of every run
+    unsigned find_percent;      // Percents of the operations
+    unsigned insert_percent;
+    unsigned erase_percent;
+};
+
+// Map shared by the threads, the keys are split between the shards with
+// their own locks, so the threads contend only for the same shard
+struct striped_map
+{
+    struct shard
+    {
+        std::mutex lock;
+        HashMap<uint64_t, uint64_t> map;
+    };
+
+    static constexpr unsigned SHARD_BITS = 6;
+
+    std::vector<std::unique_ptr<shard>> shards;
+
+    striped_map()
+    {
+        for (size_t i = 0; i < (size_t(1) << SHARD_BITS); i++)
+            shards.emplace_back(new shard);
+    }
+
+    // The shard is chosen by the high bits of the mixed key, the map uses
+    // the low bits of the hash value
+    shard& shard_of(uint64_t _key)
+    { return *shards[(_key * 0x9E3779B97F4A7C15ull) >> (64 - SHARD_BITS)]; }
+};
+
+// Generator of the indices of the keys by the distribution
+class key_generator
+{
+private:
+    key_distribution _m_dist;
+    size_t _m_count;                                // Count of the keys
+    std::mt19937_64 _m_random;
+    std::uniform_real_distribution<double> _m_real; // Uniform in [0, 1)
+    size_t _m_next;                                 // Next sequential index
+    double _m_zeta;                                 // Parameters of Zipf
+    double _m_alpha;
+    double _m_eta;
+
+public:
+    // Skew of the Zipf distribution as in YCSB
+    static constexpr double ZIPF_THETA = 0.99;
+    // Fraction of the keys in the hot set and of the accesses to them
+    static constexpr double HOT_KEYS = 0.01;
+    static constexpr double HOT_ACCESSES = 0.9;
+
+    // The zeta of the Zipf distribution is computed once for all the
+    // generators, because it takes the time linear in the count of keys
+    key_generator(key_distribution _dist, size_t _count, double _zeta,
+        size_t _thread, size_t _count_threads):
+        _m_dist{_dist},
+        _m_count{_count},
+        _m_random(_thread + 1),
+        _m_real(0.0, 1.0),
+        _m_next{_count / _count_threads * _thread},
+        _m_zeta{_zeta},
+        _m_alpha{1.0 / (1.0 - ZIPF_THETA)},
+        _m_eta{(1.0 - std::pow(2.0 / _count, 1.0 - ZIPF_THETA)) /
+            (1.0 - zeta(2) / _zeta)}
+    {}
+
+    // Returns the sum of 1/k^theta for k from 1 to the count
+    static double zeta(size_t _count)
+    {
+        double sum = 0;
+
+        for (size_t i = 1; i <= _count; i++)
+            sum += 1.0 / std::pow(double(i), ZIPF_THETA);
+
+        return sum;
+    }
+
+    // Returns the index of the next key
+    size_t next()
+    {
+        switch (_m_dist)
+        {
+        case key_distribution::uniform:
+            return _m_random() % _m_count;
+        case key_distribution::sequential:
+        {
+            size_t index = _m_next;
+            _m_next = _m_next + 1 == _m_count ? 0 : _m_next + 1;
+            return index;
+        }
+        case key_distribution::hotset:
+        {
+            size_t count_hot = std::max<size_t>(1, _m_count * HOT_KEYS);
+
+            return _m_real(_m_random) < HOT_ACCESSES ?
+                _m_random() % count_hot : _m_random() % _m_count;
+        }
+        case key_distribution::zipf:
+        default:
+        {
+            // The method of Gray et al. "Quickly generating billion-record
+            // synthetic databases", the rank 0 is the most frequent
+            double u = _m_real(_m_random);
+            double uz = u * _m_zeta;
+
+            if (uz < 1.0)
+                return 0;
+
+            if (uz < 1.0 + std::pow(0.5, ZIPF_THETA))
+                return std::min<size_t>(1, _m_count - 1);
+
+            return std::min<size_t>(_m_count - 1, _m_count *
+                std::pow(_m_eta * u - _m_eta + 1.0, _m_alpha));
+        }
+        }
+    }
+};
+
+// Results of the run
+struct load_result
+{
+    uint64_t count_ops = 0;         // Count of the operations
+    uint64_t count_finds = 0;       // Count of the lookups
+    uint64_t count_hits = 0;        // Count of the found keys
+    LatencyHistogram latencies;     // Latencies of the operations in ns
+};
+
+
+// Returns the name of the distribution
+const char* distribution_name(key_distribution _dist);
+// Parses the name of the distribution, returns false if it is unknown
+bool parse_distribution(const std::string& _name,
+    std::vector<key_distribution>& _dists);
+// Parses the ratio "find/insert/erase", returns false if it is invalid
+bool parse_mix(const std::string& _mix, load_options& _options);
+// Runs the operations of the thread till the deadline
+void run_thread(striped_map& _map, const std::vector<uint64_t>& _keys,
+    key_distribution _dist, double _zeta, const load_options& _options,
+    size_t _thread, std::chrono::steady_clock::time_point _deadline,
+    load_result& _result);
+// Runs the load of the distribution and prints its row
+void run_load(const std::vector<uint64_t>& _keys, key_distribution _dist,
+    double _zeta, const load_options& _options);
+
+
+// The threads run the mixed operations over the map shared by them, every
+// operation is timed separately, so the percentiles include the waiting for
+// the locks and the rehashing. The timing itself adds a few tens of ns to
+// every operation
+int main(int argc, char* argv[])
+{
+    std::vector<key_distribution> dists;
+    load_options options;
+
+    std::string dist_name = argc > 1 ? argv[1] : "all";
+    std::string mix = argc > 2 ? argv[2] : "90/5/5";
+    options.count_threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) :
+        std::max(1u, std::thread::hardware_concurrency());
+    options.count_keys = argc > 4 ? std::strtoul(argv[4], nullptr, 10) :
+        1000000;
+    options.seconds = argc > 5 ? std::strtod(argv[5], nullptr) : 3;
+
+    if (!parse_distribution(dist_name, dists) || !parse_mix(mix, options) ||
+        options.count_threads == 0 || options.count_keys == 0 ||
+        !(options.seconds > 0))
+    {
+        std::cout << "Usage: load_driver "
+            << "[uniform | zipf | sequential | hotset | all] "
+            << "[find/insert/erase percents] [count of threads] "
+            << "[count of keys] [seconds]" << std::endl;
+        return 1;
+    }
+
+    // The keys are random, so the ranks of the distributions are not
+    // related to the buckets
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> keys(options.count_keys);
+
+    for (uint64_t& key : keys)
+        key = random();
+
+    double zeta = key_generator::zeta(options.count_keys);
+
+    std::cout << "Load of the hash map with " << options.count_keys
+        << " keys, " << options.count_threads << " threads and "
+        << options.find_percent << "/" << options.insert_percent << "/"
+        << options.erase_percent << " percents of find/insert/erase.\n\n";
+    std::cout << std::left << std::setw(12) << "keys"
+        << std::right << std::setw(12) << "Mops/s"
+        << std::setw(10) << "p50,ns"
+        << std::setw(10) << "p99,ns"
+        << std::setw(10) << "p99.9,ns"
+        << std::setw(12) << "max,ns"
+        << std::setw(8) << "hits,%" << std::endl;
+
+    for (key_distribution dist : dists)
+        run_load(keys, dist, zeta, options);
+
+    return 0;
+}
+
+
+const char* distribution_name(key_distribution _dist)
+{
+    switch (_dist)
+    {
+    case key_distribution::uniform:
+        return "uniform";
+    case key_distribution::zipf:
+        return "zipf";
+    case key_distribution::sequential:
+        return "sequential";
+    case key_distribution::hotset:
+    default:
+        return "hotset";
+    }
+}
+
+bool parse_distribution(const std::string& _name,
+    std::vector<key_distribution>& _dists)
+{
+    const key_distribution ALL[] = { key_distribution::uniform,
+        key_distribution::zipf, key_distribution::sequential,
+        key_distribution::hotset };
+
+    for (key_distribution dist : ALL)
+        if (_name == "all" || _name == distribution_name(dist))
+            _dists.push_back(dist);
+
+    return !_dists.empty();
+}
+
+bool parse_mix(const std::string& _mix, load_options& _options)
+{
+    unsigned find = 0, insert = 0, erase = 0;
+    char end;
+
+    if (std::sscanf(_mix.c_str(), "%u/%u/%u%c", &find, &insert, &erase,
+        &end) != 3 || find + insert + erase != 100)
+        return false;
+
+    _options.find_percent = find;
+    _options.insert_percent = insert;
+    _options.erase_percent = erase;
+
+    return true;
+}
+
+void run_thread(striped_map& _map, const std::vector<uint64_t>& _keys,
+    key_distribution _dist, double _zeta, const load_options& _options,
+    size_t _thread, std::chrono::steady_clock::time_point _deadline,
+    load_result& _result)
+{
+    // The operations go in the batches between the checks of the deadline
+    const size_t CHECK_INTERVAL = 1024;
+
+    key_generator keys(_dist, _keys.size(), _zeta, _thread,
+        _options.count_threads);
+    std::mt19937_64 random(_thread + 1000);
+    // The results of the threads are adjacent in the vector, so the counters
+    // are updated in the local copy and stored once after the run to avoid
+    // the false sharing of their cache lines
+    load_result result;
+
+    while (std::chrono::steady_clock::now() < _deadline)
+    {
+        for (size_t i = 0; i < CHECK_INTERVAL; i++)
+        {
+            uint64_t key = _keys[keys.next()];
+            unsigned op = random() % 100;
+            striped_map::shard& shard = _map.shard_of(key);
+
+            auto start = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> guard(shard.lock);
+
+                // The hits are counted, so the lookups are not removed
+                if (op < _options.find_percent)
+                {
+                    result.count_finds++;
+                    result.count_hits += shard.map.count(key);
+                }
+                else if (op < _options.find_percent + _options.insert_percent)
+                    shard.map.insert(std::make_pair(key, key));
+                else
+                    shard.map.erase(key);
+            }
+            auto finish = std::chrono::steady_clock::now();
+
+            result.latencies.record(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(finish - start).count());
+        }
+
+        result.count_ops += CHECK_INTERVAL;
+    }
+
+    _result = std::move(result);
+}
+
+void run_load(const std::vector<uint64_t>& _keys, key_distribution _dist,
+    double _zeta, const load_options& _options)
+{
+    // Every run starts with all the keys, so the inserts and the erases
+    // keep the size of the map near the count of keys
+    striped_map map;
+
+    for (uint64_t key : _keys)
+        map.shard_of(key).map.insert(std::make_pair(key, key));
+
+    std::vector<load_result> results(_options.count_threads);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(_options.seconds));
+
+    for (size_t i = 0; i < _options.count_threads; i++)
+        threads.emplace_back(run_thread, std::ref(map), std::cref(_keys),
+            _dist, _zeta, std::cref(_options), i, deadline,
+            std::ref(results[i]));
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    load_result total;
+
+    for (const load_result& result : results)
+    {
+        total.count_ops += result.count_ops;
+        total.count_finds += result.count_finds;
+        total.count_hits += result.count_hits;
+        total.latencies.merge(result.latencies);
+    }
+
+    std::cout << std::left << std::setw(12) << distribution_name(_dist)
+        << std::right << std::fixed << std::setprecision(2)
+        << std::setw(12) << total.count_ops / elapsed.count() / 1e6
+        << std::setw(10) << total.latencies.percentile(50)
+        << std::setw(10) << total.latencies.percentile(99)
+        << std::setw(10) << total.latencies.percentile(99.9)
+        << std::setw(12) << total.latencies.max()
+        << std::setw(8) << (total.count_finds == 0 ? 0.0 :
+            100.0 * total.count_hits / total.count_finds) << std::endl;
+}
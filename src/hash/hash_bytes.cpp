@@ -2,6 +2,10 @@
 
 #include <hash/hash_bytes.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <random>
+
 
 // Implementation of FNV-1a hash algorithm for 32-bit size_t
 #if __SIZEOF_SIZE_T__ == 4
@@ -10,7 +14,7 @@ size_t _Fnv_hash_bytes(const void* ptr, size_t len, size_t seed)
 	const char* c_ptr = static_cast<const char*>(ptr);
 	size_t hval = seed;
 
-	for (; len > 0; len--, ptr++)
+	for (; len > 0; len--, c_ptr++)
 	{
 		hval ^= static_cast<size_t>(*c_ptr);
 		hval *= static_cast<size_t>(0x01000193);
@@ -36,3 +40,94 @@ size_t _Fnv_hash_bytes(const void* ptr, size_t len, size_t seed)
 
 
 #endif
+
+
+static inline uint64_t _rotl(uint64_t x, int b)
+{
+	return (x << b) | (x >> (64 - b));
+}
+
+static inline void _sip_round(uint64_t& v0, uint64_t& v1,
+							  uint64_t& v2, uint64_t& v3)
+{
+	v0 += v1; v1 = _rotl(v1, 13); v1 ^= v0; v0 = _rotl(v0, 32);
+	v2 += v3; v3 = _rotl(v3, 16); v3 ^= v2;
+	v0 += v3; v3 = _rotl(v3, 21); v3 ^= v0;
+	v2 += v1; v1 = _rotl(v1, 17); v1 ^= v2; v2 = _rotl(v2, 32);
+}
+
+// Implementation of SipHash-1-3: one compression round per 8-byte word and
+// three finalization rounds. The words are read in little-endian order
+uint64_t _Sip13_hash_bytes(const void* ptr, size_t len,
+						   uint64_t k0, uint64_t k1)
+{
+	const unsigned char* c_ptr = static_cast<const unsigned char*>(ptr);
+	uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+	uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+	uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+	uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+	uint64_t last = static_cast<uint64_t>(len) << 56;
+
+	for (; len >= 8; len -= 8, c_ptr += 8)
+	{
+		uint64_t word = 0;
+
+		for (int i = 7; i >= 0; i--)
+			word = (word << 8) | c_ptr[i];
+
+		v3 ^= word;
+		_sip_round(v0, v1, v2, v3);
+		v0 ^= word;
+	}
+
+	for (size_t i = 0; i < len; i++)
+		last |= static_cast<uint64_t>(c_ptr[i]) << (8 * i);
+
+	v3 ^= last;
+	_sip_round(v0, v1, v2, v3);
+	v0 ^= last;
+
+	v2 ^= 0xff;
+	_sip_round(v0, v1, v2, v3);
+	_sip_round(v0, v1, v2, v3);
+	_sip_round(v0, v1, v2, v3);
+
+	return v0 ^ v1 ^ v2 ^ v3;
+}
+
+
+// Returns the entropy of the system, or the time and the address of the
+// stack if there is no source of the entropy
+static uint64_t _system_entropy()
+{
+	try
+	{
+		std::random_device device;
+		return (static_cast<uint64_t>(device()) << 32) ^ device();
+	}
+	catch (...)
+	{
+		int local = 0;
+		uintptr_t address = reinterpret_cast<uintptr_t>(&local);
+
+		return static_cast<uint64_t>(std::chrono::steady_clock::now()
+			.time_since_epoch().count()) ^ (static_cast<uint64_t>(address)
+			<< 16);
+	}
+}
+
+// The seeds are the outputs of the SplitMix64 generator started by the
+// entropy. The state is advanced atomically, so the concurrent calls get
+// distinct seeds
+size_t _Random_seed()
+{
+	static std::atomic<uint64_t> state{_system_entropy()};
+
+	uint64_t z = state.fetch_add(0x9e3779b97f4a7c15ULL,
+		std::memory_order_relaxed) + 0x9e3779b97f4a7c15ULL;
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return static_cast<size_t>(z ^ (z >> 31));
+}
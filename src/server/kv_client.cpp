@@ -0,0 +1,520 @@
+// kv_client.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <exception>
+#include <system_error>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <KvProtocol.hpp>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+
+// Parameters of the load
+struct load_options
+{
+    size_t count_keys;      // Count of the keys
+    size_t batch;           // Count of the requests in the batch
+    double seconds;         // Duration of the load
+    size_t get_percent;     // Percent of GET, the rest is SET and DEL
+    size_t value_size;      // Size of the values
+};
+
+// Results of the load thread
+struct load_result
+{
+    uint64_t count_ops = 0;             // Count of the requests
+    uint64_t count_gets = 0;            // Count of GET
+    uint64_t count_hits = 0;            // Count of GET found the key
+    uint64_t count_errors = 0;          // Count of the wrong shards
+    std::vector<uint64_t> latencies;    // Round trips of the batches in ns
+};
+
+// Connections of the client to all the shards
+struct shard_connections
+{
+    std::vector<int> fds;                   // Non-blocking sockets
+    std::vector<std::string> requests;      // Requests of the batch
+    std::vector<std::vector<uint8_t>> ops;  // Operations of the batch
+    std::vector<std::vector<char>> inputs;  // Buffers of the responses
+};
+
+// Progress of the batch of the shard
+struct shard_progress
+{
+    size_t sent = 0;        // Sent bytes of the requests
+    size_t received = 0;    // Count of the parsed responses
+    size_t end = 0;         // Count of the bytes in the buffer
+};
+
+
+// Maximum size of the batch to every shard, in which the keys are loaded
+const size_t MAX_BATCH_BYTES = 1024 * 1024;
+
+
+// Connects to all the shards
+void connect_all(const kv_address& _addr, size_t _count_shards,
+    shard_connections& _conns);
+// Closes the connections
+void close_all(shard_connections& _conns);
+// Requests the count of shards from the first shard
+size_t request_count_shards(const kv_address& _addr);
+// Sends the batches to the shards and reads the responses
+void run_batch(shard_connections& _conns, load_result& _result);
+// Sends all the data to the socket
+void write_all(int _fd, const std::string& _data);
+// Sends the requests till the socket is full
+void send_requests(int _fd, const std::string& _requests,
+    shard_progress& _progress);
+// Reads the available responses for the operations of the shard
+void read_responses(int _fd, const std::vector<uint8_t>& _ops,
+    std::vector<char>& _input, shard_progress& _progress,
+    load_result& _result);
+// Stores all the keys in the server
+void load_keys(const kv_address& _addr, size_t _count_shards,
+    const std::vector<std::string>& _keys, const std::string& _value);
+// Runs the load of the thread
+void run_load(const kv_address& _addr, size_t _count_shards,
+    const std::vector<std::string>& _keys, const std::string& _value,
+    const load_options& _options, size_t _thread, load_result& _result);
+// Returns the percentile of the sorted latencies in us
+double percentile_us(const std::vector<uint64_t>& _sorted, double _percent);
+
+
+// Every thread connects to all the shards and sends the pipelined batches
+// of random requests, which are grouped by the shards of their keys. The
+// responses are read while the requests are sent, so the batch is not
+// limited by the socket buffers. The latency is the round trip of the
+// whole batch
+int main(int argc, char* argv[])
+{
+    std::string address = argc > 1 ? argv[1] : "unix:/tmp/kv_server.sock";
+    size_t count_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+
+    load_options options;
+    options.count_keys = argc > 3 ? std::strtoul(argv[3], nullptr, 10) :
+        100000;
+    options.batch = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 32;
+    options.seconds = argc > 5 ? std::strtod(argv[5], nullptr) : 5;
+    options.get_percent = argc > 6 ? std::strtoul(argv[6], nullptr, 10) : 90;
+    options.value_size = argc > 7 ? std::strtoul(argv[7], nullptr, 10) : 32;
+
+    if (count_threads == 0 || options.count_keys == 0 || options.batch == 0 ||
+        !(options.seconds > 0) || options.get_percent > 100 ||
+        options.value_size > KV_MAX_VALUE_SIZE)
+    {
+        std::cout << "Usage: kv_client [unix:<path> | tcp:<port>] "
+            << "[count of threads] [count of keys] [batch size] [seconds] "
+            << "[percent of GET] [value size]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        kv_address addr(address);
+        size_t count_shards = request_count_shards(addr);
+
+        std::vector<std::string> keys(options.count_keys);
+        std::string value(options.value_size, 'v');
+
+        for (size_t i = 0; i < keys.size(); i++)
+            keys[i] = "key:" + std::to_string(i);
+
+        load_keys(addr, count_shards, keys, value);
+
+        std::cout << "Benchmark of the key-value server with " << count_shards
+            << " shards, " << count_threads << " threads, " << keys.size()
+            << " keys, batches of " << options.batch << " requests and "
+            << options.get_percent << "% of GET.\n" << std::endl;
+
+        std::vector<load_result> results(count_threads);
+        std::vector<std::thread> threads;
+
+        for (size_t i = 0; i < count_threads; i++)
+            threads.emplace_back(run_load, std::cref(addr), count_shards,
+                std::cref(keys), std::cref(value), std::cref(options), i,
+                std::ref(results[i]));
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        load_result total;
+
+        for (load_result& result : results)
+        {
+            total.count_ops += result.count_ops;
+            total.count_gets += result.count_gets;
+            total.count_hits += result.count_hits;
+            total.count_errors += result.count_errors;
+            total.latencies.insert(total.latencies.end(),
+                result.latencies.begin(), result.latencies.end());
+        }
+
+        std::sort(total.latencies.begin(), total.latencies.end());
+
+        std::cout << std::fixed << std::setprecision(1)
+            << "throughput, ops/s:  " << total.count_ops / options.seconds
+            << "\nbatch latency, us:  p50 "
+            << percentile_us(total.latencies, 50)
+            << ", p99 " << percentile_us(total.latencies, 99)
+            << ", p99.9 " << percentile_us(total.latencies, 99.9)
+            << ", max " << percentile_us(total.latencies, 100)
+            << "\nhits of GET:        " << (total.count_gets == 0 ? 0 :
+                100.0 * total.count_hits / total.count_gets)
+            << "%\nwrong shards:       " << total.count_errors << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+void connect_all(const kv_address& _addr, size_t _count_shards,
+    shard_connections& _conns)
+{
+    _conns.requests.resize(_count_shards);
+    _conns.ops.resize(_count_shards);
+    _conns.inputs.assign(_count_shards, std::vector<char>(64 * 1024));
+
+    for (size_t i = 0; i < _count_shards; i++)
+    {
+        int fd = _addr.connect(i);
+
+        _conns.fds.push_back(fd);
+
+        if (::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) < 0)
+        {
+            close_all(_conns);
+            throw std::system_error(errno, std::generic_category(),
+                "failed to make the socket non-blocking");
+        }
+    }
+}
+
+void close_all(shard_connections& _conns)
+{
+    for (int fd : _conns.fds)
+        ::close(fd);
+
+    _conns.fds.clear();
+}
+
+size_t request_count_shards(const kv_address& _addr)
+{
+    // The single request is sent by the blocking socket
+    int fd = _addr.connect(0);
+    std::string request;
+    std::vector<char> input(64 * 1024);
+
+    kv_append_request(request, KV_INFO, "", 0);
+
+    // The response is read by hand, because it carries the value
+    kv_response response;
+    size_t end = 0;
+
+    try
+    {
+        write_all(fd, request);
+
+        while (kv_parse_response(input.data(), end, response) == 0)
+        {
+            ssize_t size = ::read(fd, input.data() + end, input.size() - end);
+
+            if (size <= 0)
+                throw std::runtime_error("the server closed the connection");
+
+            end += size;
+        }
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+
+    ::close(fd);
+
+    uint32_t count = 0;
+
+    if (response.status != KV_OK || response.value_size != sizeof(count))
+        throw std::runtime_error("invalid response to INFO");
+
+    std::memcpy(&count, response.value, sizeof(count));
+
+    if (count == 0)
+        throw std::runtime_error("the server has no shards");
+
+    return count;
+}
+
+// The shards are polled for both the sending and the receiving, because the
+// server stops reading the requests while its responses are not read
+void run_batch(shard_connections& _conns, load_result& _result)
+{
+    size_t count_shards = _conns.fds.size();
+    std::vector<shard_progress> progress(count_shards);
+    std::vector<pollfd> polls;
+    std::vector<size_t> shards;
+
+    while (true)
+    {
+        polls.clear();
+        shards.clear();
+
+        for (size_t i = 0; i < count_shards; i++)
+        {
+            short events = 0;
+
+            if (progress[i].sent < _conns.requests[i].size())
+                events |= POLLOUT;
+            if (progress[i].received < _conns.ops[i].size())
+                events |= POLLIN;
+
+            if (events != 0)
+            {
+                polls.push_back(pollfd{_conns.fds[i], events, 0});
+                shards.push_back(i);
+            }
+        }
+
+        if (polls.empty())
+            break;
+
+        if (::poll(polls.data(), polls.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            throw std::system_error(errno, std::generic_category(),
+                "failed to wait for the shards");
+        }
+
+        for (size_t n = 0; n < polls.size(); n++)
+        {
+            size_t i = shards[n];
+
+            if (polls[n].revents == 0)
+                continue;
+
+            // The errors of the socket are reported by the calls below
+            if (polls[n].events & POLLOUT)
+                send_requests(_conns.fds[i], _conns.requests[i],
+                    progress[i]);
+            if (polls[n].events & POLLIN)
+                read_responses(_conns.fds[i], _conns.ops[i],
+                    _conns.inputs[i], progress[i], _result);
+        }
+    }
+
+    for (size_t i = 0; i < count_shards; i++)
+    {
+        _conns.requests[i].clear();
+        _conns.ops[i].clear();
+    }
+}
+
+void write_all(int _fd, const std::string& _data)
+{
+    for (size_t sent = 0; sent < _data.size(); )
+    {
+        ssize_t size = ::send(_fd, _data.data() + sent, _data.size() - sent,
+            MSG_NOSIGNAL);
+
+        if (size < 0 && errno != EINTR)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to send the requests");
+
+        if (size > 0)
+            sent += size;
+    }
+}
+
+void send_requests(int _fd, const std::string& _requests,
+    shard_progress& _progress)
+{
+    while (_progress.sent < _requests.size())
+    {
+        ssize_t size = ::send(_fd, _requests.data() + _progress.sent,
+            _requests.size() - _progress.sent, MSG_NOSIGNAL);
+
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+
+        if (size < 0 && errno != EINTR)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to send the requests");
+
+        if (size > 0)
+            _progress.sent += size;
+    }
+}
+
+void read_responses(int _fd, const std::vector<uint8_t>& _ops,
+    std::vector<char>& _input, shard_progress& _progress,
+    load_result& _result)
+{
+    while (_progress.received < _ops.size())
+    {
+        if (_progress.end == _input.size())
+            _input.resize(_input.size() * 2);
+
+        ssize_t size = ::read(_fd, _input.data() + _progress.end,
+            _input.size() - _progress.end);
+
+        if (size == 0)
+            throw std::runtime_error("the server closed the connection");
+
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+
+        if (size < 0 && errno != EINTR)
+            throw std::system_error(errno, std::generic_category(),
+                "failed to receive the responses");
+
+        if (size < 0)
+            continue;
+
+        _progress.end += size;
+
+        size_t begin = 0, used;
+        kv_response response;
+
+        while (_progress.received < _ops.size() &&
+            (used = kv_parse_response(_input.data() + begin,
+                _progress.end - begin, response)) != 0)
+        {
+            uint8_t op = _ops[_progress.received++];
+
+            begin += used;
+            _result.count_ops++;
+
+            if (response.status == KV_WRONG_SHARD)
+                _result.count_errors++;
+            else if (op == KV_GET)
+            {
+                _result.count_gets++;
+                _result.count_hits += response.status == KV_OK;
+            }
+        }
+
+        // The partial response is moved to the beginning of the buffer
+        std::copy(_input.begin() + begin, _input.begin() + _progress.end,
+            _input.begin());
+        _progress.end -= begin;
+    }
+}
+
+void load_keys(const kv_address& _addr, size_t _count_shards,
+    const std::vector<std::string>& _keys, const std::string& _value)
+{
+    const size_t LOAD_BATCH = std::max<size_t>(1, MAX_BATCH_BYTES /
+        (_value.size() + 64));
+
+    shard_connections conns;
+    load_result result;
+    connect_all(_addr, _count_shards, conns);
+
+    for (size_t i = 0; i < _keys.size(); i++)
+    {
+        size_t shard = kv_shard_of(_keys[i].data(), _keys[i].size(),
+            _count_shards);
+
+        kv_append_request(conns.requests[shard], KV_SET, _keys[i].data(),
+            _keys[i].size(), _value.data(), _value.size());
+        conns.ops[shard].push_back(KV_SET);
+
+        if ((i + 1) % LOAD_BATCH == 0 || i + 1 == _keys.size())
+            run_batch(conns, result);
+    }
+
+    close_all(conns);
+}
+
+void run_load(const kv_address& _addr, size_t _count_shards,
+    const std::vector<std::string>& _keys, const std::string& _value,
+    const load_options& _options, size_t _thread, load_result& _result)
+{
+    try
+    {
+        shard_connections conns;
+        connect_all(_addr, _count_shards, conns);
+
+        std::mt19937_64 random(_thread + 1);
+        std::uniform_int_distribution<size_t> key_dist(0, _keys.size() - 1);
+        std::uniform_int_distribution<size_t> op_dist(0, 199);
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::duration_cast<
+            std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(_options.seconds));
+
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            for (size_t i = 0; i < _options.batch; i++)
+            {
+                const std::string& key = _keys[key_dist(random)];
+                size_t shard = kv_shard_of(key.data(), key.size(),
+                    _count_shards);
+                size_t choice = op_dist(random);
+
+                // The rest of GET is split between SET and DEL equally
+                uint8_t op = choice < _options.get_percent * 2 ? KV_GET :
+                    choice % 2 == 0 ? KV_SET : KV_DEL;
+
+                if (op == KV_SET)
+                    kv_append_request(conns.requests[shard], op, key.data(),
+                        key.size(), _value.data(), _value.size());
+                else
+                    kv_append_request(conns.requests[shard], op, key.data(),
+                        key.size());
+
+                conns.ops[shard].push_back(op);
+            }
+
+            auto batch_start = std::chrono::steady_clock::now();
+            run_batch(conns, _result);
+
+            _result.latencies.push_back(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                batch_start).count());
+        }
+
+        close_all(conns);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error in the thread " << _thread << ": " << e.what()
+            << std::endl;
+    }
+}
+
+double percentile_us(const std::vector<uint64_t>& _sorted, double _percent)
+{
+    if (_sorted.empty())
+        return 0;
+
+    size_t i = std::min(_sorted.size() - 1,
+        size_t(_percent / 100 * _sorted.size()));
+
+    return _sorted[i] / 1000.0;
+}
@@ -0,0 +1,381 @@
+// kv_server.cpp
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <csignal>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <KvProtocol.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+
+// Connection of the client
+struct connection
+{
+    std::vector<char> input;    // Received data
+    size_t begin = 0;           // Beginning of the unparsed data
+    size_t end = 0;             // End of the received data
+    std::string output;         // Responses to send
+    size_t sent = 0;            // Size of the sent responses
+    bool is_writing = false;    // Whether it waits for sending
+};
+
+// Shard of the map, it is served by its own thread without locking
+struct shard
+{
+    size_t index;                               // Index of the shard
+    size_t count_shards;                        // Count of the shards
+    int listen_fd;                              // Listening socket
+    HashMap<std::string, std::string> map;      // Keys of the shard
+    std::string key;                            // Buffer of the keys
+    uint64_t count_requests = 0;                // Count of the requests
+    uint64_t count_connections = 0;             // Count of the connections
+};
+
+
+// Size of the input buffer of the connection
+const size_t INPUT_SIZE = 64 * 1024;
+// Maximum count of the events handled at once
+const int MAX_EVENTS = 64;
+// Interval of checking the stop flag in ms
+const int STOP_CHECK_MS = 100;
+
+// Whether the server is stopped by the signal
+volatile std::sig_atomic_t is_stopped = 0;
+
+
+// Sets the stop flag
+void stop_handler(int);
+// Runs the event loop of the shard
+void run_shard(shard& _shard);
+// Accepts the pending connections
+void accept_connections(shard& _shard, int _epoll_fd,
+    std::vector<std::unique_ptr<connection>>& _connections);
+// Reads and executes the requests of the connection, returns false if it
+// is closed
+bool read_requests(shard& _shard, int _fd, connection& _conn);
+// Executes the request and appends the response
+void execute(shard& _shard, const kv_request& _request, std::string& _out);
+// Sends the responses of the connection, returns false if it is closed
+bool send_responses(int _fd, connection& _conn);
+
+
+// Every shard owns the keys mapped to it by kv_shard_of and is served by
+// its own thread with its own epoll loop and listening socket, so the map
+// needs no locks. The clients connect to all the shards and send a request
+// to the shard of its key
+int main(int argc, char* argv[])
+{
+    std::string address = argc > 1 ? argv[1] : "unix:/tmp/kv_server.sock";
+    size_t count_shards = argc > 2 ? std::strtoul(argv[2], nullptr, 10) :
+        std::thread::hardware_concurrency();
+
+    if (count_shards == 0)
+        count_shards = 1;
+
+    std::vector<std::unique_ptr<shard>> shards;
+    std::vector<std::thread> threads;
+
+    try
+    {
+        kv_address addr(address);
+
+        for (size_t i = 0; i < count_shards; i++)
+        {
+            shards.emplace_back(new shard);
+            shards[i]->index = i;
+            shards[i]->count_shards = count_shards;
+            shards[i]->listen_fd = addr.listen(i);
+        }
+
+        std::signal(SIGINT, stop_handler);
+        std::signal(SIGTERM, stop_handler);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::cout << "Serving " << count_shards << " shards on " << address
+            << ", press Ctrl+C to stop." << std::endl;
+
+        unsigned count_cores = std::thread::hardware_concurrency();
+
+        for (size_t i = 0; i < count_shards; i++)
+        {
+            threads.emplace_back(run_shard, std::ref(*shards[i]));
+
+            // One shard per core, the pinning is optional
+            if (count_cores != 0)
+            {
+                cpu_set_t cpus;
+                CPU_ZERO(&cpus);
+                CPU_SET(i % count_cores, &cpus);
+                pthread_setaffinity_np(threads[i].native_handle(),
+                    sizeof(cpus), &cpus);
+            }
+        }
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (const std::unique_ptr<shard>& sh : shards)
+        {
+            std::cout << "Shard " << sh->index << ": " << sh->map.size()
+                << " keys, " << sh->count_requests << " requests, "
+                << sh->count_connections << " connections." << std::endl;
+
+            ::close(sh->listen_fd);
+
+            if (addr.is_unix)
+                ::unlink(addr.shard_path(sh->index).c_str());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Usage: kv_server [unix:<path> | tcp:<port>] "
+            << "[count of shards]" << std::endl;
+
+        is_stopped = 1;
+        for (std::thread& thread : threads)
+            thread.join();
+
+        return 1;
+    }
+
+    return 0;
+}
+
+
+void stop_handler(int)
+{
+    is_stopped = 1;
+}
+
+void run_shard(shard& _shard)
+{
+    int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+
+    if (epoll_fd < 0)
+    {
+        std::cerr << "Error: failed to create epoll of the shard "
+            << _shard.index << std::endl;
+        return;
+    }
+
+    ::fcntl(_shard.listen_fd, F_SETFL,
+        ::fcntl(_shard.listen_fd, F_GETFL) | O_NONBLOCK);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = _shard.listen_fd;
+    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _shard.listen_fd, &event);
+
+    // The connections are indexed by their descriptors
+    std::vector<std::unique_ptr<connection>> connections;
+    epoll_event events[MAX_EVENTS];
+
+    while (!is_stopped)
+    {
+        int count = ::epoll_wait(epoll_fd, events, MAX_EVENTS,
+            STOP_CHECK_MS);
+
+        for (int i = 0; i < count; i++)
+        {
+            int fd = events[i].data.fd;
+
+            if (fd == _shard.listen_fd)
+            {
+                accept_connections(_shard, epoll_fd, connections);
+                continue;
+            }
+
+            connection& conn = *connections[fd];
+            bool is_open = true;
+
+            if (events[i].events & EPOLLOUT)
+                is_open = send_responses(fd, conn);
+
+            // The requests are not read while the responses are pending,
+            // so the slow client does not make the server buffer them
+            if (is_open && conn.sent == conn.output.size() &&
+                (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                is_open = read_requests(_shard, fd, conn);
+
+            if (!is_open)
+            {
+                ::close(fd);
+                connections[fd].reset();
+                continue;
+            }
+
+            // The events are changed only when the output gets pending or
+            // drained, the most batches are sent at once
+            bool is_writing = conn.sent != conn.output.size();
+
+            if (is_writing != conn.is_writing)
+            {
+                conn.is_writing = is_writing;
+                event.events = is_writing ? EPOLLOUT : EPOLLIN;
+                event.data.fd = fd;
+                ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+            }
+        }
+    }
+
+    for (size_t fd = 0; fd < connections.size(); fd++)
+        if (connections[fd])
+            ::close(fd);
+
+    ::close(epoll_fd);
+}
+
+void accept_connections(shard& _shard, int _epoll_fd,
+    std::vector<std::unique_ptr<connection>>& _connections)
+{
+    while (true)
+    {
+        int fd = ::accept4(_shard.listen_fd, nullptr, nullptr,
+            SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd < 0)
+            return;
+
+        if (size_t(fd) >= _connections.size())
+            _connections.resize(fd + 1);
+
+        _connections[fd].reset(new connection);
+        _connections[fd]->input.resize(INPUT_SIZE);
+        _shard.count_connections++;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+bool read_requests(shard& _shard, int _fd, connection& _conn)
+{
+    // The parsed data is dropped and the buffer grows only for the request
+    // larger than it
+    if (_conn.begin != 0)
+    {
+        std::copy(_conn.input.begin() + _conn.begin,
+            _conn.input.begin() + _conn.end, _conn.input.begin());
+        _conn.end -= _conn.begin;
+        _conn.begin = 0;
+    }
+
+    if (_conn.end == _conn.input.size())
+        _conn.input.resize(_conn.input.size() * 2);
+
+    ssize_t size = ::read(_fd, _conn.input.data() + _conn.end,
+        _conn.input.size() - _conn.end);
+
+    if (size == 0)
+        return false;
+
+    if (size < 0)
+        return errno == EAGAIN || errno == EINTR;
+
+    _conn.end += size;
+    _conn.output.clear();
+    _conn.sent = 0;
+
+    // All the pipelined requests are executed before sending the responses
+    // at once
+    try
+    {
+        kv_request request;
+        size_t used;
+
+        while ((used = kv_parse_request(_conn.input.data() + _conn.begin,
+            _conn.end - _conn.begin, request)) != 0)
+        {
+            execute(_shard, request, _conn.output);
+            _conn.begin += used;
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+
+    return send_responses(_fd, _conn);
+}
+
+void execute(shard& _shard, const kv_request& _request, std::string& _out)
+{
+    _shard.count_requests++;
+
+    if (_request.op == KV_INFO)
+    {
+        uint32_t count = _shard.count_shards;
+        kv_append_response(_out, KV_OK, reinterpret_cast<const char*>(&count),
+            sizeof(count));
+        return;
+    }
+
+    if (kv_shard_of(_request.key, _request.key_size, _shard.count_shards) !=
+        _shard.index)
+    {
+        kv_append_response(_out, KV_WRONG_SHARD);
+        return;
+    }
+
+    // The key buffer keeps its capacity, so the lookup does not allocate
+    _shard.key.assign(_request.key, _request.key_size);
+
+    switch (_request.op)
+    {
+    case KV_GET:
+    {
+        auto iter = _shard.map.find(_shard.key);
+
+        if (iter == _shard.map.end())
+            kv_append_response(_out, KV_NOT_FOUND);
+        else
+            kv_append_response(_out, KV_OK, (*iter).second.data(),
+                (*iter).second.size());
+        break;
+    }
+    case KV_SET:
+        _shard.map[_shard.key].assign(_request.value, _request.value_size);
+        kv_append_response(_out, KV_OK);
+        break;
+    case KV_DEL:
+        kv_append_response(_out, _shard.map.erase(_shard.key) != 0 ? KV_OK :
+            KV_NOT_FOUND);
+        break;
+    }
+}
+
+bool send_responses(int _fd, connection& _conn)
+{
+    while (_conn.sent < _conn.output.size())
+    {
+        ssize_t size = ::send(_fd, _conn.output.data() + _conn.sent,
+            _conn.output.size() - _conn.sent, MSG_NOSIGNAL);
+
+        if (size < 0)
+            return errno == EAGAIN || errno == EINTR;
+
+        _conn.sent += size;
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+// bloom_filter_test.cpp
+
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include <BloomFilter.hpp>
+
+#include "test.hpp"
+
+
+// The added hash values are always passed, the absent ones are mostly
+// rejected. The hash values are consecutive, like the hashes of integers
+void test_no_false_negatives()
+{
+    const size_t COUNT_KEYS = 10000;
+
+    BlockedBloomFilter filter;
+    CHECK(!filter.enabled() && filter.may_contain(1));
+
+    filter.enable();
+    filter.reset(COUNT_KEYS);
+    CHECK(filter.enabled() && filter.count_blocks() > 0);
+
+    for (size_t hash = 0; hash < COUNT_KEYS; hash++)
+        filter.add(hash);
+    for (size_t hash = 0; hash < COUNT_KEYS; hash++)
+        CHECK(filter.may_contain(hash));
+
+    size_t count_passed = 0;
+    for (size_t hash = COUNT_KEYS; hash < COUNT_KEYS * 11; hash++)
+        count_passed += filter.may_contain(hash);
+    CHECK(count_passed < COUNT_KEYS * 10 / 20);
+
+    // The copies and the moved filters keep the blocks
+    BlockedBloomFilter copy(filter);
+    BlockedBloomFilter moved(std::move(filter));
+    for (size_t hash = 0; hash < COUNT_KEYS; hash++)
+        CHECK(copy.may_contain(hash) && moved.may_contain(hash));
+
+    moved.disable();
+    CHECK(!moved.enabled() && moved.count_blocks() == 0);
+    CHECK(moved.may_contain(COUNT_KEYS * 100));
+}
+
+// The counters are updated only if it is requested, the false positives
+// are noted by the container, which has not found the passed key
+void test_stats()
+{
+    BlockedBloomFilter filter;
+    filter.enable(10.0f, true);
+    filter.reset(100);
+
+    for (size_t hash = 0; hash < 100; hash++)
+        filter.add(hash);
+
+    size_t count_passed = 0;
+    for (size_t hash = 0; hash < 1100; hash++)
+        if (filter.may_contain(hash) && hash >= 100)
+        {
+            filter.note_false_positive();
+            count_passed++;
+        }
+
+    BlockedBloomFilter::stats_t stats = filter.stats();
+    CHECK(stats.lookups == 1100);
+    CHECK(stats.false_positives == count_passed);
+    CHECK(stats.negatives + stats.false_positives == 1000);
+    CHECK(stats.false_positive_rate() == count_passed / 1000.0);
+
+    filter.reset_stats();
+    stats = filter.stats();
+    CHECK(stats.lookups == 0 && stats.false_positive_rate() == 0.0);
+
+    BlockedBloomFilter silent;
+    silent.enable(10.0f, false);
+    silent.reset(100);
+    silent.may_contain(1);
+    silent.note_false_positive();
+    CHECK(silent.stats().lookups == 0);
+    CHECK(silent.stats().false_positives == 0);
+}
+
+
+int main()
+{
+    test_no_false_negatives();
+    test_stats();
+
+    return test_result("bloom_filter_test");
+}
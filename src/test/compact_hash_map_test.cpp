@@ -0,0 +1,53 @@
+// compact_hash_map_test.cpp
+
+#include <string>
+#include <utility>
+
+#include <CompactHashMap.hpp>
+
+#include "test.hpp"
+
+
+// The moved-from container is valid and empty, it keeps a bucket for the
+// next insertions
+void test_moved_from()
+{
+    using map_t = CompactHashMap<int, std::string>;
+
+    check_moved_from<map_t>();
+
+    map_t source, target;
+    source[1] = "1";
+    target = std::move(source);
+    CHECK(source.buckets_count() >= 1 && target.at(1) == "1");
+}
+
+// The prehashed key carries the hash value without the seed, so the hash
+// value computed by the caller is accepted and the handle survives reseeding
+void test_hashed_key()
+{
+    CompactHashMap<std::string, int> map;
+    std::string key = "key";
+    CompactHashMap<std::string, int>::hashed_key hkey(key,
+        hash<std::string>()(key));
+
+    CHECK(map.insert(hkey, 1).second);
+    map[key] = 2;
+    CHECK(map.size() == 1);
+    CHECK(map[hkey] == 2);
+
+    map.reseed(map.seed() + 1);
+    CHECK(map.at(hkey) == 2);
+    CHECK(map.bucket(hkey) == map.bucket(key));
+    CHECK(map.erase(key) == 1);
+    CHECK(map.empty());
+}
+
+
+int main()
+{
+    test_moved_from();
+    test_hashed_key();
+
+    return test_result("compact_hash_map_test");
+}
@@ -0,0 +1,109 @@
+// cuckoo_hash_map_test.cpp
+
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+
+#include <CuckooHashMap.hpp>
+
+#include "test.hpp"
+
+
+// Hasher, which maps all the keys to the same hash value
+struct colliding_hash
+{
+    size_t operator()(int) const noexcept { return 42; }
+};
+
+
+// The keys with equal hash values go to the stash instead of growing the
+// table, the full stash throws
+template <size_t _Ways>
+void test_colliding_keys()
+{
+    using map_t = CuckooHashMap<int, int, colliding_hash, std::equal_to<int>,
+        std::allocator<std::pair<const int, int>>, _Ways>;
+
+    map_t map;
+    int count = 0;
+
+    try
+    {
+        for (; count < 1000; count++)
+            map[count] = count;
+    }
+    catch (const std::length_error&)
+    {}
+
+    // Two buckets and the stash hold the colliding keys
+    CHECK(count >= int(2 * _Ways) && count < 1000);
+    CHECK(map.size() == size_t(count));
+    CHECK(map.buckets_count() <= 64);
+
+    for (int i = 0; i < count; i++)
+        CHECK(map.count(i) == 1 && map.at(i) == i);
+
+    // The stashed keys are erased and found again
+    CHECK(map.erase(count - 1) == 1);
+    CHECK(map.count(count - 1) == 0);
+    map[count - 1] = 0;
+    CHECK(map.size() == size_t(count));
+}
+
+// The node handles, the merges and the erasures of the ranges
+void test_node_operations()
+{
+    using map_t = CuckooHashMap<int, std::string>;
+
+    map_t map, other;
+    for (int i = 0; i < 100; i++)
+        map[i] = std::to_string(i);
+    for (int i = 50; i < 150; i++)
+        other[i] = "other";
+
+    auto node = map.extract(7);
+    CHECK(!node.empty() && node.key() == 7 && node.mapped() == "7");
+    CHECK(map.count(7) == 0 && map.size() == 99);
+    CHECK(map.extract(7).empty());
+
+    auto result = other.insert(std::move(node));
+    CHECK(result.inserted && result.node.empty());
+    CHECK(other.at(7) == "7");
+
+    map.merge(other);
+    CHECK(map.size() == 150);
+    CHECK(map.at(50) == "50" && map.at(149) == "other");
+    CHECK(other.size() == 50 && other.at(50) == "other");
+
+    map_t sums;
+    sums[1] = "a";
+    map_t more;
+    more[1] = "b";
+    more[2] = "c";
+    sums.merge(more, [](const std::string& _a, std::string&& _b)
+        { return _a + _b; });
+    CHECK(sums.size() == 2 && sums.at(1) == "ab" && more.empty());
+
+    CHECK(map.erase_if([](const std::pair<const int, std::string>& _val)
+        { return _val.first % 2 == 0; }) == 75);
+    CHECK(map.size() == 75 && map.count(2) == 0 && map.count(3) == 1);
+
+    map.erase(map.begin(), map.end());
+    CHECK(map.empty() && map.begin() == map.end());
+}
+
+// The moved-from container is valid and empty
+void test_moved_from() { check_moved_from<CuckooHashMap<int, int>>(); }
+
+
+int main()
+{
+    test_colliding_keys<1>();
+    test_colliding_keys<4>();
+    test_colliding_keys<8>();
+    test_node_operations();
+    test_moved_from();
+
+    return test_result("cuckoo_hash_map_test");
+}
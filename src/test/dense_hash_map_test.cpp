@@ -0,0 +1,27 @@
+// dense_hash_map_test.cpp
+
+#include <string>
+#include <utility>
+
+#include <DenseHashMap.hpp>
+
+#include "test.hpp"
+
+
+// The moved-from container is valid and empty
+template <class _Layout>
+void test_moved_from()
+{
+    check_moved_from<DenseHashMap<int, std::string, hash<int>,
+        std::equal_to<int>, std::allocator<std::pair<const int, std::string>>,
+        _Layout>>();
+}
+
+
+int main()
+{
+    test_moved_from<dense_layout>();
+    test_moved_from<split_layout>();
+
+    return test_result("dense_hash_map_test");
+}
@@ -0,0 +1,113 @@
+// disk_hash_map_test.cpp
+
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#include <DiskHashMap.hpp>
+
+#include "test.hpp"
+
+
+// Hasher, which maps all the keys to the same hash value
+struct colliding_hash
+{
+    size_t operator()(uint64_t) const noexcept { return 42; }
+};
+
+
+// The keys with equal hash values throw instead of doubling the directory
+// up to the max depth
+void test_colliding_keys(const std::string& _path)
+{
+    using map_t = DiskHashMap<uint64_t, uint64_t, colliding_hash>;
+
+    std::remove(_path.c_str());
+    {
+        // The page holds 3 entries
+        map_t map(_path, 16, 64);
+        size_t count = 0;
+
+        try
+        {
+            for (; count < 100; count++)
+                map.insert(std::make_pair(count, count));
+        }
+        catch (const std::length_error&)
+        {}
+
+        CHECK(count == map.page_capacity());
+        CHECK(map.size() == count);
+        CHECK(map.depth() == 0);
+
+        for (uint64_t i = 0; i < count; i++)
+            CHECK(map.at(i) == i);
+    }
+    std::remove(_path.c_str());
+}
+
+// The keys with the distinct hash values split the small pages as usual
+void test_small_pages(const std::string& _path)
+{
+    const uint64_t COUNT_KEYS = 10000;
+
+    std::remove(_path.c_str());
+    {
+        DiskHashMap<uint64_t, uint64_t> map(_path, 16, 64);
+
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            map.insert(std::make_pair(i, i * 2));
+
+        CHECK(map.size() == COUNT_KEYS);
+        CHECK(map.depth() < 20);
+
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            CHECK(map.at(i) == i * 2);
+    }
+    std::remove(_path.c_str());
+}
+
+// The reopened file keeps the entries, the erasures and the directory of
+// the map
+void test_reopen(const std::string& _path)
+{
+    const uint64_t COUNT_KEYS = 5000;
+    size_t depth = 0;
+
+    std::remove(_path.c_str());
+    {
+        DiskHashMap<uint64_t, uint64_t> map(_path, 16, 256);
+
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            map.insert(std::make_pair(i, i + 1));
+        for (uint64_t i = 0; i < COUNT_KEYS; i += 2)
+            map.erase(i);
+
+        depth = map.depth();
+    }
+    {
+        DiskHashMap<uint64_t, uint64_t> map(_path, 16, 256);
+
+        CHECK(map.size() == COUNT_KEYS / 2);
+        CHECK(map.depth() == depth);
+        CHECK(map.count(0) == 0 && map.at(1) == 2);
+
+        for (uint64_t i = 1; i < COUNT_KEYS; i += 2)
+            CHECK(map.at(i) == i + 1);
+    }
+    std::remove(_path.c_str());
+}
+
+
+int main()
+{
+    std::string path = "disk_hash_map_test.db";
+
+    test_colliding_keys(path);
+    test_small_pages(path);
+    test_reopen(path);
+
+    return test_result("disk_hash_map_test");
+}
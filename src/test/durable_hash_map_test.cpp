@@ -0,0 +1,229 @@
+// durable_hash_map_test.cpp
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+#include <DurableHashMap.hpp>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "test.hpp"
+
+
+using map_t = DurableHashMap<uint64_t, uint64_t>;
+
+
+// Removes the log and the snapshot of the map
+void remove_files(const std::string& _path)
+{
+    std::remove(_path.c_str());
+    std::remove((_path + ".snap").c_str());
+}
+
+// The assignments and the erasures are replayed from the log
+void test_replay(const std::string& _path)
+{
+    remove_files(_path);
+    {
+        map_t map(_path);
+
+        for (uint64_t i = 0; i < 100; i++)
+            map.insert_or_assign(i, i * 3);
+        for (uint64_t i = 0; i < 100; i += 2)
+            map.erase(i);
+    }
+    {
+        map_t map(_path);
+
+        CHECK(map.size() == 50);
+        for (uint64_t i = 1; i < 100; i += 2)
+            CHECK(map.at(i) == i * 3);
+        CHECK(map.count(0) == 0);
+    }
+    remove_files(_path);
+}
+
+// The checksum of the empty snapshot is the offset basis of FNV-1a, not
+// the zero
+void test_snapshot_checksum(const std::string& _path)
+{
+    remove_files(_path);
+    {
+        map_t map(_path);
+
+        map.snapshot();
+    }
+
+    std::ifstream file(_path + ".snap", std::ios::binary);
+    uint64_t checksum = 0;
+
+    file.seekg(-int(sizeof(checksum)), std::ios::end);
+    file.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+
+    CHECK(file.good());
+    CHECK(checksum == uint64_t(__hash_impl::FNV::INITIAL_SEED));
+
+    file.close();
+    {
+        map_t map(_path);
+
+        CHECK(map.empty());
+    }
+    remove_files(_path);
+}
+
+// The table restored from the snapshot is sized for its elements, not for
+// the reassignments of them in the log
+void test_snapshot_reserve(const std::string& _path)
+{
+    const uint64_t COUNT_KEYS = 1000;
+
+    remove_files(_path);
+    {
+        map_t map(_path);
+
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            map.insert_or_assign(i, i);
+        map.snapshot();
+
+        for (uint64_t n = 1; n <= 8; n++)
+            for (uint64_t i = 0; i < COUNT_KEYS; i++)
+                map.insert_or_assign(i, i + n);
+    }
+    {
+        map_t map(_path);
+        HashMap<uint64_t, uint64_t> sized;
+
+        sized.reverse(COUNT_KEYS);
+
+        CHECK(map.size() == COUNT_KEYS);
+        CHECK(map.at(7) == 15);
+        CHECK(map.map().buckets_count() == sized.buckets_count());
+    }
+    remove_files(_path);
+}
+
+// The torn record at the end of the log is truncated
+void test_torn_record(const std::string& _path)
+{
+    remove_files(_path);
+    {
+        map_t map(_path);
+
+        map.insert_or_assign(1, 10);
+        map.insert_or_assign(2, 20);
+    }
+    {
+        std::ofstream file(_path, std::ios::binary | std::ios::app);
+
+        file.write("\0\0\0\0\0\0\0", 7);
+    }
+    {
+        map_t map(_path);
+
+        CHECK(map.size() == 2);
+        CHECK(map.at(2) == 20);
+
+        map.insert_or_assign(3, 30);
+    }
+    {
+        map_t map(_path);
+
+        CHECK(map.size() == 3);
+        CHECK(map.at(3) == 30);
+    }
+    remove_files(_path);
+}
+
+
+// The records made durable by sync() survive the exit of the process
+// without the destructor of the map, the burst of the records is written
+// by fewer batches
+void test_sync(const std::string& _path)
+{
+    const uint64_t COUNT_KEYS = 10000;
+
+    remove_files(_path);
+
+    std::cout.flush();
+    pid_t pid = ::fork();
+
+    if (pid == 0)
+    {
+        map_t map(_path, std::chrono::milliseconds(10));
+
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            map.insert_or_assign(i, i + 1);
+        map.sync();
+
+        map_t::stats_t stats = map.stats();
+        CHECK(stats.records == COUNT_KEYS);
+        CHECK(stats.batches > 0 && stats.batches < stats.records);
+
+        ::_exit(count_failures == 0 ? 0 : 1);
+    }
+
+    int status = 0;
+    CHECK(pid > 0 && ::waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    {
+        map_t map(_path);
+
+        CHECK(map.size() == COUNT_KEYS);
+        for (uint64_t i = 0; i < COUNT_KEYS; i++)
+            CHECK(map.at(i) == i + 1);
+    }
+    remove_files(_path);
+}
+
+// The assignment to the proxy of the absent element appends the single
+// record, the reading of it inserts the default mapped value
+void test_subscript(const std::string& _path)
+{
+    remove_files(_path);
+    {
+        map_t map(_path);
+
+        map[1] = 10;
+        CHECK(map.stats().records == 1 && map.at(1) == 10);
+
+        map[1] = 11;
+        CHECK(map.stats().records == 2 && map.at(1) == 11);
+
+        uint64_t data = map[2];
+        CHECK(data == 0 && map.count(2) == 1);
+        CHECK(map.stats().records == 3);
+
+        map[3] = map[1];
+        CHECK(map.at(3) == 11 && map.stats().records == 4);
+    }
+    {
+        map_t map(_path);
+
+        CHECK(map.size() == 3);
+        CHECK(map.at(1) == 11 && map.at(2) == 0 && map.at(3) == 11);
+    }
+    remove_files(_path);
+}
+
+
+int main()
+{
+    std::string path = "durable_hash_map_test.log";
+
+    test_replay(path);
+    test_snapshot_checksum(path);
+    test_snapshot_reserve(path);
+    test_torn_record(path);
+    test_sync(path);
+    test_subscript(path);
+
+    return test_result("durable_hash_map_test");
+}
@@ -0,0 +1,487 @@
+// hash_map_test.cpp
+
+#include <string>
+#include <set>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <alloc/memory_resource.hpp>
+
+#include "test.hpp"
+
+
+// Memory resource, which counts its blocks and the blocks released through
+// it but allocated by other resource
+class counting_resource: public memory_resource
+{
+private:
+    std::set<void*> _m_blocks;      // Allocated blocks
+    size_t _m_count_foreign;        // Count of the foreign blocks released
+
+protected:
+    void* do_allocate(size_t _bytes, size_t _alignment) override
+    {
+        void* ptr = new_delete_resource()->allocate(_bytes, _alignment);
+        _m_blocks.insert(ptr);
+
+        return ptr;
+    }
+
+    void do_deallocate(void* _ptr, size_t _bytes, size_t _alignment) override
+    {
+        if (_m_blocks.erase(_ptr) == 0)
+            _m_count_foreign++;
+
+        new_delete_resource()->deallocate(_ptr, _bytes, _alignment);
+    }
+
+public:
+    counting_resource():
+        _m_count_foreign{0}
+    {}
+
+    size_t count_blocks() const noexcept { return _m_blocks.size(); }
+    size_t count_foreign() const noexcept { return _m_count_foreign; }
+};
+
+
+// The prehashed key finds the same element as the key itself
+void test_hashed_key()
+{
+    HashMap<std::string, int> map;
+    std::string key = "key";
+
+    auto hkey = map.hash_key(key);
+    map[hkey] = 1;
+
+    CHECK(map.count(key) == 1);
+    CHECK(map.find(hkey) == map.find(key));
+    CHECK(map.bucket(hkey) == map.bucket(key));
+    CHECK(map[key] == 1);
+    CHECK(map.erase(hkey) == 1);
+    CHECK(map.empty());
+
+    // The hash value computed by the caller with the hasher of the
+    // container is accepted as well
+    std::string other = "other";
+    HashMap<std::string, int>::hashed_key upstream(other,
+        hash<std::string>()(other));
+
+    CHECK(map.insert(upstream, 1).second);
+    map[other] = 2;
+    CHECK(map.size() == 1);
+    CHECK(map[upstream] == 2);
+    CHECK(map.bucket(upstream) == map.bucket(other));
+    CHECK(map.erase(other) == 1);
+    CHECK(map.empty());
+
+    // The handle remains valid after reseeding
+    map[hkey] = 3;
+    map.reseed(map.seed() + 1);
+    CHECK(map.find(hkey) != map.end());
+    CHECK(map.at(hkey) == 3);
+    map[key] = 4;
+    CHECK(map.size() == 1);
+    CHECK(map.extract(hkey).mapped() == 4);
+    CHECK(map.empty());
+}
+
+// The buckets reserved for the elements are kept by the insertions, only
+// the erasures make the container sparse
+template <class _Policy>
+void test_reserve_retention()
+{
+    using map_t = HashMap<uint64_t, uint64_t, hash<uint64_t>,
+        std::equal_to<uint64_t>,
+        std::allocator<std::pair<const uint64_t, uint64_t>>, _Policy>;
+
+    map_t map;
+    map.min_load_factor(0.5f);
+    map.reverse(100000);
+
+    size_t count_buckets = map.buckets_count();
+    CHECK(count_buckets >= 100000 / map.max_load_factor());
+
+    map[1] = 1;
+    CHECK(map.buckets_count() == count_buckets);
+
+    map_t sized(100000);
+    sized.min_load_factor(0.5f);
+    sized[1] = 1;
+    CHECK(sized.buckets_count() >= 100000);
+
+    // After the erasures the sparse container shrinks on the insertion
+    for (uint64_t i = 0; i < 1000; i++)
+        map[i] = i;
+    for (uint64_t i = 0; i < 900; i++)
+        map.erase(i);
+
+    map[5000] = 5000;
+    CHECK(map.buckets_count() < count_buckets);
+    CHECK(map.size() == 101);
+}
+
+// The low memory policy shrinks by default, but only the erasures make the
+// container sparse
+void test_low_memory_policy()
+{
+    using map_t = HashMap<uint64_t, uint64_t, hash<uint64_t>,
+        std::equal_to<uint64_t>,
+        std::allocator<std::pair<const uint64_t, uint64_t>>,
+        LowMemoryRehashPolicy>;
+
+    map_t map;
+    CHECK(map.min_load_factor() ==
+        float(LowMemoryRehashPolicy::DEFAULT_MIN_LOAD_FACTOR));
+
+    map.reverse(100000);
+    size_t count_buckets = map.buckets_count();
+
+    for (uint64_t i = 0; i < 100; i++)
+        map[i] = i;
+
+    CHECK(map.buckets_count() == count_buckets);
+
+    map_t other;
+    for (uint64_t i = 100; i < 200; i++)
+        other[i] = i;
+
+    map.merge(other);
+    CHECK(map.size() == 200);
+    CHECK(map.buckets_count() == count_buckets);
+}
+
+// The allocator is not replaced by the assignments, so the nodes are
+// released by the resource they were allocated from
+void test_allocator_propagation()
+{
+    using map_t = HashMap<int, std::string, hash<int>, std::equal_to<int>,
+        polymorphic_allocator<std::pair<const int, std::string>>>;
+
+    counting_resource first, second;
+    {
+        map_t source(&first), target(&second);
+
+        for (int i = 0; i < 100; i++)
+            source[i] = std::to_string(i);
+
+        target = source;
+        CHECK(target.get_allocator().resource() == &second);
+        CHECK(target.size() == 100 && target.at(42) == "42");
+
+        // The rehashing relinks the nodes to the buckets of the target
+        target.reverse(1000);
+        CHECK(target.size() == 100);
+
+        map_t moved(&second);
+        moved = std::move(source);
+        CHECK(moved.get_allocator().resource() == &second);
+        CHECK(moved.size() == 100 && moved.at(7) == "7");
+
+        moved.rehash(1000);
+        moved.clear();
+        target = std::move(moved);
+        CHECK(target.empty());
+    }
+
+    CHECK(first.count_blocks() == 0 && first.count_foreign() == 0);
+    CHECK(second.count_blocks() == 0 && second.count_foreign() == 0);
+}
+
+// The moved-from container is valid and empty, the one left without the
+// buckets handles the erasures and the extraction as well
+void test_moved_from()
+{
+    using map_t = HashMap<int, std::string>;
+
+    check_moved_from<map_t>();
+
+    map_t source;
+    source[42] = "42";
+
+    map_t target(std::move(source));
+    CHECK(source.erase(42) == 0 && source.extract(42).empty());
+    CHECK(source.load_factor() == 0 && target.at(42) == "42");
+
+    size_t count = 0;
+    for (auto& item : source)
+        count += item.first;
+    CHECK(count == 0);
+
+    // The moves allocate nothing, the source gets its buckets by the next
+    // insertion
+    static_assert(std::is_nothrow_move_constructible<map_t>::value,
+        "the move constructor must not throw");
+    static_assert(std::is_nothrow_move_assignable<map_t>::value,
+        "the move assignment must not throw");
+
+    using pmr_map_t = HashMap<int, int, hash<int>, std::equal_to<int>,
+        polymorphic_allocator<std::pair<const int, int>>>;
+
+    counting_resource resource;
+    pmr_map_t pmr_source(&resource);
+    for (int i = 0; i < 100; i++)
+        pmr_source[i] = i;
+
+    size_t count_blocks = resource.count_blocks();
+    pmr_map_t pmr_target(std::move(pmr_source));
+    CHECK(resource.count_blocks() == count_blocks);
+    pmr_source = std::move(pmr_target);
+    CHECK(resource.count_blocks() == count_blocks);
+    CHECK(pmr_target.buckets_count() == 0 && pmr_source.size() == 100);
+
+    pmr_target[1] = 1;
+    CHECK(pmr_target.size() == 1 && pmr_target.at(1) == 1);
+}
+
+// The extracted nodes are relinked by the insertion without reallocation
+// if the allocators are equal, the handle of the node, whose key is already
+// in the map, is returned back
+void test_node_operations()
+{
+    using map_t = HashMap<int, std::string, hash<int>, std::equal_to<int>,
+        polymorphic_allocator<std::pair<const int, std::string>>>;
+
+    counting_resource first, second;
+    {
+        map_t source(&first), target(&first);
+
+        for (int i = 0; i < 100; i++)
+            source[i] = std::to_string(i);
+        target.reverse(100);
+
+        size_t count_blocks = first.count_blocks();
+
+        map_t::node_type node = source.extract(10);
+        CHECK(node && node.key() == 10 && node.mapped() == "10");
+        CHECK(source.size() == 99 && source.count(10) == 0);
+        CHECK(!source.extract(10) && source.extract(1000).empty());
+
+        const std::pair<const int, std::string>* element = &node.value();
+        map_t::insert_return_type result = target.insert(std::move(node));
+        CHECK(result.inserted && result.node.empty());
+        CHECK(&*result.position == element && target.at(10) == "10");
+        CHECK(first.count_blocks() == count_blocks);
+
+        // The extraction by the iterators
+        node = source.extract(source.find(20));
+        CHECK(node.key() == 20 && source.size() == 98);
+        map_t::node_type other
+            = source.extract(map_t::const_iterator(source.find(30)));
+        CHECK(other.key() == 30 && source.count(30) == 0);
+
+        // The node with the present key is returned to the caller
+        target[20] = "t";
+        result = target.insert(std::move(node));
+        CHECK(!result.inserted && result.node.mapped() == "20");
+        CHECK((*result.position).second == "t" && target.size() == 2);
+
+        result = target.insert(map_t::node_type());
+        CHECK(!result.inserted && result.position == target.end());
+
+        // The node of the other allocator is moved into the new node, the
+        // node handle outlives the map it was extracted from
+        {
+            map_t foreign(&second);
+            foreign.reseed(source.seed() + 1);
+
+            result = foreign.insert(std::move(other));
+            CHECK(result.inserted && foreign.at(30) == "30");
+            CHECK(second.count_blocks() > 0);
+
+            node = foreign.extract(30);
+        }
+
+        result = source.insert(std::move(node));
+        CHECK(result.inserted && source.at(30) == "30");
+        CHECK(source.size() == 98);
+    }
+
+    CHECK(first.count_blocks() == 0 && first.count_foreign() == 0);
+    CHECK(second.count_blocks() == 0 && second.count_foreign() == 0);
+}
+
+// The erasure by the iterator returns the next one, so the elements can be
+// erased while iterating, the range erasure stops at the last iterator
+void test_erase()
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; i++)
+        map[i] = i;
+
+    size_t count_visited = 0;
+    for (auto iter = map.begin(); iter != map.end(); count_visited++)
+        if ((*iter).first % 2 == 0)
+            iter = map.erase(iter);
+        else
+            ++iter;
+
+    CHECK(count_visited == 1000 && map.size() == 500);
+    for (int i = 0; i < 1000; i++)
+        CHECK(map.count(i) == size_t(i % 2));
+
+    // The range in the middle of the iteration order
+    auto first = std::next(map.begin(), 100);
+    auto last = std::next(first, 200);
+    int last_key = (*last).first;
+
+    auto iter = map.erase(first, last);
+    CHECK(map.size() == 300 && iter != map.end());
+    CHECK((*iter).first == last_key && map.count(last_key) == 1);
+    CHECK(std::distance(map.begin(), iter) == 100);
+
+    CHECK(map.erase(iter, iter) == iter && map.size() == 300);
+    CHECK(map.erase(std::next(map.begin(), 250), map.end()) == map.end());
+    CHECK(map.size() == 250);
+    CHECK(map.erase(map.begin(), map.end()) == map.end() && map.empty());
+
+    // The sweep erases the elements of the predicate in a single pass
+    for (int i = 0; i < 10000; i++)
+        map[i] = i;
+
+    CHECK(map.erase_if([](const std::pair<const int, int>& _item)
+        { return _item.first % 3 == 0; }) == 3334);
+    CHECK(map.size() == 6666);
+    for (int i = 0; i < 10000; i++)
+        CHECK(map.count(i) == (i % 3 == 0 ? 0 : 1));
+
+    CHECK(map.erase_if([](const std::pair<const int, int>&)
+        { return false; }) == 0);
+    CHECK(map.erase(1) == 1 && map.erase(1) == 0 && map.size() == 6665);
+}
+
+// Both merges share the loop: the plain one leaves the elements with the
+// equal keys in the source, the combining one takes them, the nodes are
+// relinked for the equal allocators and moved otherwise
+void test_merge()
+{
+    using map_t = HashMap<int, std::string, hash<int>, std::equal_to<int>,
+        polymorphic_allocator<std::pair<const int, std::string>>>;
+
+    counting_resource first, second;
+    {
+        for (memory_resource* resource : { &first, &second })
+        {
+            map_t target(&first), source(resource);
+
+            for (int i = 0; i < 100; i++)
+                target[i] = "t";
+            for (int i = 50; i < 150; i++)
+                source[i] = "s";
+
+            map_t copy(source, resource);
+
+            target.merge(source);
+            CHECK(target.size() == 150 && source.size() == 50);
+            CHECK(target.at(60) == "t" && target.at(120) == "s");
+            CHECK(source.at(60) == "s" && source.count(120) == 0);
+
+            target.merge(copy, [](const std::string& _value,
+                std::string&& _other) { return _value + _other; });
+            CHECK(target.size() == 150 && copy.empty());
+            CHECK(target.at(60) == "ts" && target.at(120) == "ss");
+            CHECK(target.at(10) == "t");
+
+            target.merge(target);
+            CHECK(target.size() == 150);
+        }
+    }
+
+    CHECK(first.count_blocks() == 0 && first.count_foreign() == 0);
+    CHECK(second.count_blocks() == 0 && second.count_foreign() == 0);
+}
+
+
+// Checks that every key of the range is found in the map
+template <class _Map>
+bool contains_all(const _Map& _map, int _first, int _last)
+{
+    for (int i = _first; i < _last; i++)
+        if (_map.find(i) == _map.end())
+            return false;
+
+    return true;
+}
+
+// The filter never rejects the stored keys: it is updated by the
+// insertions and rebuilt by rehashing, reseeding and erase_if, the other
+// erasures leave the bits of the erased keys until rebuild_filter
+void test_filter()
+{
+    const int COUNT_KEYS = 10000;
+
+    HashMap<int, int> map;
+    map.enable_filter(10.0f, true);
+    CHECK(map.filter_enabled());
+
+    for (int i = 0; i < COUNT_KEYS; i++)
+        map[i] = i;
+    CHECK(contains_all(map, 0, COUNT_KEYS));
+
+    for (int i = 0; i < COUNT_KEYS; i += 2)
+        map.erase(i);
+    CHECK(map.count(0) == 0 && map.size() == COUNT_KEYS / 2);
+    for (int i = 1; i < COUNT_KEYS; i += 2)
+        CHECK(map.count(i) == 1);
+
+    // The growth rehashes the map and rebuilds the filter
+    size_t count_buckets = map.buckets_count();
+    for (int i = COUNT_KEYS; i < COUNT_KEYS * 4; i++)
+        map[i] = i;
+    CHECK(map.buckets_count() > count_buckets);
+    CHECK(contains_all(map, COUNT_KEYS, COUNT_KEYS * 4));
+
+    map.reseed(12345);
+    CHECK(contains_all(map, COUNT_KEYS, COUNT_KEYS * 4));
+
+    map.erase_if([](const std::pair<const int, int>& _item)
+        { return _item.first >= COUNT_KEYS * 3; });
+    map.rebuild_filter();
+    CHECK(contains_all(map, COUNT_KEYS, COUNT_KEYS * 3));
+    CHECK(map.size() == COUNT_KEYS / 2 + COUNT_KEYS * 2);
+
+    // Every absent key is either rejected or noted as the false positive
+    map.reset_filter_stats();
+    for (int i = COUNT_KEYS * 3; i < COUNT_KEYS * 13; i++)
+        CHECK(map.count(i) == 0);
+
+    BlockedBloomFilter::stats_t stats = map.filter_stats();
+    CHECK(stats.lookups == size_t(COUNT_KEYS) * 10);
+    CHECK(stats.negatives + stats.false_positives == stats.lookups);
+    CHECK(stats.false_positive_rate() < 0.05);
+
+    // The found keys are not counted as the false positives
+    map.reset_filter_stats();
+    CHECK(contains_all(map, COUNT_KEYS, COUNT_KEYS * 3));
+    stats = map.filter_stats();
+    CHECK(stats.lookups == size_t(COUNT_KEYS) * 2);
+    CHECK(stats.negatives == 0 && stats.false_positives == 0);
+
+    map.disable_filter();
+    CHECK(!map.filter_enabled());
+    CHECK(contains_all(map, COUNT_KEYS, COUNT_KEYS * 3));
+    CHECK(map.count(COUNT_KEYS * 3) == 0);
+    CHECK(map.filter_stats().lookups == size_t(COUNT_KEYS) * 2);
+}
+
+
+int main()
+{
+    test_hashed_key();
+    test_reserve_retention<DefaultRehashPolicy>();
+    test_reserve_retention<LowMemoryRehashPolicy>();
+    test_reserve_retention<LowLatencyRehashPolicy>();
+    test_low_memory_policy();
+    test_allocator_propagation();
+    test_moved_from();
+    test_node_operations();
+    test_erase();
+    test_merge();
+    test_filter();
+
+    return test_result("hash_map_test");
+}
@@ -0,0 +1,138 @@
+// hash_set_test.cpp
+
+#include <string>
+#include <set>
+#include <cstddef>
+
+#include <HashSet.hpp>
+
+#include "test.hpp"
+
+
+// Returns the set of the keys of the hash set
+template <class _Set>
+std::set<typename _Set::_key_t> keys_of(const _Set& _set)
+{
+    std::set<typename _Set::_key_t> keys;
+
+    for (const auto& key : _set)
+        keys.insert(key);
+
+    return keys;
+}
+
+// Returns the hash set with the keys of the range taken with the step
+HashSet<int> make_set(int _first, int _last, int _step = 1)
+{
+    HashSet<int> result;
+
+    for (int i = _first; i < _last; i += _step)
+        result.insert(i);
+
+    return result;
+}
+
+// The compound operations change the set in place, the keys of the other
+// set are looked up by their stored hash values if the seeds are equal and
+// hashed again otherwise
+void test_compound_operations()
+{
+    HashSet<int> evens = make_set(0, 1000, 2);
+    HashSet<int> threes = make_set(0, 1000, 3);
+    CHECK(evens.seed() != threes.seed());
+
+    for (bool is_same_seed : { false, true })
+    {
+        if (is_same_seed)
+            threes.reseed(evens.seed());
+
+        HashSet<int> united(evens);
+        united.unite(threes);
+        CHECK(united.size() == 500 + 334 - 167);
+        for (int i = 0; i < 1000; i++)
+            CHECK(united.contains(i) == (i % 2 == 0 || i % 3 == 0));
+
+        HashSet<int> common(evens);
+        common.intersect(threes);
+        CHECK(common.size() == 167);
+        for (int i = 0; i < 1000; i++)
+            CHECK(common.contains(i) == (i % 6 == 0));
+
+        HashSet<int> rest(evens);
+        rest.subtract(threes);
+        CHECK(rest.size() == 500 - 167);
+        for (int i = 0; i < 1000; i++)
+            CHECK(rest.contains(i) == (i % 2 == 0 && i % 3 != 0));
+
+        // The operators are the same operations
+        HashSet<int> other(evens);
+        CHECK(keys_of(other |= threes) == keys_of(united));
+        other = evens;
+        CHECK(keys_of(other &= threes) == keys_of(common));
+        other = evens;
+        CHECK(keys_of(other -= threes) == keys_of(rest));
+    }
+
+    // The operations with the set itself
+    HashSet<int> self = make_set(0, 100);
+    CHECK(self.unite(self).size() == 100);
+    CHECK(self.intersect(self).size() == 100);
+    CHECK(self.subtract(self).empty());
+
+    // The operations with the empty set
+    HashSet<int> empty;
+    self = make_set(0, 100);
+    CHECK(HashSet<int>(self).unite(empty).size() == 100);
+    CHECK(HashSet<int>(self).intersect(empty).empty());
+    CHECK(HashSet<int>(self).subtract(empty).size() == 100);
+    CHECK(HashSet<int>(empty).unite(self).size() == 100);
+}
+
+// The binary operators do not change their operands, the results are the
+// same whichever operand is smaller
+void test_binary_operators()
+{
+    HashSet<std::string> small, large;
+
+    for (int i = 0; i < 100; i++)
+        small.insert(std::to_string(i));
+    for (int i = 50; i < 1050; i++)
+        large.insert(std::to_string(i));
+
+    std::set<std::string> small_keys = keys_of(small);
+    std::set<std::string> large_keys = keys_of(large);
+
+    HashSet<std::string> united = small | large;
+    CHECK(united.size() == 1050);
+    CHECK(keys_of(large | small) == keys_of(united));
+
+    HashSet<std::string> common = small & large;
+    CHECK(common.size() == 50);
+    CHECK(common.contains("50") && !common.contains("49"));
+    CHECK(keys_of(large & small) == keys_of(common));
+
+    // The intersection keeps the stored hash values of the smaller set
+    CHECK(common.seed() == small.seed());
+    for (int i = 50; i < 100; i++)
+        CHECK(common.find(std::to_string(i)) != common.end());
+
+    HashSet<std::string> rest = small - large;
+    CHECK(rest.size() == 50 && rest.contains("0") && !rest.contains("50"));
+    CHECK((large - small).size() == 950);
+
+    CHECK(keys_of(small) == small_keys && keys_of(large) == large_keys);
+
+    // The results are usual sets open to the next insertions
+    common.insert("new");
+    rest.insert("50");
+    CHECK(common.size() == 51 && rest.size() == 51);
+}
+
+
+int main()
+{
+    test_compound_operations();
+    test_binary_operators();
+
+    return test_result("hash_set_test");
+}
@@ -0,0 +1,136 @@
+// hopscotch_hash_map_test.cpp
+
+#include <random>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+#include <HopscotchHashMap.hpp>
+
+#include "test.hpp"
+
+
+// Hasher, which maps all the keys to the same hash value
+struct colliding_hash
+{
+    size_t operator()(int) const noexcept { return 42; }
+};
+
+
+// More keys with equal hash values than the neighborhood holds throw
+// instead of growing the table without limit
+void test_colliding_keys()
+{
+    using map_t = HopscotchHashMap<int, int, colliding_hash>;
+
+    map_t map;
+    int count = 0;
+
+    try
+    {
+        for (; count < 1000; count++)
+            map[count] = count;
+    }
+    catch (const std::length_error&)
+    {}
+
+    CHECK(count == int(map_t::NEIGHBORHOOD_SIZE));
+    CHECK(map.size() == size_t(count));
+    CHECK(map.buckets_count() <= 64 * 16);
+
+    for (int i = 0; i < count; i++)
+        CHECK(map.at(i) == i);
+}
+
+// The table filled up to the high max load factor is not halved by the
+// first failed displacement
+void test_high_load()
+{
+    const size_t COUNT_KEYS = 100000;
+
+    HopscotchHashMap<uint64_t, uint64_t> map;
+    std::mt19937_64 random(42);
+
+    map.max_load_factor(0.95f);
+    map.reverse(COUNT_KEYS);
+
+    for (size_t i = 0; i < COUNT_KEYS; i++)
+        map[random()] = i;
+
+    CHECK(map.size() == COUNT_KEYS);
+    CHECK(map.load_factor() > 0.8f);
+}
+
+// The node handles, the merges and the erasures of the ranges
+void test_node_operations()
+{
+    using map_t = HopscotchHashMap<int, std::string>;
+
+    map_t map, other;
+    for (int i = 0; i < 100; i++)
+        map[i] = std::to_string(i);
+    for (int i = 50; i < 150; i++)
+        other[i] = "other";
+
+    auto node = map.extract(7);
+    CHECK(!node.empty() && node.key() == 7 && node.mapped() == "7");
+    CHECK(map.count(7) == 0 && map.size() == 99);
+    CHECK(map.extract(7).empty());
+
+    auto result = other.insert(std::move(node));
+    CHECK(result.inserted && result.node.empty());
+    CHECK(other.at(7) == "7");
+
+    map.merge(other);
+    CHECK(map.size() == 150);
+    CHECK(map.at(50) == "50" && map.at(149) == "other");
+    CHECK(other.size() == 50 && other.at(50) == "other");
+
+    map_t sums;
+    sums[1] = "a";
+    map_t more;
+    more[1] = "b";
+    more[2] = "c";
+    sums.merge(more, [](const std::string& _a, std::string&& _b)
+        { return _a + _b; });
+    CHECK(sums.size() == 2 && sums.at(1) == "ab" && more.empty());
+
+    CHECK(map.erase_if([](const std::pair<const int, std::string>& _val)
+        { return _val.first % 2 == 0; }) == 75);
+    CHECK(map.size() == 75 && map.count(2) == 0 && map.count(3) == 1);
+
+    map.erase(map.begin(), map.end());
+    CHECK(map.empty() && map.begin() == map.end());
+
+    // The colliding keys share the neighborhood, the erasures do not move
+    // the remaining ones
+    HopscotchHashMap<int, int, colliding_hash> crowded;
+    for (int i = 0; i < 10; i++)
+        crowded[i] = i;
+
+    auto crowded_node = crowded.extract(crowded.find(0));
+    CHECK(!crowded_node.empty() && crowded_node.key() == 0);
+    CHECK(crowded.size() == 9 && crowded.count(0) == 0);
+    CHECK(crowded.erase_if([](const std::pair<const int, int>& _val)
+        { return _val.first < 5; }) == 4);
+    for (int i = 5; i < 10; i++)
+        CHECK(crowded.at(i) == i);
+    CHECK(crowded.insert(std::move(crowded_node)).inserted);
+    CHECK(crowded.size() == 6);
+}
+
+// The moved-from container is valid and empty
+void test_moved_from() { check_moved_from<HopscotchHashMap<int, int>>(); }
+
+
+int main()
+{
+    test_colliding_keys();
+    test_high_load();
+    test_node_operations();
+    test_moved_from();
+
+    return test_result("hopscotch_hash_map_test");
+}
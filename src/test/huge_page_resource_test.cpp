@@ -0,0 +1,91 @@
+// huge_page_resource_test.cpp
+
+#include <utility>
+#include <functional>
+#include <cstddef>
+
+#include <HashMap.hpp>
+#include <alloc/memory_resource.hpp>
+#include <alloc/huge_page_resource.hpp>
+
+#include "test.hpp"
+
+
+// Returns the count of the bytes mapped by the resource
+size_t mapped_bytes(const huge_page_resource& _resource)
+{
+    huge_page_resource::stats_t stats = _resource.stats();
+
+    return stats.explicit_bytes + stats.transparent_bytes + stats.normal_bytes;
+}
+
+// The map takes its buckets and nodes from the pool over the resource, the
+// memory is mapped on the first allocation and unmapped by release(). The
+// transparent huge pages may be unavailable, then the pages are normal
+void test_map_over_pool(huge_page_resource::page_mode _mode)
+{
+    using map_t = HashMap<int, int, hash<int>, std::equal_to<int>,
+        polymorphic_allocator<std::pair<const int, int>>>;
+
+    const int COUNT_KEYS = 100000;
+
+    huge_page_resource resource(_mode);
+    CHECK(mapped_bytes(resource) == 0);
+    CHECK(resource.stats().numa_failures == 0);
+
+    unsynchronized_pool_resource pool(&resource);
+    {
+        map_t map(&pool);
+        for (int i = 0; i < COUNT_KEYS; i++)
+            map[i] = i * 2;
+
+        CHECK(map.size() == COUNT_KEYS);
+        for (int i = 0; i < COUNT_KEYS; i++)
+            CHECK(map.at(i) == i * 2);
+
+        huge_page_resource::stats_t stats = resource.stats();
+        CHECK(mapped_bytes(resource) >= COUNT_KEYS * sizeof(int) * 2);
+        CHECK(mapped_bytes(resource) % huge_page_resource::HUGE_PAGE_SIZE
+            == 0);
+        CHECK(stats.explicit_bytes == 0);
+        if (_mode == huge_page_resource::page_mode::NORMAL)
+            CHECK(stats.transparent_bytes == 0);
+    }
+
+    // The shared region of the small blocks stays mapped for the reuse
+    pool.release();
+    CHECK(mapped_bytes(resource) <= huge_page_resource::HUGE_PAGE_SIZE);
+
+    resource.release();
+    CHECK(mapped_bytes(resource) == 0);
+}
+
+// The node out of the mask of the NUMA nodes is counted as the failed
+// request, the memory is mapped without the policy
+void test_numa_node_out_of_mask()
+{
+    const int NODES[] = { -1, 64, 1000 };
+
+    for (int node : NODES)
+    {
+        huge_page_resource resource(huge_page_resource::page_mode::NORMAL,
+            huge_page_resource::numa_mode::BIND, node);
+
+        void* ptr = resource.allocate(1024);
+        CHECK(ptr != nullptr);
+        CHECK(resource.stats().numa_failures == 1);
+        CHECK(mapped_bytes(resource) == huge_page_resource::HUGE_PAGE_SIZE);
+
+        resource.deallocate(ptr, 1024);
+    }
+}
+
+
+int main()
+{
+    test_map_over_pool(huge_page_resource::page_mode::NORMAL);
+    test_map_over_pool(huge_page_resource::page_mode::TRANSPARENT);
+    test_numa_node_out_of_mask();
+
+    return test_result("huge_page_resource_test");
+}
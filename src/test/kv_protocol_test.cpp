@@ -0,0 +1,171 @@
+// kv_protocol_test.cpp
+
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+#include <KvProtocol.hpp>
+
+#include "test.hpp"
+
+
+// Returns the raw request with the specified header fields and no data
+std::string raw_request(uint8_t _op, uint32_t _key_size,
+    uint32_t _value_size)
+{
+    kv_request_header header{_op, {0, 0, 0}, _key_size, _value_size};
+
+    return std::string(reinterpret_cast<const char*>(&header),
+        sizeof(header));
+}
+
+// Every prefix of the request is incomplete, the parsed request points to
+// the key and the value in the buffer
+void test_partial_request()
+{
+    std::string data;
+    kv_append_request(data, KV_SET, "key", 3, "value", 5);
+    CHECK(data.size() == sizeof(kv_request_header) + 8);
+
+    kv_request request{};
+    for (size_t size = 0; size < data.size(); size++)
+        CHECK(kv_parse_request(data.data(), size, request) == 0);
+
+    CHECK(kv_parse_request(data.data(), data.size(), request) ==
+        data.size());
+    CHECK(request.op == KV_SET);
+    CHECK(request.key == data.data() + sizeof(kv_request_header));
+    CHECK(std::string(request.key, request.key_size) == "key");
+    CHECK(std::string(request.value, request.value_size) == "value");
+}
+
+// The same holds for the responses with the partial header or value
+void test_partial_response()
+{
+    std::string data;
+    kv_append_response(data, KV_OK, "value", 5);
+
+    kv_response response{};
+    for (size_t size = 0; size < data.size(); size++)
+        CHECK(kv_parse_response(data.data(), size, response) == 0);
+
+    CHECK(kv_parse_response(data.data(), data.size(), response) ==
+        data.size());
+    CHECK(response.status == KV_OK);
+    CHECK(std::string(response.value, response.value_size) == "value");
+
+    data.clear();
+    kv_append_response(data, KV_NOT_FOUND);
+    CHECK(kv_parse_response(data.data(), data.size(), response) ==
+        sizeof(kv_response_header));
+    CHECK(response.status == KV_NOT_FOUND && response.value_size == 0);
+}
+
+// The pipelined requests and responses are parsed one by one from the same
+// buffer, the incomplete last one waits for the rest of its data
+void test_pipelined()
+{
+    std::string data;
+    kv_append_request(data, KV_GET, "a", 1);
+    kv_append_request(data, KV_SET, "bb", 2, "value", 5);
+    kv_append_request(data, KV_DEL, "ccc", 3);
+    kv_append_request(data, KV_INFO, "", 0);
+    kv_append_request(data, KV_SET, "d", 1, "tail", 4);
+
+    // The last request is cut in the middle of its value
+    data.resize(data.size() - 2);
+
+    const uint8_t OPS[] = { KV_GET, KV_SET, KV_DEL, KV_INFO };
+    const char* KEYS[] = { "a", "bb", "ccc", "" };
+
+    size_t offset = 0;
+    kv_request request{};
+    for (size_t i = 0; i < 4; i++)
+    {
+        size_t size = kv_parse_request(data.data() + offset,
+            data.size() - offset, request);
+
+        CHECK(size != 0);
+        CHECK(request.op == OPS[i]);
+        CHECK(std::string(request.key, request.key_size) == KEYS[i]);
+        offset += size;
+    }
+
+    CHECK(std::string(request.value, request.value_size) == "");
+    CHECK(kv_parse_request(data.data() + offset, data.size() - offset,
+        request) == 0);
+
+    data.append("il");
+    CHECK(kv_parse_request(data.data() + offset, data.size() - offset,
+        request) == data.size() - offset);
+    CHECK(std::string(request.value, request.value_size) == "tail");
+
+    std::string responses;
+    kv_append_response(responses, KV_OK, "1", 1);
+    kv_append_response(responses, KV_WRONG_SHARD);
+    kv_append_response(responses, KV_OK, "22", 2);
+
+    offset = 0;
+    kv_response response{};
+    size_t count = 0;
+    while (size_t size = kv_parse_response(responses.data() + offset,
+        responses.size() - offset, response))
+    {
+        offset += size;
+        count++;
+    }
+
+    CHECK(count == 3 && offset == responses.size());
+    CHECK(std::string(response.value, response.value_size) == "22");
+}
+
+// The unknown operations and the oversized keys and values are rejected
+// by the header alone, before their data is received
+void test_malformed()
+{
+    kv_request request{};
+    kv_response response{};
+
+    std::string data = raw_request(0, 1, 0);
+    CHECK_THROWS(kv_parse_request(data.data(), data.size(), request),
+        std::runtime_error);
+
+    data = raw_request(KV_INFO + 1, 1, 0);
+    CHECK_THROWS(kv_parse_request(data.data(), data.size(), request),
+        std::runtime_error);
+
+    data = raw_request(KV_GET, KV_MAX_KEY_SIZE + 1, 0);
+    CHECK_THROWS(kv_parse_request(data.data(), data.size(), request),
+        std::runtime_error);
+
+    data = raw_request(KV_SET, 1, KV_MAX_VALUE_SIZE + 1);
+    CHECK_THROWS(kv_parse_request(data.data(), data.size(), request),
+        std::runtime_error);
+
+    // The largest sizes are accepted and wait for the data
+    data = raw_request(KV_SET, KV_MAX_KEY_SIZE, KV_MAX_VALUE_SIZE);
+    CHECK(kv_parse_request(data.data(), data.size(), request) == 0);
+
+    kv_response_header header{KV_WRONG_SHARD + 1, {0, 0, 0}, 0};
+    data.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    CHECK_THROWS(kv_parse_response(data.data(), data.size(), response),
+        std::runtime_error);
+
+    header = kv_response_header{KV_OK, {0, 0, 0},
+        uint32_t(KV_MAX_VALUE_SIZE + 1)};
+    data.assign(reinterpret_cast<const char*>(&header), sizeof(header));
+    CHECK_THROWS(kv_parse_response(data.data(), data.size(), response),
+        std::runtime_error);
+}
+
+
+int main()
+{
+    test_partial_request();
+    test_partial_response();
+    test_pipelined();
+    test_malformed();
+
+    return test_result("kv_protocol_test");
+}
@@ -0,0 +1,98 @@
+// latency_histogram_test.cpp
+
+#include <cstdint>
+#include <cstddef>
+
+#include <LatencyHistogram.hpp>
+
+#include "test.hpp"
+
+
+// Returns the upper bound of the bucket of the value, which is reported as
+// the median of the value and a larger one
+uint64_t bucket_bound(uint64_t _value)
+{
+    LatencyHistogram histogram;
+
+    histogram.record(_value);
+    histogram.record(UINT64_MAX);
+
+    return histogram.percentile(50);
+}
+
+// The values less than SUB_COUNT and the first range above it are exact,
+// the next ranges are split into the buckets of 2^k values, the values
+// from 2^MAX_BITS go to the last bucket without the upper bound
+void test_bucket_bounds()
+{
+    CHECK(bucket_bound(0) == 0);
+    CHECK(bucket_bound(127) == 127);
+    CHECK(bucket_bound(128) == 128);
+    CHECK(bucket_bound(255) == 255);
+    CHECK(bucket_bound(256) == 257);
+    CHECK(bucket_bound(257) == 257);
+    CHECK(bucket_bound(258) == 259);
+
+    // The bound is within 1/SUB_COUNT of the value
+    for (uint64_t value = 1; value < (uint64_t(1) << 30);
+        value = value * 3 + 1)
+    {
+        uint64_t bound = bucket_bound(value);
+        CHECK(bound >= value);
+        CHECK(bound - value <= value / LatencyHistogram::SUB_COUNT);
+    }
+
+    // The large values are not reported below themselves
+    uint64_t large = uint64_t(1) << LatencyHistogram::MAX_BITS;
+    CHECK(bucket_bound(large) == UINT64_MAX);
+    CHECK(bucket_bound(large / 2) < large);
+
+    LatencyHistogram histogram;
+    histogram.record(large);
+    histogram.record(large * 4);
+    CHECK(histogram.percentile(50) == large * 4);
+}
+
+// The percentile is the least recorded value, which is not less than the
+// specified part of the values
+void test_percentiles()
+{
+    LatencyHistogram histogram;
+    CHECK(histogram.percentile(50) == 0 && histogram.min() == 0);
+
+    for (uint64_t value = 1; value <= 100; value++)
+        histogram.record(value);
+
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.min() == 1 && histogram.max() == 100);
+    CHECK(histogram.mean() == 50.5);
+    CHECK(histogram.percentile(0) == 1);
+    CHECK(histogram.percentile(1) == 1);
+    CHECK(histogram.percentile(50) == 50);
+    CHECK(histogram.percentile(50.5) == 51);
+    CHECK(histogram.percentile(99) == 99);
+    CHECK(histogram.percentile(99.9) == 100);
+    CHECK(histogram.percentile(100) == 100);
+
+    // The merged histogram has the ranks of both
+    LatencyHistogram other;
+    for (uint64_t value = 101; value <= 200; value++)
+        other.record(value);
+
+    histogram.merge(other);
+    CHECK(histogram.count() == 200 && histogram.max() == 200);
+    CHECK(histogram.percentile(50) == 100);
+    CHECK(histogram.percentile(75) == 150);
+
+    histogram.clear();
+    CHECK(histogram.count() == 0 && histogram.percentile(99) == 0);
+}
+
+
+int main()
+{
+    test_bucket_bounds();
+    test_percentiles();
+
+    return test_result("latency_histogram_test");
+}
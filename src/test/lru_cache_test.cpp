@@ -0,0 +1,76 @@
+// lru_cache_test.cpp
+
+#include <vector>
+
+#include <LruCache.hpp>
+
+#include "test.hpp"
+
+
+// The entries are evicted in the order of the replacement
+void test_eviction_order()
+{
+    std::vector<int> evicted;
+
+    LruCache<int, int> lru(3);
+    lru.on_evict([&](const int& _key, int&) { evicted.push_back(_key); });
+
+    lru.put(1, 1);
+    lru.put(2, 2);
+    lru.put(3, 3);
+    lru.get(1);
+    lru.put(4, 4);
+    lru.put(5, 5);
+
+    CHECK((evicted == std::vector<int>{2, 3}));
+    CHECK(lru.contains(1) && lru.contains(4) && lru.contains(5));
+
+    // The hand gives the referenced entry the second chance
+    evicted.clear();
+    ClockCache<int, int> clock(3);
+    clock.on_evict([&](const int& _key, int&) { evicted.push_back(_key); });
+
+    clock.put(1, 1);
+    clock.put(2, 2);
+    clock.put(3, 3);
+    clock.get(1);
+    clock.put(4, 4);
+    clock.put(5, 5);
+
+    CHECK((evicted == std::vector<int>{2, 3}));
+    CHECK(clock.contains(1) && clock.contains(4) && clock.contains(5));
+}
+
+// The put entry is never evicted by its own insertion
+void test_put_at_capacity()
+{
+    ClockCache<int, int> clock(3);
+
+    for (int i = 0; i < 3; i++)
+        clock.put(i, i);
+
+    // All the reference bits are set, so the hand sweeps the whole list
+    for (int i = 0; i < 3; i++)
+        clock.get(i);
+
+    clock.put(3, 3);
+    CHECK(clock.contains(3) && clock.size() == 3);
+
+    for (int i = 4; i < 100; i++)
+    {
+        for (int k = i - 3; k < i; k++)
+            clock.get(k);
+
+        clock.put(i, i);
+        CHECK(clock.contains(i) && clock.size() == 3);
+    }
+}
+
+
+int main()
+{
+    test_eviction_order();
+    test_put_at_capacity();
+
+    return test_result("lru_cache_test");
+}
@@ -0,0 +1,140 @@
+// parallel_aggregator_test.cpp
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include <ParallelAggregator.hpp>
+
+#include "test.hpp"
+
+
+// Returns the input of the aggregation: the pairs with the repeated keys
+std::vector<std::pair<uint64_t, uint64_t>> make_input(size_t _count,
+    size_t _count_keys)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> input(_count);
+    uint64_t state = 42;
+
+    for (std::pair<uint64_t, uint64_t>& item : input)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        item.first = (state >> 33) % _count_keys;
+        item.second = state >> 48;
+    }
+
+    return input;
+}
+
+// Returns the serial fold of the input by the combine functor
+template <class _Combine>
+HashMap<uint64_t, uint64_t> fold(
+    const std::vector<std::pair<uint64_t, uint64_t>>& _input)
+{
+    HashMap<uint64_t, uint64_t> result;
+    _Combine combine;
+
+    for (const std::pair<uint64_t, uint64_t>& item : _input)
+    {
+        auto res = result.insert(item);
+        if (!res.second)
+            (*res.first).second = combine((*res.first).second, item.second);
+    }
+
+    return result;
+}
+
+// Checks that the maps have the same elements
+bool same_items(const HashMap<uint64_t, uint64_t>& _map,
+    const HashMap<uint64_t, uint64_t>& _other)
+{
+    if (_map.size() != _other.size())
+        return false;
+
+    for (const auto& item : _map)
+    {
+        auto iter = _other.find(item.first);
+        if (iter == _other.end() || (*iter).second != item.second)
+            return false;
+    }
+
+    return true;
+}
+
+// The workers aggregate the interleaved slices of the input, the merged
+// result is equal to the serial fold for any count of workers, with and
+// without spilling, and every key is in a single partition
+template <class _Combine>
+void test_serial_equivalence()
+{
+    using aggregator_t = ParallelAggregator<uint64_t, uint64_t, _Combine>;
+
+    const size_t COUNT_ITEMS = 200000;
+    const size_t COUNT_KEYS = 5000;
+    const size_t COUNT_WORKERS[] = { 1, 2, 3, 8 };
+    const size_t SPILL_SIZES[] = { 0, 100 };
+
+    std::vector<std::pair<uint64_t, uint64_t>> input = make_input(
+        COUNT_ITEMS, COUNT_KEYS);
+    HashMap<uint64_t, uint64_t> expected = fold<_Combine>(input);
+
+    for (size_t count_workers : COUNT_WORKERS)
+        for (size_t spill_size : SPILL_SIZES)
+        {
+            aggregator_t aggregator(count_workers, spill_size);
+
+            aggregator.run([&input, count_workers](
+                typename aggregator_t::worker& _worker, size_t _n)
+            {
+                for (size_t i = _n; i < input.size(); i += count_workers)
+                    _worker.add(input[i].first, input[i].second);
+            });
+            aggregator.merge();
+
+            CHECK(aggregator.size() == expected.size());
+
+            size_t count_found = 0;
+            for (const auto& part : aggregator.partitions())
+                for (const auto& item : part)
+                {
+                    CHECK(item.second == expected.at(item.first));
+                    count_found++;
+                }
+            CHECK(count_found == expected.size());
+
+            HashMap<uint64_t, uint64_t> result = aggregator.release();
+            CHECK(same_items(result, expected) && aggregator.size() == 0);
+        }
+}
+
+// The workers can update the values in place by operator[], the values
+// added by several workers are combined by merge
+void test_subscript()
+{
+    ParallelAggregator<uint64_t, uint64_t> aggregator(4);
+
+    aggregator.run([](ParallelAggregator<uint64_t, uint64_t>::worker&
+        _worker, size_t)
+    {
+        for (uint64_t i = 0; i < 1000; i++)
+            _worker[i % 10]++;
+    });
+    aggregator.merge();
+
+    HashMap<uint64_t, uint64_t> result = aggregator.release();
+    CHECK(result.size() == 10);
+    for (uint64_t i = 0; i < 10; i++)
+        CHECK(result.at(i) == 400);
+}
+
+
+int main()
+{
+    test_serial_equivalence<combine_sum>();
+    test_serial_equivalence<combine_max>();
+    test_serial_equivalence<combine_min>();
+    test_subscript();
+
+    return test_result("parallel_aggregator_test");
+}
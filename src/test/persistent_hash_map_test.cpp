@@ -0,0 +1,175 @@
+// persistent_hash_map_test.cpp
+
+#include <string>
+#include <set>
+#include <utility>
+#include <cstddef>
+
+#include <PersistentHashMap.hpp>
+
+#include "test.hpp"
+
+
+// Hasher, which maps all the keys to the same hash value
+struct colliding_hash
+{
+    size_t operator()(int) const noexcept { return 42; }
+};
+
+
+// Returns the set of the keys of the map collected by its iterators
+template <class _Map>
+std::set<int> keys_of(const _Map& _map)
+{
+    std::set<int> keys;
+
+    for (const auto& item : _map)
+        keys.insert(item.first);
+
+    return keys;
+}
+
+// The snapshots keep their elements after the updates of the map
+void test_snapshots()
+{
+    using map_t = PersistentHashMap<int, std::string>;
+
+    map_t map;
+    for (int i = 0; i < 1000; i++)
+        map.insert(std::make_pair(i, std::to_string(i)));
+
+    map_t snapshot = map.snapshot();
+
+    for (int i = 0; i < 1000; i += 2)
+        map.erase(i);
+    for (int i = 1; i < 1000; i += 2)
+        map.insert_or_assign(i, "updated");
+    for (int i = 1000; i < 1100; i++)
+        map.insert(std::make_pair(i, "new"));
+
+    CHECK(map.size() == 600 && map.at(1) == "updated");
+    CHECK(map.count(0) == 0 && map.at(1050) == "new");
+
+    CHECK(snapshot.size() == 1000 && keys_of(snapshot).size() == 1000);
+    for (int i = 0; i < 1000; i++)
+        CHECK(snapshot.at(i) == std::to_string(i));
+    CHECK(snapshot.count(1050) == 0);
+}
+
+// The persistent map given by the transient is not changed by the next
+// updates of the transient, and the transient does not change the map it
+// has started from
+void test_transient()
+{
+    using map_t = PersistentHashMap<int, int>;
+
+    map_t origin;
+    for (int i = 0; i < 100; i++)
+        origin.insert(std::make_pair(i, i));
+
+    map_t::transient_type transient = origin.transient();
+    for (int i = 0; i < 100; i++)
+        transient.insert_or_assign(i, -i);
+    for (int i = 100; i < 200; i++)
+        transient.insert(std::make_pair(i, i));
+
+    map_t first = transient.persistent();
+
+    // The edits after persistent() copy the nodes given to the map
+    for (int i = 0; i < 200; i += 2)
+        transient.erase(i);
+    for (int i = 1; i < 200; i += 2)
+        transient.insert_or_assign(i, 0);
+    transient.insert(std::make_pair(1000, 1000));
+
+    map_t second = transient.persistent();
+
+    CHECK(origin.size() == 100);
+    for (int i = 0; i < 100; i++)
+        CHECK(origin.at(i) == i);
+
+    CHECK(first.size() == 200 && first.count(1000) == 0);
+    for (int i = 0; i < 100; i++)
+        CHECK(first.at(i) == -i);
+    for (int i = 100; i < 200; i++)
+        CHECK(first.at(i) == i);
+
+    CHECK(second.size() == 101 && transient.size() == 101);
+    CHECK(second.count(0) == 0 && second.at(1) == 0);
+    CHECK(second.at(1000) == 1000);
+}
+
+// The keys with equal hash values go to the collision node, which is
+// copied on the update like the other nodes
+void test_collisions()
+{
+    using map_t = PersistentHashMap<int, int, colliding_hash>;
+
+    map_t map;
+    for (int i = 0; i < 10; i++)
+        CHECK(map.insert(std::make_pair(i, i)).second);
+    CHECK(!map.insert(std::make_pair(5, 0)).second);
+
+    map_t snapshot = map.snapshot();
+
+    CHECK(map.erase(3) == 1 && map.erase(3) == 0);
+    CHECK(!map.insert_or_assign(4, 40));
+    CHECK(map.size() == 9 && map.count(3) == 0 && map.at(4) == 40);
+    CHECK(keys_of(map).size() == 9);
+
+    CHECK(snapshot.size() == 10 && snapshot.at(3) == 3);
+    CHECK(snapshot.at(4) == 4 && keys_of(snapshot).size() == 10);
+
+    // The last keys of the collision node are erased as well
+    for (int i = 0; i < 10; i++)
+        map.erase(i);
+    CHECK(map.empty() && map.begin() == map.end());
+    CHECK(snapshot.size() == 10);
+}
+
+// The iterator returned by find() goes on to the elements after the found
+// one, so together with the elements before it every element is visited
+// once
+void test_find_iteration()
+{
+    using map_t = PersistentHashMap<int, int>;
+
+    map_t map;
+    for (int i = 0; i < 5000; i++)
+        map.insert(std::make_pair(i, i));
+
+    std::set<int> before;
+    for (auto iter = map.begin(); iter->first != 1234; ++iter)
+        before.insert(iter->first);
+
+    std::set<int> after;
+    for (auto iter = map.find(1234); iter != map.end(); ++iter)
+        CHECK(after.insert(iter->first).second);
+
+    CHECK(before.size() + after.size() == 5000);
+    CHECK(after.count(1234) == 1);
+    for (int key : before)
+        CHECK(after.count(key) == 0);
+
+    // The same holds for the keys in the collision node
+    PersistentHashMap<int, int, colliding_hash> colliding;
+    for (int i = 0; i < 10; i++)
+        colliding.insert(std::make_pair(i, i));
+
+    size_t count = 0;
+    for (auto iter = colliding.find(colliding.begin()->first);
+        iter != colliding.end(); ++iter)
+        count++;
+    CHECK(count == 10);
+}
+
+
+int main()
+{
+    test_snapshots();
+    test_transient();
+    test_collisions();
+    test_find_iteration();
+
+    return test_result("persistent_hash_map_test");
+}
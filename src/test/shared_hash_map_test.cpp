@@ -0,0 +1,81 @@
+// shared_hash_map_test.cpp
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+#include <SharedHashMap.hpp>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "test.hpp"
+
+
+// The child process maps the segment again, the inherited mapping stays, so
+// the new one is at another address. The changes of the child through the
+// offset pointers are seen by the parent, and the updates of both processes
+// are serialized by the shared lock
+void test_fork()
+{
+    using map_t = SharedHashMap<int, long>;
+
+    const int COUNT_UPDATES = 1000;
+    std::string name = "/shared_hash_map_test_" + std::to_string(::getpid());
+
+    map_t::remove(name);
+    {
+        map_t map(name, 1000);
+        map.insert(std::make_pair(1, 10L));
+        map.insert(std::make_pair(2, 20L));
+
+        std::cout.flush();
+        pid_t pid = ::fork();
+
+        if (pid == 0)
+        {
+            {
+                map_t child(name, 1);
+                CHECK(child.capacity() == 1000 && child.at(1) == 10);
+
+                child.insert_or_assign(1, 11);
+                child.update(2, [](long& _data) { _data += 5; });
+                CHECK(child.insert(std::make_pair(3, 30L)));
+
+                for (int i = 0; i < COUNT_UPDATES; i++)
+                    child.update(0, [](long& _data) { _data++; });
+            }
+
+            ::_exit(count_failures == 0 ? 0 : 1);
+        }
+
+        CHECK(pid > 0);
+
+        for (int i = 0; i < COUNT_UPDATES; i++)
+            map.update(0, [](long& _data) { _data++; });
+
+        int status = 0;
+        CHECK(::waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        CHECK(map.size() == 4);
+        CHECK(map.at(0) == 2 * COUNT_UPDATES);
+        CHECK(map.at(1) == 11 && map.at(2) == 25 && map.at(3) == 30);
+
+        // The element inserted by the child is found through the new
+        // mapping of the parent as well
+        map_t reopened(name, 1);
+        CHECK(reopened.at(3) == 30 && reopened.size() == 4);
+    }
+    map_t::remove(name);
+}
+
+
+int main()
+{
+    test_fork();
+
+    return test_result("shared_hash_map_test");
+}
@@ -0,0 +1,71 @@
+// static_hash_map_test.cpp
+
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+
+#include <StaticHashMap.hpp>
+
+#include "test.hpp"
+
+
+constexpr static_entry<const char*, int> COMMANDS[] =
+    { { "get", 1 }, { "set", 2 }, { "del", 3 }, { "incr", 4 },
+      { "decr", 5 }, { "keys", 6 }, { "ping", 7 } };
+using commands_t = StaticHashMap<decltype(COMMANDS), COMMANDS>;
+
+enum class color { red, green, blue };
+
+constexpr static_entry<color, unsigned> COLORS[] =
+    { { color::red, 0xff0000 }, { color::green, 0x00ff00 },
+      { color::blue, 0x0000ff } };
+using colors_t = StaticHashMap<decltype(COLORS), COLORS>;
+
+
+// The lookups of the keys are constant expressions
+static_assert(commands_t::at("set") == 2, "");
+static_assert(commands_t::count("put") == 0, "");
+static_assert(colors_t::at(color::green) == 0x00ff00, "");
+
+
+// Every entry of the list is found by its key
+void test_lookup()
+{
+    CHECK(commands_t::size() == 7);
+    CHECK(!commands_t::empty());
+
+    for (const auto& entry : COMMANDS)
+    {
+        CHECK(commands_t::find(entry._m_key) == &entry._m_value);
+        CHECK(commands_t::at(std::string(entry._m_key)) == entry._m_value);
+        CHECK(commands_t::count(std::string(entry._m_key)) == 1);
+    }
+
+    CHECK(commands_t::find("put") == nullptr);
+    CHECK(commands_t::count(std::string("ge")) == 0);
+    CHECK_THROWS(commands_t::at(std::string("gets")), std::out_of_range);
+
+    for (const auto& entry : COLORS)
+        CHECK(colors_t::at(entry._m_key) == entry._m_value);
+}
+
+// The iteration goes in the order of the list
+void test_iteration()
+{
+    size_t n = 0;
+
+    for (auto it = commands_t::begin(); it != commands_t::end(); ++it, n++)
+        CHECK(it == &COMMANDS[n]);
+
+    CHECK(n == commands_t::size());
+    CHECK(commands_t::slots_count() >= commands_t::size());
+}
+
+
+int main()
+{
+    test_lookup();
+    test_iteration();
+
+    return test_result("static_hash_map_test");
+}
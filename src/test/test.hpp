@@ -0,0 +1,91 @@
+// test.hpp
+
+#ifndef _TEST_
+#define _TEST_
+
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+
+// Count of the failed checks of the test program
+static size_t count_failures = 0;
+
+// Checks the condition and reports the failed one with its location, the
+// test goes on, so all the failed checks of the run are reported
+#define CHECK(_cond)                                                        \
+    do                                                                      \
+    {                                                                       \
+        if (!(_cond))                                                       \
+        {                                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: "  \
+                << #_cond << std::endl;                                     \
+            count_failures++;                                               \
+        }                                                                   \
+    } while (false)
+
+// Checks that the statement throws the exception of the specified type
+#define CHECK_THROWS(_stmt, _exception)                                     \
+    do                                                                      \
+    {                                                                       \
+        bool is_thrown = false;                                             \
+        try { _stmt; } catch (const _exception&) { is_thrown = true; }      \
+        CHECK(is_thrown && #_stmt);                                         \
+    } while (false)
+
+// Returns the mapped value of the test element with the key
+template <class _Data>
+_Data test_value(int _key);
+
+template <>
+inline int test_value<int>(int _key) { return _key; }
+
+template <>
+inline std::string test_value<std::string>(int _key)
+{ return std::to_string(_key); }
+
+// Checks that the moved-from map is valid and empty after the move
+// construction and the move assignment: the lookups and the iteration find
+// nothing and it accepts new elements. The map has the int keys and the int
+// or string mapped values
+template <class _Map>
+void check_moved_from()
+{
+    using data_t = typename _Map::_mapped_t;
+
+    _Map source;
+    for (int i = 0; i < 100; i++)
+        source[i] = test_value<data_t>(i);
+
+    _Map target(std::move(source));
+    CHECK(target.size() == 100 && target.at(42) == test_value<data_t>(42));
+    CHECK(source.empty() && source.begin() == source.end());
+    CHECK(source.find(1) == source.end() && source.count(1) == 0);
+
+    source[1] = test_value<data_t>(1);
+    CHECK(source.size() == 1 && source.at(1) == test_value<data_t>(1));
+
+    _Map assigned;
+    assigned = std::move(target);
+    CHECK(assigned.size() == 100 && assigned.at(7) == test_value<data_t>(7));
+    CHECK(target.empty() && target.begin() == target.end());
+    CHECK(target.find(42) == target.end() && target.count(42) == 0);
+
+    for (int i = 0; i < 100; i++)
+        target[i] = test_value<data_t>(i);
+    CHECK(target.size() == 100 && target.at(99) == test_value<data_t>(99));
+}
+
+// Returns the exit code of the test program and reports its result
+inline int test_result(const char* _name)
+{
+    std::cout << _name << ": " << (count_failures == 0 ? "passed" :
+        "FAILED") << std::endl;
+
+    return count_failures == 0 ? 0 : 1;
+}
+
+
+#endif  // _TEST_